@@ -16,4 +16,8 @@ constexpr bool is_debug_build() noexcept {
 // 本地开发 Playground 时改为 true 后全量重编。
 constexpr bool rpc_json_schema_enabled() noexcept { return false; }
 
+// 性能区间追踪；运行时默认不记录，由 system.setTracing 开启。
+// 改为 false 后全量重编，tracing::Span 会在编译期整体消失。
+constexpr bool tracing_enabled() noexcept { return true; }
+
 }  // namespace core::build_config
@@ -6,7 +6,10 @@
 
 #include "core/database/state.hpp"
 #include "core/database/types.hpp"
+#include "core/executor_metrics/executor_metrics.hpp"
 #include "core/state/app_state.hpp"
+#include "core/tracing/tracing.hpp"
+#include "core/worker_pool/worker_pool.hpp"
 #include "utils/logger/logger.hpp"
 
 namespace core::database {
@@ -15,6 +18,9 @@ namespace core::database {
 // 事务 lambda 内再次调用 execute/query 时会命中它并直接执行，避免任务重入死锁。
 thread_local SQLite::Database* current_connection = nullptr;
 
+// 业务线程上由 CancellationScope 设置，投递任务时随任务一起带到 DB worker。
+thread_local std::stop_token current_stop_token;
+
 namespace executor {
 
 auto resolve_thread_count() -> std::size_t {
@@ -102,6 +108,7 @@ auto worker_loop(DatabaseState& state, std::size_t index) -> void {
 
     // 标记当前线程为 DB worker；事务内部重入会直接复用这个连接。
     current_connection = &connection;
+    core::tracing::set_thread_name(std::format("database/{}", index));
 
     Logger().info("Database worker {} started", index);
 
@@ -148,6 +155,11 @@ auto worker_loop(DatabaseState& state, std::size_t index) -> void {
 
 }  // namespace executor
 
+CancellationScope::CancellationScope(std::stop_token stop_token)
+    : previous(std::exchange(current_stop_token, std::move(stop_token))) {}
+
+CancellationScope::~CancellationScope() { current_stop_token = std::move(previous); }
+
 auto run_database_job(core::AppState& app_state,
                       std::move_only_function<void(SQLite::Database&)> job)
     -> std::expected<void, std::string> {
@@ -165,16 +177,47 @@ auto run_database_job(core::AppState& app_state,
     return std::unexpected("Database executor is not running");
   }
 
+  auto stop_token = current_stop_token;
+  if (stop_token.stop_requested()) {
+    state.cancelled_jobs.fetch_add(1, std::memory_order_relaxed);
+    return std::unexpected("Database job cancelled");
+  }
+
   // 对外保持同步 API：调用线程等待 promise，实际 SQLite 操作在 DB worker 线程执行。
   std::promise<std::expected<void, std::string>> promise;
   auto future = promise.get_future();
-  auto task = [promise = std::move(promise), job = std::move(job)]() mutable {
+  const auto source = static_cast<std::size_t>(core::worker_pool::current_task_tag());
+  auto task = [&state, promise = std::move(promise), job = std::move(job),
+               stop_token = std::move(stop_token), source,
+               enqueued_at = executor_metrics::enqueue_time(state.metrics)]() mutable {
     if (!current_connection) {
       promise.set_value(std::unexpected("Database worker connection is not ready"));
       return;
     }
 
-    promise.set_value(executor::execute_job(*current_connection, job));
+    // 排队期间调用方已放弃，不再占用 worker
+    if (stop_token.stop_requested()) {
+      state.cancelled_jobs.fetch_add(1, std::memory_order_relaxed);
+      promise.set_value(std::unexpected("Database job cancelled"));
+      return;
+    }
+
+    // 执行中取消时中断当前语句；未提交的事务随 SQLITE_INTERRUPT 回滚
+    auto* connection = current_connection;
+    std::stop_callback interrupt_on_cancel(stop_token, [&state, connection] {
+      state.interrupted_jobs.fetch_add(1, std::memory_order_relaxed);
+      sqlite3_interrupt(connection->getHandle());
+    });
+    const auto started_at = executor_metrics::begin_task(state.metrics, source, enqueued_at);
+    auto result = [&] {
+      // 以提交来源命名，时间线上能直接对应到发起的扫描、相似度等子系统
+      core::tracing::Span span(
+          core::worker_pool::task_tag_name(static_cast<core::worker_pool::TaskTag>(source)).data(),
+          "database");
+      return executor::execute_job(*current_connection, job);
+    }();
+    executor_metrics::end_task(state.metrics, source, enqueued_at, started_at);
+    promise.set_value(std::move(result));
   };
 
   if (auto submit_result = executor::submit_task(state, std::move(task)); !submit_result) {
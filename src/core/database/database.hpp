@@ -10,6 +10,18 @@
 
 namespace core::database {
 
+// 作用域内当前线程投递的数据库任务绑定该令牌：排队中被取消的任务直接跳过，
+// 执行中被取消时中断 SQLite 语句。作用域只能覆盖同步调用，不能跨越 co_await。
+struct CancellationScope {
+  std::stop_token previous;
+
+  explicit CancellationScope(std::stop_token stop_token);
+  ~CancellationScope();
+
+  CancellationScope(const CancellationScope&) = delete;
+  auto operator=(const CancellationScope&) -> CancellationScope& = delete;
+};
+
 // 同步执行数据库任务。调用方会等待任务完成；事务内重入时由实现复用当前 worker 连接。
 auto run_database_job(core::AppState& app_state,
                       std::move_only_function<void(SQLite::Database&)> job)
@@ -2,6 +2,9 @@
 
 #include "vendor/std.hpp"
 
+#include "core/executor_metrics/executor_metrics.hpp"
+#include "core/worker_pool/state.hpp"
+
 namespace core::database {
 
 struct DatabaseState {
@@ -15,6 +18,13 @@ struct DatabaseState {
   std::atomic<bool> is_running{false};
   std::atomic<bool> shutdown_requested{false};
   std::size_t thread_count = 0;
+
+  // 绑定了取消令牌的任务：出队时已取消而跳过的数量，执行中被 sqlite3_interrupt 的数量
+  std::atomic<std::uint64_t> cancelled_jobs{0};
+  std::atomic<std::uint64_t> interrupted_jobs{0};
+
+  // 按提交线程所在的线程池任务来源统计，池外线程计入 General
+  executor_metrics::ExecutorMetrics metrics{worker_pool::kTaskTagCount};
 };
 
 }  // namespace core::database
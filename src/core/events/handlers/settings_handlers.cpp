@@ -6,6 +6,7 @@
 #include "core/events/events.hpp"
 #include "core/http_server/http_server.hpp"
 #include "core/http_server/sse_manager.hpp"
+#include "core/http_server/websocket.hpp"
 #include "core/i18n/i18n.hpp"
 #include "core/rpc/notification_hub.hpp"
 #include "core/state/app_state.hpp"
@@ -181,9 +182,10 @@ auto handle_settings_changed(core::AppState& state,
     const bool new_lan_enabled = event.data.new_settings.app.lan_access.enabled;
 
     if (old_lan_enabled != new_lan_enabled) {
-      // 关闭 LAN 后立即踢出远端 SSE，避免连接继续接收旧会话的推送。
+      // 关闭 LAN 后立即踢出远端 SSE/WebSocket，避免连接继续接收旧会话的推送。
       if (!new_lan_enabled) {
         core::http_server::sse_manager::request_close_all_connections(state);
+        core::http_server::websocket::request_close_all_connections(state);
       }
 
       if (auto rebind_result = core::http_server::rebind_listen_socket(state, new_lan_enabled);
@@ -0,0 +1,108 @@
+#include "core/executor_metrics/executor_metrics.hpp"
+
+#include "vendor/std.hpp"
+
+#include "core/rpc/metrics.hpp"
+
+namespace core::executor_metrics {
+
+auto enqueue_time(const ExecutorMetrics& metrics) -> std::chrono::steady_clock::time_point {
+  if (!metrics.enabled.load(std::memory_order_relaxed)) {
+    return {};
+  }
+  return std::chrono::steady_clock::now();
+}
+
+auto begin_task(ExecutorMetrics& metrics, std::size_t source,
+                std::chrono::steady_clock::time_point enqueued_at)
+    -> std::chrono::steady_clock::time_point {
+  if (enqueued_at == std::chrono::steady_clock::time_point{}) {
+    return {};
+  }
+  metrics.running.fetch_add(1, std::memory_order_relaxed);
+  return rpc::metrics::record_since(metrics.sources[source].queue_wait, enqueued_at);
+}
+
+auto end_task(ExecutorMetrics& metrics, std::size_t source,
+              std::chrono::steady_clock::time_point enqueued_at,
+              std::chrono::steady_clock::time_point started_at) -> void {
+  if (enqueued_at == std::chrono::steady_clock::time_point{}) {
+    return;
+  }
+  auto& timings = metrics.sources[source];
+  const auto elapsed = std::chrono::steady_clock::now() - started_at;
+  rpc::metrics::record_latency(timings.run, elapsed);
+  timings.tasks.fetch_add(1, std::memory_order_relaxed);
+  metrics.busy_us.fetch_add(
+      static_cast<std::uint64_t>(
+          std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()),
+      std::memory_order_relaxed);
+  metrics.running.fetch_sub(1, std::memory_order_relaxed);
+}
+
+auto record_sample(ExecutorMetrics& metrics, std::uint64_t queue_depth, std::size_t workers,
+                   std::chrono::steady_clock::time_point now, std::int64_t timestamp_ms) -> void {
+  const auto busy_us = metrics.busy_us.load(std::memory_order_relaxed);
+  std::lock_guard lock(metrics.samples_mutex);
+  if (metrics.sampled_at == std::chrono::steady_clock::time_point{}) {
+    metrics.sampled_at = now;
+    metrics.sampled_busy_us = busy_us;
+    return;
+  }
+
+  const auto elapsed_us =
+      std::chrono::duration_cast<std::chrono::microseconds>(now - metrics.sampled_at).count();
+  const auto capacity_us = static_cast<double>(elapsed_us) * static_cast<double>(workers);
+  // 长任务在完成的那个周期一次性计入，可能超过 1，按满载截断
+  const auto utilization =
+      capacity_us > 0.0
+          ? std::min(1.0, static_cast<double>(busy_us - metrics.sampled_busy_us) / capacity_us)
+          : 0.0;
+
+  metrics.samples.push_back(UtilizationSample{
+      .timestamp_ms = timestamp_ms,
+      .utilization = utilization,
+      .queue_depth = queue_depth,
+      .running = static_cast<std::uint64_t>(
+          std::max<std::int64_t>(0, metrics.running.load(std::memory_order_relaxed)))});
+  if (metrics.samples.size() > kSampleCapacity) {
+    metrics.samples.pop_front();
+  }
+  metrics.sampled_at = now;
+  metrics.sampled_busy_us = busy_us;
+}
+
+auto set_enabled(ExecutorMetrics& metrics, bool enabled) -> void {
+  std::lock_guard lock(metrics.samples_mutex);
+  if (enabled && !metrics.enabled.load(std::memory_order_relaxed)) {
+    metrics.samples.clear();
+    metrics.sampled_at = {};
+  }
+  metrics.enabled.store(enabled, std::memory_order_relaxed);
+}
+
+auto snapshot(std::string executor, ExecutorMetrics& metrics, std::size_t workers,
+              const std::function<std::string(std::size_t)>& source_name)
+    -> ExecutorMetricsSnapshot {
+  ExecutorMetricsSnapshot result{.executor = std::move(executor),
+                                 .enabled = metrics.enabled.load(std::memory_order_relaxed),
+                                 .workers = workers};
+  for (std::size_t i = 0; i < metrics.sources.size(); ++i) {
+    const auto& timings = metrics.sources[i];
+    const auto tasks = timings.tasks.load(std::memory_order_relaxed);
+    if (tasks == 0) {
+      continue;
+    }
+    result.sources.push_back(
+        SourceSnapshot{.source = source_name(i),
+                       .tasks = tasks,
+                       .queue_wait = rpc::metrics::snapshot_latency(timings.queue_wait),
+                       .run = rpc::metrics::snapshot_latency(timings.run)});
+  }
+
+  std::lock_guard lock(metrics.samples_mutex);
+  result.samples.assign(metrics.samples.begin(), metrics.samples.end());
+  return result;
+}
+
+}  // namespace core::executor_metrics
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "vendor/std.hpp"
+
+#include "core/rpc/metrics.hpp"
+
+namespace core::executor_metrics {
+
+// 每秒采样一次，保留最近 5 分钟
+constexpr auto kSampleInterval = std::chrono::seconds(1);
+constexpr std::size_t kSampleCapacity = 300;
+
+// 单个提交来源的排队等待与执行耗时
+struct SourceTimings {
+  std::atomic<std::uint64_t> tasks{0};
+  rpc::metrics::LatencyHistogram queue_wait;
+  rpc::metrics::LatencyHistogram run;
+};
+
+// utilization 为采样周期内完成任务的执行时间占全部线程时间的比例，长任务在完成时才计入；
+// running 为采样瞬间正在执行的任务数，可以看出卡住的任务
+struct UtilizationSample {
+  std::int64_t timestamp_ms = 0;
+  double utilization = 0.0;
+  std::uint64_t queue_depth = 0;
+  std::uint64_t running = 0;
+};
+
+// 默认关闭；关闭时提交路径只多一次 relaxed 读取，执行路径只多一次时间点比较
+struct ExecutorMetrics {
+  std::atomic<bool> enabled{false};
+  // 下标由执行器自己定义，如线程池的 TaskTag
+  std::vector<SourceTimings> sources;
+  std::atomic<std::uint64_t> busy_us{0};
+  std::atomic<std::int64_t> running{0};
+
+  // 只由采样协程写入，快照时加锁读取
+  std::mutex samples_mutex;
+  std::deque<UtilizationSample> samples;
+  std::uint64_t sampled_busy_us = 0;
+  std::chrono::steady_clock::time_point sampled_at;
+
+  explicit ExecutorMetrics(std::size_t source_count) : sources(source_count) {}
+};
+
+struct SourceSnapshot {
+  std::string source;
+  std::uint64_t tasks = 0;
+  rpc::metrics::LatencySnapshot queue_wait;
+  rpc::metrics::LatencySnapshot run;
+};
+
+struct ExecutorMetricsSnapshot {
+  std::string executor;
+  bool enabled = false;
+  std::uint64_t workers = 0;
+  // 只包含有过任务的来源
+  std::vector<SourceSnapshot> sources;
+  // 按时间从旧到新
+  std::vector<UtilizationSample> samples;
+};
+
+// 入队时调用；关闭时返回空时间点，执行端据此跳过全部记录
+auto enqueue_time(const ExecutorMetrics& metrics) -> std::chrono::steady_clock::time_point;
+
+// 开始执行时调用，返回开始时间；enqueued_at 为空时不做任何事
+auto begin_task(ExecutorMetrics& metrics, std::size_t source,
+                std::chrono::steady_clock::time_point enqueued_at)
+    -> std::chrono::steady_clock::time_point;
+
+// 与 begin_task 成对调用
+auto end_task(ExecutorMetrics& metrics, std::size_t source,
+              std::chrono::steady_clock::time_point enqueued_at,
+              std::chrono::steady_clock::time_point started_at) -> void;
+
+// 第一次调用只建立基准，之后每次追加一个样本
+auto record_sample(ExecutorMetrics& metrics, std::uint64_t queue_depth, std::size_t workers,
+                   std::chrono::steady_clock::time_point now, std::int64_t timestamp_ms) -> void;
+
+// 开关切换；重新开启时清空旧样本，避免跨越关闭期间的样本失真
+auto set_enabled(ExecutorMetrics& metrics, bool enabled) -> void;
+
+auto snapshot(std::string executor, ExecutorMetrics& metrics, std::size_t workers,
+              const std::function<std::string(std::size_t)>& source_name)
+    -> ExecutorMetricsSnapshot;
+
+}  // namespace core::executor_metrics
@@ -4,9 +4,11 @@
 
 #include "vendor/windows/bcrypt.hpp"
 
+#include "core/build_config.hpp"
 #include "core/http_server/network_addresses.hpp"
 #include "core/http_server/sse_manager.hpp"
 #include "core/http_server/state.hpp"
+#include "core/http_server/websocket.hpp"
 #include "core/state/app_state.hpp"
 #include "features/settings/state.hpp"
 #include "utils/logger/logger.hpp"
@@ -114,6 +116,15 @@ auto trim_ascii(std::string_view value) -> std::string_view {
   return value;
 }
 
+// 判断 Origin 是否来自本机同端口页面。
+auto is_local_origin_allowed(std::string_view origin, int port) -> bool {
+  const auto localhost = std::format("http://localhost:{}", port);
+  const auto loopback_v4 = std::format("http://127.0.0.1:{}", port);
+  const auto loopback_v6 = std::format("http://[::1]:{}", port);
+
+  return origin == localhost || origin == loopback_v4 || origin == loopback_v6;
+}
+
 }  // namespace
 
 // 启动 HTTP 服务前准备本次运行使用的 LAN 访问令牌。
@@ -157,8 +168,9 @@ auto reset_token(core::AppState& state) -> std::expected<std::string, std::strin
     std::unique_lock lock(state.http_server->access_token_mutex);
     state.http_server->access_token = *generated;
   }
-  // 旧 Cookie 仍可能保持着 SSE 长连接；令牌轮换后立即撤销已有 HTTP 会话。
+  // 旧 Cookie 仍可能保持着 SSE/WebSocket 长连接；令牌轮换后立即撤销已有 HTTP 会话。
   core::http_server::sse_manager::request_close_all_connections(state);
+  core::http_server::websocket::request_close_all_connections(state);
   Logger().info("LAN access token was regenerated");
   return *generated;
 }
@@ -275,6 +287,25 @@ auto resolve_http_access(const core::AppState& state, std::string_view remote_ad
   return core::rpc::AccessLevel::lan;
 }
 
+// 按构建模式和当前 Host 判断请求来源是否允许继续处理。
+auto is_origin_allowed(std::string_view origin, int port, std::string_view host) -> bool {
+  if (origin.empty()) {
+    // 无 Origin 通常来自非浏览器本地请求。
+    return true;
+  }
+
+  // 开发模式放行所有 Origin，便于局域网/多设备联调。
+  if (core::build_config::is_debug_build()) {
+    return true;
+  }
+
+  // 发布模式允许本机同端口来源，以及经过鉴权后从当前 HTTP Host 加载的同源页面。
+  if (is_local_origin_allowed(origin, port)) {
+    return true;
+  }
+  return origin == std::format("http://{}", host);
+}
+
 // 生成带 HttpOnly、严格 SameSite 和有限生命周期的会话 Cookie。
 auto make_cookie(std::string_view token) -> std::string {
   return std::format("{}={}; HttpOnly; SameSite=Strict; Path=/; Max-Age=2592000", kCookieName,
@@ -40,6 +40,8 @@ auto is_token_valid(const core::AppState& state, std::string_view token) -> bool
 // 根据来源地址、服务状态和 Cookie 判定 HTTP 请求的访问等级。
 auto resolve_http_access(const core::AppState& state, std::string_view remote_address,
                          std::string_view cookie_header) -> std::optional<core::rpc::AccessLevel>;
+// 校验浏览器 Origin：RPC、SSE 与 WebSocket 升级共用，阻止其他站点借用已登录 Cookie。
+auto is_origin_allowed(std::string_view origin, int port, std::string_view host) -> bool;
 // 构造只允许脚本携带的 LAN 会话 Cookie。
 auto make_cookie(std::string_view token) -> std::string;
 
@@ -0,0 +1,97 @@
+#include "core/http_server/compression.hpp"
+
+#include "vendor/std.hpp"
+
+#include "utils/compression/compression.hpp"
+
+namespace core::http_server::compression {
+
+using utils::compression::Encoding;
+
+auto trim_token(std::string_view value) -> std::string_view {
+  while (!value.empty() && (value.front() == ' ' || value.front() == '\t')) {
+    value.remove_prefix(1);
+  }
+  while (!value.empty() && (value.back() == ' ' || value.back() == '\t')) {
+    value.remove_suffix(1);
+  }
+  return value;
+}
+
+auto equals_ignore_case(std::string_view left, std::string_view right) -> bool {
+  return std::ranges::equal(left, right, [](char a, char b) {
+    return std::tolower(static_cast<unsigned char>(a)) ==
+           std::tolower(static_cast<unsigned char>(b));
+  });
+}
+
+// 返回 Accept-Encoding 中某个编码的 q 值；未列出时返回空，由通配符决定
+auto find_quality(std::string_view accept_encoding, std::string_view coding)
+    -> std::optional<double> {
+  auto remaining = accept_encoding;
+  while (!remaining.empty()) {
+    const auto comma_pos = remaining.find(',');
+    auto item = trim_token(remaining.substr(0, comma_pos));
+    remaining = comma_pos == std::string_view::npos ? std::string_view{}
+                                                    : remaining.substr(comma_pos + 1);
+
+    const auto semicolon_pos = item.find(';');
+    if (!equals_ignore_case(trim_token(item.substr(0, semicolon_pos)), coding)) {
+      continue;
+    }
+    if (semicolon_pos == std::string_view::npos) {
+      return 1.0;
+    }
+
+    auto parameter = trim_token(item.substr(semicolon_pos + 1));
+    if (parameter.size() < 2 || (parameter[0] != 'q' && parameter[0] != 'Q') ||
+        parameter[1] != '=') {
+      return 1.0;
+    }
+    parameter.remove_prefix(2);
+    double quality = 0.0;
+    auto [end, error] =
+        std::from_chars(parameter.data(), parameter.data() + parameter.size(), quality);
+    // 无法解析的 q 值按拒绝处理，宁可不压缩也不要发出客户端无法解码的内容
+    return error == std::errc{} ? quality : 0.0;
+  }
+  return std::nullopt;
+}
+
+auto resolve_quality(std::string_view accept_encoding, Encoding encoding) -> double {
+  if (auto quality = find_quality(accept_encoding, encoding_token(encoding))) {
+    return *quality;
+  }
+  return find_quality(accept_encoding, "*").value_or(0.0);
+}
+
+auto negotiate_encoding(std::string_view accept_encoding) -> std::optional<Encoding> {
+  const auto gzip_quality = resolve_quality(accept_encoding, Encoding::Gzip);
+  const auto deflate_quality = resolve_quality(accept_encoding, Encoding::Deflate);
+  if (gzip_quality <= 0.0 && deflate_quality <= 0.0) {
+    return std::nullopt;
+  }
+  return gzip_quality >= deflate_quality ? Encoding::Gzip : Encoding::Deflate;
+}
+
+auto accepts_encoding(std::string_view accept_encoding, Encoding encoding) -> bool {
+  return resolve_quality(accept_encoding, encoding) > 0.0;
+}
+
+auto is_compressible_mime(std::string_view mime_type) -> bool {
+  const auto essence = trim_token(mime_type.substr(0, mime_type.find(';')));
+  if (essence.starts_with("text/")) {
+    return true;
+  }
+
+  static constexpr std::array<std::string_view, 6> kCompressibleTypes{
+      "application/javascript", "application/json", "application/xml", "application/wasm",
+      "image/svg+xml", "image/x-icon"};
+  return std::ranges::find(kCompressibleTypes, essence) != kCompressibleTypes.end();
+}
+
+auto encoding_token(Encoding encoding) -> std::string_view {
+  return encoding == Encoding::Gzip ? "gzip" : "deflate";
+}
+
+}  // namespace core::http_server::compression
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "vendor/std.hpp"
+
+#include "utils/compression/compression.hpp"
+
+namespace core::http_server::compression {
+
+// 小于该大小的响应压缩收益抵不过头部和 CPU 开销
+constexpr size_t kMinCompressSize = 1024;
+
+// 静态资源只压缩一次并随热缓存复用，使用最高压缩率
+constexpr int kStaticCompressionLevel = 9;
+
+// RPC 等动态响应每次都要压缩，级别偏向速度
+constexpr int kDynamicCompressionLevel = 4;
+
+// 按 Accept-Encoding 的 q 值选择 gzip 或 deflate；同权重时优先 gzip，都不接受时返回空
+auto negotiate_encoding(std::string_view accept_encoding)
+    -> std::optional<utils::compression::Encoding>;
+
+// 客户端是否接受指定编码（q > 0，含通配符 *）
+auto accepts_encoding(std::string_view accept_encoding, utils::compression::Encoding encoding)
+    -> bool;
+
+// 文本类 MIME 才值得压缩；图片、视频、字体等已压缩格式原样发送
+auto is_compressible_mime(std::string_view mime_type) -> bool;
+
+// Content-Encoding 头中使用的编码名
+auto encoding_token(utils::compression::Encoding encoding) -> std::string_view;
+
+}  // namespace core::http_server::compression
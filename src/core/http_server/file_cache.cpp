@@ -0,0 +1,107 @@
+#include "core/http_server/file_cache.hpp"
+
+#include "vendor/std.hpp"
+
+namespace core::http_server::file_cache {
+
+auto entry_bytes(const CachedFile& file) -> size_t {
+  return file.data->size() + (file.gzip_data ? file.gzip_data->size() : 0);
+}
+
+// 调用方持有 cache.mutex
+auto erase_slot(StaticFileCache& cache,
+                std::unordered_map<CacheKey, CacheSlot>::iterator slot_it) -> void {
+  cache.cached_bytes -= entry_bytes(*slot_it->second.file);
+  cache.lru.erase(slot_it->second.lru_position);
+  cache.slots.erase(slot_it);
+}
+
+// 调用方持有 cache.mutex
+auto touch_slot(StaticFileCache& cache, CacheSlot& slot) -> void {
+  cache.lru.splice(cache.lru.begin(), cache.lru, slot.lru_position);
+}
+
+auto find_immutable(StaticFileCache& cache, const std::filesystem::path& path)
+    -> std::shared_ptr<const CachedFile> {
+  std::lock_guard lock(cache.mutex);
+  auto slot_it = cache.slots.find(path.native());
+  if (slot_it == cache.slots.end() || !slot_it->second.file->immutable) {
+    return nullptr;
+  }
+
+  touch_slot(cache, slot_it->second);
+  cache.hit_count.fetch_add(1, std::memory_order_relaxed);
+  return slot_it->second.file;
+}
+
+auto find_valid(StaticFileCache& cache, const std::filesystem::path& path, size_t size,
+                std::int64_t modified_seconds) -> std::shared_ptr<const CachedFile> {
+  std::lock_guard lock(cache.mutex);
+  auto slot_it = cache.slots.find(path.native());
+  if (slot_it == cache.slots.end()) {
+    cache.miss_count.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+  }
+
+  const auto& file = slot_it->second.file;
+  if (file->data->size() != size || file->modified_seconds != modified_seconds) {
+    // 文件已被替换，丢弃旧内容，由本次请求重新读取后写回
+    erase_slot(cache, slot_it);
+    cache.miss_count.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+  }
+
+  touch_slot(cache, slot_it->second);
+  cache.hit_count.fetch_add(1, std::memory_order_relaxed);
+  return slot_it->second.file;
+}
+
+auto store(StaticFileCache& cache, const std::filesystem::path& path, CachedFile file) -> void {
+  if (!file.data) {
+    return;
+  }
+
+  const auto stored_bytes = entry_bytes(file);
+  std::lock_guard lock(cache.mutex);
+  if (stored_bytes > cache.budget_bytes) {
+    return;
+  }
+
+  if (auto slot_it = cache.slots.find(path.native()); slot_it != cache.slots.end()) {
+    erase_slot(cache, slot_it);
+  }
+
+  while (!cache.lru.empty() && cache.cached_bytes + stored_bytes > cache.budget_bytes) {
+    erase_slot(cache, cache.slots.find(cache.lru.back()));
+  }
+
+  cache.lru.push_front(path.native());
+  cache.slots.emplace(path.native(),
+                      CacheSlot{.file = std::make_shared<const CachedFile>(std::move(file)),
+                                .lru_position = cache.lru.begin()});
+  cache.cached_bytes += stored_bytes;
+}
+
+auto record_bytes_saved(StaticFileCache& cache, size_t bytes) -> void {
+  cache.bytes_saved.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+auto get_stats(StaticFileCache& cache) -> StaticFileCacheStats {
+  StaticFileCacheStats stats{
+      .hit_count = cache.hit_count.load(std::memory_order_relaxed),
+      .miss_count = cache.miss_count.load(std::memory_order_relaxed),
+      .bytes_saved = cache.bytes_saved.load(std::memory_order_relaxed),
+  };
+
+  const auto lookups = stats.hit_count + stats.miss_count;
+  stats.hit_ratio =
+      lookups > 0 ? static_cast<double>(stats.hit_count) / static_cast<double>(lookups) : 0.0;
+
+  std::lock_guard lock(cache.mutex);
+  stats.entry_count = cache.slots.size();
+  stats.cached_bytes = cache.cached_bytes;
+  stats.budget_bytes = cache.budget_bytes;
+  return stats;
+}
+
+}  // namespace core::http_server::file_cache
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "vendor/std.hpp"
+
+namespace core::http_server::file_cache {
+
+// 默认缓存预算：足以容纳构建后的 web 资源和一屏缩略图
+constexpr size_t kDefaultBudgetBytes = 32 * 1024 * 1024;
+
+// 单个缓存文件；内容只读共享，命中时可直接交给 uWS 发送
+struct CachedFile {
+  std::shared_ptr<const std::string> data;
+  // 文本资源的 gzip 预压缩版本，随条目一起计入预算；不可压缩的文件为空
+  std::shared_ptr<const std::string> gzip_data;
+  std::int64_t modified_seconds = 0;
+  // 带内容哈希的构建产物，命中后不再查询文件属性
+  bool immutable = false;
+};
+
+// 以原生路径字符串为键，避免每次查找都做编码转换
+using CacheKey = std::filesystem::path::string_type;
+
+struct CacheSlot {
+  std::shared_ptr<const CachedFile> file;
+  std::list<CacheKey>::iterator lru_position;
+};
+
+// 按路径缓存静态小文件内容，以 (size, mtime) 校验；超出预算时淘汰最久未使用的条目
+struct StaticFileCache {
+  size_t budget_bytes = kDefaultBudgetBytes;
+
+  std::mutex mutex;
+  std::list<CacheKey> lru;  // 最近使用的在前
+  std::unordered_map<CacheKey, CacheSlot> slots;
+  size_t cached_bytes = 0;
+
+  std::atomic<std::uint64_t> hit_count{0};
+  std::atomic<std::uint64_t> miss_count{0};
+  std::atomic<std::uint64_t> bytes_saved{0};
+};
+
+struct StaticFileCacheStats {
+  std::uint64_t hit_count = 0;
+  std::uint64_t miss_count = 0;
+  double hit_ratio = 0.0;
+  std::uint64_t bytes_saved = 0;
+  std::uint64_t entry_count = 0;
+  std::uint64_t cached_bytes = 0;
+  std::uint64_t budget_bytes = 0;
+};
+
+// 查找不可变资源；未命中不计入统计，调用方随后会按文件属性再查一次
+auto find_immutable(StaticFileCache& cache, const std::filesystem::path& path)
+    -> std::shared_ptr<const CachedFile>;
+
+// 查找并以文件当前的大小和修改时间校验；过期条目会被移除
+auto find_valid(StaticFileCache& cache, const std::filesystem::path& path, size_t size,
+                std::int64_t modified_seconds) -> std::shared_ptr<const CachedFile>;
+
+// 写入或替换缓存条目；超过整个预算的文件不缓存
+auto store(StaticFileCache& cache, const std::filesystem::path& path, CachedFile file) -> void;
+
+// 记录一次由缓存直接提供的响应体字节数
+auto record_bytes_saved(StaticFileCache& cache, size_t bytes) -> void;
+
+auto get_stats(StaticFileCache& cache) -> StaticFileCacheStats;
+
+}  // namespace core::http_server::file_cache
@@ -9,6 +9,7 @@
 #include "core/http_server/routes.hpp"
 #include "core/http_server/sse_manager.hpp"
 #include "core/http_server/state.hpp"
+#include "core/http_server/websocket.hpp"
 #include "core/state/app_state.hpp"
 #include "features/settings/state.hpp"
 #include "utils/logger/logger.hpp"
@@ -235,7 +236,7 @@ auto initialize(core::AppState& state) -> std::expected<void, std::string> {
   }
 }
 
-// 停止接受请求、关闭 SSE 和监听 socket，并等待 HTTP 线程退出。
+// 停止接受请求、关闭 SSE/WebSocket 和监听 socket，并等待 HTTP 线程退出。
 auto shutdown(core::AppState& state) -> void {
   if (!state.http_server || !state.http_server->is_running) {
     return;
@@ -254,9 +255,10 @@ auto shutdown(core::AppState& state) -> void {
 
   // 使用 defer 将关闭操作调度到事件循环线程
   if (loop) {
-    Logger().info("Scheduling SSE close and socket close");
+    Logger().info("Scheduling SSE/WebSocket close and socket close");
     loop->defer([&state, listen_socket]() {
       core::http_server::sse_manager::close_all_connections(state);
+      core::http_server::websocket::close_all_connections(state);
 
       if (listen_socket) {
         us_listen_socket_close(0, listen_socket);
@@ -278,6 +280,9 @@ auto shutdown(core::AppState& state) -> void {
 
   auto remaining_sse = core::http_server::sse_manager::get_connection_count(state);
   Logger().info("Remaining SSE connections after shutdown: {}", remaining_sse);
+  const auto sse_stats = core::http_server::sse_manager::get_queue_stats(state);
+  Logger().info("SSE queue stats: coalesced={}, dropped={}, lagging_disconnects={}",
+                sse_stats.coalesced, sse_stats.dropped, sse_stats.lagging_disconnects);
   Logger().info("HTTP server shut down");
 }
 
@@ -6,49 +6,28 @@
 #include "vendor/uwebsockets.hpp"
 
 #include "core/async/async.hpp"
-#include "core/build_config.hpp"
 #include "core/http_server/access.hpp"
+#include "core/http_server/compression.hpp"
 #include "core/http_server/downloads.hpp"
 #include "core/http_server/sse_manager.hpp"
 #include "core/http_server/state.hpp"
 #include "core/http_server/static.hpp"
+#include "core/http_server/thumbnail_batch.hpp"
+#include "core/http_server/websocket.hpp"
+#include "core/rpc/columnar.hpp"
 #include "core/rpc/rpc.hpp"
 #include "core/state/app_state.hpp"
+#include "utils/compression/compression.hpp"
 #include "utils/logger/logger.hpp"
 
 namespace core::http_server::routes {
 
+// RPC 会话头上限，随机 UUID 远小于此值；超长时按未提供处理
+constexpr std::size_t kMaxRpcSessionLength = 128;
+
 // 从 uWebSockets 请求对象读取 Origin，供 CORS 和同源校验复用。
 auto get_origin_header(auto* req) -> std::string { return std::string(req->getHeader("origin")); }
 
-// 判断 Origin 是否来自本机同端口页面。
-auto is_local_origin_allowed(std::string_view origin, int port) -> bool {
-  const auto localhost = std::format("http://localhost:{}", port);
-  const auto loopback_v4 = std::format("http://127.0.0.1:{}", port);
-  const auto loopback_v6 = std::format("http://[::1]:{}", port);
-
-  return origin == localhost || origin == loopback_v4 || origin == loopback_v6;
-}
-
-// 按构建模式和当前 Host 判断请求来源是否允许继续处理。
-auto is_origin_allowed(std::string_view origin, int port, std::string_view host) -> bool {
-  if (origin.empty()) {
-    // 无 Origin 通常来自非浏览器本地请求。
-    return true;
-  }
-
-  // 开发模式放行所有 Origin，便于局域网/多设备联调。
-  if (core::build_config::is_debug_build()) {
-    return true;
-  }
-
-  // 发布模式允许本机同端口来源，以及经过鉴权后从当前 HTTP Host 加载的同源页面。
-  if (is_local_origin_allowed(origin, port)) {
-    return true;
-  }
-  return origin == std::format("http://{}", host);
-}
-
 // 为允许的跨域请求写出统一的预检和响应头。
 auto write_cors_headers(auto* res, std::string_view origin) -> void {
   if (!origin.empty()) {
@@ -56,7 +35,7 @@ auto write_cors_headers(auto* res, std::string_view origin) -> void {
     res->writeHeader("Vary", "Origin");
   }
   res->writeHeader("Access-Control-Allow-Methods", "GET, POST, OPTIONS");
-  res->writeHeader("Access-Control-Allow-Headers", "Content-Type");
+  res->writeHeader("Access-Control-Allow-Headers", "Content-Type, X-Rpc-Session");
 }
 
 // 返回来源不被允许的 HTTP 403 响应。
@@ -109,7 +88,26 @@ auto handle_token_exchange(core::AppState& state, auto* res, auto* req) -> void
   res->end();
 }
 
-// 注册令牌交换、RPC、SSE、CORS 和静态资源路由。
+// 按协商结果原地压缩 RPC 响应，返回实际使用的编码；小响应或压缩失败时保持原样。
+auto compress_rpc_response(std::string& response_json,
+                           std::optional<utils::compression::Encoding> encoding)
+    -> std::optional<utils::compression::Encoding> {
+  if (!encoding || response_json.size() < compression::kMinCompressSize) {
+    return std::nullopt;
+  }
+
+  auto compressed =
+      utils::compression::compress(response_json, *encoding, compression::kDynamicCompressionLevel);
+  if (!compressed) {
+    Logger().warn("Failed to compress RPC response: {}", compressed.error());
+    return std::nullopt;
+  }
+
+  response_json = std::move(compressed.value());
+  return encoding;
+}
+
+// 注册令牌交换、RPC、SSE、WebSocket、CORS 和静态资源路由。
 auto register_routes(core::AppState& state, uWS::App& app) -> void {
   // 检查状态是否已初始化
   if (!state.http_server) {
@@ -132,44 +130,89 @@ auto register_routes(core::AppState& state, uWS::App& app) -> void {
     // 身份通过后再校验 Origin，阻止其他站点借用已登录 Cookie。
     auto origin = get_origin_header(req);
     const auto host = std::string(req->getHeader("host"));
-    if (!is_origin_allowed(origin, state.http_server->port, host)) {
+    if (!core::http_server::access::is_origin_allowed(origin, state.http_server->port, host)) {
       Logger().warn("Rejected RPC request due to disallowed origin: {}",
                     origin.empty() ? "<empty>" : origin);
       reject_forbidden(res);
       return;
     }
 
+    // 请求对象只在本回调内有效，先取出协商结果供异步响应使用
+    auto response_encoding =
+        compression::negotiate_encoding(req->getHeader("accept-encoding"));
+    const bool accepts_columnar =
+        req->getHeader("accept").find(core::rpc::columnar::kMimeType) != std::string_view::npos;
+    // HTTP 请求之间没有连接身份，客户端用随机会话头声明哪些请求属于自己；
+    // 不带会话头的请求不能取消，也不会被取消
+    auto caller = core::rpc::Caller{.access = *caller_access};
+    if (const auto session = req->getHeader("x-rpc-session");
+        !session.empty() && session.size() <= kMaxRpcSessionLength) {
+      caller.session = "http:" + std::string(session);
+    }
+
     std::string buffer;
-    res->onData([&state, caller_access = *caller_access, buffer = std::move(buffer),
-                 origin = std::move(origin), res](std::string_view data, bool last) mutable {
+    res->onData([&state, caller = std::move(caller), buffer = std::move(buffer),
+                 origin = std::move(origin), response_encoding, accepts_columnar,
+                 res](std::string_view data, bool last) mutable {
       buffer.append(data.data(), data.size());
 
       if (last) {
         // 收齐请求体后才进入异步 RPC 流程，避免分片数据被提前解析。
         // 使用 cork 包裹整个异步操作，延长 res 的生命周期
         res->cork(
-            [&state, caller_access, buffer = std::move(buffer), origin = std::move(origin), res]() {
+            [&state, caller = std::move(caller), buffer = std::move(buffer),
+             origin = std::move(origin), response_encoding, accepts_columnar, res]() {
               // 获取事件循环
               auto* loop = uWS::Loop::get();
 
               // 在异步运行时中处理rpc请求
               asio::co_spawn(
                   *core::async::get_io_context(state),
-                  [&state, caller_access, buffer = std::move(buffer), origin = std::move(origin),
-                   res, loop]() -> asio::awaitable<void> {
+                  [&state, caller = std::move(caller), buffer = std::move(buffer),
+                   origin = std::move(origin), response_encoding, accepts_columnar, res,
+                   loop]() -> asio::awaitable<void> {
                     try {
                       // 处理rpc请求
                       // 将 HTTP 层确认的访问等级贯穿到每个 RPC 方法。
-                      auto response_json =
-                          co_await core::rpc::process_request(state, buffer, caller_access);
+                      core::rpc::RpcResponseBody response;
+                      if (accepts_columnar) {
+                        response =
+                            co_await core::rpc::process_columnar_request(state, buffer, caller);
+                      } else {
+                        response.body = co_await core::rpc::process_request(state, buffer, caller);
+                      }
+
+                      // 通知没有响应体，按 JSON-RPC over HTTP 的约定回 204
+                      if (response.body.empty()) {
+                        loop->defer([res, origin]() {
+                          res->writeStatus("204 No Content");
+                          write_cors_headers(res, origin);
+                          res->end();
+                        });
+                        co_return;
+                      }
+
+                      // 大响应在 IO 线程按动态压缩级别压缩，uWS 线程只负责发送
+                      auto content_encoding =
+                          compress_rpc_response(response.body, response_encoding);
+
+                      // 列式结果与 JSON 错误共用一个连接，客户端按 Content-Type 区分
+                      const std::string_view content_type =
+                          response.columnar ? core::rpc::columnar::kMimeType : "application/json";
 
                       // 在事件循环线程中发送响应
-                      loop->defer([res, origin, response_json = std::move(response_json)]() {
+                      loop->defer([res, origin, response = std::move(response), content_type,
+                                   content_encoding]() {
                         // 先确定状态，再写 CORS 和内容头。
                         res->writeStatus("200 OK");
                         write_cors_headers(res, origin);
-                        res->writeHeader("Content-Type", "application/json");
-                        res->end(response_json);
+                        res->writeHeader("Content-Type", content_type);
+                        res->writeHeader("Vary", "Accept, Accept-Encoding");
+                        if (content_encoding) {
+                          res->writeHeader("Content-Encoding",
+                                           compression::encoding_token(*content_encoding));
+                        }
+                        res->end(response.body);
                       });
                     } catch (const std::exception& e) {
                       Logger().error("Error processing RPC request: {}", e.what());
@@ -211,7 +254,7 @@ auto register_routes(core::AppState& state, uWS::App& app) -> void {
 
     auto origin = get_origin_header(req);
     const auto host = std::string(req->getHeader("host"));
-    if (!is_origin_allowed(origin, state.http_server->port, host)) {
+    if (!core::http_server::access::is_origin_allowed(origin, state.http_server->port, host)) {
       Logger().warn("Rejected SSE request due to disallowed origin: {}",
                     origin.empty() ? "<empty>" : origin);
       reject_forbidden(res);
@@ -222,6 +265,9 @@ auto register_routes(core::AppState& state, uWS::App& app) -> void {
     core::http_server::sse_manager::add_connection(state, res, std::move(origin));
   });
 
+  // WebSocket 在一条连接上承载 RPC 与通知，认证和 Origin 校验在升级阶段完成
+  core::http_server::websocket::register_routes(state, app);
+
   // 配置CORS
   app.options("/*", [&state](auto* res, auto* req) {
     // 预检请求也必须先认证，不能成为绕过访问边界的入口。
@@ -233,7 +279,7 @@ auto register_routes(core::AppState& state, uWS::App& app) -> void {
 
     auto origin = get_origin_header(req);
     const auto host = std::string(req->getHeader("host"));
-    if (!is_origin_allowed(origin, state.http_server->port, host)) {
+    if (!core::http_server::access::is_origin_allowed(origin, state.http_server->port, host)) {
       reject_forbidden(res);
       return;
     }
@@ -245,6 +291,7 @@ auto register_routes(core::AppState& state, uWS::App& app) -> void {
 
   // 下载路由必须在静态 fallback 前注册，避免临时归档被当作前端资源处理。
   core::http_server::downloads::register_routes(state, app);
+  core::http_server::thumbnail_batch::register_routes(state, app);
 
   // 静态文件服务（fallback路由）
   core::http_server::static_content::register_routes(state, app);
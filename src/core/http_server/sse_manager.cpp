@@ -4,6 +4,7 @@
 
 #include "vendor/uwebsockets.hpp"
 
+#include "core/http_server/sse_queue.hpp"
 #include "core/http_server/state.hpp"
 #include "core/http_server/types.hpp"
 #include "core/state/app_state.hpp"
@@ -15,6 +16,52 @@ auto format_sse_message(const std::string& event_data) -> std::string {
   return std::format("data: {}\n\n", event_data);
 }
 
+// 未处于背压时按序写出积压事件；写出返回背压时保留剩余事件，等待 onWritable
+auto write_pending(SseConnection& connection) -> void {
+  while (!connection.is_closed && connection.response) {
+    auto message = sse_queue::pop_writable(connection.queue);
+    if (!message) {
+      return;
+    }
+    sse_queue::record_write(connection.queue, connection.response->write(*message),
+                            std::chrono::steady_clock::now());
+  }
+}
+
+// onWritable 回调：socket 已排空一部分，解除背压后继续写出
+auto flush_pending(SseConnection& connection) -> bool {
+  sse_queue::resume(connection.queue);
+  write_pending(connection);
+  return !connection.queue.write_blocked;
+}
+
+// 事件先入队再写出；背压期间按 key 合并、超出上限淘汰无 key 事件，超出延迟预算断开连接
+auto enqueue_event(core::AppState& state, SseConnection& connection,
+                   const std::string& coalesce_key, const std::string& message) -> void {
+  auto& counters = state.http_server->sse_queue_counters;
+
+  switch (sse_queue::enqueue(connection.queue, SSE_QUEUE_LIMITS, coalesce_key, message,
+                             std::chrono::steady_clock::now())) {
+    case sse_queue::EnqueueResult::Queued:
+      break;
+    case sse_queue::EnqueueResult::Coalesced:
+      counters.coalesced.fetch_add(1, std::memory_order_relaxed);
+      break;
+    case sse_queue::EnqueueResult::Dropped:
+      counters.dropped.fetch_add(1, std::memory_order_relaxed);
+      break;
+    case sse_queue::EnqueueResult::Lagging:
+      counters.lagging_disconnects.fetch_add(1, std::memory_order_relaxed);
+      Logger().warn("Disconnecting lagging SSE client {} ({} events pending)",
+                    connection.client_id, connection.queue.events.size());
+      // close 会同步触发 onAborted，由 remove_connection 标记关闭并移出列表
+      connection.response->close();
+      return;
+  }
+
+  write_pending(connection);
+}
+
 auto add_connection(core::AppState& state, uWS::HttpResponse<false>* response,
                     std::string allowed_origin) -> void {
   if (!state.http_server || !response) {
@@ -33,6 +80,7 @@ auto add_connection(core::AppState& state, uWS::HttpResponse<false>* response,
 
   response->onAborted(
       [&state, client_id = connection->client_id]() { remove_connection(state, client_id); });
+  response->onWritable([connection](std::uintmax_t) { return flush_pending(*connection); });
 
   response->writeStatus("200 OK");
   response->writeHeader("Content-Type", "text/event-stream");
@@ -70,6 +118,7 @@ auto remove_connection(core::AppState& state, const std::string& client_id) -> v
                            [&client_id](const std::shared_ptr<SseConnection>& conn) {
                              if (conn && conn->client_id == client_id) {
                                conn->is_closed = true;
+                               conn->queue.events.clear();
                                return true;
                              }
                              return false;
@@ -126,7 +175,8 @@ auto request_close_all_connections(core::AppState& state) -> void {
   state.http_server->loop->defer([&state]() { close_all_connections(state); });
 }
 
-auto broadcast_event(core::AppState& state, const std::string& event_data) -> void {
+auto broadcast_event(core::AppState& state, const std::string& event_data,
+                     std::string coalesce_key) -> void {
   if (!state.http_server || !state.http_server->is_running) {
     return;
   }
@@ -138,7 +188,8 @@ auto broadcast_event(core::AppState& state, const std::string& event_data) -> vo
 
   auto sse_message = format_sse_message(event_data);
 
-  loop->defer([&state, sse_message = std::move(sse_message)]() {
+  loop->defer([&state, sse_message = std::move(sse_message),
+               coalesce_key = std::move(coalesce_key)]() {
     if (!state.http_server) {
       return;
     }
@@ -165,10 +216,7 @@ auto broadcast_event(core::AppState& state, const std::string& event_data) -> vo
       if (!conn || !conn->response || conn->is_closed) {
         continue;
       }
-      const auto ok = conn->response->write(sse_message);
-      if (!ok) {
-        Logger().warn("SSE write reported backpressure for client {}", conn->client_id);
-      }
+      enqueue_event(state, *conn, coalesce_key, sse_message);
     }
   });
 }
@@ -184,4 +232,16 @@ auto get_connection_count(const core::AppState& state) -> size_t {
   std::lock_guard<std::mutex> lock(mtx);
   return connections.size();
 }
+
+auto get_queue_stats(const core::AppState& state) -> SseQueueStats {
+  if (!state.http_server) {
+    return {};
+  }
+
+  const auto& counters = state.http_server->sse_queue_counters;
+  return SseQueueStats{
+      .coalesced = counters.coalesced.load(std::memory_order_relaxed),
+      .dropped = counters.dropped.load(std::memory_order_relaxed),
+      .lagging_disconnects = counters.lagging_disconnects.load(std::memory_order_relaxed)};
+}
 }  // namespace core::http_server::sse_manager
@@ -4,6 +4,7 @@
 
 #include "vendor/uwebsockets.hpp"
 
+#include "core/http_server/types.hpp"
 #include "core/state/app_state.hpp"
 
 namespace core::http_server::sse_manager {
@@ -21,8 +22,13 @@ auto close_all_connections(core::AppState& state) -> void;
 auto request_close_all_connections(core::AppState& state) -> void;
 
 // 广播事件到所有 SSE 客户端（线程安全，内部会切换到 HTTP loop 线程）
-auto broadcast_event(core::AppState& state, const std::string& event_data) -> void;
+// 客户端背压时事件进入连接队列，coalesce_key 非空时队列中同 key 的旧事件被替换
+auto broadcast_event(core::AppState& state, const std::string& event_data,
+                     std::string coalesce_key = "") -> void;
 
 // 获取 SSE 连接数量
 auto get_connection_count(const core::AppState& state) -> size_t;
+
+// 获取累计的合并、丢弃和慢消费者断开次数
+auto get_queue_stats(const core::AppState& state) -> SseQueueStats;
 }  // namespace core::http_server::sse_manager
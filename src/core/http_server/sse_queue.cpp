@@ -0,0 +1,58 @@
+#include "core/http_server/sse_queue.hpp"
+
+#include "vendor/std.hpp"
+
+namespace core::http_server::sse_queue {
+
+auto enqueue(EventQueue& queue, const EventQueueLimits& limits, std::string_view coalesce_key,
+             std::string message, std::chrono::steady_clock::time_point now) -> EnqueueResult {
+  if (queue.write_blocked && now - queue.blocked_since > limits.lag_budget) {
+    return EnqueueResult::Lagging;
+  }
+
+  if (!coalesce_key.empty()) {
+    auto it = std::ranges::find(queue.events, coalesce_key, &PendingEvent::coalesce_key);
+    if (it != queue.events.end()) {
+      it->message = std::move(message);
+      return EnqueueResult::Coalesced;
+    }
+  }
+
+  queue.events.push_back(
+      PendingEvent{.coalesce_key = std::string(coalesce_key), .message = std::move(message)});
+  if (queue.events.size() <= limits.max_pending_events) {
+    return EnqueueResult::Queued;
+  }
+
+  auto evictable = std::ranges::find_if(
+      queue.events, [](const PendingEvent& event) { return event.coalesce_key.empty(); });
+  if (evictable == queue.events.end()) {
+    return EnqueueResult::Queued;
+  }
+  queue.events.erase(evictable);
+  return EnqueueResult::Dropped;
+}
+
+auto pop_writable(EventQueue& queue) -> std::optional<std::string> {
+  if (queue.write_blocked || queue.events.empty()) {
+    return std::nullopt;
+  }
+
+  auto event = std::move(queue.events.front());
+  queue.events.pop_front();
+  return std::move(event.message);
+}
+
+auto record_write(EventQueue& queue, bool accepted, std::chrono::steady_clock::time_point now)
+    -> void {
+  if (!accepted) {
+    queue.write_blocked = true;
+    queue.blocked_since = now;
+  }
+}
+
+auto resume(EventQueue& queue) -> void {
+  queue.write_blocked = false;
+}
+
+}  // namespace core::http_server::sse_queue
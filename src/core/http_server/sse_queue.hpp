@@ -0,0 +1,55 @@
+#pragma once
+
+#include "vendor/std.hpp"
+
+namespace core::http_server::sse_queue {
+
+// 等待写出的 SSE 事件；coalesce_key 相同的事件只保留最新一条
+struct PendingEvent {
+  std::string coalesce_key;
+  std::string message;
+};
+
+struct EventQueueLimits {
+  // 积压事件条数上限，超出时淘汰最旧的无 key 事件
+  std::size_t max_pending_events = 0;
+  // 持续背压且没有任何写出进展超过此时长即视为慢消费者
+  std::chrono::steady_clock::duration lag_budget{};
+};
+
+// 单个连接的事件队列，只在 HTTP loop 线程读写
+struct EventQueue {
+  std::deque<PendingEvent> events;
+  // 写出返回背压后置位，直到 resume 后把积压全部写出
+  bool write_blocked = false;
+  // 最近一次写出进展的时间，只在 write_blocked 时有意义
+  std::chrono::steady_clock::time_point blocked_since;
+};
+
+enum class EnqueueResult {
+  Queued,
+  // 替换了队列中同 key 的旧事件
+  Coalesced,
+  // 入队后超出上限，淘汰了一条无 key 事件
+  Dropped,
+  // 背压超出延迟预算，事件未入队，调用方应断开连接
+  Lagging,
+};
+
+// 带 key 的事件只会被同 key 的新事件合并，从不被淘汰：任务的最后一条 task.updated
+// 总能送达。无 key 事件可由后续全量刷新补偿，超出上限时从最旧的开始淘汰；
+// 全部积压都带 key 时允许暂时超出上限，由延迟预算兜底。
+auto enqueue(EventQueue& queue, const EventQueueLimits& limits, std::string_view coalesce_key,
+             std::string message, std::chrono::steady_clock::time_point now) -> EnqueueResult;
+
+// 未处于背压时按入队顺序取出下一条事件
+auto pop_writable(EventQueue& queue) -> std::optional<std::string>;
+
+// 记录一次写出的结果；写出返回背压时重新计时，因为这次写出本身就是进展
+auto record_write(EventQueue& queue, bool accepted, std::chrono::steady_clock::time_point now)
+    -> void;
+
+// socket 可写回调：解除背压，随后由调用方继续 pop_writable
+auto resume(EventQueue& queue) -> void;
+
+}  // namespace core::http_server::sse_queue
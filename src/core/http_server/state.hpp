@@ -4,6 +4,7 @@
 
 #include "vendor/uwebsockets.hpp"
 
+#include "core/http_server/file_cache.hpp"
 #include "core/http_server/types.hpp"
 
 namespace core::http_server {
@@ -23,6 +24,12 @@ struct HttpServerState {
   std::vector<std::shared_ptr<SseConnection>> sse_connections;
   std::atomic<std::uint64_t> client_counter{0};
   std::mutex sse_connections_mutex;
+  SseQueueCounters sse_queue_counters;
+
+  // WebSocket连接管理；与 SSE 共用 client_counter
+  std::vector<std::shared_ptr<WebSocketConnection>> websocket_connections;
+  std::mutex websocket_connections_mutex;
+
   std::atomic<bool> is_running{false};
   std::atomic<bool> runtime_lan_enabled{false};
 
@@ -36,6 +43,13 @@ struct HttpServerState {
 
   // 路径解析器注册表
   ResolverRegistry path_resolvers;
+
+  // 流式传输缓冲预算；流上下文共享所有权，服务关闭后仍可安全归还
+  std::shared_ptr<StreamMemoryBudget> stream_budget = std::make_shared<StreamMemoryBudget>();
+
+  // 静态小文件热缓存；读取协程共享所有权，服务关闭后回写仍然安全
+  std::shared_ptr<file_cache::StaticFileCache> file_cache =
+      std::make_shared<file_cache::StaticFileCache>();
 };
 
 }  // namespace core::http_server
@@ -8,8 +8,12 @@
 
 #include "core/async/async.hpp"
 #include "core/http_server/access.hpp"
+#include "core/http_server/compression.hpp"
+#include "core/http_server/file_cache.hpp"
 #include "core/http_server/types.hpp"
 #include "core/state/app_state.hpp"
+#include "core/tracing/tracing.hpp"
+#include "utils/compression/compression.hpp"
 #include "utils/file/file.hpp"
 #include "utils/file/mime.hpp"
 #include "utils/logger/logger.hpp"
@@ -325,6 +329,24 @@ auto write_common_file_headers(auto* res, const std::string& mime_type,
   }
 }
 
+// 压缩表示与原始字节不同，ETag 需要区分，避免条件请求把两种表示混用。
+auto build_encoded_validators(const CacheValidators& validators, std::string_view encoding)
+    -> CacheValidators {
+  auto etag = validators.etag;
+  etag.insert(etag.size() - 1, std::format("-{}", encoding));
+  return CacheValidators{.etag = std::move(etag), .last_modified = validators.last_modified};
+}
+
+// 可压缩资源的两种表示共用同一 URL，缓存必须按 Accept-Encoding 区分。
+auto write_encoding_headers(auto* res, bool compressible, bool gzip_encoded) -> void {
+  if (compressible) {
+    res->writeHeader("Vary", "Accept-Encoding");
+  }
+  if (gzip_encoded) {
+    res->writeHeader("Content-Encoding", "gzip");
+  }
+}
+
 // 304 响应不返回实体，但仍需回写缓存校验头，让浏览器更新缓存元数据。
 auto write_not_modified(auto* res, std::string_view cache_control,
                         const CacheValidators& validators) -> void {
@@ -365,19 +387,78 @@ auto complete_stream(const std::shared_ptr<StreamContext>& ctx) -> void {
   Logger().debug("Stream completed: {}, sent {} bytes", ctx->file_path.string(), ctx->bytes_sent);
 }
 
-// 在 uWS 线程中发送数据块
-auto send_chunk_to_uws(std::shared_ptr<StreamContext> ctx, std::shared_ptr<std::string> chunk_data)
-    -> void {
+// 按上一块的排空速率调整后续块大小，使一块约在 STREAM_TARGET_CHUNK_DRAIN 内发完。
+// 快速客户端逐步扩块以填满链路，慢速客户端缩回基础块，避免为其囤积缓冲。
+auto adapt_chunk_size(const std::shared_ptr<StreamContext>& ctx, size_t sent_bytes) -> void {
+  constexpr auto max_chunk_size = std::clamp(STREAM_CONNECTION_BUDGET / STREAM_READ_AHEAD_SLOTS,
+                                             STREAM_CHUNK_SIZE, STREAM_MAX_CHUNK_SIZE);
+
+  const auto elapsed_micros = std::chrono::duration_cast<std::chrono::microseconds>(
+                                  std::chrono::steady_clock::now() - ctx->send_started_at)
+                                  .count();
+  const auto target_micros =
+      std::chrono::duration_cast<std::chrono::microseconds>(STREAM_TARGET_CHUNK_DRAIN).count();
+  // tryEnd 立即写完说明 socket 仍有余量，按可用的最大块估算
+  const auto estimated_size =
+      elapsed_micros <= 0
+          ? max_chunk_size
+          : static_cast<size_t>(sent_bytes * static_cast<std::uint64_t>(target_micros) /
+                                static_cast<std::uint64_t>(elapsed_micros));
+
+  // 每次只翻倍或减半，避免单次抖动让缓冲区反复重新分配
+  if (estimated_size >= ctx->chunk_size * 2) {
+    ctx->chunk_size = ctx->chunk_size * 2;
+  } else if (estimated_size * 2 <= ctx->chunk_size) {
+    ctx->chunk_size = ctx->chunk_size / 2;
+  }
+  ctx->chunk_size = std::clamp(ctx->chunk_size, STREAM_CHUNK_SIZE, max_chunk_size);
+}
+
+// 槽位空闲时把缓冲区调整到目标块大小；扩块受全局预算约束，申请失败则沿用原缓冲区
+auto fit_chunk_buffer(const std::shared_ptr<StreamContext>& ctx, StreamChunk& chunk) -> void {
+  const auto current_size = chunk.buffer.size();
+  // 剩余数据不足一块时不为尾部扩块
+  const auto remaining = ctx->file_end_offset - ctx->read_offset;
+  const auto desired_size = std::min(ctx->chunk_size, std::max(remaining, current_size));
+
+  if (desired_size > current_size) {
+    if (!ctx->buffer_reservation.try_reserve(desired_size - current_size)) {
+      return;
+    }
+    chunk.buffer = std::vector<char>(desired_size);
+  } else if (desired_size < current_size) {
+    chunk.buffer = std::vector<char>(desired_size);
+    ctx->buffer_reservation.release(current_size - desired_size);
+  }
+}
+
+// 当前块已全部交给 uWS：推进发送偏移并把槽位还给预读
+auto release_sent_chunk(const std::shared_ptr<StreamContext>& ctx, size_t slot) -> void {
+  auto& chunk = ctx->chunks[slot];
+  adapt_chunk_size(ctx, chunk.size);
+  ctx->bytes_sent = ctx->res->getWriteOffset();
+  ctx->file_offset += chunk.size;
+  chunk.size = 0;
+  chunk.state = StreamChunkState::Free;
+}
+
+// 在 uWS 线程中直接发送槽位缓冲区里的数据块，不再额外拷贝成独立字符串
+auto send_chunk_to_uws(std::shared_ptr<StreamContext> ctx, size_t slot) -> void {
   if (ctx->abort_flag->load()) {
     Logger().debug("Stream aborted, stopping");
     return;
   }
 
+  auto& chunk = ctx->chunks[slot];
+  chunk.state = StreamChunkState::Sending;
+  ctx->send_started_at = std::chrono::steady_clock::now();
+
   // 记录发送前的偏移量（用于处理背压）
   size_t chunk_start_offset = ctx->bytes_sent;
 
   // tryEnd 的 total 必须为「整个 HTTP 响应体」长度；Range 时为片段长而非文件全长。
-  auto [ok, done] = ctx->res->tryEnd(*chunk_data, ctx->response_size);
+  auto [ok, done] =
+      ctx->res->tryEnd(std::string_view{chunk.buffer.data(), chunk.size}, ctx->response_size);
 
   if (done) {
     // tryEnd 已经完成响应；不要再访问响应对象或调度下一次读取。
@@ -389,31 +470,34 @@ auto send_chunk_to_uws(std::shared_ptr<StreamContext> ctx, std::shared_ptr<std::
   }
 
   if (!ok) {
-    // 背压：缓冲区满，需要等待可写
-    ctx->res->onWritable([ctx, chunk_data, chunk_start_offset](size_t) -> bool {
+    // 背压：缓冲区满，需要等待可写；槽位保持 Sending，缓冲区在发完前不会被预读覆盖
+    ctx->res->onWritable([ctx, slot, chunk_start_offset](size_t) -> bool {
       if (ctx->abort_flag->load()) {
         return false;  // 停止等待
       }
 
+      const auto& chunk = ctx->chunks[slot];
+
       // 计算已经发送的字节数
       size_t already_sent = ctx->res->getWriteOffset() - chunk_start_offset;
 
-      if (already_sent >= chunk_data->size()) {
+      if (already_sent >= chunk.size) {
         // 这个块已经全部发送完成
-        ctx->bytes_sent = ctx->res->getWriteOffset();
-        ctx->file_offset += chunk_data->size();
+        release_sent_chunk(ctx, slot);
 
         // onWritable 的返回值表示写入是否成功，不负责移除回调。
         ctx->res->onWritable(nullptr);
 
-        // 继续读下一块
-        read_and_send_next_chunk(ctx);
+        // 下一块可能已经预读完成并立即发送；推迟到回调返回后，避免在回调内重新注册 onWritable
+        ctx->loop->defer([ctx]() { read_and_send_next_chunk(ctx); });
         return true;
       }
 
       // 发送剩余数据
-      auto remaining = chunk_data->substr(already_sent);
-      auto [ok2, done2] = ctx->res->tryEnd(remaining, ctx->response_size);
+      auto [ok2, done2] =
+          ctx->res->tryEnd(std::string_view{chunk.buffer.data() + already_sent,
+                                            chunk.size - already_sent},
+                           ctx->response_size);
 
       if (done2) {
         // tryEnd 已经完成响应；它会清除 onWritable。
@@ -426,12 +510,11 @@ auto send_chunk_to_uws(std::shared_ptr<StreamContext> ctx, std::shared_ptr<std::
 
       if (ok2) {
         // 发送成功，显式移除本次背压回调。
-        ctx->bytes_sent = ctx->res->getWriteOffset();
-        ctx->file_offset += chunk_data->size();
+        release_sent_chunk(ctx, slot);
         ctx->res->onWritable(nullptr);
 
-        // 继续读下一块
-        read_and_send_next_chunk(ctx);
+        // 继续发送下一块
+        ctx->loop->defer([ctx]() { read_and_send_next_chunk(ctx); });
         return true;
       }
 
@@ -439,68 +522,94 @@ auto send_chunk_to_uws(std::shared_ptr<StreamContext> ctx, std::shared_ptr<std::
       return true;
     });
   } else {
-    // 发送成功，更新状态
-    ctx->bytes_sent = ctx->res->getWriteOffset();
-    ctx->file_offset += chunk_data->size();
-
-    // 继续读下一块
+    // 发送成功，更新状态并继续推进
+    release_sent_chunk(ctx, slot);
     read_and_send_next_chunk(ctx);
   }
 }
 
-// 读取并发送下一个数据块
-auto read_and_send_next_chunk(std::shared_ptr<StreamContext> ctx) -> void {
-  // 检查是否完成
-  if (ctx->file_offset >= ctx->file_end_offset || ctx->abort_flag->load()) {
-    if (!ctx->abort_flag->load()) {
-      if (ctx->bytes_sent == ctx->response_size) {
-        complete_stream(ctx);
-      } else {
-        Logger().error("Stream ended before the full response was sent: {}",
-                       ctx->file_path.string());
-      }
-    }
-    return;
-  }
+// 向空闲槽位发起下一块异步读取；读完成后回到 uWS 线程更新槽位状态
+auto start_chunk_read(const std::shared_ptr<StreamContext>& ctx, size_t slot) -> void {
+  auto& chunk = ctx->chunks[slot];
+  fit_chunk_buffer(ctx, chunk);
+  chunk.state = StreamChunkState::Reading;
+  ctx->read_in_flight = true;
 
   // 计算本次读取大小
-  size_t to_read = std::min(STREAM_CHUNK_SIZE, ctx->file_end_offset - ctx->file_offset);
+  size_t to_read = std::min(chunk.buffer.size(), ctx->file_end_offset - ctx->read_offset);
 
-  // 异步读取文件块
   ctx->file.async_read_some_at(
-      ctx->file_offset, asio::buffer(ctx->buffer.data(), to_read),
-      [ctx](std::error_code ec, size_t bytes_read) {
+      ctx->read_offset, asio::buffer(chunk.buffer.data(), to_read),
+      [ctx, slot](std::error_code ec, size_t bytes_read) {
         if (ctx->abort_flag->load()) {
           return;
         }
 
-        if (ec || bytes_read == 0) {
-          // 文件读取失败时结束响应，但不触发“完整传输”的删除回调。
-          Logger().error("Failed to read file {}: {}", ctx->file_path.string(),
-                         ec ? ec.message() : "EOF");
-          ctx->loop->defer([ctx]() {
-            if (ctx->abort_flag->load()) {
-              return;
-            }
+        ctx->loop->defer([ctx, slot, ec, bytes_read]() {
+          if (ctx->abort_flag->load() || ctx->completion_called) {
+            return;
+          }
+          ctx->read_in_flight = false;
+
+          if (ec || bytes_read == 0) {
+            // 文件读取失败时结束响应，但不触发“完整传输”的删除回调。
+            Logger().error("Failed to read file {}: {}", ctx->file_path.string(),
+                           ec ? ec.message() : "EOF");
             ctx->res->writeStatus("500 Internal Server Error");
             ctx->res->end("Internal server error");
-          });
-          return;
-        }
-
-        // 准备发送的数据（拷贝到独立的 string）
-        auto chunk_data = std::make_shared<std::string>(ctx->buffer.data(), bytes_read);
-
-        // 在 uWS 线程中发送
-        ctx->loop->defer([ctx, chunk_data]() {
-          if (ctx->abort_flag->load()) {
             return;
           }
-          send_chunk_to_uws(ctx, chunk_data);
+
+          auto& chunk = ctx->chunks[slot];
+          chunk.size = bytes_read;
+          chunk.state = StreamChunkState::Ready;
+          ctx->read_offset += bytes_read;
+          read_and_send_next_chunk(ctx);
         });
       });
 }
 
+// 推进流式发送：先为空闲槽位发起预读，再发送已就绪的块；只在 uWS 线程调用
+auto read_and_send_next_chunk(std::shared_ptr<StreamContext> ctx) -> void {
+  if (ctx->abort_flag->load() || ctx->completion_called) {
+    return;
+  }
+
+  auto find_slot = [&ctx](StreamChunkState state) -> std::optional<size_t> {
+    for (size_t slot = 0; slot < ctx->chunks.size(); ++slot) {
+      if (ctx->chunks[slot].state == state) {
+        return slot;
+      }
+    }
+    return std::nullopt;
+  };
+
+  // 预读：当前块还在发送或等待背压时，下一块已经在 IO 线程读取
+  if (!ctx->read_in_flight && ctx->read_offset < ctx->file_end_offset) {
+    if (auto free_slot = find_slot(StreamChunkState::Free)) {
+      start_chunk_read(ctx, *free_slot);
+    }
+  }
+
+  auto sending_slot = find_slot(StreamChunkState::Sending);
+  auto ready_slot = find_slot(StreamChunkState::Ready);
+  if (!sending_slot && ready_slot) {
+    send_chunk_to_uws(ctx, *ready_slot);
+    return;
+  }
+
+  // 检查是否完成：没有在途读取、待发送或发送中的块
+  if (!sending_slot && !ready_slot && !ctx->read_in_flight &&
+      ctx->file_offset >= ctx->file_end_offset) {
+    if (ctx->bytes_sent == ctx->response_size) {
+      complete_stream(ctx);
+    } else {
+      Logger().error("Stream ended before the full response was sent: {}",
+                     ctx->file_path.string());
+    }
+  }
+}
+
 // 按块异步读取大文件，并在完整发送后执行完成回调。
 auto handle_file_stream(core::AppState& state, std::filesystem::path file_path,
                         std::string mime_type, std::string cache_control,
@@ -515,6 +624,8 @@ auto handle_file_stream(core::AppState& state, std::filesystem::path file_path,
   size_t range_end = range.has_value() ? range->end : (file_size - 1);
   size_t response_size = range_end >= range_start ? (range_end - range_start + 1) : 0;
   auto abort_flag = std::make_shared<std::atomic_bool>(false);
+  auto stream_budget = state.http_server ? state.http_server->stream_budget
+                                         : std::shared_ptr<StreamMemoryBudget>{};
 
   // 必须在异步打开文件前注册；否则客户端可能已经中止而流上下文尚未建立。
   res->onAborted([abort_flag, file_path]() {
@@ -529,7 +640,8 @@ auto handle_file_stream(core::AppState& state, std::filesystem::path file_path,
                            validators = std::move(validators),
                            content_disposition = std::move(content_disposition), loop, io_context,
                            file_size, range, range_start, range_end, response_size, allow_range,
-                           on_complete = std::move(on_complete)]() mutable {
+                           on_complete = std::move(on_complete),
+                           stream_budget = std::move(stream_budget)]() mutable {
     try {
       // 在异步线程打开文件，避免阻塞 uWS 事件循环。
       asio::random_access_file file(*io_context, file_path.string(), asio::file_base::read_only);
@@ -543,6 +655,7 @@ auto handle_file_stream(core::AppState& state, std::filesystem::path file_path,
           .source_file_size = file_size,
           .response_size = response_size,
           .file_offset = range_start,
+          .read_offset = range_start,
           .file_end_offset = range_end + 1,
           .mime_type = mime_type,
           .cache_control = cache_control,
@@ -558,12 +671,18 @@ auto handle_file_stream(core::AppState& state, std::filesystem::path file_path,
           .accepts_ranges = allow_range,
           .loop = loop,
           .res = res,
-          .buffer = std::vector<char>(STREAM_CHUNK_SIZE),
           .on_complete = std::move(on_complete),
           .completion_called = false,
           .abort_flag = abort_flag,
       });
 
+      // 槽位先按基础块分配，短 Range 不必占满整块；之后按排空速率在预算内扩缩
+      ctx->buffer_reservation = StreamBufferReservation{std::move(stream_budget)};
+      for (auto& chunk : ctx->chunks) {
+        chunk.buffer.resize(std::min(STREAM_CHUNK_SIZE, std::max<size_t>(response_size, 1)));
+        ctx->buffer_reservation.force_reserve(chunk.buffer.size());
+      }
+
       // 回到 uWS 线程写响应头，再启动第一轮异步读取。
       loop->defer([ctx]() {
         if (ctx->abort_flag->load()) {
@@ -609,17 +728,48 @@ auto serve_resolved_file_request(
     std::optional<std::string> cache_control_override, auto* res, auto* req, bool is_head,
     std::optional<std::string> content_disposition_override = std::nullopt, bool allow_range = true,
     std::move_only_function<void()> on_complete = {}) -> void {
+  // 只覆盖同步部分；大文件的分块流式发送在之后的回调中继续
+  core::tracing::Span span("serve_file", "http");
+  // 一次性下载会在完成后清理文件，不进入热缓存
+  std::shared_ptr<file_cache::StaticFileCache> cache;
+  if (state.http_server && allow_range && !on_complete) {
+    cache = state.http_server->file_cache;
+  }
+  // 与 immutable Cache-Control 的判定一致：带哈希的构建产物内容不会变化
+  const bool immutable_asset = !cache_control_override && url_path.starts_with("/assets/");
+
+  // 不可变资源命中后直接使用缓存时记录的属性，连文件属性都不再查询
+  std::shared_ptr<const file_cache::CachedFile> cached_file;
+  if (cache && immutable_asset) {
+    cached_file = file_cache::find_immutable(*cache, file_path);
+  }
+
   // 先读取统一元数据，后续 Range、缓存和响应头都使用同一份快照。
-  auto metadata_result = query_file_metadata(file_path);
-  if (!metadata_result) {
-    Logger().warn("Resolved file unavailable: {} ({})", file_path.string(),
-                  metadata_result.error());
-    res->writeStatus("404 Not Found");
-    res->end("File not found");
-    return;
+  FileMetadata metadata;
+  if (cached_file) {
+    metadata = FileMetadata{
+        .size = cached_file->data->size(),
+        .modified_seconds = cached_file->modified_seconds,
+        .modified_time = std::chrono::system_clock::time_point{
+            std::chrono::seconds{cached_file->modified_seconds}},
+    };
+  } else {
+    auto metadata_result = query_file_metadata(file_path);
+    if (!metadata_result) {
+      Logger().warn("Resolved file unavailable: {} ({})", file_path.string(),
+                    metadata_result.error());
+      res->writeStatus("404 Not Found");
+      res->end("File not found");
+      return;
+    }
+    metadata = metadata_result.value();
+
+    if (cache && metadata.size <= STREAM_THRESHOLD) {
+      cached_file =
+          file_cache::find_valid(*cache, file_path, metadata.size, metadata.modified_seconds);
+    }
   }
 
-  const auto& metadata = metadata_result.value();
   const size_t file_size = metadata.size;
 
   // 决定mime类型和缓存时间
@@ -645,9 +795,22 @@ auto serve_resolved_file_request(
     return;
   }
 
+  // 文本小文件随热缓存保存 gzip 版本；Range 与 HEAD 始终使用原始表示。
+  const bool compressible = cache && file_size >= compression::kMinCompressSize &&
+                            file_size <= STREAM_THRESHOLD &&
+                            compression::is_compressible_mime(mime_type);
+  const bool serve_gzip =
+      compressible && !is_head && !range_parse.range.has_value() &&
+      (!cached_file || cached_file->gzip_data) &&
+      compression::accepts_encoding(req->getHeader("accept-encoding"),
+                                    utils::compression::Encoding::Gzip);
+  const auto representation_validators =
+      serve_gzip ? build_encoded_validators(validators, "gzip") : validators;
+
   // 临时归档必须真正发送完整内容，不走 304 短路。
-  if (allow_range && is_not_modified_request(req, validators, range_parse.range.has_value())) {
-    write_not_modified(res, cache_control, validators);
+  if (allow_range &&
+      is_not_modified_request(req, representation_validators, range_parse.range.has_value())) {
+    write_not_modified(res, cache_control, representation_validators);
     return;
   }
 
@@ -664,6 +827,7 @@ auto serve_resolved_file_request(
                                   ? std::optional<std::string_view>{*content_disposition_override}
                                   : std::nullopt,
                               allow_range);
+    write_encoding_headers(res, compressible, false);
     res->writeHeader("Content-Length", std::to_string(content_length));
     res->end();
     return;
@@ -679,6 +843,26 @@ auto serve_resolved_file_request(
     return;
   }
 
+  if (cached_file) {
+    // 命中热缓存：直接在 uWS 线程写响应，不再切换到异步运行时
+    const size_t range_start = range_parse.range.has_value() ? range_parse.range->start : 0;
+    const auto response_body =
+        serve_gzip ? std::string_view{*cached_file->gzip_data}
+                   : std::string_view{*cached_file->data}.substr(range_start, content_length);
+    res->writeStatus(range_parse.range.has_value() ? "206 Partial Content" : "200 OK");
+    write_common_file_headers(res, mime_type, cache_control, representation_validators, file_size,
+                              range_parse.range,
+                              content_disposition_override.has_value()
+                                  ? std::optional<std::string_view>{*content_disposition_override}
+                                  : std::nullopt,
+                              allow_range);
+    write_encoding_headers(res, compressible, serve_gzip);
+    res->end(response_body);
+    // 节省的是磁盘读取量，按原始表示计
+    file_cache::record_bytes_saved(*cache, content_length);
+    return;
+  }
+
   Logger().debug("Using single-read for small resolved file: {} bytes", file_size);
 
   // 小文件整读仍放到异步运行时，避免阻塞 HTTP 事件循环。
@@ -704,7 +888,9 @@ auto serve_resolved_file_request(
       [res, file_path, mime_type, cache_control = std::move(cache_control),
        validators = std::move(validators),
        content_disposition = std::move(content_disposition_override), loop, file_size,
-       range = range_parse.range, allow_range, abort_flag, completion]() -> asio::awaitable<void> {
+       range = range_parse.range, allow_range, abort_flag, completion, cache, immutable_asset,
+       modified_seconds = metadata.modified_seconds, compressible,
+       serve_gzip]() -> asio::awaitable<void> {
         try {
           // 读取整文件后再按请求的 Range 截取响应体。
           auto file_result = co_await utils::file::read_file(file_path, file_size);
@@ -733,6 +919,38 @@ auto serve_resolved_file_request(
             co_return;
           }
 
+          // 文本资源在首次读取时压缩一次，之后由热缓存直接复用
+          std::shared_ptr<const std::string> gzip_data;
+          if (compressible) {
+            auto gzip_result = utils::compression::compress(
+                std::string_view{file_data.data.data(), file_size},
+                utils::compression::Encoding::Gzip, compression::kStaticCompressionLevel);
+            if (gzip_result) {
+              gzip_data = std::make_shared<const std::string>(std::move(gzip_result.value()));
+            } else {
+              Logger().warn("Failed to precompress {}: {}", file_path.string(),
+                            gzip_result.error());
+            }
+          }
+
+          if (cache) {
+            // 按读取前的属性快照写回；文件若在读取期间被替换，下一次校验会发现并重新读取
+            file_cache::store(
+                *cache, file_path,
+                file_cache::CachedFile{
+                    .data = std::make_shared<const std::string>(file_data.data.data(),
+                                                                file_size),
+                    .gzip_data = gzip_data,
+                    .modified_seconds = modified_seconds,
+                    .immutable = immutable_asset,
+                });
+          }
+
+          // 压缩失败时退回原始表示，ETag 也随之使用原始版本
+          const bool gzip_encoded = serve_gzip && gzip_data != nullptr;
+          const auto response_validators =
+              gzip_encoded ? build_encoded_validators(validators, "gzip") : validators;
+
           const size_t range_start = range.has_value() ? range->start : 0;
           const size_t range_end =
               file_size > 0 ? (range.has_value() ? range->end : file_size - 1) : 0;
@@ -740,16 +958,19 @@ auto serve_resolved_file_request(
               file_size > 0 && range_end >= range_start ? (range_end - range_start + 1) : 0;
 
           std::string response_body;
-          if (content_length > 0) {
+          if (gzip_encoded) {
+            response_body = *gzip_data;
+          } else if (content_length > 0) {
             response_body.assign(reinterpret_cast<const char*>(file_data.data.data() + range_start),
                                  content_length);
           }
 
           // 只有响应成功结束后才执行一次性归档的完成回调。
-          loop->defer([res, file_path, mime_type, cache_control, validators, file_size, range,
+          loop->defer([res, file_path, mime_type, cache_control,
+                       validators = response_validators, file_size, range,
                        content_disposition = std::move(content_disposition),
                        response_body = std::move(response_body), allow_range, abort_flag,
-                       completion]() mutable {
+                       completion, compressible, gzip_encoded]() mutable {
             if (abort_flag->load()) {
               return;
             }
@@ -759,6 +980,7 @@ auto serve_resolved_file_request(
                                           ? std::optional<std::string_view>{*content_disposition}
                                           : std::nullopt,
                                       allow_range);
+            write_encoding_headers(res, compressible, gzip_encoded);
             res->end(response_body);
 
             if (*completion) {
@@ -0,0 +1,161 @@
+#include "core/http_server/thumbnail_batch.hpp"
+
+#include "vendor/std.hpp"
+
+#include "vendor/asio.hpp"
+#include "vendor/rfl.hpp"
+#include "vendor/uwebsockets.hpp"
+
+#include "core/async/async.hpp"
+#include "core/http_server/access.hpp"
+#include "features/gallery/asset/thumbnail.hpp"
+#include "features/gallery/state.hpp"
+#include "utils/file/file.hpp"
+#include "utils/logger/logger.hpp"
+
+namespace core::http_server::thumbnail_batch {
+namespace {
+
+struct BatchRequest {
+  std::vector<std::string> hashes;
+};
+
+// 一次批量读取的共享状态；每个读取协程只写自己的下标，最后完成者负责组包
+struct BatchReadState {
+  std::vector<EntryStatus> statuses;
+  std::vector<std::vector<char>> payloads;
+  std::atomic<std::size_t> remaining{0};
+};
+
+auto reject_unauthorized(auto* res) -> void {
+  res->writeStatus("401 Unauthorized");
+  res->writeHeader("Cache-Control", "no-store");
+  res->writeHeader("Content-Type", "text/plain; charset=utf-8");
+  res->end("Authentication required");
+}
+
+auto reject_bad_request(auto* res, std::string_view message) -> void {
+  res->writeStatus("400 Bad Request");
+  res->writeHeader("Cache-Control", "no-store");
+  res->writeHeader("Content-Type", "text/plain; charset=utf-8");
+  res->end(message);
+}
+
+auto send_batch_response(auto* res, const BatchReadState& batch) -> void {
+  auto body = encode_batch_response(batch.statuses, batch.payloads);
+  res->writeStatus("200 OK");
+  res->writeHeader("Content-Type", "application/octet-stream");
+  res->writeHeader("Cache-Control", "no-store");
+  res->end(body);
+}
+
+// 解析请求体后并发读取全部缩略图；无效 hash 不触盘，直接标记。
+auto start_batch_read(core::AppState& state, auto* res, std::string_view body,
+                      std::shared_ptr<std::atomic_bool> abort_flag) -> void {
+  auto request = rfl::json::read<BatchRequest, rfl::DefaultIfMissing>(body);
+  if (!request) {
+    reject_bad_request(res, "Invalid batch request");
+    return;
+  }
+
+  auto& hashes = request->hashes;
+  if (hashes.size() > kMaxBatchSize) {
+    reject_bad_request(res, "Too many thumbnails requested");
+    return;
+  }
+
+  auto batch = std::make_shared<BatchReadState>();
+  batch->statuses.assign(hashes.size(), EntryStatus::Invalid);
+  batch->payloads.resize(hashes.size());
+
+  auto* io_context = core::async::get_io_context(state);
+  const bool has_thumbnails_directory =
+      state.gallery && !state.gallery->thumbnails_directory.empty();
+
+  std::vector<std::pair<std::size_t, std::filesystem::path>> reads;
+  reads.reserve(hashes.size());
+  for (std::size_t index = 0; index < hashes.size(); ++index) {
+    if (!is_valid_thumbnail_hash(hashes[index])) {
+      continue;
+    }
+    batch->statuses[index] = EntryStatus::Missing;
+    if (has_thumbnails_directory && io_context) {
+      reads.emplace_back(index, features::gallery::asset::thumbnail::build_thumbnail_path(
+                                    state.gallery->thumbnails_directory, hashes[index]));
+    }
+  }
+
+  if (reads.empty()) {
+    send_batch_response(res, *batch);
+    return;
+  }
+
+  // 每张缩略图一个读取协程，IO 线程池上的重叠读取替代浏览器的数百个独立请求
+  auto* loop = uWS::Loop::get();
+  batch->remaining.store(reads.size(), std::memory_order_relaxed);
+  for (auto& [index, path] : reads) {
+    asio::co_spawn(
+        *io_context,
+        [res, loop, batch, abort_flag, index, path = std::move(path)]() -> asio::awaitable<void> {
+          if (!abort_flag->load()) {
+            auto file_result = co_await utils::file::read_file(path);
+            if (file_result) {
+              batch->statuses[index] = EntryStatus::Ok;
+              batch->payloads[index] = std::move(file_result->data);
+            }
+          }
+
+          if (batch->remaining.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+            co_return;
+          }
+          loop->defer([res, batch, abort_flag]() {
+            if (abort_flag->load()) {
+              return;
+            }
+            send_batch_response(res, *batch);
+          });
+        },
+        core::async::log_completion("Thumbnail batch read"));
+  }
+}
+
+auto handle_batch_request(core::AppState& state, auto* res, auto* req) -> void {
+  if (!core::http_server::access::resolve_http_access(state, res->getRemoteAddressAsText(),
+                                                      req->getHeader("cookie"))) {
+    reject_unauthorized(res);
+    return;
+  }
+
+  auto abort_flag = std::make_shared<std::atomic_bool>(false);
+  res->onAborted([abort_flag]() {
+    abort_flag->store(true);
+    Logger().debug("Thumbnail batch request aborted");
+  });
+
+  std::string buffer;
+  res->onData([&state, res, abort_flag, buffer = std::move(buffer)](std::string_view data,
+                                                                     bool last) mutable {
+    if (buffer.size() + data.size() > kMaxRequestBodySize) {
+      // 超限后仍会收到剩余分片，只在第一次超限时响应
+      if (!abort_flag->exchange(true)) {
+        reject_bad_request(res, "Batch request too large");
+      }
+      return;
+    }
+    buffer.append(data.data(), data.size());
+
+    if (last && !abort_flag->load()) {
+      start_batch_read(state, res, buffer, abort_flag);
+    }
+  });
+}
+
+}  // namespace
+
+auto register_routes(core::AppState& state, uWS::App& app) -> void {
+  Logger().info("Registering thumbnail batch route");
+  app.post("/gallery/thumbnails/batch",
+           [&state](auto* res, auto* req) { handle_batch_request(state, res, req); });
+}
+
+}  // namespace core::http_server::thumbnail_batch
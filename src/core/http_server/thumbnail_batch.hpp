@@ -0,0 +1,21 @@
+#pragma once
+
+#include "vendor/std.hpp"
+
+#include "vendor/uwebsockets.hpp"
+
+#include "core/http_server/thumbnail_batch_format.hpp"
+#include "core/state/app_state.hpp"
+
+namespace core::http_server::thumbnail_batch {
+
+// 单次批量请求允许的最大 hash 数，约等于一屏密集网格的两倍
+constexpr std::size_t kMaxBatchSize = 256;
+
+// 请求体上限；256 个 64 位十六进制 hash 的 JSON 远小于此值
+constexpr std::size_t kMaxRequestBodySize = 64 * 1024;
+
+// 注册 POST /gallery/thumbnails/batch，一次返回多张缩略图。
+auto register_routes(core::AppState& state, uWS::App& app) -> void;
+
+}  // namespace core::http_server::thumbnail_batch
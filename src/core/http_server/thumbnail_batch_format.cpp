@@ -0,0 +1,53 @@
+#include "core/http_server/thumbnail_batch_format.hpp"
+
+#include "vendor/std.hpp"
+
+namespace core::http_server::thumbnail_batch {
+namespace {
+
+auto append_u32_le(std::string& out, std::uint32_t value) -> void {
+  for (int shift = 0; shift < 32; shift += 8) {
+    out.push_back(static_cast<char>((value >> shift) & 0xFF));
+  }
+}
+
+}  // namespace
+
+auto is_valid_thumbnail_hash(std::string_view hash) -> bool {
+  if (hash.size() < 16 || hash.size() > 64) {
+    return false;
+  }
+  return std::ranges::all_of(
+      hash, [](char c) { return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f'); });
+}
+
+auto encode_batch_response(std::span<const EntryStatus> statuses,
+                           std::span<const std::vector<char>> payloads) -> std::string {
+  std::size_t total_size = kResponseMagic.size() + 8;
+  for (std::size_t index = 0; index < statuses.size(); ++index) {
+    total_size += 5;
+    if (statuses[index] == EntryStatus::Ok) {
+      total_size += payloads[index].size();
+    }
+  }
+
+  std::string out;
+  out.reserve(total_size);
+  out.append(kResponseMagic);
+  append_u32_le(out, kResponseVersion);
+  append_u32_le(out, static_cast<std::uint32_t>(statuses.size()));
+
+  for (std::size_t index = 0; index < statuses.size(); ++index) {
+    out.push_back(static_cast<char>(statuses[index]));
+    if (statuses[index] != EntryStatus::Ok) {
+      append_u32_le(out, 0);
+      continue;
+    }
+    const auto& payload = payloads[index];
+    append_u32_le(out, static_cast<std::uint32_t>(payload.size()));
+    out.append(payload.data(), payload.size());
+  }
+  return out;
+}
+
+}  // namespace core::http_server::thumbnail_batch
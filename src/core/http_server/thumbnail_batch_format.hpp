@@ -0,0 +1,26 @@
+#pragma once
+
+#include "vendor/std.hpp"
+
+namespace core::http_server::thumbnail_batch {
+
+// 响应头魔数与版本，客户端据此确认是批量缩略图格式
+constexpr std::string_view kResponseMagic = "SMTB";
+constexpr std::uint32_t kResponseVersion = 1;
+
+// 每个条目的状态字节，missing/invalid 时客户端回退到单张 URL
+enum class EntryStatus : std::uint8_t {
+  Ok = 0,
+  Missing = 1,
+  Invalid = 2,
+};
+
+// 只接受 16~64 位小写十六进制，保证 hash 不能构成路径穿越。
+auto is_valid_thumbnail_hash(std::string_view hash) -> bool;
+
+// 把条目按请求顺序编码为长度前缀的二进制流（小端）：
+// "SMTB" | u32 version | u32 count | { u8 status | u32 length | bytes }...
+auto encode_batch_response(std::span<const EntryStatus> statuses,
+                           std::span<const std::vector<char>> payloads) -> std::string;
+
+}  // namespace core::http_server::thumbnail_batch
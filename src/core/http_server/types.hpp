@@ -5,6 +5,10 @@
 #include "vendor/asio.hpp"
 #include "vendor/uwebsockets.hpp"
 
+#include "core/http_server/sse_queue.hpp"
+#include "core/http_server/websocket_queue.hpp"
+#include "core/rpc/types.hpp"
+
 namespace core::http_server {
 
 // ============= 流式传输配置 =============
@@ -15,6 +19,94 @@ constexpr size_t STREAM_THRESHOLD = 1024 * 1024;  // 1MB
 // 流式传输块大小
 constexpr size_t STREAM_CHUNK_SIZE = 65536;  // 64KB
 
+// 流式传输预读槽位数：一块交给 uWS 发送时，下一块已在异步读取
+constexpr size_t STREAM_READ_AHEAD_SLOTS = 2;
+
+// 自适应块大小上限：快速局域网客户端每块最多读取 1MB
+constexpr size_t STREAM_MAX_CHUNK_SIZE = 1024 * 1024;
+
+// 自适应目标：让一块数据大约在这段时间内被 socket 排空
+constexpr std::chrono::milliseconds STREAM_TARGET_CHUNK_DRAIN{25};
+
+// 单连接在途字节上限（所有预读槽位合计）
+constexpr size_t STREAM_CONNECTION_BUDGET = 2 * 1024 * 1024;  // 2MB
+
+// 全部流式连接共享的缓冲内存上限
+constexpr size_t STREAM_GLOBAL_BUDGET = 64 * 1024 * 1024;  // 64MB
+
+// 全部流式连接已占用的缓冲字节数，上限为 STREAM_GLOBAL_BUDGET
+struct StreamMemoryBudget {
+  std::atomic<size_t> reserved{0};
+};
+
+// 单个流从全局预算中占用的字节数，随流上下文析构归还
+struct StreamBufferReservation {
+  std::shared_ptr<StreamMemoryBudget> budget;
+  size_t bytes = 0;
+
+  StreamBufferReservation() = default;
+  explicit StreamBufferReservation(std::shared_ptr<StreamMemoryBudget> value)
+      : budget(std::move(value)) {}
+  ~StreamBufferReservation() { release(bytes); }
+
+  StreamBufferReservation(const StreamBufferReservation&) = delete;
+  auto operator=(const StreamBufferReservation&) -> StreamBufferReservation& = delete;
+
+  StreamBufferReservation(StreamBufferReservation&& other) noexcept
+      : budget(std::move(other.budget)), bytes(std::exchange(other.bytes, 0)) {}
+
+  auto operator=(StreamBufferReservation&& other) noexcept -> StreamBufferReservation& {
+    if (this != &other) {
+      release(bytes);
+      budget = std::move(other.budget);
+      bytes = std::exchange(other.bytes, 0);
+    }
+    return *this;
+  }
+
+  // 最小块无条件占用，保证预算紧张时新流仍能以基础块大小工作
+  auto force_reserve(size_t amount) -> void {
+    if (budget) {
+      budget->reserved.fetch_add(amount, std::memory_order_relaxed);
+    }
+    bytes += amount;
+  }
+
+  // 扩块前申请增量；超过全局上限时拒绝
+  auto try_reserve(size_t amount) -> bool {
+    if (!budget) {
+      bytes += amount;
+      return true;
+    }
+    auto current = budget->reserved.load(std::memory_order_relaxed);
+    do {
+      if (current + amount > STREAM_GLOBAL_BUDGET) {
+        return false;
+      }
+    } while (!budget->reserved.compare_exchange_weak(current, current + amount,
+                                                     std::memory_order_relaxed));
+    bytes += amount;
+    return true;
+  }
+
+  auto release(size_t amount) -> void {
+    amount = std::min(amount, bytes);
+    if (budget && amount > 0) {
+      budget->reserved.fetch_sub(amount, std::memory_order_relaxed);
+    }
+    bytes -= amount;
+  }
+};
+
+enum class StreamChunkState { Free, Reading, Ready, Sending };
+
+// 流式传输块槽位：缓冲区在流创建时分配一次，之后在读取与发送之间轮换复用
+struct StreamChunk {
+  std::vector<char> buffer;
+  size_t size = 0;  // 已读入的有效字节数
+  StreamChunkState state = StreamChunkState::Free;
+};
+
 // 流式传输上下文（完整状态）
 struct StreamContext {
   // 文件相关
@@ -22,7 +114,8 @@ struct StreamContext {
   std::filesystem::path file_path;
   size_t source_file_size;  // 完整文件大小（Content-Range 里的总长）
   size_t response_size;     // 本次 HTTP 体长度（uWS tryEnd 的 total；Range 时为片段字节数）
-  size_t file_offset;       // 下一次 async_read 的起始绝对偏移
+  size_t file_offset;       // 下一块待发送数据的起始绝对偏移
+  size_t read_offset;       // 下一次 async_read 的起始绝对偏移（领先于 file_offset）
   size_t file_end_offset;   // 读到该偏移前停止（exclusive；即「尾字节 + 1」）
 
   // 响应相关
@@ -39,7 +132,11 @@ struct StreamContext {
   // 运行时
   uWS::Loop* loop;
   uWS::HttpResponse<false>* res;
-  std::vector<char> buffer;
+  std::array<StreamChunk, STREAM_READ_AHEAD_SLOTS> chunks;
+  bool read_in_flight = false;  // 同一时刻只有一个读取在途，保证块按文件顺序就绪
+  size_t chunk_size = STREAM_CHUNK_SIZE;  // 自适应目标块大小，槽位空闲时按它调整缓冲区
+  std::chrono::steady_clock::time_point send_started_at{};  // 当前块开始交给 uWS 的时间
+  StreamBufferReservation buffer_reservation;
   std::move_only_function<void()> on_complete;  // 完整响应结束后的资源清理回调。
   bool completion_called = false;               // 防止流式完成路径重复执行清理。
 
@@ -70,12 +167,75 @@ struct ResolverRegistry {
   std::shared_mutex mutex;
 };
 
-// SSE连接信息结构
+// ============= SSE 配置 =============
+
+// 单个连接积压事件上限；合并后仍超出时淘汰最旧的无 key 事件
+constexpr size_t SSE_MAX_PENDING_EVENTS = 256;
+
+// 连接持续处于背压且没有写出进展超过此时长即视为慢消费者并断开，浏览器 EventSource 会自动重连
+constexpr std::chrono::seconds SSE_LAG_BUDGET{30};
+
+constexpr sse_queue::EventQueueLimits SSE_QUEUE_LIMITS{
+    .max_pending_events = SSE_MAX_PENDING_EVENTS, .lag_budget = SSE_LAG_BUDGET};
+
+// SSE连接信息结构；除 client_id 外的字段只在 HTTP loop 线程读写
 struct SseConnection {
   uWS::HttpResponse<false>* response = nullptr;
   std::string client_id;
   std::chrono::system_clock::time_point connected_at;
   bool is_closed = false;
+  sse_queue::EventQueue queue;
+};
+
+// 全部 SSE 连接累计的队列计数
+struct SseQueueCounters {
+  std::atomic<std::uint64_t> coalesced{0};
+  std::atomic<std::uint64_t> dropped{0};
+  std::atomic<std::uint64_t> lagging_disconnects{0};
+};
+
+struct SseQueueStats {
+  std::uint64_t coalesced = 0;
+  std::uint64_t dropped = 0;
+  std::uint64_t lagging_disconnects = 0;
+};
+
+// ============= WebSocket 配置 =============
+
+// 单帧请求上限，与 RPC POST 请求体同量级
+constexpr size_t WEBSOCKET_MAX_PAYLOAD = 16 * 1024 * 1024;  // 16MB
+
+// socket 内部缓冲超过此值时，新消息改入连接自己的发送队列，等 drain 时再写出
+constexpr size_t WEBSOCKET_SEND_HIGH_WATERMARK = 1024 * 1024;  // 1MB
+
+// 缓冲加队列超过此值时丢弃新的通知；RPC 响应仍然入队，客户端在等待它们
+constexpr size_t WEBSOCKET_NOTIFICATION_DROP_THRESHOLD = 4 * 1024 * 1024;  // 4MB
+
+// 队列总量超过此值说明客户端长期不读，直接断开连接
+constexpr size_t WEBSOCKET_MAX_QUEUED_BYTES = 32 * 1024 * 1024;  // 32MB
+
+constexpr websocket_queue::SendQueueLimits WEBSOCKET_SEND_QUEUE_LIMITS{
+    .high_watermark = WEBSOCKET_SEND_HIGH_WATERMARK,
+    .notification_drop_threshold = WEBSOCKET_NOTIFICATION_DROP_THRESHOLD,
+    .max_queued_bytes = WEBSOCKET_MAX_QUEUED_BYTES};
+
+struct WebSocketConnection;
+
+// uWS 为每个 socket 分配的用户数据，只持有共享的连接状态
+struct WebSocketUserData {
+  std::shared_ptr<WebSocketConnection> connection;
+};
+
+using WebSocket = uWS::WebSocket<false, true, WebSocketUserData>;
+
+// WebSocket 连接信息；除 access_level 外的字段只在 HTTP loop 线程读写
+struct WebSocketConnection {
+  WebSocket* socket = nullptr;
+  std::string client_id;
+  core::rpc::AccessLevel access_level = core::rpc::AccessLevel::lan;
+  std::chrono::system_clock::time_point connected_at;
+  // 关闭后 send_queue.closed 置位，仍在途的响应据此丢弃
+  websocket_queue::SendQueue send_queue;
 };
 
 }  // namespace core::http_server
@@ -0,0 +1,288 @@
+#include "core/http_server/websocket.hpp"
+
+#include "vendor/std.hpp"
+
+#include "vendor/asio.hpp"
+#include "vendor/uwebsockets.hpp"
+
+#include "core/async/async.hpp"
+#include "core/http_server/access.hpp"
+#include "core/http_server/compression.hpp"
+#include "core/http_server/state.hpp"
+#include "core/http_server/types.hpp"
+#include "core/http_server/websocket_queue.hpp"
+#include "core/rpc/rpc.hpp"
+#include "core/state/app_state.hpp"
+#include "utils/logger/logger.hpp"
+
+namespace core::http_server::websocket {
+
+// 小消息压缩收益不抵 CPU 开销，与 HTTP 动态压缩使用同一阈值
+auto write_frame(WebSocket& socket, std::string_view message) -> void {
+  socket.send(message, uWS::OpCode::TEXT, message.size() >= compression::kMinCompressSize);
+}
+
+// 按入队顺序写出积压消息，直到 socket 缓冲重新越过高水位
+auto flush_pending(WebSocketConnection& connection) -> void {
+  while (connection.socket) {
+    auto message = websocket_queue::pop_writable(connection.send_queue,
+                                                 WEBSOCKET_SEND_QUEUE_LIMITS,
+                                                 connection.socket->getBufferedAmount());
+    if (!message) {
+      return;
+    }
+    write_frame(*connection.socket, *message);
+  }
+}
+
+// 先入队再写出：缓冲未满且无积压时立即发出，否则等 drain 回调
+auto send_message(WebSocketConnection& connection, std::string message,
+                  websocket_queue::MessageKind kind) -> void {
+  if (!connection.socket) {
+    return;
+  }
+
+  const auto result =
+      websocket_queue::push(connection.send_queue, WEBSOCKET_SEND_QUEUE_LIMITS, std::move(message),
+                            kind, connection.socket->getBufferedAmount());
+  switch (result) {
+    case websocket_queue::PushResult::Accepted:
+      flush_pending(connection);
+      break;
+    case websocket_queue::PushResult::DroppedNotification:
+      if (connection.send_queue.dropped_notifications == 1) {
+        Logger().warn("WebSocket client {} is backpressured; dropping notifications",
+                      connection.client_id);
+      }
+      break;
+    case websocket_queue::PushResult::Overflow:
+      Logger().warn("WebSocket send queue overflow for client {}; closing", connection.client_id);
+      connection.socket->end(1008, "Send queue overflow");
+      break;
+    case websocket_queue::PushResult::Closed:
+      break;
+  }
+}
+
+auto remove_connection(core::AppState& state, const std::string& client_id) -> void {
+  if (!state.http_server) {
+    return;
+  }
+
+  auto& connections = state.http_server->websocket_connections;
+  auto& mtx = state.http_server->websocket_connections_mutex;
+
+  std::lock_guard<std::mutex> lock(mtx);
+  const auto removed = std::erase_if(
+      connections, [&client_id](const std::shared_ptr<WebSocketConnection>& connection) {
+        return !connection || connection->client_id == client_id;
+      });
+
+  if (removed > 0) {
+    Logger().info("WebSocket connection removed. client_id={}, total={}", client_id,
+                  connections.size());
+  }
+}
+
+// 升级前完成与 /rpc 相同的会话认证和 Origin 校验，访问等级在连接生命周期内固定
+auto handle_upgrade(core::AppState& state, auto* res, auto* req, auto* context) -> void {
+  if (!state.http_server || !state.http_server->is_running) {
+    res->close();
+    return;
+  }
+
+  const auto caller_access = core::http_server::access::resolve_http_access(
+      state, res->getRemoteAddressAsText(), req->getHeader("cookie"));
+  if (!caller_access) {
+    res->writeStatus("401 Unauthorized");
+    res->writeHeader("Cache-Control", "no-store");
+    res->writeHeader("Content-Type", "text/plain; charset=utf-8");
+    res->end("Authentication required");
+    return;
+  }
+
+  const auto origin = req->getHeader("origin");
+  if (!core::http_server::access::is_origin_allowed(origin, state.http_server->port,
+                                                    req->getHeader("host"))) {
+    Logger().warn("Rejected WebSocket upgrade due to disallowed origin: {}",
+                  origin.empty() ? "<empty>" : origin);
+    res->writeStatus("403 Forbidden");
+    res->end("Forbidden");
+    return;
+  }
+
+  auto connection = std::make_shared<WebSocketConnection>();
+  connection->client_id = std::to_string(++state.http_server->client_counter);
+  connection->access_level = *caller_access;
+  connection->connected_at = std::chrono::system_clock::now();
+
+  res->template upgrade<WebSocketUserData>(
+      WebSocketUserData{.connection = std::move(connection)},
+      req->getHeader("sec-websocket-key"), req->getHeader("sec-websocket-protocol"),
+      req->getHeader("sec-websocket-extensions"), context);
+}
+
+auto handle_open(core::AppState& state, WebSocket* socket) -> void {
+  auto connection = socket->getUserData()->connection;
+  connection->socket = socket;
+
+  size_t current_count = 0;
+  {
+    std::lock_guard<std::mutex> lock(state.http_server->websocket_connections_mutex);
+    state.http_server->websocket_connections.push_back(connection);
+    current_count = state.http_server->websocket_connections.size();
+  }
+
+  Logger().info("New WebSocket connection established. client_id={}, total={}",
+                connection->client_id, current_count);
+}
+
+// 每条消息是一个 JSON-RPC 请求或批量数组；响应回到 loop 线程后经发送队列写出
+auto handle_message(core::AppState& state, WebSocket* socket, std::string_view message) -> void {
+  auto connection = socket->getUserData()->connection;
+
+  auto* io_context = core::async::get_io_context(state);
+  if (!io_context) {
+    send_message(*connection,
+                 core::rpc::create_error_response(rfl::Generic(),
+                                                  core::rpc::ErrorCode::InternalError,
+                                                  "Async runtime is unavailable"),
+                 websocket_queue::MessageKind::Response);
+    return;
+  }
+
+  auto* loop = uWS::Loop::get();
+  asio::co_spawn(
+      *io_context,
+      [&state, connection, loop, request = std::string(message)]() -> asio::awaitable<void> {
+        // 每条连接是独立的会话，只能取消自己发起的请求
+        auto response = co_await core::rpc::process_request(
+            state, request,
+            {.access = connection->access_level, .session = "ws:" + connection->client_id});
+        // 通知不回复
+        if (response.empty()) {
+          co_return;
+        }
+        loop->defer([connection, response = std::move(response)]() mutable {
+          send_message(*connection, std::move(response), websocket_queue::MessageKind::Response);
+        });
+      },
+      core::async::log_completion("WebSocket RPC request"));
+}
+
+auto handle_close(core::AppState& state, WebSocket* socket, int code) -> void {
+  // uWS 在回调结束后销毁用户数据，这里持有一份引用供仍在途的响应判断连接已关闭
+  auto connection = socket->getUserData()->connection;
+  websocket_queue::close(connection->send_queue);
+  connection->socket = nullptr;
+
+  if (connection->send_queue.dropped_notifications > 0) {
+    Logger().info("WebSocket client {} dropped {} notifications under backpressure",
+                  connection->client_id, connection->send_queue.dropped_notifications);
+  }
+  Logger().debug("WebSocket connection closed. client_id={}, code={}", connection->client_id,
+                 code);
+  remove_connection(state, connection->client_id);
+}
+
+auto register_routes(core::AppState& state, uWS::App& app) -> void {
+  uWS::App::WebSocketBehavior<WebSocketUserData> behavior;
+  // permessage-deflate；共享压缩器内存占用最低，适合连接数少、消息以 JSON 为主的场景
+  behavior.compression = uWS::SHARED_COMPRESSOR;
+  behavior.maxPayloadLength = WEBSOCKET_MAX_PAYLOAD;
+  behavior.idleTimeout = 120;
+  // 发送队列由连接自己维护，这里只作为 uWS 内部缓冲的最终兜底
+  behavior.maxBackpressure = WEBSOCKET_MAX_QUEUED_BYTES;
+  behavior.closeOnBackpressureLimit = false;
+  behavior.resetIdleTimeoutOnSend = true;
+  behavior.sendPingsAutomatically = true;
+
+  behavior.upgrade = [&state](auto* res, auto* req, auto* context) {
+    handle_upgrade(state, res, req, context);
+  };
+  behavior.open = [&state](WebSocket* socket) { handle_open(state, socket); };
+  behavior.message = [&state](WebSocket* socket, std::string_view message, uWS::OpCode) {
+    handle_message(state, socket, message);
+  };
+  behavior.drain = [](WebSocket* socket) { flush_pending(*socket->getUserData()->connection); };
+  behavior.close = [&state](WebSocket* socket, int code, std::string_view) {
+    handle_close(state, socket, code);
+  };
+
+  app.ws<WebSocketUserData>("/ws", std::move(behavior));
+}
+
+auto close_all_connections(core::AppState& state) -> void {
+  if (!state.http_server) {
+    return;
+  }
+
+  std::vector<std::shared_ptr<WebSocketConnection>> snapshot;
+  {
+    std::lock_guard<std::mutex> lock(state.http_server->websocket_connections_mutex);
+    snapshot = std::move(state.http_server->websocket_connections);
+    state.http_server->websocket_connections.clear();
+  }
+
+  size_t closed_count = 0;
+  for (const auto& connection : snapshot) {
+    if (!connection || connection->send_queue.closed || !connection->socket) {
+      continue;
+    }
+    // 与 SSE 一致直接关闭底层连接，否则 uWS 事件循环不会退出。
+    connection->socket->close();
+    ++closed_count;
+  }
+
+  Logger().info("Closed {} WebSocket connections", closed_count);
+}
+
+// 将会话关闭动作投递到 uWS 事件循环，供其他线程安全调用。
+auto request_close_all_connections(core::AppState& state) -> void {
+  if (!state.http_server || !state.http_server->loop) {
+    return;
+  }
+
+  state.http_server->loop->defer([&state]() { close_all_connections(state); });
+}
+
+auto broadcast_notification(core::AppState& state, const std::string& payload) -> void {
+  if (!state.http_server || !state.http_server->is_running) {
+    return;
+  }
+
+  auto* loop = state.http_server->loop;
+  if (!loop) {
+    return;
+  }
+
+  loop->defer([&state, payload]() {
+    if (!state.http_server) {
+      return;
+    }
+
+    std::vector<std::shared_ptr<WebSocketConnection>> snapshot;
+    {
+      std::lock_guard<std::mutex> lock(state.http_server->websocket_connections_mutex);
+      snapshot = state.http_server->websocket_connections;
+    }
+
+    for (const auto& connection : snapshot) {
+      if (!connection || connection->send_queue.closed || !connection->socket) {
+        continue;
+      }
+      send_message(*connection, payload, websocket_queue::MessageKind::Notification);
+    }
+  });
+}
+
+auto get_connection_count(const core::AppState& state) -> size_t {
+  if (!state.http_server) {
+    return 0;
+  }
+
+  std::lock_guard<std::mutex> lock(state.http_server->websocket_connections_mutex);
+  return state.http_server->websocket_connections.size();
+}
+
+}  // namespace core::http_server::websocket
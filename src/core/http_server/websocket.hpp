@@ -0,0 +1,26 @@
+#pragma once
+
+#include "vendor/std.hpp"
+
+#include "vendor/uwebsockets.hpp"
+
+#include "core/state/app_state.hpp"
+
+namespace core::http_server::websocket {
+
+// 注册 /ws：在一条连接上复用 JSON-RPC 请求、响应和服务端通知
+auto register_routes(core::AppState& state, uWS::App& app) -> void;
+
+// 关闭所有 WebSocket 连接（应在 HTTP loop 线程调用）
+auto close_all_connections(core::AppState& state) -> void;
+
+// 将关闭请求投递到 HTTP loop，供令牌/监听配置变化等非 HTTP 线程安全地撤销会话。
+auto request_close_all_connections(core::AppState& state) -> void;
+
+// 广播 JSON-RPC 通知到所有 WebSocket 客户端（线程安全，内部会切换到 HTTP loop 线程）
+auto broadcast_notification(core::AppState& state, const std::string& payload) -> void;
+
+// 获取 WebSocket 连接数量
+auto get_connection_count(const core::AppState& state) -> size_t;
+
+}  // namespace core::http_server::websocket
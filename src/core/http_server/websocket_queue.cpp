@@ -0,0 +1,46 @@
+#include "core/http_server/websocket_queue.hpp"
+
+#include "vendor/std.hpp"
+
+namespace core::http_server::websocket_queue {
+
+auto push(SendQueue& queue, const SendQueueLimits& limits, std::string message, MessageKind kind,
+          std::size_t buffered_amount) -> PushResult {
+  if (queue.closed) {
+    return PushResult::Closed;
+  }
+
+  if (kind == MessageKind::Notification &&
+      buffered_amount + queue.bytes > limits.notification_drop_threshold) {
+    ++queue.dropped_notifications;
+    return PushResult::DroppedNotification;
+  }
+
+  queue.bytes += message.size();
+  queue.messages.push_back(std::move(message));
+  if (queue.bytes > limits.max_queued_bytes) {
+    close(queue);
+    return PushResult::Overflow;
+  }
+  return PushResult::Accepted;
+}
+
+auto pop_writable(SendQueue& queue, const SendQueueLimits& limits, std::size_t buffered_amount)
+    -> std::optional<std::string> {
+  if (queue.closed || queue.messages.empty() || buffered_amount >= limits.high_watermark) {
+    return std::nullopt;
+  }
+
+  auto message = std::move(queue.messages.front());
+  queue.messages.pop_front();
+  queue.bytes -= message.size();
+  return message;
+}
+
+auto close(SendQueue& queue) -> void {
+  queue.closed = true;
+  queue.messages.clear();
+  queue.bytes = 0;
+}
+
+}  // namespace core::http_server::websocket_queue
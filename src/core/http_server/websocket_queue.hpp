@@ -0,0 +1,48 @@
+#pragma once
+
+#include "vendor/std.hpp"
+
+namespace core::http_server::websocket_queue {
+
+// RPC 响应必须送达；通知可以由后续全量刷新补偿，背压时可以丢弃
+enum class MessageKind { Response, Notification };
+
+enum class PushResult {
+  Accepted,
+  // 缓冲加队列越过通知阈值，通知被丢弃
+  DroppedNotification,
+  // 队列总量越过上限，队列已清空并关闭，调用方应断开连接
+  Overflow,
+  // 连接已关闭，消息被忽略
+  Closed,
+};
+
+struct SendQueueLimits {
+  // socket 内部缓冲低于此值时才继续写出
+  std::size_t high_watermark = 0;
+  // socket 缓冲加队列超过此值时丢弃新的通知
+  std::size_t notification_drop_threshold = 0;
+  // 队列总量上限
+  std::size_t max_queued_bytes = 0;
+};
+
+// 单个连接的发送队列，只在 HTTP loop 线程读写
+struct SendQueue {
+  std::deque<std::string> messages;
+  std::size_t bytes = 0;
+  std::uint64_t dropped_notifications = 0;
+  bool closed = false;
+};
+
+// 消息总是先入队，再由 pop_writable 按入队顺序取出，保证响应与通知按产生顺序到达
+auto push(SendQueue& queue, const SendQueueLimits& limits, std::string message, MessageKind kind,
+          std::size_t buffered_amount) -> PushResult;
+
+// socket 缓冲低于高水位时取出队首消息；缓冲已满、队列为空或已关闭时返回空
+auto pop_writable(SendQueue& queue, const SendQueueLimits& limits, std::size_t buffered_amount)
+    -> std::optional<std::string>;
+
+// 连接关闭后丢弃积压，之后的 push 都返回 Closed
+auto close(SendQueue& queue) -> void;
+
+}  // namespace core::http_server::websocket_queue
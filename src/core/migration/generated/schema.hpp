@@ -10,3 +10,5 @@
 #include "core/migration/generated/schema_003.hpp"
 #include "core/migration/generated/schema_004.hpp"
 #include "core/migration/generated/schema_005.hpp"
+#include "core/migration/generated/schema_006.hpp"
+#include "core/migration/generated/schema_007.hpp"
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "vendor/std.hpp"
+
+// Auto-generated SQL schema header
+// DO NOT EDIT - This file is generated from
+// src/migrations/006_asset_perceptual_hash.sql
+
+namespace core::migration::schema {
+
+struct V006 {
+  static constexpr std::array<std::string_view, 2> statements = {
+      R"SQL(
+CREATE TABLE IF NOT EXISTS asset_perceptual_hashes (
+    asset_id INTEGER PRIMARY KEY REFERENCES assets(id) ON DELETE CASCADE,
+    dhash INTEGER NOT NULL,
+    algorithm_version INTEGER NOT NULL
+)
+        )SQL",
+      R"SQL(
+CREATE INDEX IF NOT EXISTS idx_asset_perceptual_hashes_version ON asset_perceptual_hashes(algorithm_version)
+        )SQL"};
+};
+
+}  // namespace core::migration::schema
@@ -0,0 +1,179 @@
+#pragma once
+
+#include "vendor/std.hpp"
+
+// Auto-generated SQL schema header
+// DO NOT EDIT - This file is generated from
+// src/migrations/007_gallery_change_log.sql
+
+namespace core::migration::schema {
+
+struct V007 {
+  static constexpr std::array<std::string_view, 15> statements = {
+      R"SQL(
+CREATE TABLE IF NOT EXISTS gallery_change_log (
+    seq INTEGER PRIMARY KEY AUTOINCREMENT,
+    entity TEXT NOT NULL CHECK (entity IN ('asset', 'folder', 'tag')),
+    entity_id INTEGER NOT NULL,
+    op TEXT NOT NULL CHECK (op IN ('upsert', 'remove'))
+)
+        )SQL",
+      R"SQL(
+CREATE TRIGGER IF NOT EXISTS gallery_change_log_assets_insert
+AFTER
+INSERT
+    ON assets FOR EACH ROW BEGIN
+INSERT INTO
+    gallery_change_log (entity, entity_id, op)
+VALUES
+    ('asset', NEW.id, 'upsert');
+END
+        )SQL",
+      R"SQL(
+DROP TRIGGER IF EXISTS update_assets_updated_at
+        )SQL",
+      R"SQL(
+CREATE TRIGGER update_assets_updated_at
+AFTER
+UPDATE
+    ON assets FOR EACH ROW BEGIN
+UPDATE
+    assets
+SET
+    updated_at = (unixepoch('subsec') * 1000)
+WHERE
+    id = NEW.id;
+INSERT INTO
+    gallery_change_log (entity, entity_id, op)
+VALUES
+    ('asset', NEW.id, 'upsert');
+END
+        )SQL",
+      R"SQL(
+CREATE TRIGGER IF NOT EXISTS gallery_change_log_assets_delete
+AFTER
+DELETE
+    ON assets FOR EACH ROW BEGIN
+INSERT INTO
+    gallery_change_log (entity, entity_id, op)
+VALUES
+    ('asset', OLD.id, 'remove');
+END
+        )SQL",
+      R"SQL(
+CREATE TRIGGER IF NOT EXISTS gallery_change_log_asset_tags_insert
+AFTER
+INSERT
+    ON asset_tags FOR EACH ROW BEGIN
+INSERT INTO
+    gallery_change_log (entity, entity_id, op)
+VALUES
+    ('asset', NEW.asset_id, 'upsert');
+END
+        )SQL",
+      R"SQL(
+CREATE TRIGGER IF NOT EXISTS gallery_change_log_asset_tags_delete
+AFTER
+DELETE
+    ON asset_tags FOR EACH ROW
+    WHEN EXISTS (
+        SELECT
+            1
+        FROM
+            assets
+        WHERE
+            id = OLD.asset_id
+    ) BEGIN
+INSERT INTO
+    gallery_change_log (entity, entity_id, op)
+VALUES
+    ('asset', OLD.asset_id, 'upsert');
+END
+        )SQL",
+      R"SQL(
+CREATE TRIGGER IF NOT EXISTS gallery_change_log_folders_insert
+AFTER
+INSERT
+    ON folders FOR EACH ROW BEGIN
+INSERT INTO
+    gallery_change_log (entity, entity_id, op)
+VALUES
+    ('folder', NEW.id, 'upsert');
+END
+        )SQL",
+      R"SQL(
+DROP TRIGGER IF EXISTS update_folders_updated_at
+        )SQL",
+      R"SQL(
+CREATE TRIGGER update_folders_updated_at
+AFTER
+UPDATE
+    ON folders FOR EACH ROW BEGIN
+UPDATE
+    folders
+SET
+    updated_at = (unixepoch('subsec') * 1000)
+WHERE
+    id = NEW.id;
+INSERT INTO
+    gallery_change_log (entity, entity_id, op)
+VALUES
+    ('folder', NEW.id, 'upsert');
+END
+        )SQL",
+      R"SQL(
+CREATE TRIGGER IF NOT EXISTS gallery_change_log_folders_delete
+AFTER
+DELETE
+    ON folders FOR EACH ROW BEGIN
+INSERT INTO
+    gallery_change_log (entity, entity_id, op)
+VALUES
+    ('folder', OLD.id, 'remove');
+END
+        )SQL",
+      R"SQL(
+CREATE TRIGGER IF NOT EXISTS gallery_change_log_tags_insert
+AFTER
+INSERT
+    ON tags FOR EACH ROW BEGIN
+INSERT INTO
+    gallery_change_log (entity, entity_id, op)
+VALUES
+    ('tag', NEW.id, 'upsert');
+END
+        )SQL",
+      R"SQL(
+DROP TRIGGER IF EXISTS update_tags_updated_at
+        )SQL",
+      R"SQL(
+CREATE TRIGGER update_tags_updated_at
+AFTER
+UPDATE
+    ON tags FOR EACH ROW BEGIN
+UPDATE
+    tags
+SET
+    updated_at = (unixepoch('subsec') * 1000)
+WHERE
+    id = NEW.id;
+INSERT INTO
+    gallery_change_log (entity, entity_id, op)
+VALUES
+    ('tag', NEW.id, 'upsert');
+END
+        )SQL",
+      R"SQL(
+CREATE TRIGGER IF NOT EXISTS gallery_change_log_tags_delete
+AFTER
+DELETE
+    ON tags FOR EACH ROW BEGIN
+INSERT INTO
+    gallery_change_log (entity, entity_id, op)
+VALUES
+    ('tag', OLD.id, 'remove');
+END
+        )SQL"};
+};
+
+}  // namespace core::migration::schema
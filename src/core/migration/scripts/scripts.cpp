@@ -13,18 +13,26 @@
 
 namespace core::migration::scripts {
 
-// 执行 SQL schema 迁移的辅助函数
 template <typename SchemaModule>
+auto execute_schema_statements(core::AppState& txn_app_state) -> std::expected<void, std::string> {
+  for (const auto& sql : SchemaModule::statements) {
+    auto result = core::database::execute(txn_app_state, std::string(sql));
+    if (!result) {
+      return std::unexpected(std::format("SQL execution failed: {}", result.error()));
+    }
+  }
+  return {};
+}
+
+// 执行 SQL schema 迁移的辅助函数；同一版本的多个 schema 在一个事务里提交，
+// 避免前一个已生效、版本号却因后一个失败没有记录
+template <typename... SchemaModules>
 auto execute_sql_schema(core::AppState& app_state) -> std::expected<void, std::string> {
   return core::database::execute_transaction(
       app_state, [](core::AppState& txn_app_state) -> std::expected<void, std::string> {
-        for (const auto& sql : SchemaModule::statements) {
-          auto result = core::database::execute(txn_app_state, std::string(sql));
-          if (!result) {
-            return std::unexpected(std::format("SQL execution failed: {}", result.error()));
-          }
-        }
-        return {};
+        std::expected<void, std::string> result;
+        ((result = execute_schema_statements<SchemaModules>(txn_app_state)) && ...);
+        return result;
       });
 }
 
@@ -125,6 +133,19 @@ auto migrate_v2_1_2_0(core::AppState& app_state) -> std::expected<void, std::str
   return {};
 }
 
+auto migrate_v2_1_6_0(core::AppState& app_state) -> std::expected<void, std::string> {
+  Logger().info(
+      "Executing migration to 2.1.6.0: Add gallery asset perceptual hashes and change log");
+
+  auto result = execute_sql_schema<core::migration::schema::V006, core::migration::schema::V007>(
+      app_state);
+  if (!result) {
+    return std::unexpected("Failed to add gallery asset perceptual hashes and change log: " +
+                           result.error());
+  }
+  return {};
+}
+
 auto migrate_v2_0_11_0(core::AppState& app_state) -> std::expected<void, std::string> {
   Logger().info("Executing migration to 2.0.11.0: Set update download sources");
 
@@ -179,6 +200,8 @@ auto get_all_migrations() -> const std::vector<MigrationScript>& {
       {"2.0.9.0", "Rebuild Infinity Nikki user record as key-value", true, migrate_v2_0_9_0},
       {"2.0.11.0", "Set update download sources", false, migrate_v2_0_11_0},
       {"2.1.2.0", "Add gallery asset missing lifecycle", true, migrate_v2_1_2_0},
+      {"2.1.6.0", "Add gallery asset perceptual hashes and change log", true,
+       migrate_v2_1_6_0},
 
       // 未来版本的迁移脚本在此添加
       // {"2.0.2.0", "Add user preferences", migrate_v2_0_2_0},
@@ -0,0 +1,46 @@
+#include "core/rpc/cancellation.hpp"
+
+#include "vendor/std.hpp"
+
+namespace core::rpc::cancellation {
+
+auto make_key(bool local_caller, std::string_view session, std::string_view id_json)
+    -> std::optional<std::string> {
+  if (session.empty() || id_json == "null") {
+    return std::nullopt;
+  }
+  // 会话由客户端提供时可能含任意字符，长度前缀保证不同的会话与 id 组合不会拼出同一个 key
+  return std::format("{}:{}:{}{}", local_caller ? "local" : "lan", session.size(), session,
+                     id_json);
+}
+
+auto add(InFlightTable& table, std::string key, std::stop_source stop_source) -> std::uint64_t {
+  std::lock_guard lock(table.mutex);
+  const auto serial = ++table.next_serial;
+  table.requests.emplace(
+      serial, InFlightRequest{.key = std::move(key), .stop_source = std::move(stop_source)});
+  return serial;
+}
+
+auto remove(InFlightTable& table, std::uint64_t serial) -> void {
+  std::lock_guard lock(table.mutex);
+  table.requests.erase(serial);
+}
+
+auto request_stop(InFlightTable& table, std::string_view key) -> std::size_t {
+  std::vector<std::stop_source> matched;
+  {
+    std::lock_guard lock(table.mutex);
+    for (const auto& [serial, request] : table.requests) {
+      if (request.key == key) {
+        matched.push_back(request.stop_source);
+      }
+    }
+  }
+  for (auto& stop_source : matched) {
+    stop_source.request_stop();
+  }
+  return matched.size();
+}
+
+}  // namespace core::rpc::cancellation
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "vendor/std.hpp"
+
+namespace core::rpc::cancellation {
+
+// 带 id 的进行中请求
+struct InFlightRequest {
+  std::string key;
+  std::stop_source stop_source;
+};
+
+struct InFlightTable {
+  std::mutex mutex;
+  std::unordered_map<std::uint64_t, InFlightRequest> requests;
+  std::uint64_t next_serial = 0;
+};
+
+// key 由访问等级、调用方会话和 id 的 JSON 文本组成：LAN 调用者不能取消本机请求，
+// 不同连接或会话即使复用同一个 id 也互不影响。
+// 会话为空或 id 为 null 时返回空，这类请求不登记，也无法被取消。
+auto make_key(bool local_caller, std::string_view session, std::string_view id_json)
+    -> std::optional<std::string>;
+
+// 登记请求，返回注销用的序号
+auto add(InFlightTable& table, std::string key, std::stop_source stop_source) -> std::uint64_t;
+
+auto remove(InFlightTable& table, std::uint64_t serial) -> void;
+
+// 停止 key 相同的全部请求并返回命中数；停止回调可能同步中断数据库语句，在锁外触发
+auto request_stop(InFlightTable& table, std::string_view key) -> std::size_t;
+
+}  // namespace core::rpc::cancellation
@@ -0,0 +1,68 @@
+#include "core/rpc/columnar.hpp"
+
+#include "vendor/std.hpp"
+
+namespace core::rpc::columnar {
+
+// 数值按本机字节序直接拷贝，只在小端平台上成立
+static_assert(std::endian::native == std::endian::little);
+
+auto append_u32(ColumnarBuilder& builder, std::uint32_t value) -> void {
+  append_bytes(builder, &value, sizeof(value));
+}
+
+auto begin_columnar(std::uint32_t row_count, std::string_view meta_json) -> ColumnarBuilder {
+  ColumnarBuilder builder;
+  builder.row_count = row_count;
+  builder.buffer.append(kMagic);
+  append_u32(builder, kVersion);
+  append_u32(builder, row_count);
+  // 列数在 finish_columnar 时回填
+  append_u32(builder, 0);
+  append_u32(builder, static_cast<std::uint32_t>(meta_json.size()));
+  builder.buffer.append(meta_json);
+  pad_to_alignment(builder);
+  return builder;
+}
+
+auto append_bytes(ColumnarBuilder& builder, const void* data, std::size_t size) -> void {
+  builder.buffer.append(static_cast<const char*>(data), size);
+}
+
+auto pad_to_alignment(ColumnarBuilder& builder) -> void {
+  const auto remainder = builder.buffer.size() % kAlignment;
+  if (remainder != 0) {
+    builder.buffer.append(kAlignment - remainder, '\0');
+  }
+}
+
+auto write_column_header(ColumnarBuilder& builder, std::string_view name, ColumnType type,
+                         bool nullable) -> std::size_t {
+  const auto name_length = static_cast<std::uint16_t>(name.size());
+  append_bytes(builder, &name_length, sizeof(name_length));
+  builder.buffer.append(name.substr(0, name_length));
+  builder.buffer.push_back(static_cast<char>(type));
+  builder.buffer.push_back(static_cast<char>(nullable ? kNullableFlag : 0));
+  pad_to_alignment(builder);
+
+  const auto length_offset = builder.buffer.size();
+  const std::uint64_t placeholder = 0;
+  append_bytes(builder, &placeholder, sizeof(placeholder));
+  ++builder.column_count;
+  return length_offset;
+}
+
+auto finish_column(ColumnarBuilder& builder, std::size_t length_offset) -> void {
+  pad_to_alignment(builder);
+  const std::uint64_t body_length = builder.buffer.size() - length_offset - sizeof(std::uint64_t);
+  std::memcpy(builder.buffer.data() + length_offset, &body_length, sizeof(body_length));
+}
+
+auto finish_columnar(ColumnarBuilder builder) -> std::string {
+  constexpr auto kColumnCountOffset = kMagic.size() + 2 * sizeof(std::uint32_t);
+  std::memcpy(builder.buffer.data() + kColumnCountOffset, &builder.column_count,
+              sizeof(builder.column_count));
+  return std::move(builder.buffer);
+}
+
+}  // namespace core::rpc::columnar
@@ -0,0 +1,143 @@
+#pragma once
+
+#include "vendor/std.hpp"
+
+namespace core::rpc::columnar {
+
+// HTTP 请求在 Accept 中带上此类型时，支持列式编码的方法直接返回二进制结果
+constexpr std::string_view kMimeType = "application/x-spinning-momo-columnar";
+
+constexpr std::string_view kMagic = "SMCF";
+constexpr std::uint32_t kVersion = 1;
+
+// 每段数据按 8 字节对齐，前端可直接在 ArrayBuffer 上建 Int32Array/BigInt64Array/Float64Array
+constexpr std::size_t kAlignment = 8;
+
+enum class ColumnType : std::uint8_t {
+  Int32 = 1,
+  Int64 = 2,
+  Float64 = 3,
+  String = 4,
+};
+
+constexpr std::uint8_t kNullableFlag = 1;
+
+// 格式（小端）：
+//   "SMCF" | u32 version | u32 row_count | u32 column_count | u32 meta_len | meta JSON | pad
+//   每列：u16 name_len | name | u8 type | u8 flags | pad | u64 body_len | body
+//   body：[可空列的 u8 有效位 × row_count | pad] 数值列 T × row_count；
+//         字符串列 u32 offsets × (row_count + 1) | pad | UTF-8 bytes；末尾补齐到 8 字节
+struct ColumnarBuilder {
+  std::string buffer;
+  std::uint32_t row_count = 0;
+  std::uint32_t column_count = 0;
+};
+
+template <typename T>
+struct OptionalTraits {
+  using Value = T;
+  static constexpr bool kNullable = false;
+};
+
+template <typename T>
+struct OptionalTraits<std::optional<T>> {
+  using Value = T;
+  static constexpr bool kNullable = true;
+};
+
+// meta_json 承载不适合按列存放的标量字段，如 totalCount
+auto begin_columnar(std::uint32_t row_count, std::string_view meta_json) -> ColumnarBuilder;
+
+auto append_bytes(ColumnarBuilder& builder, const void* data, std::size_t size) -> void;
+
+auto pad_to_alignment(ColumnarBuilder& builder) -> void;
+
+// 写出列头并预留 body 长度，返回长度字段所在位置
+auto write_column_header(ColumnarBuilder& builder, std::string_view name, ColumnType type,
+                         bool nullable) -> std::size_t;
+
+// 对齐 body 末尾并回填长度
+auto finish_column(ColumnarBuilder& builder, std::size_t length_offset) -> void;
+
+auto finish_columnar(ColumnarBuilder builder) -> std::string;
+
+template <typename T>
+constexpr auto column_type_of() -> ColumnType {
+  if constexpr (std::is_same_v<T, std::int32_t>) {
+    return ColumnType::Int32;
+  } else if constexpr (std::is_same_v<T, std::int64_t>) {
+    return ColumnType::Int64;
+  } else if constexpr (std::is_same_v<T, double>) {
+    return ColumnType::Float64;
+  } else {
+    static_assert(std::is_same_v<T, std::string>, "Unsupported columnar value type");
+    return ColumnType::String;
+  }
+}
+
+// 按投影从行结构直接写出一列，不构造中间数组；std::optional 字段编码为可空列
+template <typename Row, typename Projection>
+auto append_column(ColumnarBuilder& builder, std::string_view name, std::span<const Row> rows,
+                   Projection projection) -> void {
+  using Field = std::remove_cvref_t<std::invoke_result_t<Projection&, const Row&>>;
+  using Value = typename OptionalTraits<Field>::Value;
+  constexpr bool kNullable = OptionalTraits<Field>::kNullable;
+
+  const auto length_offset =
+      write_column_header(builder, name, column_type_of<Value>(), kNullable);
+
+  // 定长段先整体扩容再按位置写入，避免逐行追加
+  auto allocate = [&builder](std::size_t size) -> char* {
+    const auto offset = builder.buffer.size();
+    builder.buffer.resize(offset + size);
+    return builder.buffer.data() + offset;
+  };
+
+  if constexpr (kNullable) {
+    auto* validity = allocate(rows.size());
+    for (const auto& row : rows) {
+      *validity++ = std::invoke(projection, row).has_value() ? 1 : 0;
+    }
+    pad_to_alignment(builder);
+  }
+
+  auto value_of = [&projection](const Row& row) -> const Value* {
+    const auto& field = std::invoke(projection, row);
+    if constexpr (kNullable) {
+      return field ? &*field : nullptr;
+    } else {
+      return &field;
+    }
+  };
+
+  if constexpr (std::is_same_v<Value, std::string>) {
+    auto* offsets = allocate((rows.size() + 1) * sizeof(std::uint32_t));
+    std::uint32_t offset = 0;
+    std::memcpy(offsets, &offset, sizeof(offset));
+    for (const auto& row : rows) {
+      const auto* value = value_of(row);
+      offset += value ? static_cast<std::uint32_t>(value->size()) : 0;
+      offsets += sizeof(offset);
+      std::memcpy(offsets, &offset, sizeof(offset));
+    }
+    pad_to_alignment(builder);
+    builder.buffer.reserve(builder.buffer.size() + offset);
+    for (const auto& row : rows) {
+      if (const auto* value = value_of(row)) {
+        append_bytes(builder, value->data(), value->size());
+      }
+    }
+  } else {
+    auto* values = allocate(rows.size() * sizeof(Value));
+    for (const auto& row : rows) {
+      const auto* value = value_of(row);
+      const Value stored = value ? *value : Value{};
+      std::memcpy(values, &stored, sizeof(stored));
+      values += sizeof(stored);
+    }
+  }
+
+  finish_column(builder, length_offset);
+}
+
+}  // namespace core::rpc::columnar
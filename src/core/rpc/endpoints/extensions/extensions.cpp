@@ -5,6 +5,7 @@
 #include "vendor/asio.hpp"
 #include "vendor/rfl.hpp"
 
+#include "core/rpc/columnar.hpp"
 #include "core/rpc/notification_hub.hpp"
 #include "core/rpc/rpc.hpp"
 #include "core/rpc/state.hpp"
@@ -82,12 +83,36 @@ auto handle_infinity_nikki_start_initialize_media_hardlinks(
   co_return StartExtensionTaskResult{.task_id = task_result.value()};
 }
 
+// 地图点按列输出，字符串列共享一段 UTF-8 缓冲
+auto encode_photo_map_points_columnar(
+    const std::vector<::extensions::infinity_nikki::PhotoMapPoint>& points) -> std::string {
+  using ::extensions::infinity_nikki::PhotoMapPoint;
+  const std::span<const PhotoMapPoint> rows = points;
+  auto builder = core::rpc::columnar::begin_columnar(static_cast<std::uint32_t>(rows.size()), "{}");
+  core::rpc::columnar::append_column(builder, "assetId", rows, &PhotoMapPoint::asset_id);
+  core::rpc::columnar::append_column(builder, "name", rows, &PhotoMapPoint::name);
+  core::rpc::columnar::append_column(builder, "hash", rows, &PhotoMapPoint::hash);
+  core::rpc::columnar::append_column(builder, "fileCreatedAt", rows,
+                                     &PhotoMapPoint::file_created_at);
+  core::rpc::columnar::append_column(builder, "nikkiLocX", rows, &PhotoMapPoint::nikki_loc_x);
+  core::rpc::columnar::append_column(builder, "nikkiLocY", rows, &PhotoMapPoint::nikki_loc_y);
+  core::rpc::columnar::append_column(builder, "nikkiLocZ", rows, &PhotoMapPoint::nikki_loc_z);
+  core::rpc::columnar::append_column(builder, "lat", rows, &PhotoMapPoint::lat);
+  core::rpc::columnar::append_column(builder, "lng", rows, &PhotoMapPoint::lng);
+  core::rpc::columnar::append_column(builder, "worldId", rows, &PhotoMapPoint::world_id);
+  core::rpc::columnar::append_column(builder, "officialWorldId", rows,
+                                     &PhotoMapPoint::official_world_id);
+  core::rpc::columnar::append_column(builder, "assetIndex", rows, &PhotoMapPoint::asset_index);
+  return core::rpc::columnar::finish_columnar(std::move(builder));
+}
+
 auto handle_infinity_nikki_query_photo_map_points(
     core::AppState& app_state,
-    const ::extensions::infinity_nikki::QueryPhotoMapPointsParams& params)
+    const ::extensions::infinity_nikki::QueryPhotoMapPointsParams& params,
+    std::stop_token stop_token)
     -> core::rpc::RpcAwaitable<std::vector<::extensions::infinity_nikki::PhotoMapPoint>> {
   auto result = co_await ::extensions::infinity_nikki::asset_service::query_photo_map_points(
-      app_state, params);
+      app_state, params, stop_token);
   if (!result) {
     co_return std::unexpected(core::rpc::RpcError{
         .code = static_cast<int>(core::rpc::ErrorCode::ServerError),
@@ -262,7 +287,7 @@ auto register_all(core::AppState& app_state) -> void {
       handle_infinity_nikki_query_photo_map_points,
       "Query Infinity Nikki photo map points using the current gallery filters",
       // 地图 iframe 属于第三方 origin，LAN 模式不能安全地向其提供本地缩略图鉴权。
-      core::rpc::AccessLevel::local);
+      core::rpc::AccessLevel::local, false, encode_photo_map_points_columnar);
 
   core::rpc::register_method<::extensions::infinity_nikki::GetInfinityNikkiDetailsParams,
                              ::extensions::infinity_nikki::InfinityNikkiDetails>(
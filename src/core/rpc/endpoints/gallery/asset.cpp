@@ -3,7 +3,10 @@
 #include "vendor/std.hpp"
 
 #include "vendor/asio.hpp"
+#include "vendor/rfl.hpp"
 
+#include "core/database/database.hpp"
+#include "core/rpc/columnar.hpp"
 #include "core/rpc/notification_hub.hpp"
 #include "core/rpc/rpc.hpp"
 #include "core/rpc/state.hpp"
@@ -40,11 +43,55 @@ struct CheckAssetReachableResult {
   std::optional<std::string> reason;
 };
 
+struct LayoutMetaColumnarMeta {
+  std::int32_t total_count = 0;
+};
+
+struct TimelineColumnarMeta {
+  int total_count = 0;
+  std::optional<std::int64_t> active_asset_index;
+};
+
+// ============= 列式编码 =============
+
+// 10 万级条目的布局元数据按 id/width/height 三列输出
+auto encode_layout_meta_columnar(const features::gallery::QueryAssetLayoutMetaResponse& response)
+    -> std::string {
+  using features::gallery::AssetLayoutMetaItem;
+  const std::span<const AssetLayoutMetaItem> items = response.items;
+  auto builder = columnar::begin_columnar(
+      static_cast<std::uint32_t>(items.size()),
+      rfl::json::write<rfl::SnakeCaseToCamelCase>(
+          LayoutMetaColumnarMeta{.total_count = response.total_count}));
+  columnar::append_column(builder, "id", items, &AssetLayoutMetaItem::id);
+  columnar::append_column(builder, "width", items, &AssetLayoutMetaItem::width);
+  columnar::append_column(builder, "height", items, &AssetLayoutMetaItem::height);
+  return columnar::finish_columnar(std::move(builder));
+}
+
+auto encode_timeline_buckets_columnar(const features::gallery::TimelineBucketsResponse& response)
+    -> std::string {
+  using features::gallery::TimelineBucket;
+  const std::span<const TimelineBucket> buckets = response.buckets;
+  auto builder = columnar::begin_columnar(
+      static_cast<std::uint32_t>(buckets.size()),
+      rfl::json::write<rfl::SnakeCaseToCamelCase>(TimelineColumnarMeta{
+          .total_count = response.total_count,
+          .active_asset_index = response.active_asset_index}));
+  columnar::append_column(builder, "month", buckets, &TimelineBucket::month);
+  columnar::append_column(builder, "count", buckets, &TimelineBucket::count);
+  return columnar::finish_columnar(std::move(builder));
+}
+
 // ============= 时间线视图 RPC 处理函数 =============
 
+// 查询类处理器可被 $/cancelRequest 取消；处理器体内没有 co_await，取消作用域不会跨越挂起点
+
 auto handle_get_timeline_buckets(core::AppState& app_state,
-                                 const features::gallery::TimelineBucketsParams& params)
+                                 const features::gallery::TimelineBucketsParams& params,
+                                 std::stop_token stop_token)
     -> RpcAwaitable<features::gallery::TimelineBucketsResponse> {
+  core::database::CancellationScope cancellation_scope(stop_token);
   auto result = features::gallery::asset::service::get_timeline_buckets(app_state, params);
 
   if (!result) {
@@ -56,8 +103,10 @@ auto handle_get_timeline_buckets(core::AppState& app_state,
 }
 
 auto handle_get_assets_by_month(core::AppState& app_state,
-                                const features::gallery::GetAssetsByMonthParams& params)
+                                const features::gallery::GetAssetsByMonthParams& params,
+                                std::stop_token stop_token)
     -> RpcAwaitable<features::gallery::GetAssetsByMonthResponse> {
+  core::database::CancellationScope cancellation_scope(stop_token);
   auto result = features::gallery::asset::service::get_assets_by_month(app_state, params);
 
   if (!result) {
@@ -71,8 +120,10 @@ auto handle_get_assets_by_month(core::AppState& app_state,
 // ============= 统一查询 RPC 处理函数 =============
 
 auto handle_query_assets(core::AppState& app_state,
-                         const features::gallery::QueryAssetsParams& params)
+                         const features::gallery::QueryAssetsParams& params,
+                         std::stop_token stop_token)
     -> RpcAwaitable<features::gallery::ListResponse> {
+  core::database::CancellationScope cancellation_scope(stop_token);
   auto result = features::gallery::asset::service::query_assets(app_state, params);
 
   if (!result) {
@@ -84,8 +135,10 @@ auto handle_query_assets(core::AppState& app_state,
 }
 
 auto handle_query_asset_layout_meta(core::AppState& app_state,
-                                    const features::gallery::QueryAssetLayoutMetaParams& params)
+                                    const features::gallery::QueryAssetLayoutMetaParams& params,
+                                    std::stop_token stop_token)
     -> RpcAwaitable<features::gallery::QueryAssetLayoutMetaResponse> {
+  core::database::CancellationScope cancellation_scope(stop_token);
   auto result = features::gallery::asset::service::query_asset_layout_meta(app_state, params);
 
   if (!result) {
@@ -96,6 +149,21 @@ auto handle_query_asset_layout_meta(core::AppState& app_state,
   co_return result.value();
 }
 
+auto handle_query_asset_layout(core::AppState& app_state,
+                               const features::gallery::QueryAssetLayoutParams& params,
+                               std::stop_token stop_token)
+    -> RpcAwaitable<features::gallery::QueryAssetLayoutResponse> {
+  core::database::CancellationScope cancellation_scope(stop_token);
+  auto result = features::gallery::asset::service::query_asset_layout(app_state, params);
+
+  if (!result) {
+    co_return std::unexpected(RpcError{.code = static_cast<int>(ErrorCode::ServerError),
+                                       .message = "Service error: " + result.error()});
+  }
+
+  co_return result.value();
+}
+
 auto handle_get_asset_main_colors(core::AppState& app_state,
                                   const features::gallery::GetAssetMainColorsParams& params)
     -> RpcAwaitable<std::vector<features::gallery::AssetMainColor>> {
@@ -122,8 +190,10 @@ auto handle_get_home_stats(core::AppState& app_state, [[maybe_unused]] const Emp
 }
 
 auto handle_get_batch_selection_summary(
-    core::AppState& app_state, const features::gallery::BatchSelectionSummaryParams& params)
+    core::AppState& app_state, const features::gallery::BatchSelectionSummaryParams& params,
+    std::stop_token stop_token)
     -> RpcAwaitable<features::gallery::BatchSelectionSummary> {
+  core::database::CancellationScope cancellation_scope(stop_token);
   auto result = features::gallery::asset::service::get_batch_selection_summary(app_state, params);
 
   if (!result) {
@@ -408,48 +478,55 @@ auto register_all(core::AppState& app_state) -> void {
   register_method<features::gallery::TimelineBucketsParams,
                   features::gallery::TimelineBucketsResponse>(
       app_state, app_state.rpc->registry, "gallery.getTimelineBuckets", handle_get_timeline_buckets,
-      "Get timeline buckets (months) with asset counts for timeline view", AccessLevel::lan);
+      "Get timeline buckets (months) with asset counts for timeline view", AccessLevel::lan, true,
+      encode_timeline_buckets_columnar);
 
   register_method<features::gallery::GetAssetsByMonthParams,
                   features::gallery::GetAssetsByMonthResponse>(
       app_state, app_state.rpc->registry, "gallery.getAssetsByMonth", handle_get_assets_by_month,
-      "Get all assets for a specific month in timeline view", AccessLevel::lan);
+      "Get all assets for a specific month in timeline view", AccessLevel::lan, true);
 
   // 统一资产查询接口
   register_method<features::gallery::QueryAssetsParams, features::gallery::ListResponse>(
       app_state, app_state.rpc->registry, "gallery.queryAssets", handle_query_assets,
       "Unified asset query interface with flexible filters (folder, month, year, type, search) "
       "and optional pagination",
-      AccessLevel::lan);
+      AccessLevel::lan, true);
 
   register_method<features::gallery::QueryAssetLayoutMetaParams,
                   features::gallery::QueryAssetLayoutMetaResponse>(
       app_state, app_state.rpc->registry, "gallery.queryAssetLayoutMeta",
       handle_query_asset_layout_meta,
       "Query lightweight asset layout metadata for adaptive gallery layout calculation",
-      AccessLevel::lan);
+      AccessLevel::lan, true, encode_layout_meta_columnar);
+
+  register_method<features::gallery::QueryAssetLayoutParams,
+                  features::gallery::QueryAssetLayoutResponse>(
+      app_state, app_state.rpc->registry, "gallery.queryAssetLayout", handle_query_asset_layout,
+      "Compute the justified gallery layout and return the rows inside the scroll window",
+      AccessLevel::lan, true);
 
   register_method<features::gallery::GetAssetMainColorsParams,
                   std::vector<features::gallery::AssetMainColor>>(
       app_state, app_state.rpc->registry, "gallery.getAssetMainColors",
       handle_get_asset_main_colors, "Get extracted main colors for the specified asset",
-      AccessLevel::lan);
+      AccessLevel::lan, true);
 
   register_method<EmptyParams, features::gallery::HomeStats>(
       app_state, app_state.rpc->registry, "gallery.getHomeStats", handle_get_home_stats,
-      "Get home page gallery stats summary", AccessLevel::lan);
+      "Get home page gallery stats summary", AccessLevel::lan, true);
 
   register_method<features::gallery::BatchSelectionSummaryParams,
                   features::gallery::BatchSelectionSummary>(
       app_state, app_state.rpc->registry, "gallery.getBatchSelectionSummary",
       handle_get_batch_selection_summary,
       "Get the aggregated review and common-tag summary for the current selection",
-      AccessLevel::lan);
+      AccessLevel::lan, true);
 
   register_method<EmptyParams, features::gallery::MissingAssetsResponse>(
       app_state, app_state.rpc->registry, "gallery.getMissingAssets", handle_get_missing_assets,
       "List assets in the missing recovery period and their reclaimable thumbnail storage",
-      AccessLevel::lan);
+      AccessLevel::lan, true);
 
   register_method<features::gallery::PurgeMissingAssetsParams,
                   features::gallery::PurgeMissingAssetsResult>(
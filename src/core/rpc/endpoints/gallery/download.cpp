@@ -97,7 +97,10 @@ auto prepare_on_worker(core::AppState& app_state, std::vector<std::int64_t> ids)
               asio::post(*io_context, [handler_holder, result = std::move(result)]() mutable {
                 (*handler_holder)(std::move(result));
               });
-            });
+            },
+            // 用户正在等待下载，排在扫描和回填等后台任务之前
+            {.priority = core::worker_pool::TaskPriority::Interactive,
+             .tag = core::worker_pool::TaskTag::GalleryDownload});
 
         if (!submitted) {
           // 提交失败也必须完成 handler，否则调用方会一直等待。
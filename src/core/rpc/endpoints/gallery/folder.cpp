@@ -100,7 +100,7 @@ auto register_all(core::AppState& app_state) -> void {
   // 文件夹树
   register_method<EmptyParams, std::vector<features::gallery::FolderTreeNode>>(
       app_state, app_state.rpc->registry, "gallery.getFolderTree", handle_get_folder_tree,
-      "Get folder tree structure for navigation", AccessLevel::lan);
+      "Get folder tree structure for navigation", AccessLevel::lan, true);
 
   register_method<CreateFolderParams, features::gallery::OperationResult>(
       app_state, app_state.rpc->registry, "gallery.createFolder", handle_create_folder,
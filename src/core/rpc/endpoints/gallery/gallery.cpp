@@ -8,6 +8,7 @@
 #include "core/rpc/endpoints/gallery/asset.hpp"
 #include "core/rpc/endpoints/gallery/download.hpp"
 #include "core/rpc/endpoints/gallery/folder.hpp"
+#include "core/rpc/endpoints/gallery/similarity.hpp"
 #include "core/rpc/endpoints/gallery/tag.hpp"
 #include "core/rpc/notification_hub.hpp"
 #include "core/rpc/rpc.hpp"
@@ -15,6 +16,7 @@
 #include "core/rpc/types.hpp"
 #include "core/state/app_state.hpp"
 #include "core/tasks/tasks.hpp"
+#include "features/gallery/change_log/service.hpp"
 #include "features/gallery/gallery.hpp"
 #include "features/gallery/types.hpp"
 #include "utils/logger/logger.hpp"
@@ -114,6 +116,21 @@ auto handle_start_scan_directory(core::AppState& app_state,
   co_return StartScanDirectoryResult{.task_id = task_id};
 }
 
+// ============= 增量变更 RPC 处理函数 =============
+
+auto handle_get_changes_since(core::AppState& app_state,
+                              const features::gallery::GalleryChangesSinceParams& params)
+    -> RpcAwaitable<features::gallery::GalleryChangesSinceResponse> {
+  auto result = features::gallery::change_log::service::get_changes_since(app_state, params);
+
+  if (!result) {
+    co_return std::unexpected(RpcError{.code = static_cast<int>(ErrorCode::ServerError),
+                                       .message = "Service error: " + result.error()});
+  }
+
+  co_return result.value();
+}
+
 // ============= 缩略图 RPC 处理函数 =============
 
 auto handle_cleanup_thumbnails(core::AppState& app_state,
@@ -153,6 +170,7 @@ auto register_all(core::AppState& app_state) -> void {
   download::register_all(app_state);
   tag::register_all(app_state);
   folder::register_all(app_state);
+  similarity::register_all(app_state);
 
   // 扫描和索引
   register_method<features::gallery::ScanOptions, features::gallery::ScanResult>(
@@ -164,6 +182,14 @@ auto register_all(core::AppState& app_state) -> void {
       app_state, app_state.rpc->registry, "gallery.startScanDirectory", handle_start_scan_directory,
       "Create a background scan task for the gallery and return task id immediately.");
 
+  // 增量变更
+  register_method<features::gallery::GalleryChangesSinceParams,
+                  features::gallery::GalleryChangesSinceResponse>(
+      app_state, app_state.rpc->registry, "gallery.changesSince", handle_get_changes_since,
+      "Return deduplicated asset, folder and tag changes after a change log cursor, or "
+      "resyncRequired when the cursor has been trimmed",
+      AccessLevel::lan, true);
+
   // 缩略图操作
   register_method<EmptyParams, features::gallery::OperationResult>(
       app_state, app_state.rpc->registry, "gallery.cleanupThumbnails", handle_cleanup_thumbnails,
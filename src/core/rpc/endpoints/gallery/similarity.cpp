@@ -0,0 +1,151 @@
+#include "core/rpc/endpoints/gallery/similarity.hpp"
+
+#include "vendor/std.hpp"
+
+#include "vendor/asio.hpp"
+
+#include "core/async/async.hpp"
+#include "core/rpc/notification_hub.hpp"
+#include "core/rpc/rpc.hpp"
+#include "core/rpc/state.hpp"
+#include "core/rpc/types.hpp"
+#include "core/state/app_state.hpp"
+#include "core/tasks/tasks.hpp"
+#include "features/gallery/similarity/service.hpp"
+#include "features/gallery/types.hpp"
+#include "utils/logger/logger.hpp"
+
+namespace core::rpc::endpoints::gallery::similarity {
+
+struct StartPerceptualHashBackfillResult {
+  std::string task_id;
+};
+
+auto launch_perceptual_hash_backfill_task(core::AppState& app_state, const std::string& task_id)
+    -> void {
+  auto* io_context = core::async::get_io_context(app_state);
+  if (!io_context) {
+    core::tasks::complete_task_failed(app_state, task_id, "Async runtime is not available");
+    return;
+  }
+
+  asio::co_spawn(
+      *io_context,
+      [&app_state, task_id]() -> asio::awaitable<void> {
+        // 先让出执行权，RPC 立即返回 task_id，解码在后续调度中进行。
+        co_await asio::post(asio::use_awaitable);
+
+        core::tasks::mark_task_running(app_state, task_id);
+
+        auto progress_callback = [&app_state,
+                                  &task_id](const features::gallery::ScanProgress& progress) {
+          core::tasks::TaskProgress task_progress{
+              .stage = progress.stage,
+              .current = progress.current,
+              .total = progress.total,
+              .percent = progress.percent,
+              .message = progress.message,
+          };
+          core::tasks::update_task_progress(app_state, task_id, task_progress);
+        };
+
+        auto backfill_result = features::gallery::similarity::service::backfill_perceptual_hashes(
+            app_state, progress_callback);
+        if (!backfill_result) {
+          auto error_message = "Perceptual hash backfill failed: " + backfill_result.error();
+          Logger().error("{}", error_message);
+          core::tasks::complete_task_failed(app_state, task_id, error_message);
+          co_return;
+        }
+
+        const auto& result = backfill_result.value();
+        core::tasks::update_task_progress(
+            app_state, task_id,
+            core::tasks::TaskProgress{
+                .stage = "completed",
+                .current = result.hashed_count + result.failed_count,
+                .total = result.total_candidates,
+                .percent = 100.0,
+                .message = std::format("Hashed {}, failed {}", result.hashed_count,
+                                       result.failed_count),
+            });
+        core::tasks::complete_task_success(app_state, task_id);
+        core::rpc::notification_hub::send_notification(app_state, "gallery.changed");
+      },
+      core::async::log_completion("Gallery perceptual hash backfill task"));
+}
+
+// ============= 相似图 RPC 处理函数 =============
+
+auto handle_find_similar_assets(core::AppState& app_state,
+                                const features::gallery::FindSimilarAssetsParams& params)
+    -> RpcAwaitable<features::gallery::FindSimilarAssetsResponse> {
+  auto result = features::gallery::similarity::service::find_similar_assets(app_state, params);
+
+  if (!result) {
+    co_return std::unexpected(RpcError{.code = static_cast<int>(ErrorCode::ServerError),
+                                       .message = "Service error: " + result.error()});
+  }
+
+  co_return result.value();
+}
+
+auto handle_group_near_duplicates(core::AppState& app_state,
+                                  const features::gallery::GroupNearDuplicatesParams& params)
+    -> RpcAwaitable<features::gallery::GroupNearDuplicatesResponse> {
+  auto result = features::gallery::similarity::service::group_near_duplicates(app_state, params);
+
+  if (!result) {
+    co_return std::unexpected(RpcError{.code = static_cast<int>(ErrorCode::ServerError),
+                                       .message = "Service error: " + result.error()});
+  }
+
+  co_return result.value();
+}
+
+auto handle_start_perceptual_hash_backfill(core::AppState& app_state,
+                                           [[maybe_unused]] const EmptyParams& params)
+    -> RpcAwaitable<StartPerceptualHashBackfillResult> {
+  constexpr auto kTaskType = "gallery.perceptualHashBackfill";
+  if (core::tasks::has_active_task_of_type(app_state, kTaskType)) {
+    co_return std::unexpected(
+        RpcError{.code = static_cast<int>(ErrorCode::InvalidRequest),
+                 .message = "Another perceptual hash backfill task is already running"});
+  }
+
+  auto task_id = core::tasks::create_task(app_state, kTaskType);
+  if (task_id.empty()) {
+    co_return std::unexpected(
+        RpcError{.code = static_cast<int>(ErrorCode::ServerError),
+                 .message = "Failed to create perceptual hash backfill task"});
+  }
+
+  launch_perceptual_hash_backfill_task(app_state, task_id);
+
+  co_return StartPerceptualHashBackfillResult{.task_id = task_id};
+}
+
+// ============= RPC 方法注册 =============
+
+auto register_all(core::AppState& app_state) -> void {
+  register_method<features::gallery::FindSimilarAssetsParams,
+                  features::gallery::FindSimilarAssetsResponse>(
+      app_state, app_state.rpc->registry, "gallery.findSimilarAssets", handle_find_similar_assets,
+      "Find assets whose perceptual hash is within the given Hamming distance of an asset",
+      AccessLevel::lan);
+
+  register_method<features::gallery::GroupNearDuplicatesParams,
+                  features::gallery::GroupNearDuplicatesResponse>(
+      app_state, app_state.rpc->registry, "gallery.groupNearDuplicates",
+      handle_group_near_duplicates,
+      "Group filtered assets into near-duplicate and burst-shot clusters by perceptual hash",
+      AccessLevel::lan);
+
+  register_method<EmptyParams, StartPerceptualHashBackfillResult>(
+      app_state, app_state.rpc->registry, "gallery.startPerceptualHashBackfill",
+      handle_start_perceptual_hash_backfill,
+      "Create a background task that computes perceptual hashes for photos indexed before "
+      "hashing existed and return task id immediately.");
+}
+
+}  // namespace core::rpc::endpoints::gallery::similarity
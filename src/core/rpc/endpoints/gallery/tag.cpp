@@ -179,7 +179,7 @@ auto register_all(core::AppState& app_state) -> void {
   // 标签管理
   register_method<EmptyParams, std::vector<features::gallery::TagTreeNode>>(
       app_state, app_state.rpc->registry, "gallery.getTagTree", handle_get_tag_tree,
-      "Get tag tree structure for navigation", AccessLevel::lan);
+      "Get tag tree structure for navigation", AccessLevel::lan, true);
 
   register_method<features::gallery::CreateTagParams, std::int64_t>(
       app_state, app_state.rpc->registry, "gallery.createTag", handle_create_tag,
@@ -195,7 +195,7 @@ auto register_all(core::AppState& app_state) -> void {
 
   register_method<EmptyParams, std::vector<features::gallery::TagStats>>(
       app_state, app_state.rpc->registry, "gallery.getTagStats", handle_get_tag_stats,
-      "Get tag usage statistics", AccessLevel::lan);
+      "Get tag usage statistics", AccessLevel::lan, true);
 
   // 资产-标签关联
   register_method<features::gallery::AddTagsToAssetParams, features::gallery::OperationResult>(
@@ -216,12 +216,12 @@ auto register_all(core::AppState& app_state) -> void {
 
   register_method<features::gallery::GetAssetTagsParams, std::vector<features::gallery::Tag>>(
       app_state, app_state.rpc->registry, "gallery.getAssetTags", handle_get_asset_tags,
-      "Get all tags for a specific asset", AccessLevel::lan);
+      "Get all tags for a specific asset", AccessLevel::lan, true);
 
   register_method<GetTagsByAssetIdsParams,
                   std::unordered_map<std::int64_t, std::vector<features::gallery::Tag>>>(
       app_state, app_state.rpc->registry, "gallery.getTagsByAssetIds", handle_get_tags_by_asset_ids,
-      "Batch get tags for multiple assets", AccessLevel::lan);
+      "Batch get tags for multiple assets", AccessLevel::lan, true);
 }
 
 }  // namespace core::rpc::endpoints::gallery::tag
@@ -0,0 +1,88 @@
+#include "core/rpc/endpoints/system/system.hpp"
+
+#include "vendor/std.hpp"
+
+#include "vendor/asio.hpp"
+
+#include "core/database/state.hpp"
+#include "core/executor_metrics/executor_metrics.hpp"
+#include "core/rpc/rpc.hpp"
+#include "core/rpc/state.hpp"
+#include "core/rpc/types.hpp"
+#include "core/state/app_state.hpp"
+#include "core/tracing/tracing.hpp"
+#include "core/worker_pool/state.hpp"
+#include "utils/logger/logger.hpp"
+#include "utils/path/path.hpp"
+#include "utils/time.hpp"
+
+namespace core::rpc::endpoints::system {
+
+struct SetExecutorMetricsParams {
+  bool enabled = false;
+};
+
+// 线程池与数据库执行器共用一个开关；结果见内置 system.getMetrics（rpc.cpp）的 executors 字段
+auto handle_set_executor_metrics(core::AppState& app_state, const SetExecutorMetricsParams& params)
+    -> RpcAwaitable<bool> {
+  if (app_state.worker_pool) {
+    core::executor_metrics::set_enabled(app_state.worker_pool->metrics, params.enabled);
+  }
+  if (app_state.database) {
+    core::executor_metrics::set_enabled(app_state.database->metrics, params.enabled);
+  }
+  Logger().info("Executor metrics {}", params.enabled ? "enabled" : "disabled");
+  co_return params.enabled;
+}
+
+struct SetTracingParams {
+  bool enabled = false;
+};
+
+// 开启时清空之前记录的区间
+auto handle_set_tracing([[maybe_unused]] core::AppState& app_state, const SetTracingParams& params)
+    -> RpcAwaitable<bool> {
+  core::tracing::set_recording(params.enabled);
+  Logger().info("Span tracing {}", params.enabled ? "enabled" : "disabled");
+  co_return params.enabled;
+}
+
+struct DumpTraceParams {};
+
+// 写入日志目录下的 traces 子目录，返回文件路径，可直接在 Perfetto 或 chrome://tracing 打开
+auto handle_dump_trace([[maybe_unused]] core::AppState& app_state,
+                       [[maybe_unused]] const DumpTraceParams& params)
+    -> RpcAwaitable<std::string> {
+  auto logs_dir_result = utils::path::GetAppDataSubdirectory("logs");
+  if (!logs_dir_result) {
+    co_return std::unexpected(core::rpc::RpcError{
+        .code = static_cast<int>(core::rpc::ErrorCode::ServerError),
+        .message = "Failed to get logs directory: " + logs_dir_result.error()});
+  }
+
+  const auto trace_path = logs_dir_result.value() / "traces" /
+                          std::format("trace_{}.json", utils::time::current_millis());
+  if (auto dump_result = core::tracing::dump_chrome_trace(trace_path); !dump_result) {
+    co_return std::unexpected(
+        core::rpc::RpcError{.code = static_cast<int>(core::rpc::ErrorCode::ServerError),
+                            .message = dump_result.error()});
+  }
+  Logger().info("Span trace written to {}", trace_path.string());
+  co_return trace_path.string();
+}
+
+auto register_all(core::AppState& app_state) -> void {
+  core::rpc::register_method<SetExecutorMetricsParams, bool>(
+      app_state, app_state.rpc->registry, "system.setExecutorMetrics",
+      handle_set_executor_metrics,
+      "Enable or disable queue wait, run time and utilization tracking for the worker pool and "
+      "database executor");
+  core::rpc::register_method<SetTracingParams, bool>(
+      app_state, app_state.rpc->registry, "system.setTracing", handle_set_tracing,
+      "Start or stop recording span traces for scans, database jobs, HTTP and RPC calls");
+  core::rpc::register_method<DumpTraceParams, std::string>(
+      app_state, app_state.rpc->registry, "system.dumpTrace", handle_dump_trace,
+      "Write recorded spans as Chrome trace JSON and return the file path");
+}
+
+}  // namespace core::rpc::endpoints::system
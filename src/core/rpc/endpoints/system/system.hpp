@@ -0,0 +1,12 @@
+#pragma once
+
+#include "vendor/std.hpp"
+
+#include "core/state/app_state.hpp"
+
+namespace core::rpc::endpoints::system {
+
+// 注册本机诊断开关；指标查询由 rpc.cpp 内置的 system.getMetrics 统一返回。
+auto register_all(core::AppState& app_state) -> void;
+
+}  // namespace core::rpc::endpoints::system
@@ -0,0 +1,97 @@
+#include "core/rpc/metrics.hpp"
+
+#include "vendor/std.hpp"
+
+namespace core::rpc::metrics {
+
+auto latency_bucket_index(std::uint64_t micros) -> std::size_t {
+  // 小于 8 微秒时每微秒一个桶
+  if (micros < kLatencySubBucketCount) {
+    return static_cast<std::size_t>(micros);
+  }
+  const auto exponent = static_cast<std::size_t>(std::bit_width(micros) - 1);
+  if (exponent >= kLatencyMaxExponent) {
+    return kLatencyBucketCount - 1;
+  }
+  const auto shift = exponent - kLatencySubBucketBits;
+  const auto sub_bucket = static_cast<std::size_t>(micros >> shift) - kLatencySubBucketCount;
+  return (shift + 1) * kLatencySubBucketCount + sub_bucket;
+}
+
+auto latency_bucket_upper_bound(std::size_t index) -> std::uint64_t {
+  if (index < kLatencySubBucketCount) {
+    return index;
+  }
+  const auto shift = index / kLatencySubBucketCount - 1;
+  const auto sub_bucket = index % kLatencySubBucketCount;
+  const auto lower = static_cast<std::uint64_t>(kLatencySubBucketCount + sub_bucket) << shift;
+  return lower + (std::uint64_t{1} << shift) - 1;
+}
+
+auto record_latency(LatencyHistogram& histogram, std::chrono::steady_clock::duration elapsed)
+    -> void {
+  const auto micros = static_cast<std::uint64_t>(std::max<std::int64_t>(
+      0, std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()));
+  histogram.buckets[latency_bucket_index(micros)].fetch_add(1, std::memory_order_relaxed);
+  histogram.total_us.fetch_add(micros, std::memory_order_relaxed);
+
+  auto current_max = histogram.max_us.load(std::memory_order_relaxed);
+  while (micros > current_max &&
+         !histogram.max_us.compare_exchange_weak(current_max, micros,
+                                                 std::memory_order_relaxed)) {
+  }
+}
+
+auto record_since(LatencyHistogram& histogram, std::chrono::steady_clock::time_point start)
+    -> std::chrono::steady_clock::time_point {
+  const auto now = std::chrono::steady_clock::now();
+  record_latency(histogram, now - start);
+  return now;
+}
+
+auto snapshot_latency(const LatencyHistogram& histogram) -> LatencySnapshot {
+  std::array<std::uint64_t, kLatencyBucketCount> counts{};
+  std::uint64_t bucket_total = 0;
+  for (std::size_t i = 0; i < kLatencyBucketCount; ++i) {
+    counts[i] = histogram.buckets[i].load(std::memory_order_relaxed);
+    bucket_total += counts[i];
+  }
+
+  LatencySnapshot snapshot{.count = bucket_total,
+                           .total_us = histogram.total_us.load(std::memory_order_relaxed),
+                           .max_us = histogram.max_us.load(std::memory_order_relaxed)};
+  if (bucket_total == 0) {
+    return snapshot;
+  }
+
+  // 按桶累计到目标名次，分位数不超过已观测的最大值
+  auto percentile = [&](double quantile) -> std::uint64_t {
+    const auto rank = std::max<std::uint64_t>(
+        1, static_cast<std::uint64_t>(std::ceil(quantile * static_cast<double>(bucket_total))));
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < kLatencyBucketCount; ++i) {
+      seen += counts[i];
+      if (seen >= rank) {
+        return std::min(latency_bucket_upper_bound(i), snapshot.max_us);
+      }
+    }
+    return snapshot.max_us;
+  };
+  snapshot.p50_us = percentile(0.5);
+  snapshot.p90_us = percentile(0.9);
+  snapshot.p99_us = percentile(0.99);
+  snapshot.p999_us = percentile(0.999);
+  return snapshot;
+}
+
+auto snapshot_method(std::string method, const MethodMetrics& metrics) -> MethodMetricsSnapshot {
+  return MethodMetricsSnapshot{.method = std::move(method),
+                               .calls = metrics.calls.load(std::memory_order_relaxed),
+                               .errors = metrics.errors.load(std::memory_order_relaxed),
+                               .in_flight = metrics.in_flight.load(std::memory_order_relaxed),
+                               .parse = snapshot_latency(metrics.parse),
+                               .handler = snapshot_latency(metrics.handler),
+                               .serialize = snapshot_latency(metrics.serialize)};
+}
+
+}  // namespace core::rpc::metrics
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "vendor/std.hpp"
+
+namespace core::rpc::metrics {
+
+// 对数-线性分桶（HDR 风格）：每个 2 的幂区间再均分 8 份，相对误差不超过 12.5%
+constexpr std::size_t kLatencySubBucketBits = 3;
+constexpr std::size_t kLatencySubBucketCount = std::size_t{1} << kLatencySubBucketBits;
+// 覆盖到 2^24 微秒（约 16.8 秒），更慢的样本计入最后一个桶
+constexpr std::size_t kLatencyMaxExponent = 24;
+constexpr std::size_t kLatencyBucketCount =
+    (kLatencyMaxExponent - kLatencySubBucketBits + 1) * kLatencySubBucketCount;
+
+// 只用 relaxed 原子累加，记录路径无锁；快照与记录并发时允许各字段之间略有出入
+struct LatencyHistogram {
+  std::array<std::atomic<std::uint64_t>, kLatencyBucketCount> buckets{};
+  std::atomic<std::uint64_t> total_us{0};
+  std::atomic<std::uint64_t> max_us{0};
+};
+
+// 分位数取所在桶的上界，单位均为微秒
+struct LatencySnapshot {
+  std::uint64_t count = 0;
+  std::uint64_t total_us = 0;
+  std::uint64_t max_us = 0;
+  std::uint64_t p50_us = 0;
+  std::uint64_t p90_us = 0;
+  std::uint64_t p99_us = 0;
+  std::uint64_t p999_us = 0;
+};
+
+// 每个注册方法一份，解析参数、业务处理器和结果序列化分开计时
+struct MethodMetrics {
+  std::atomic<std::uint64_t> calls{0};
+  std::atomic<std::uint64_t> errors{0};
+  std::atomic<std::int64_t> in_flight{0};
+  LatencyHistogram parse;
+  LatencyHistogram handler;
+  LatencyHistogram serialize;
+};
+
+struct MethodMetricsSnapshot {
+  std::string method;
+  std::uint64_t calls = 0;
+  std::uint64_t errors = 0;
+  std::int64_t in_flight = 0;
+  LatencySnapshot parse;
+  LatencySnapshot handler;
+  LatencySnapshot serialize;
+};
+
+// 随协程帧析构递减，异常和提前返回路径同样生效
+struct InFlightGauge {
+  std::atomic<std::int64_t>& gauge;
+
+  explicit InFlightGauge(std::atomic<std::int64_t>& value) : gauge(value) {
+    gauge.fetch_add(1, std::memory_order_relaxed);
+  }
+  ~InFlightGauge() { gauge.fetch_sub(1, std::memory_order_relaxed); }
+
+  InFlightGauge(const InFlightGauge&) = delete;
+  auto operator=(const InFlightGauge&) -> InFlightGauge& = delete;
+};
+
+auto latency_bucket_index(std::uint64_t micros) -> std::size_t;
+
+// 桶内最大的微秒值
+auto latency_bucket_upper_bound(std::size_t index) -> std::uint64_t;
+
+auto record_latency(LatencyHistogram& histogram, std::chrono::steady_clock::duration elapsed)
+    -> void;
+
+// 记录从 start 到现在的耗时，返回的当前时间可直接作为下一阶段的起点
+auto record_since(LatencyHistogram& histogram, std::chrono::steady_clock::time_point start)
+    -> std::chrono::steady_clock::time_point;
+
+auto snapshot_latency(const LatencyHistogram& histogram) -> LatencySnapshot;
+
+auto snapshot_method(std::string method, const MethodMetrics& metrics) -> MethodMetricsSnapshot;
+
+}  // namespace core::rpc::metrics
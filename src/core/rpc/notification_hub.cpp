@@ -4,6 +4,7 @@
 
 #include "core/events/events.hpp"
 #include "core/http_server/sse_manager.hpp"
+#include "core/http_server/websocket.hpp"
 #include "core/state/app_state.hpp"
 #include "core/webview/events.hpp"
 #include "utils/logger/logger.hpp"
@@ -16,7 +17,7 @@ auto build_json_rpc_notification(const std::string& method, const std::string& p
 }
 
 auto send_notification(core::AppState& state, const std::string& method,
-                       const std::string& params_json) -> void {
+                       const std::string& params_json, std::string coalesce_key) -> void {
   auto payload = build_json_rpc_notification(method, params_json);
 
   if (state.events) {
@@ -24,8 +25,14 @@ auto send_notification(core::AppState& state, const std::string& method,
     core::events::post(state, core::webview::events::WebViewResponseEvent{payload});
   }
 
-  // 浏览器开发模式也用同一份通知（SSE）。
-  core::http_server::sse_manager::broadcast_event(state, payload);
+  // 无参数通知只表示“有变化”，积压时保留一条即可
+  if (coalesce_key.empty() && params_json == "{}") {
+    coalesce_key = method;
+  }
+
+  // 浏览器开发模式和 LAN 客户端也用同一份通知（SSE 与 WebSocket）。
+  core::http_server::sse_manager::broadcast_event(state, payload, std::move(coalesce_key));
+  core::http_server::websocket::broadcast_notification(state, payload);
 
   Logger().debug("Notification dispatched: {}", method);
 }
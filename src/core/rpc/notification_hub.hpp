@@ -6,8 +6,11 @@
 
 namespace core::rpc::notification_hub {
 
-// 同时分发到 WebView 和 SSE 的统一通知出口
+// 同时分发到 WebView、SSE 和 WebSocket 的统一通知出口
+// coalesce_key 相同的通知在慢 SSE 客户端的队列里只保留最新一条；
+// 为空且不带参数时按方法名合并，如 gallery.changed。
 auto send_notification(core::AppState& state, const std::string& method,
-                       const std::string& params_json = "{}") -> void;
+                       const std::string& params_json = "{}", std::string coalesce_key = "")
+    -> void;
 
 }  // namespace core::rpc::notification_hub
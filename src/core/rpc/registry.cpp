@@ -12,10 +12,12 @@
 #include "core/rpc/endpoints/registry/registry.hpp"
 #include "core/rpc/endpoints/runtime_info/runtime_info.hpp"
 #include "core/rpc/endpoints/settings/settings.hpp"
+#include "core/rpc/endpoints/system/system.hpp"
 #include "core/rpc/endpoints/tasks/tasks.hpp"
 #include "core/rpc/endpoints/update/update.hpp"
 #include "core/rpc/endpoints/webview/webview.hpp"
 #include "core/rpc/endpoints/window_control/window_control.hpp"
+#include "core/rpc/rpc.hpp"
 #include "core/state/app_state.hpp"
 #include "utils/logger/logger.hpp"
 
@@ -40,6 +42,9 @@ auto register_all_endpoints(core::AppState& state) -> void {
   // 注册设置端点
   endpoints::settings::register_all(state);
 
+  // 注册运行指标端点
+  endpoints::system::register_all(state);
+
   // 注册后台任务端点
   endpoints::tasks::register_all(state);
 
@@ -68,6 +73,9 @@ auto register_all_endpoints(core::AppState& state) -> void {
   endpoints::window_control::register_all(state);
 
   Logger().info("RPC endpoints registration completed");
+
+  // 注册表此后不再变化，周期指标日志可以安全遍历
+  core::rpc::start_metrics_log(state);
 }
 
 }  // namespace core::rpc::registry
@@ -5,9 +5,18 @@
 #include "vendor/asio.hpp"
 #include "vendor/rfl.hpp"
 
+#include "core/async/async.hpp"
+#include "core/database/state.hpp"
+#include "core/executor_metrics/executor_metrics.hpp"
+#include "core/http_server/file_cache.hpp"
+#include "core/http_server/state.hpp"
+#include "core/rpc/cancellation.hpp"
+#include "core/rpc/single_flight.hpp"
 #include "core/rpc/state.hpp"
 #include "core/rpc/types.hpp"
 #include "core/state/app_state.hpp"
+#include "core/worker_pool/state.hpp"
+#include "core/worker_pool/worker_pool.hpp"
 #include "utils/logger/logger.hpp"
 
 namespace core::rpc {
@@ -21,6 +30,24 @@ auto create_error_response(rfl::Generic request_id, ErrorCode error_code,
   return rfl::json::write<rfl::SnakeCaseToCamelCase>(error_response);
 }
 
+auto create_cancelled_response(core::AppState& app_state, rfl::Generic request_id,
+                               bool handler_started) -> std::string {
+  auto& metrics = app_state.rpc->cancellation_metrics;
+  (handler_started ? metrics.cancelled_in_flight : metrics.cancelled_before_start)
+      .fetch_add(1, std::memory_order_relaxed);
+  return create_error_response(std::move(request_id), ErrorCode::RequestCancelled,
+                               "Request cancelled");
+}
+
+auto create_call_error_response(core::AppState& app_state, rfl::Generic request_id,
+                                const RpcError& error, bool handler_started) -> std::string {
+  const auto error_code = static_cast<ErrorCode>(error.code);
+  if (error_code == ErrorCode::RequestCancelled) {
+    return create_cancelled_response(app_state, std::move(request_id), handler_started);
+  }
+  return create_error_response(std::move(request_id), error_code, error.message);
+}
+
 // 获取当前访问等级可以调用的已注册方法列表。
 auto get_method_list(const core::AppState& app_state, AccessLevel caller_access)
     -> std::vector<MethodListItem> {
@@ -37,14 +64,268 @@ auto get_method_list(const core::AppState& app_state, AccessLevel caller_access)
   return methods;
 }
 
+auto snapshot_batch_metrics(const BatchMetrics& metrics) -> BatchMetricsSnapshot {
+  BatchMetricsSnapshot snapshot{.batches = metrics.batches.load(std::memory_order_relaxed),
+                                .calls = metrics.calls.load(std::memory_order_relaxed),
+                                .rejected = metrics.rejected.load(std::memory_order_relaxed),
+                                .size_buckets = {}};
+  snapshot.size_buckets.reserve(kBatchSizeBucketCount);
+  for (std::size_t i = 0; i < kBatchSizeBucketCount; ++i) {
+    snapshot.size_buckets.push_back(
+        BatchSizeBucket{.max_size = std::uint64_t{1} << i,
+                        .count = metrics.size_buckets[i].load(std::memory_order_relaxed)});
+  }
+  return snapshot;
+}
+
+auto snapshot_cancellation_metrics(const core::AppState& app_state)
+    -> CancellationMetricsSnapshot {
+  const auto& metrics = app_state.rpc->cancellation_metrics;
+  CancellationMetricsSnapshot snapshot{
+      .requested = metrics.requested.load(std::memory_order_relaxed),
+      .unmatched = metrics.unmatched.load(std::memory_order_relaxed),
+      .cancelled_before_start = metrics.cancelled_before_start.load(std::memory_order_relaxed),
+      .cancelled_in_flight = metrics.cancelled_in_flight.load(std::memory_order_relaxed),
+      .database_jobs_skipped = 0,
+      .database_jobs_interrupted = 0};
+  if (app_state.database) {
+    snapshot.database_jobs_skipped =
+        app_state.database->cancelled_jobs.load(std::memory_order_relaxed);
+    snapshot.database_jobs_interrupted =
+        app_state.database->interrupted_jobs.load(std::memory_order_relaxed);
+  }
+  return snapshot;
+}
+
+auto snapshot_single_flight_metrics(const SingleFlightMetrics& metrics)
+    -> SingleFlightMetricsSnapshot {
+  return SingleFlightMetricsSnapshot{
+      .executions = metrics.executions.load(std::memory_order_relaxed),
+      .joined = metrics.joined.load(std::memory_order_relaxed)};
+}
+
+auto snapshot_method_metrics(const core::AppState& app_state)
+    -> std::vector<metrics::MethodMetricsSnapshot> {
+  std::vector<metrics::MethodMetricsSnapshot> snapshots;
+  for (const auto& [name, info] : app_state.rpc->registry) {
+    if (info.metrics && info.metrics->calls.load(std::memory_order_relaxed) > 0) {
+      snapshots.push_back(metrics::snapshot_method(name, *info.metrics));
+    }
+  }
+  std::ranges::sort(snapshots, {}, &metrics::MethodMetricsSnapshot::method);
+  return snapshots;
+}
+
+auto task_source_name(std::size_t index) -> std::string {
+  return std::string(
+      core::worker_pool::task_tag_name(static_cast<core::worker_pool::TaskTag>(index)));
+}
+
+auto snapshot_executor_metrics(core::AppState& app_state)
+    -> std::vector<executor_metrics::ExecutorMetricsSnapshot> {
+  std::vector<executor_metrics::ExecutorMetricsSnapshot> snapshots;
+  if (app_state.worker_pool) {
+    auto& pool = *app_state.worker_pool;
+    snapshots.push_back(executor_metrics::snapshot("worker_pool", pool.metrics,
+                                                   pool.worker_threads.size(), task_source_name));
+  }
+  if (app_state.database) {
+    auto& database = *app_state.database;
+    snapshots.push_back(executor_metrics::snapshot("database", database.metrics,
+                                                   database.thread_count, task_source_name));
+  }
+  return snapshots;
+}
+
+auto snapshot_static_file_cache(core::AppState& app_state)
+    -> std::optional<core::http_server::file_cache::StaticFileCacheStats> {
+  if (!app_state.http_server || !app_state.http_server->file_cache) {
+    return std::nullopt;
+  }
+  return core::http_server::file_cache::get_stats(*app_state.http_server->file_cache);
+}
+
+constexpr auto kMetricsLogInterval = std::chrono::minutes(1);
+
+// 只输出上次之后有新调用的方法，空闲时不刷日志
+auto log_method_metrics_loop(core::AppState& app_state) -> asio::awaitable<void> {
+  asio::steady_timer timer(co_await asio::this_coro::executor);
+  std::unordered_map<std::string, std::uint64_t> logged_calls;
+  while (true) {
+    timer.expires_after(kMetricsLogInterval);
+    std::error_code wait_error;
+    co_await timer.async_wait(asio::redirect_error(asio::use_awaitable, wait_error));
+    if (wait_error) {
+      co_return;
+    }
+
+    for (const auto& [name, info] : app_state.rpc->registry) {
+      if (!info.metrics) {
+        continue;
+      }
+      const auto calls = info.metrics->calls.load(std::memory_order_relaxed);
+      auto& last_calls = logged_calls[name];
+      if (calls == last_calls) {
+        continue;
+      }
+      last_calls = calls;
+
+      const auto snapshot = metrics::snapshot_method(name, *info.metrics);
+      Logger().debug(
+          "RPC metrics {}: calls={} errors={} in_flight={} handler p50/p99/max={}/{}/{}us "
+          "parse p99={}us serialize p99={}us",
+          snapshot.method, snapshot.calls, snapshot.errors, snapshot.in_flight,
+          snapshot.handler.p50_us, snapshot.handler.p99_us, snapshot.handler.max_us,
+          snapshot.parse.p99_us, snapshot.serialize.p99_us);
+    }
+  }
+}
+
+// 只为已开启指标的执行器采样；关闭时每秒只多两次原子读取
+auto sample_executor_metrics(core::AppState& app_state) -> void {
+  const auto now = std::chrono::steady_clock::now();
+  const auto timestamp_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                std::chrono::system_clock::now().time_since_epoch())
+                                .count();
+  if (app_state.worker_pool && app_state.worker_pool->metrics.enabled.load()) {
+    auto& pool = *app_state.worker_pool;
+    executor_metrics::record_sample(pool.metrics, pool.queued_tasks.load(),
+                                    pool.worker_threads.size(), now, timestamp_ms);
+  }
+  if (app_state.database && app_state.database->metrics.enabled.load()) {
+    auto& database = *app_state.database;
+    std::size_t queue_depth = 0;
+    {
+      std::lock_guard lock(database.queue_mutex);
+      queue_depth = database.task_queue.size();
+    }
+    executor_metrics::record_sample(database.metrics, queue_depth, database.thread_count, now,
+                                    timestamp_ms);
+  }
+}
+
+// 汇总最近一个日志周期内的样本，再逐个来源输出排队与执行耗时
+auto log_executor_metrics(core::AppState& app_state) -> void {
+  constexpr auto kWindow =
+      static_cast<std::size_t>(kMetricsLogInterval / executor_metrics::kSampleInterval);
+  for (const auto& snapshot : snapshot_executor_metrics(app_state)) {
+    if (!snapshot.enabled || snapshot.samples.empty()) {
+      continue;
+    }
+    const auto window =
+        std::span(snapshot.samples).last(std::min(kWindow, snapshot.samples.size()));
+    double utilization = 0.0;
+    std::uint64_t max_queue_depth = 0;
+    for (const auto& sample : window) {
+      utilization += sample.utilization;
+      max_queue_depth = std::max(max_queue_depth, sample.queue_depth);
+    }
+    Logger().debug(
+        "Executor metrics {}: workers={} utilization={:.1f}% max_queue_depth={} running={}",
+        snapshot.executor, snapshot.workers,
+        utilization * 100.0 / static_cast<double>(window.size()), max_queue_depth,
+        window.back().running);
+    for (const auto& source : snapshot.sources) {
+      Logger().debug(
+          "Executor metrics {}/{}: tasks={} wait p50/p99={}/{}us run p50/p99/max={}/{}/{}us",
+          snapshot.executor, source.source, source.tasks, source.queue_wait.p50_us,
+          source.queue_wait.p99_us, source.run.p50_us, source.run.p99_us, source.run.max_us);
+    }
+  }
+}
+
+auto sample_executor_metrics_loop(core::AppState& app_state) -> asio::awaitable<void> {
+  asio::steady_timer timer(co_await asio::this_coro::executor);
+  auto next_log_at = std::chrono::steady_clock::now() + kMetricsLogInterval;
+  while (true) {
+    timer.expires_after(executor_metrics::kSampleInterval);
+    std::error_code wait_error;
+    co_await timer.async_wait(asio::redirect_error(asio::use_awaitable, wait_error));
+    if (wait_error) {
+      co_return;
+    }
+
+    sample_executor_metrics(app_state);
+    if (std::chrono::steady_clock::now() >= next_log_at) {
+      next_log_at += kMetricsLogInterval;
+      log_executor_metrics(app_state);
+    }
+  }
+}
+
+// 没有 id 的通知和没有会话的调用者都无法取消，不登记
+auto make_cancellation_key(const Caller& caller, const rfl::Generic& request_id)
+    -> std::optional<std::string> {
+  return cancellation::make_key(caller.access == AccessLevel::local, caller.session,
+                                rfl::json::write(request_id));
+}
+
+// 请求结束或协程帧销毁时从进行中表注销
+struct InFlightRegistration {
+  cancellation::InFlightTable* table = nullptr;
+  std::uint64_t serial = 0;
+
+  InFlightRegistration() = default;
+  ~InFlightRegistration() {
+    if (table) {
+      cancellation::remove(*table, serial);
+    }
+  }
+
+  InFlightRegistration(const InFlightRegistration&) = delete;
+  auto operator=(const InFlightRegistration&) -> InFlightRegistration& = delete;
+};
+
+auto begin_in_flight(RpcState& state, InFlightRegistration& registration, const Caller& caller,
+                     const rfl::Generic& request_id) -> std::stop_token {
+  auto key = make_cancellation_key(caller, request_id);
+  if (!key) {
+    return {};
+  }
+
+  std::stop_source stop_source;
+  auto stop_token = stop_source.get_token();
+  registration.serial =
+      cancellation::add(state.in_flight, std::move(key.value()), std::move(stop_source));
+  registration.table = &state.in_flight;
+  return stop_token;
+}
+
+// 同一调用方复用 id 时一并取消；请求已结束时只计数，不报错
+auto handle_cancel_request(core::AppState& app_state, const JsonRpcRequest& request,
+                           rfl::Generic request_id, const Caller& caller) -> std::string {
+  auto params_result = rfl::from_generic<CancelRequestParams, rfl::SnakeCaseToCamelCase>(
+      request.params.value_or(rfl::Generic::Object()));
+  if (!params_result) {
+    return create_error_response(request_id, ErrorCode::InvalidParams,
+                                 "Invalid parameters: " + params_result.error().what());
+  }
+  const auto& target_id = params_result.value().id;
+  if (rfl::json::write(target_id) == "null") {
+    return create_error_response(request_id, ErrorCode::InvalidParams,
+                                 "Invalid parameters: id must not be null");
+  }
+
+  auto& state = *app_state.rpc;
+  state.cancellation_metrics.requested.fetch_add(1, std::memory_order_relaxed);
+
+  // 没有会话的调用者自己的请求也未登记，只能返回未命中
+  const auto key = make_cancellation_key(caller, target_id);
+  const auto matched = key ? cancellation::request_stop(state.in_flight, key.value()) : 0;
+  if (matched == 0) {
+    state.cancellation_metrics.unmatched.fetch_add(1, std::memory_order_relaxed);
+  }
+  return write_success_response(matched > 0, std::move(request_id));
+}
+
 // 处理系统内置方法，并在查询元数据时应用调用者访问等级。
 auto handle_system_method(core::AppState& app_state, const JsonRpcRequest& request,
-                          rfl::Generic request_id, AccessLevel caller_access)
+                          rfl::Generic request_id, const Caller& caller)
     -> std::optional<std::string> {
   if (request.method == "system.listMethods") {
     JsonRpcSuccessResponse success_response;
     success_response.id = request_id;
-    success_response.result = rfl::to_generic(get_method_list(app_state, caller_access));
+    success_response.result = rfl::to_generic(get_method_list(app_state, caller.access));
     return rfl::json::write<rfl::SnakeCaseToCamelCase>(success_response);
   }
 
@@ -53,10 +334,31 @@ auto handle_system_method(core::AppState& app_state, const JsonRpcRequest& reque
     JsonRpcSuccessResponse success_response;
     success_response.id = request_id;
     success_response.result = rfl::to_generic(
-        caller_access == AccessLevel::local ? std::string{"local"} : std::string{"lan"});
+        caller.access == AccessLevel::local ? std::string{"local"} : std::string{"lan"});
     return rfl::json::write<rfl::SnakeCaseToCamelCase>(success_response);
   }
 
+  if (request.method == "system.getMetrics") {
+    // 运行指标只对本机开放
+    if (caller.access < AccessLevel::local) {
+      return create_error_response(request_id, ErrorCode::AccessDenied,
+                                   "Access denied for this method");
+    }
+    return write_success_response(
+        MetricsResponse{.batch = snapshot_batch_metrics(app_state.rpc->batch_metrics),
+                        .cancellation = snapshot_cancellation_metrics(app_state),
+                        .single_flight = snapshot_single_flight_metrics(
+                            app_state.rpc->single_flight_metrics),
+                        .methods = snapshot_method_metrics(app_state),
+                        .executors = snapshot_executor_metrics(app_state),
+                        .static_file_cache = snapshot_static_file_cache(app_state)},
+        request_id);
+  }
+
+  if (request.method == "$/cancelRequest") {
+    return handle_cancel_request(app_state, request, std::move(request_id), caller);
+  }
+
   if (request.method == "system.methodSignature") {
     // 提前验证参数
     if (!request.params.has_value()) {
@@ -82,7 +384,7 @@ auto handle_system_method(core::AppState& app_state, const JsonRpcRequest& reque
     }
 
     // 方法签名本身也属于能力信息，未授权调用者不能用它探测受限接口。
-    if (caller_access < method_it->second.required_access) {
+    if (caller.access < method_it->second.required_access) {
       return create_error_response(request_id, ErrorCode::AccessDenied,
                                    "Access denied for this method");
     }
@@ -101,14 +403,30 @@ auto handle_system_method(core::AppState& app_state, const JsonRpcRequest& reque
   return std::nullopt;  // 不是系统方法
 }
 
-// 执行已完成参数转换的业务处理器，并统一转换异常结果。
-auto execute_registered_method(const MethodInfo& method_info, rfl::Generic params_generic,
-                               rfl::Generic request_id) -> RpcJsonAwaitable {
+auto start_metrics_log(core::AppState& app_state) -> void {
+  auto* io_context = core::async::get_io_context(app_state);
+  if (!io_context) {
+    Logger().warn("IO context unavailable, RPC metrics log disabled");
+    return;
+  }
+  asio::co_spawn(*io_context, log_method_metrics_loop(app_state),
+                 core::async::log_completion("RPC metrics log"));
+  asio::co_spawn(*io_context, sample_executor_metrics_loop(app_state),
+                 core::async::log_completion("Executor metrics sampler"));
+}
+
+// 调用业务处理器，并统一转换异常结果。
+auto invoke_method_handler(const MethodInfo& method_info, rfl::Generic params_generic,
+                           rfl::Generic request_id, std::stop_token stop_token)
+    -> RpcJsonAwaitable {
   try {
-    auto response_json = co_await method_info.handler(params_generic, request_id);
+    auto response_json = co_await method_info.handler(params_generic, request_id, stop_token);
     Logger().trace("Response: {}", response_json);
     co_return response_json;
   } catch (const std::exception& e) {
+    if (method_info.metrics) {
+      method_info.metrics->errors.fetch_add(1, std::memory_order_relaxed);
+    }
     Logger().error("Internal error during method execution: {}", e.what());
     co_return create_error_response(
         request_id, ErrorCode::InternalError,
@@ -116,55 +434,348 @@ auto execute_registered_method(const MethodInfo& method_info, rfl::Generic param
   }
 }
 
-// 解析 JSON-RPC 请求、执行内置方法，并在业务调用前检查访问等级。
-auto process_request(core::AppState& app_state, const std::string& request_json,
-                     AccessLevel caller_access) -> RpcJsonAwaitable {
+// 对象键按字典序重排、数组保持顺序，参数书写顺序不同的相同调用得到同一个 key
+auto canonicalize_params(const rfl::Generic& value) -> rfl::Generic {
+  if (auto object = value.to_object()) {
+    std::vector<std::pair<std::string, rfl::Generic>> fields(object.value().begin(),
+                                                             object.value().end());
+    std::ranges::stable_sort(fields, {}, &std::pair<std::string, rfl::Generic>::first);
+    rfl::Generic::Object canonical;
+    for (const auto& [key, field] : fields) {
+      canonical[key] = canonicalize_params(field);
+    }
+    return canonical;
+  }
+  if (auto array = value.to_array()) {
+    rfl::Generic::Array canonical;
+    canonical.reserve(array.value().size());
+    for (const auto& item : array.value()) {
+      canonical.push_back(canonicalize_params(item));
+    }
+    return canonical;
+  }
+  return value;
+}
+
+// 调用共享执行入口，异常按内部错误交给全部参与者
+auto invoke_result_handler(const MethodInfo& method_info, rfl::Generic params_generic,
+                           std::stop_token stop_token) -> RpcOutcomeAwaitable {
   try {
-    // 解析JSON-RPC请求
-    auto request_result = rfl::json::read<JsonRpcRequest, rfl::SnakeCaseToCamelCase>(request_json);
-    if (!request_result) {
-      const auto error_msg = "Parse error: " + std::string(request_result.error().what());
-      Logger().error(error_msg);
-      co_return create_error_response(rfl::Generic(), ErrorCode::ParseError, error_msg);
+    co_return co_await method_info.result_handler(std::move(params_generic), stop_token);
+  } catch (const std::exception& e) {
+    if (method_info.metrics) {
+      method_info.metrics->errors.fetch_add(1, std::memory_order_relaxed);
+    }
+    Logger().error("Internal error during method execution: {}", e.what());
+    single_flight::Outcome outcome;
+    outcome.error_code = static_cast<int>(ErrorCode::InternalError);
+    outcome.error_message = "Internal error during method execution: " + std::string(e.what());
+    co_return outcome;
+  }
+}
+
+auto wait_shared_outcome(single_flight::Table& table, std::shared_ptr<single_flight::Run> run)
+    -> asio::awaitable<std::shared_ptr<const single_flight::Outcome>> {
+  using Completion = void(std::shared_ptr<const single_flight::Outcome>);
+  co_return co_await asio::async_initiate<decltype(asio::use_awaitable), Completion>(
+      [&table, run](auto handler) {
+        // 结果可能在执行者所在线程交付，投递回等待者自己的执行器
+        single_flight::wait(
+            table, *run,
+            [handler = std::move(handler)](
+                std::shared_ptr<const single_flight::Outcome> outcome) mutable {
+              auto executor = asio::get_associated_executor(handler);
+              asio::post(executor, [handler = std::move(handler),
+                                    outcome = std::move(outcome)]() mutable {
+                std::move(handler)(std::move(outcome));
+              });
+            });
+      },
+      asio::use_awaitable);
+}
+
+// 按调用方自己的 id 写出共享结果的信封
+auto write_shared_response(core::AppState& app_state, const single_flight::Outcome& outcome,
+                           rfl::Generic request_id) -> std::string {
+  if (outcome.result_json) {
+    return single_flight::write_success_envelope(outcome.result_json.value(),
+                                                 rfl::json::write(request_id));
+  }
+  return create_call_error_response(
+      app_state, std::move(request_id),
+      RpcError{.code = outcome.error_code, .message = outcome.error_message},
+      outcome.handler_started);
+}
+
+// 单飞执行：首个调用者执行，其余调用者等待同一份结果，各自写出带自己 id 的信封。
+// 加入者不经过包装层，调用次数、等待耗时与错误在这里按方法记录
+auto execute_shared_call(core::AppState& app_state, const MethodInfo& method_info,
+                         rfl::Generic params_generic, rfl::Generic request_id,
+                         std::stop_token stop_token, std::uint64_t arrival) -> RpcJsonAwaitable {
+  auto& state = *app_state.rpc;
+  auto& table = state.single_flight;
+  const auto key = std::format("{}\n{}", method_info.name,
+                               rfl::json::write(canonicalize_params(params_generic)));
+  auto [shared_run, is_leader] = single_flight::join(table, key, arrival);
+  auto run = std::move(shared_run);
+  (is_leader ? state.single_flight_metrics.executions : state.single_flight_metrics.joined)
+      .fetch_add(1, std::memory_order_relaxed);
+
+  // 单个参与者取消只计数，全部取消后才停止共享执行
+  std::stop_callback on_cancel(stop_token, [&table, run] { single_flight::cancel(table, *run); });
+
+  if (is_leader) {
+    auto outcome = std::make_shared<const single_flight::Outcome>(co_await invoke_result_handler(
+        method_info, std::move(params_generic), run->stop_source.get_token()));
+    for (auto& waiter : single_flight::finish(table, key, run, outcome)) {
+      waiter(outcome);
+    }
+    // 共享执行自身被取消时结果已是 RequestCancelled；否则只有本调用者取消
+    if (stop_token.stop_requested() && !run->stop_source.stop_requested()) {
+      method_info.metrics->errors.fetch_add(1, std::memory_order_relaxed);
+      co_return create_cancelled_response(app_state, std::move(request_id), true);
     }
+    co_return write_shared_response(app_state, *outcome, std::move(request_id));
+  }
+
+  auto& method_metrics = *method_info.metrics;
+  method_metrics.calls.fetch_add(1, std::memory_order_relaxed);
+  metrics::InFlightGauge in_flight(method_metrics.in_flight);
+  auto phase_start = std::chrono::steady_clock::now();
+
+  auto outcome = co_await wait_shared_outcome(table, run);
+  phase_start = metrics::record_since(method_metrics.handler, phase_start);
+
+  if (stop_token.stop_requested() && !run->stop_source.stop_requested()) {
+    method_metrics.errors.fetch_add(1, std::memory_order_relaxed);
+    co_return create_cancelled_response(app_state, std::move(request_id), true);
+  }
+  if (!outcome->result_json) {
+    method_metrics.errors.fetch_add(1, std::memory_order_relaxed);
+  }
+  auto response = write_shared_response(app_state, *outcome, std::move(request_id));
+  metrics::record_since(method_metrics.serialize, phase_start);
+  co_return response;
+}
+
+// 登记进行中请求后执行；幂等方法走单飞执行
+auto execute_registered_method(core::AppState& app_state, const MethodInfo& method_info,
+                               rfl::Generic params_generic, rfl::Generic request_id,
+                               const Caller& caller, std::uint64_t arrival) -> RpcJsonAwaitable {
+  InFlightRegistration registration;
+  auto stop_token = begin_in_flight(*app_state.rpc, registration, caller, request_id);
+  if (method_info.idempotent) {
+    co_return co_await execute_shared_call(app_state, method_info, std::move(params_generic),
+                                           std::move(request_id), stop_token, arrival);
+  }
+  co_return co_await invoke_method_handler(method_info, std::move(params_generic),
+                                           std::move(request_id), stop_token);
+}
+
+// 通过版本与权限校验、等待执行的业务调用
+struct PreparedCall {
+  const MethodInfo* method = nullptr;
+  rfl::Generic params;
+  rfl::Generic id;
+  // 没有 id 的通知照常执行，但不返回响应
+  bool notification = false;
+};
+
+// 执行内置方法，并在业务调用前检查访问等级。
+// 返回字符串时表示请求已经得到完整的 JSON 响应（错误或系统方法结果）。
+auto prepare_parsed_call(core::AppState& app_state, const JsonRpcRequest& request,
+                         const Caller& caller) -> std::variant<PreparedCall, std::string> {
+  const rfl::Generic request_id = request.id.value_or(rfl::Generic());
+
+  // 验证JSON-RPC版本
+  if (request.jsonrpc != "2.0") {
+    const auto error_msg = "Invalid request: jsonrpc must be '2.0'";
+    Logger().error(error_msg);
+    return create_error_response(request_id, ErrorCode::InvalidRequest, error_msg);
+  }
+
+  // JSON-RPC 2.0 禁止回复通知：之后的结果和错误都丢弃，只有无效请求仍按 null id 回复
+  const bool notification = !request.id.has_value();
+  auto reply = [notification](std::string response) {
+    return notification ? std::string{} : std::move(response);
+  };
+
+  // 处理系统内置方法
+  if (auto system_response = handle_system_method(app_state, request, request_id, caller)) {
+    return reply(std::move(system_response.value()));
+  }
+
+  // 查找已注册的方法
+  const auto& registry = app_state.rpc->registry;
+  const auto method_it = registry.find(request.method);
+  if (method_it == registry.end()) {
+    const auto error_msg = "Method not found: " + request.method;
+    Logger().error(error_msg);
+    return reply(create_error_response(request_id, ErrorCode::MethodNotFound, error_msg));
+  }
+
+  // 这是所有注册 RPC 的最终权限闸门，不能只依赖前端隐藏按钮。
+  if (caller.access < method_it->second.required_access) {
+    Logger().warn("Rejected RPC method '{}' for insufficient access level", request.method);
+    return reply(create_error_response(request_id, ErrorCode::AccessDenied,
+                                       "Access denied for this method"));
+  }
+
+  // 准备参数
+  return PreparedCall{.method = &method_it->second,
+                      .params = request.params.value_or(rfl::Generic::Object()),
+                      .id = request_id,
+                      .notification = notification};
+}
+
+// 解析单个 JSON-RPC 请求对象后交给 prepare_parsed_call
+auto prepare_call(core::AppState& app_state, const std::string& request_json,
+                  const Caller& caller) -> std::variant<PreparedCall, std::string> {
+  auto request_result = rfl::json::read<JsonRpcRequest, rfl::SnakeCaseToCamelCase>(request_json);
+  if (!request_result) {
+    const auto error_msg = "Parse error: " + std::string(request_result.error().what());
+    Logger().error(error_msg);
+    return create_error_response(rfl::Generic(), ErrorCode::ParseError, error_msg);
+  }
+  return prepare_parsed_call(app_state, request_result.value(), caller);
+}
 
-    auto request = request_result.value();
-    const rfl::Generic request_id = request.id.value_or(rfl::Generic());
+auto is_batch_request(std::string_view request_json) -> bool {
+  const auto first = request_json.find_first_not_of(" \t\r\n");
+  return first != std::string_view::npos && request_json[first] == '[';
+}
+
+auto record_batch_size(BatchMetrics& metrics, std::size_t size) -> void {
+  metrics.batches.fetch_add(1, std::memory_order_relaxed);
+  metrics.calls.fetch_add(size, std::memory_order_relaxed);
+  const auto bucket =
+      std::min<std::size_t>(std::bit_width(size - 1), kBatchSizeBucketCount - 1);
+  metrics.size_buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+using BatchOperation = decltype(asio::co_spawn(std::declval<asio::any_io_executor>(),
+                                               std::declval<RpcJsonAwaitable>(), asio::deferred));
+
+// JSON-RPC 2.0 批量请求：每个调用单独解析并经过访问等级闸门，
+// 业务调用在同一执行器上并发运行，响应按请求顺序拼成数组。
+// 通知不占数组位置；整批都是通知时不返回任何内容。
+auto process_batch_request(core::AppState& app_state, const std::string& request_json,
+                           const Caller& caller, std::uint64_t arrival) -> RpcJsonAwaitable {
+  auto batch_result = rfl::json::read<std::vector<rfl::Generic>>(request_json);
+  if (!batch_result) {
+    const auto error_msg = "Parse error: " + std::string(batch_result.error().what());
+    Logger().error(error_msg);
+    co_return create_error_response(rfl::Generic(), ErrorCode::ParseError, error_msg);
+  }
+
+  const auto& entries = batch_result.value();
+  auto& metrics = app_state.rpc->batch_metrics;
+  if (entries.empty() || entries.size() > kMaxBatchSize) {
+    metrics.rejected.fetch_add(1, std::memory_order_relaxed);
+    const auto error_msg =
+        entries.empty() ? std::string{"Invalid request: empty batch"}
+                        : std::format("Invalid request: batch exceeds {} calls", kMaxBatchSize);
+    Logger().warn(error_msg);
+    co_return create_error_response(rfl::Generic(), ErrorCode::InvalidRequest, error_msg);
+  }
+  record_batch_size(metrics, entries.size());
+
+  std::vector<std::string> responses(entries.size());
+  std::vector<PreparedCall> pending_calls;
+  std::vector<std::size_t> pending_indices;
+  std::vector<BatchOperation> operations;
+  auto executor = co_await asio::this_coro::executor;
+
+  for (std::size_t index = 0; index < entries.size(); ++index) {
+    auto request_result =
+        rfl::from_generic<JsonRpcRequest, rfl::SnakeCaseToCamelCase>(entries[index]);
+    if (!request_result) {
+      responses[index] =
+          create_error_response(rfl::Generic(), ErrorCode::InvalidRequest,
+                                "Invalid request: " + std::string(request_result.error().what()));
+      continue;
+    }
 
-    // 验证JSON-RPC版本
-    if (request.jsonrpc != "2.0") {
-      const auto error_msg = "Invalid request: jsonrpc must be '2.0'";
-      Logger().error(error_msg);
-      co_return create_error_response(request_id, ErrorCode::InvalidRequest, error_msg);
+    auto prepared = prepare_parsed_call(app_state, request_result.value(), caller);
+    if (auto* response = std::get_if<std::string>(&prepared)) {
+      responses[index] = std::move(*response);
+      continue;
     }
 
-    // 处理系统内置方法
-    if (auto system_response =
-            handle_system_method(app_state, request, request_id, caller_access)) {
-      co_return system_response.value();
+    auto& call = std::get<PreparedCall>(prepared);
+    operations.push_back(asio::co_spawn(
+        executor,
+        execute_registered_method(app_state, *call.method, std::move(call.params), call.id,
+                                  caller, arrival),
+        asio::deferred));
+    pending_calls.push_back(std::move(call));
+    pending_indices.push_back(index);
+  }
+
+  if (!operations.empty()) {
+    // 结果向量按操作下标排列，与完成顺序无关
+    auto [completion_order, exceptions, results] =
+        co_await asio::experimental::make_parallel_group(std::move(operations))
+            .async_wait(asio::experimental::wait_for_all(), asio::use_awaitable);
+
+    for (std::size_t i = 0; i < pending_calls.size(); ++i) {
+      auto& call = pending_calls[i];
+      if (call.notification) {
+        continue;
+      }
+      auto& response = responses[pending_indices[i]];
+      if (exceptions[i]) {
+        response = create_error_response(std::move(call.id), ErrorCode::InternalError,
+                                         "Internal error during method execution");
+      } else {
+        response = std::move(results[i]);
+      }
     }
+  }
 
-    // 查找已注册的方法
-    const auto& registry = app_state.rpc->registry;
-    const auto method_it = registry.find(request.method);
-    if (method_it == registry.end()) {
-      const auto error_msg = "Method not found: " + request.method;
-      Logger().error(error_msg);
-      co_return create_error_response(request_id, ErrorCode::MethodNotFound, error_msg);
+  // 空字符串是通知留下的位置
+  std::size_t body_size = responses.size() + 1;
+  for (const auto& response : responses) {
+    body_size += response.size();
+  }
+  std::string body;
+  body.reserve(body_size);
+  body.push_back('[');
+  for (const auto& response : responses) {
+    if (response.empty()) {
+      continue;
+    }
+    if (body.size() > 1) {
+      body.push_back(',');
     }
+    body.append(response);
+  }
+  if (body.size() == 1) {
+    co_return std::string{};
+  }
+  body.push_back(']');
+  co_return body;
+}
 
-    // 这是所有注册 RPC 的最终权限闸门，不能只依赖前端隐藏按钮。
-    if (caller_access < method_it->second.required_access) {
-      Logger().warn("Rejected RPC method '{}' for insufficient access level", request.method);
-      co_return create_error_response(request_id, ErrorCode::AccessDenied,
-                                      "Access denied for this method");
+auto process_request(core::AppState& app_state, const std::string& request_json, Caller caller)
+    -> RpcJsonAwaitable {
+  // 单飞执行只接纳到达之后才启动的共享执行，到达序号在解析前取得
+  const auto arrival = single_flight::arrive(app_state.rpc->single_flight);
+  try {
+    if (is_batch_request(request_json)) {
+      co_return co_await process_batch_request(app_state, request_json, caller, arrival);
     }
 
-    // 准备参数
-    rfl::Generic params_generic = request.params.value_or(rfl::Generic::Object());
+    auto prepared = prepare_call(app_state, request_json, caller);
+    if (auto* response = std::get_if<std::string>(&prepared)) {
+      co_return std::move(*response);
+    }
 
     // 执行方法处理器
-    co_return co_await execute_registered_method(method_it->second, params_generic, request_id);
+    auto& call = std::get<PreparedCall>(prepared);
+    auto response = co_await execute_registered_method(
+        app_state, *call.method, std::move(call.params), call.id, caller, arrival);
+    co_return call.notification ? std::string{} : std::move(response);
 
   } catch (const std::exception& e) {
     // 顶层异常处理
@@ -174,4 +785,51 @@ auto process_request(core::AppState& app_state, const std::string& request_json,
   }
 }
 
+auto process_columnar_request(core::AppState& app_state, const std::string& request_json,
+                              Caller caller) -> RpcBodyAwaitable {
+  const auto arrival = single_flight::arrive(app_state.rpc->single_flight);
+  try {
+    // 批量请求的结果是多个响应组成的 JSON 数组，不走列式编码
+    if (is_batch_request(request_json)) {
+      co_return RpcResponseBody{
+          .body = co_await process_batch_request(app_state, request_json, caller, arrival)};
+    }
+
+    auto prepared = prepare_call(app_state, request_json, caller);
+    if (auto* response = std::get_if<std::string>(&prepared)) {
+      co_return RpcResponseBody{.body = std::move(*response)};
+    }
+
+    // 没有列式编码器的方法照常返回 JSON，客户端按 Content-Type 区分
+    auto& call = std::get<PreparedCall>(prepared);
+    if (call.notification || !call.method->columnar_handler) {
+      auto response = co_await execute_registered_method(
+          app_state, *call.method, std::move(call.params), call.id, caller, arrival);
+      co_return RpcResponseBody{.body = call.notification ? std::string{} : std::move(response)};
+    }
+
+    InFlightRegistration registration;
+    auto stop_token = begin_in_flight(*app_state.rpc, registration, caller, call.id);
+    try {
+      co_return co_await call.method->columnar_handler(std::move(call.params), call.id,
+                                                       stop_token);
+    } catch (const std::exception& e) {
+      if (call.method->metrics) {
+        call.method->metrics->errors.fetch_add(1, std::memory_order_relaxed);
+      }
+      Logger().error("Internal error during method execution: {}", e.what());
+      co_return RpcResponseBody{.body = create_error_response(
+                                    call.id, ErrorCode::InternalError,
+                                    "Internal error during method execution: " +
+                                        std::string(e.what()))};
+    }
+
+  } catch (const std::exception& e) {
+    const auto error_msg = "Unexpected error: " + std::string(e.what());
+    Logger().error(error_msg);
+    co_return RpcResponseBody{
+        .body = create_error_response(rfl::Generic(), ErrorCode::InternalError, error_msg)};
+  }
+}
+
 }  // namespace core::rpc
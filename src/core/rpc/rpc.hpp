@@ -8,6 +8,7 @@
 #include "core/build_config.hpp"
 #include "core/rpc/types.hpp"
 #include "core/state/app_state.hpp"
+#include "core/tracing/tracing.hpp"
 #include "utils/logger/logger.hpp"
 
 namespace core::rpc {
@@ -17,51 +18,204 @@ template <typename Request, typename Response>
 using AsyncHandler =
     std::move_only_function<RpcAwaitable<Response>(core::AppState&, const Request&) const>;
 
+// 可取消处理器额外接收请求级 stop_token，通常用 core::database::CancellationScope 传给数据库任务
+template <typename Request, typename Response>
+using CancellableHandler = std::move_only_function<RpcAwaitable<Response>(
+    core::AppState&, const Request&, std::stop_token) const>;
+
+// 把业务结果直接编码为列式二进制，跳过 rfl::Generic 与 JSON 文本
+template <typename Response>
+using ColumnarEncoder = auto (*)(const Response&) -> std::string;
+
 // 创建标准错误响应
 auto create_error_response(rfl::Generic request_id, ErrorCode error_code,
                            const std::string& message) -> std::string;
 
+// 已取消请求的 RequestCancelled 响应，同时按是否已进入业务处理器计数
+auto create_cancelled_response(core::AppState& app_state, rfl::Generic request_id,
+                               bool handler_started) -> std::string;
+
+// 把调用失败写成错误响应；RequestCancelled 交给 create_cancelled_response 计数
+auto create_call_error_response(core::AppState& app_state, rfl::Generic request_id,
+                                const RpcError& error, bool handler_started) -> std::string;
+
+// 结果结构体随信封一次写出，不再先 to_generic 构造中间树；字段命名与旧路径一致
+template <typename Response>
+auto write_success_response(Response result, rfl::Generic id) -> std::string {
+  JsonRpcTypedSuccessResponse<Response> response;
+  response.result = std::move(result);
+  response.id = std::move(id);
+  return rfl::json::write<rfl::SnakeCaseToCamelCase>(response);
+}
+
+// 每分钟按 DEBUG 级别输出一次有新调用的方法指标；默认 INFO 级别下不产生日志。
+// 同时每秒为已开启指标的执行器采样利用率与队列深度，并随方法指标一起输出
+auto start_metrics_log(core::AppState& app_state) -> void;
+
 // 处理JSON-RPC请求
-// caller_access 由 WebView 或 HTTP 层确定，不能由请求体自行声明。
-auto process_request(core::AppState& app_state, const std::string& request_json,
-                     AccessLevel caller_access) -> RpcJsonAwaitable;
+// caller 由 WebView、HTTP 或 WebSocket 层确定，不能由请求体自行声明。
+// 返回空字符串表示请求是通知，传输层不应发送任何响应。
+auto process_request(core::AppState& app_state, const std::string& request_json, Caller caller)
+    -> RpcJsonAwaitable;
+
+// 与 process_request 相同的流程，但目标方法注册了列式编码器时返回二进制结果
+auto process_columnar_request(core::AppState& app_state, const std::string& request_json,
+                              Caller caller) -> RpcBodyAwaitable;
+
+// 一次强类型调用的结果：value 为按入口编码后的成功结果，失败或取消时为 RpcError。
+// 取消时 handler_started 区分取消发生在业务处理器之前还是之后
+template <typename T>
+struct TypedCallOutcome {
+  RpcResult<T> value;
+  bool handler_started = false;
+};
+
+// 各入口共用的调用流程：追踪区间、调用与在途计数、参数解析、取消检查、错误日志与阶段耗时。
+// encode 把业务结果编码为入口需要的形式，入口只负责把结果写成各自的响应
+template <typename Request, typename Response, typename Encode>
+auto run_typed_call(core::AppState& app_state, const CancellableHandler<Request, Response>& handler,
+                    metrics::MethodMetrics& method_metrics, const char* trace_name,
+                    rfl::Generic params_generic, std::stop_token stop_token, Encode encode)
+    -> asio::awaitable<TypedCallOutcome<std::invoke_result_t<Encode&, Response>>> {
+  using Outcome = TypedCallOutcome<std::invoke_result_t<Encode&, Response>>;
+  // 取消的请求按 RequestCancelled 失败，错误计数与响应写出规则对所有入口一致
+  auto cancelled = [&method_metrics](bool handler_started) {
+    method_metrics.errors.fetch_add(1, std::memory_order_relaxed);
+    return Outcome{.value = std::unexpected(
+                       RpcError{.code = static_cast<int>(ErrorCode::RequestCancelled),
+                                .message = "Request cancelled"}),
+                   .handler_started = handler_started};
+  };
+
+  // 跨越 co_await，按异步区间记录
+  core::tracing::Span span(trace_name, "rpc", true);
+  method_metrics.calls.fetch_add(1, std::memory_order_relaxed);
+  metrics::InFlightGauge in_flight(method_metrics.in_flight);
+  auto phase_start = std::chrono::steady_clock::now();
+
+  // 把通用 JSON 参数转换为当前方法的强类型请求
+  auto request_result =
+      rfl::from_generic<Request, rfl::SnakeCaseToCamelCase, rfl::DefaultIfMissing>(params_generic);
+  phase_start = metrics::record_since(method_metrics.parse, phase_start);
+  if (!request_result) {
+    method_metrics.errors.fetch_add(1, std::memory_order_relaxed);
+    co_return Outcome{.value = std::unexpected(
+                          RpcError{.code = static_cast<int>(ErrorCode::InvalidParams),
+                                   .message = "Invalid parameters: " +
+                                              request_result.error().what()})};
+  }
+
+  // 取消通知先于执行到达时不再进入业务处理器
+  if (stop_token.stop_requested()) {
+    co_return cancelled(false);
+  }
+
+  // 调用业务协程并保留统一的 AppState 注入方式
+  auto result = co_await handler(app_state, request_result.value(), stop_token);
+  phase_start = metrics::record_since(method_metrics.handler, phase_start);
+
+  // 执行期间被取消时，结果可能因数据库任务中断而不完整，统一按取消处理
+  if (stop_token.stop_requested()) {
+    co_return cancelled(true);
+  }
+
+  if (!result) {
+    method_metrics.errors.fetch_add(1, std::memory_order_relaxed);
+    Logger().error("Error response: {}", result.error().message);
+    co_return Outcome{.value = std::unexpected(std::move(result.error()))};
+  }
+
+  Outcome outcome{.value = encode(std::move(result.value()))};
+  metrics::record_since(method_metrics.serialize, phase_start);
+  co_return outcome;
+}
 
 // 注册 RPC 方法：擦除业务处理器类型并生成统一的 JSON-RPC 协程入口
 template <typename Request, typename Response>
 inline auto register_method(core::AppState& app_state,
                             std::unordered_map<std::string, MethodInfo>& registry,
-                            const std::string& method_name, AsyncHandler<Request, Response> handler,
+                            const std::string& method_name,
+                            CancellableHandler<Request, Response> handler,
                             const std::string& description = "",
                             // 默认只允许本机，公开给 LAN 的方法必须显式标记。
-                            AccessLevel required_access = AccessLevel::local) -> void {
-  // 注册表独占业务处理器，包装层只保留可重复 const 调用能力
-  auto wrapped_handler = [handler = std::move(handler), &app_state](
-                             rfl::Generic params_generic, rfl::Generic id) -> RpcJsonAwaitable {
-    // 把通用 JSON 参数转换为当前方法的强类型请求
-    auto request_result =
-        rfl::from_generic<Request, rfl::SnakeCaseToCamelCase, rfl::DefaultIfMissing>(
-            params_generic);
-    if (!request_result) {
-      co_return create_error_response(id, ErrorCode::InvalidParams,
-                                      "Invalid parameters: " + request_result.error().what());
-    }
+                            AccessLevel required_access = AccessLevel::local,
+                            // 只能用于只读、结果只取决于参数的方法，写操作不得标记
+                            bool idempotent = false,
+                            ColumnarEncoder<Response> columnar_encoder = nullptr) -> void {
+  // JSON、列式与共享执行三个入口共用同一个业务处理器
+  auto shared_handler =
+      std::make_shared<CancellableHandler<Request, Response>>(std::move(handler));
 
-    // 调用业务协程并保留统一的 AppState 注入方式
-    auto result = co_await handler(app_state, request_result.value());
-
-    // 将业务结果转换为 JSON-RPC 成功或错误响应
-    if (result) {
-      JsonRpcSuccessResponse success_response;
-      success_response.id = id;
-      success_response.result = rfl::to_generic<rfl::SnakeCaseToCamelCase>(result.value());
-      co_return rfl::json::write<rfl::SnakeCaseToCamelCase>(success_response);
-    } else {
-      const auto& error = result.error();
-      Logger().error("Error response: {}", error.message);
-      co_return create_error_response(id, static_cast<ErrorCode>(error.code), error.message);
+  // 各入口共同累计调用次数与各阶段耗时，由 system.getMetrics 读取
+  auto method_metrics = std::make_shared<metrics::MethodMetrics>();
+  // 追踪缓冲区只保存指针，方法名换成永久有效的副本
+  const auto* trace_name = core::tracing::intern_name(method_name);
+
+  // JSON 与列式入口共用这条 JSON-RPC 响应路径，只替换成功结果的编码；失败与取消都写 JSON 错误
+  auto respond = [shared_handler, method_metrics, trace_name, &app_state](
+                     rfl::Generic params_generic, rfl::Generic id, std::stop_token stop_token,
+                     auto encode_success) -> RpcBodyAwaitable {
+    auto outcome = co_await run_typed_call(
+        app_state, *shared_handler, *method_metrics, trace_name, std::move(params_generic),
+        stop_token,
+        [&encode_success, &id](Response result) { return encode_success(std::move(result), id); });
+    if (!outcome.value) {
+      co_return RpcResponseBody{.body = create_call_error_response(app_state, std::move(id),
+                                                                   outcome.value.error(),
+                                                                   outcome.handler_started)};
     }
+    co_return std::move(outcome.value.value());
   };
 
+  // 注册表独占业务处理器，包装层只保留可重复 const 调用能力
+  auto wrapped_handler = [respond](rfl::Generic params_generic, rfl::Generic id,
+                                   std::stop_token stop_token) -> RpcJsonAwaitable {
+    auto response = co_await respond(std::move(params_generic), std::move(id), stop_token,
+                                     [](Response result, rfl::Generic& request_id) {
+                                       return RpcResponseBody{.body = write_success_response(
+                                                                  std::move(result),
+                                                                  std::move(request_id))};
+                                     });
+    co_return std::move(response.body);
+  };
+
+  // 幂等方法的共享执行入口：只序列化 result 成员，错误与取消交给各参与者按自己的 id 写出
+  std::move_only_function<RpcOutcomeAwaitable(rfl::Generic, std::stop_token) const>
+      result_handler;
+  if (idempotent) {
+    result_handler = [shared_handler, method_metrics, trace_name, &app_state](
+                         rfl::Generic params_generic,
+                         std::stop_token stop_token) -> RpcOutcomeAwaitable {
+      auto outcome = co_await run_typed_call(
+          app_state, *shared_handler, *method_metrics, trace_name, std::move(params_generic),
+          stop_token, [](const Response& result) {
+            return rfl::json::write<rfl::SnakeCaseToCamelCase>(result);
+          });
+      single_flight::Outcome shared;
+      shared.handler_started = outcome.handler_started;
+      if (outcome.value) {
+        shared.result_json = std::move(outcome.value.value());
+      } else {
+        shared.error_code = outcome.value.error().code;
+        shared.error_message = std::move(outcome.value.error().message);
+      }
+      co_return shared;
+    };
+  }
+
+  std::move_only_function<RpcBodyAwaitable(rfl::Generic, rfl::Generic, std::stop_token) const>
+      columnar_handler;
+  if (columnar_encoder) {
+    columnar_handler = [respond, columnar_encoder](rfl::Generic params_generic, rfl::Generic id,
+                                                   std::stop_token stop_token) -> RpcBodyAwaitable {
+      co_return co_await respond(std::move(params_generic), std::move(id), stop_token,
+                                 [columnar_encoder](const Response& result, const rfl::Generic&) {
+                                   return RpcResponseBody{.body = columnar_encoder(result),
+                                                          .columnar = true};
+                                 });
+    };
+  }
+
   std::string params_schema;
   if constexpr (core::build_config::rpc_json_schema_enabled()) {
     params_schema = rfl::json::to_schema<Request, rfl::SnakeCaseToCamelCase>();
@@ -72,7 +226,28 @@ inline auto register_method(core::AppState& app_state,
                                      .description = description,
                                      .params_schema = std::move(params_schema),
                                      .required_access = required_access,
-                                     .handler = std::move(wrapped_handler)};
+                                     .idempotent = idempotent,
+                                     .handler = std::move(wrapped_handler),
+                                     .columnar_handler = std::move(columnar_handler),
+                                     .result_handler = std::move(result_handler),
+                                     .metrics = std::move(method_metrics)};
+}
+
+// 不关心取消的处理器照常注册；取消仍会在进入处理器前和返回后生效
+template <typename Request, typename Response>
+inline auto register_method(core::AppState& app_state,
+                            std::unordered_map<std::string, MethodInfo>& registry,
+                            const std::string& method_name, AsyncHandler<Request, Response> handler,
+                            const std::string& description = "",
+                            AccessLevel required_access = AccessLevel::local,
+                            bool idempotent = false,
+                            ColumnarEncoder<Response> columnar_encoder = nullptr) -> void {
+  register_method<Request, Response>(
+      app_state, registry, method_name,
+      CancellableHandler<Request, Response>(
+          [handler = std::move(handler)](core::AppState& state, const Request& request,
+                                         std::stop_token) { return handler(state, request); }),
+      description, required_access, idempotent, columnar_encoder);
 }
 
 }  // namespace core::rpc
@@ -0,0 +1,68 @@
+#include "core/rpc/single_flight.hpp"
+
+#include "vendor/std.hpp"
+
+namespace core::rpc::single_flight {
+
+auto arrive(Table& table) -> std::uint64_t {
+  return table.arrivals.fetch_add(1, std::memory_order_relaxed);
+}
+
+auto join(Table& table, const std::string& key, std::uint64_t arrival) -> JoinResult {
+  std::lock_guard lock(table.mutex);
+  auto& slot = table.runs[key];
+  if (slot && !slot->stop_source.stop_requested() && arrival < slot->arrivals_at_start) {
+    ++slot->participants;
+    return {.run = slot, .leader = false};
+  }
+  slot = std::make_shared<Run>();
+  slot->arrivals_at_start = table.arrivals.load(std::memory_order_relaxed);
+  return {.run = slot, .leader = true};
+}
+
+auto cancel(Table& table, Run& run) -> void {
+  std::lock_guard lock(table.mutex);
+  if (++run.cancelled == run.participants) {
+    run.stop_source.request_stop();
+  }
+}
+
+auto wait(Table& table, Run& run, Waiter waiter) -> void {
+  std::shared_ptr<const Outcome> outcome;
+  {
+    std::lock_guard lock(table.mutex);
+    if (!run.outcome) {
+      run.waiters.push_back(std::move(waiter));
+      return;
+    }
+    outcome = run.outcome;
+  }
+  waiter(std::move(outcome));
+}
+
+auto finish(Table& table, const std::string& key, const std::shared_ptr<Run>& run,
+            std::shared_ptr<const Outcome> outcome) -> std::vector<Waiter> {
+  std::lock_guard lock(table.mutex);
+  auto it = table.runs.find(key);
+  if (it != table.runs.end() && it->second == run) {
+    table.runs.erase(it);
+  }
+  run->outcome = std::move(outcome);
+  return std::exchange(run->waiters, {});
+}
+
+auto write_success_envelope(std::string_view result_json, std::string_view id_json)
+    -> std::string {
+  constexpr std::string_view prefix = R"({"jsonrpc":"2.0","result":)";
+  constexpr std::string_view id_field = R"(,"id":)";
+  std::string envelope;
+  envelope.reserve(prefix.size() + result_json.size() + id_field.size() + id_json.size() + 1);
+  envelope.append(prefix);
+  envelope.append(result_json);
+  envelope.append(id_field);
+  envelope.append(id_json);
+  envelope.push_back('}');
+  return envelope;
+}
+
+}  // namespace core::rpc::single_flight
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "vendor/std.hpp"
+
+namespace core::rpc::single_flight {
+
+// 共享执行的结果。result 成员只序列化一次，信封与 id 由每个参与者各自写出
+struct Outcome {
+  // 成功时为 result 成员的 JSON 文本，失败时为空
+  std::optional<std::string> result_json;
+  int error_code = 0;
+  std::string error_message;
+  // 共享执行被取消时是否已进入业务处理器，用于取消计数
+  bool handler_started = false;
+};
+
+using Waiter = std::move_only_function<void(std::shared_ptr<const Outcome>)>;
+
+// 幂等方法的一次共享执行。参与者全部取消后才停止执行
+struct Run {
+  // 启动时已到达的请求数；到达序号小于它的调用才能加入
+  std::uint64_t arrivals_at_start = 0;
+  std::stop_source stop_source;
+  std::size_t participants = 1;
+  std::size_t cancelled = 0;
+  std::shared_ptr<const Outcome> outcome;
+  std::vector<Waiter> waiters;
+};
+
+// key 为方法名与规范化参数
+struct Table {
+  std::mutex mutex;
+  std::unordered_map<std::string, std::shared_ptr<Run>> runs;
+  std::atomic<std::uint64_t> arrivals{0};
+};
+
+struct JoinResult {
+  std::shared_ptr<Run> run;
+  bool leader = false;
+};
+
+// 请求到达时取一个递增的到达序号
+auto arrive(Table& table) -> std::uint64_t;
+
+// 加入同 key 的共享执行，没有可加入的执行时新建并由当前调用者执行。
+// 在本调用到达之前就已启动的执行可能读不到调用方刚完成的写入，已被全部参与者取消的执行
+// 会以取消结束，这两种都不接纳新调用
+auto join(Table& table, const std::string& key, std::uint64_t arrival) -> JoinResult;
+
+// 记录一个参与者取消，全部取消时停止共享执行
+auto cancel(Table& table, Run& run) -> void;
+
+// 结果已就绪时在锁外直接交给等待者，否则登记，由 finish 返回给执行者通知
+auto wait(Table& table, Run& run, Waiter waiter) -> void;
+
+// 保存结果并移除自己的条目，返回需要通知的等待者。
+// 执行期间被全部取消或过期的旧条目可能已被新执行替换，新条目保持不动
+auto finish(Table& table, const std::string& key, const std::shared_ptr<Run>& run,
+            std::shared_ptr<const Outcome> outcome) -> std::vector<Waiter>;
+
+// 按 JsonRpcTypedSuccessResponse 的字段顺序写出信封，与 write_success_response 的输出一致
+auto write_success_envelope(std::string_view result_json, std::string_view id_json)
+    -> std::string;
+
+}  // namespace core::rpc::single_flight
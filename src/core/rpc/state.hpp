@@ -2,12 +2,46 @@
 
 #include "vendor/std.hpp"
 
+#include "core/rpc/cancellation.hpp"
+#include "core/rpc/single_flight.hpp"
 #include "core/rpc/types.hpp"
 
 namespace core::rpc {
 
+// 单个批量请求最多包含的调用数，超出时整批以 InvalidRequest 拒绝
+constexpr std::size_t kMaxBatchSize = 64;
+
+// 批量规模按 2 的幂分桶：1, 2, 3-4, 5-8, ..., 33-64
+constexpr std::size_t kBatchSizeBucketCount = 7;
+
+struct BatchMetrics {
+  std::atomic<std::uint64_t> batches{0};
+  std::atomic<std::uint64_t> calls{0};
+  std::atomic<std::uint64_t> rejected{0};
+  std::array<std::atomic<std::uint64_t>, kBatchSizeBucketCount> size_buckets{};
+};
+
+struct CancellationMetrics {
+  std::atomic<std::uint64_t> requested{0};
+  std::atomic<std::uint64_t> unmatched{0};
+  std::atomic<std::uint64_t> cancelled_before_start{0};
+  std::atomic<std::uint64_t> cancelled_in_flight{0};
+};
+
+struct SingleFlightMetrics {
+  std::atomic<std::uint64_t> executions{0};
+  std::atomic<std::uint64_t> joined{0};
+};
+
 struct RpcState {
   std::unordered_map<std::string, MethodInfo> registry;
+  BatchMetrics batch_metrics;
+
+  cancellation::InFlightTable in_flight;
+  CancellationMetrics cancellation_metrics;
+
+  single_flight::Table single_flight;
+  SingleFlightMetrics single_flight_metrics;
 };
 
 }  // namespace core::rpc
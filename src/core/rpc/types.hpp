@@ -5,17 +5,23 @@
 #include "vendor/asio.hpp"
 #include "vendor/rfl.hpp"
 
+#include "core/executor_metrics/executor_metrics.hpp"
+#include "core/http_server/file_cache.hpp"
+#include "core/rpc/metrics.hpp"
+#include "core/rpc/single_flight.hpp"
+
 namespace core::rpc {
 
 // JSON-RPC 2.0 标准错误码
 enum class ErrorCode {
-  ParseError = -32700,      // JSON解析错误
-  InvalidRequest = -32600,  // 无效请求
-  MethodNotFound = -32601,  // 方法未找到
-  InvalidParams = -32602,   // 无效参数
-  InternalError = -32603,   // 内部错误
-  ServerError = -32000,     // 服务器错误
-  AccessDenied = -32003,    // 当前访问等级无权调用
+  ParseError = -32700,        // JSON解析错误
+  InvalidRequest = -32600,    // 无效请求
+  MethodNotFound = -32601,    // 方法未找到
+  InvalidParams = -32602,     // 无效参数
+  InternalError = -32603,     // 内部错误
+  ServerError = -32000,       // 服务器错误
+  AccessDenied = -32003,      // 当前访问等级无权调用
+  RequestCancelled = -32800,  // 客户端已通过 $/cancelRequest 取消
 };
 
 // RPC 调用者访问等级。local 高于 lan；WebView2 和 loopback HTTP 属于 local，
@@ -25,6 +31,13 @@ enum class AccessLevel : std::uint8_t {
   local = 1,
 };
 
+// RPC 调用方：访问等级由传输层认证确定；session 标识同一等级下的具体连接或会话，
+// $/cancelRequest 只能取消同一 session 发起的请求，为空时请求不可取消。
+struct Caller {
+  AccessLevel access = AccessLevel::lan;
+  std::string session;
+};
+
 // RPC错误结构
 struct RpcError {
   int code;
@@ -41,6 +54,16 @@ using RpcAwaitable = asio::awaitable<RpcResult<T>>;
 
 using RpcJsonAwaitable = asio::awaitable<std::string>;
 
+using RpcOutcomeAwaitable = asio::awaitable<single_flight::Outcome>;
+
+// columnar 为 false 时 body 是 JSON-RPC 文本：错误、系统方法和未提供列式编码的方法都走这一支
+struct RpcResponseBody {
+  std::string body;
+  bool columnar = false;
+};
+
+using RpcBodyAwaitable = asio::awaitable<RpcResponseBody>;
+
 struct MethodListItem {
   std::string name;
   std::string description;
@@ -58,6 +81,54 @@ struct MethodSignatureResponse {
   std::string params_schema;  // 参数的JSON Schema
 };
 
+// 批量请求规模分桶，max_size 为该桶包含的最大调用数
+struct BatchSizeBucket {
+  std::uint64_t max_size;
+  std::uint64_t count;
+};
+
+struct BatchMetricsSnapshot {
+  std::uint64_t batches;
+  std::uint64_t calls;
+  std::uint64_t rejected;
+  std::vector<BatchSizeBucket> size_buckets;
+};
+
+// before_start 在进入业务处理器前取消，in_flight 在处理器执行期间取消；
+// unmatched 为取消时请求已结束或 id 不存在
+struct CancellationMetricsSnapshot {
+  std::uint64_t requested;
+  std::uint64_t unmatched;
+  std::uint64_t cancelled_before_start;
+  std::uint64_t cancelled_in_flight;
+  std::uint64_t database_jobs_skipped;
+  std::uint64_t database_jobs_interrupted;
+};
+
+// executions 为幂等方法实际执行次数，joined 为搭上已有执行、未单独执行的调用数
+struct SingleFlightMetricsSnapshot {
+  std::uint64_t executions;
+  std::uint64_t joined;
+};
+
+// system.getMetrics 响应结构
+struct MetricsResponse {
+  BatchMetricsSnapshot batch;
+  CancellationMetricsSnapshot cancellation;
+  SingleFlightMetricsSnapshot single_flight;
+  // 按方法名排序，只包含启动以来被调用过的方法
+  std::vector<metrics::MethodMetricsSnapshot> methods;
+  // 线程池与数据库执行器；未开启 system.setExecutorMetrics 时只有 enabled 与 workers
+  std::vector<executor_metrics::ExecutorMetricsSnapshot> executors;
+  // 静态资源热缓存；HTTP 服务未启动时为空
+  std::optional<core::http_server::file_cache::StaticFileCacheStats> static_file_cache;
+};
+
+// $/cancelRequest 参数，id 与被取消请求的 JSON-RPC id 完全一致
+struct CancelRequestParams {
+  rfl::Generic id;
+};
+
 // JSON-RPC请求结构
 struct JsonRpcRequest {
   std::string jsonrpc;                 // 必须为 "2.0"
@@ -73,6 +144,14 @@ struct JsonRpcSuccessResponse {
   rfl::Generic id;             // 请求ID
 };
 
+// 带具体结果类型的成功响应，直接反射写出，不先转换成 rfl::Generic
+template <typename T>
+struct JsonRpcTypedSuccessResponse {
+  std::string jsonrpc{"2.0"};
+  T result;
+  rfl::Generic id;
+};
+
 // JSON-RPC错误响应结构
 struct JsonRpcErrorResponse {
   std::string jsonrpc{"2.0"};  // 版本号
@@ -86,7 +165,19 @@ struct MethodInfo {
   std::string description;
   std::string params_schema;  // 参数的JSON Schema
   AccessLevel required_access = AccessLevel::local;
-  std::move_only_function<RpcJsonAwaitable(rfl::Generic, rfl::Generic) const> handler;
+  // 只读且结果只取决于参数；并发的相同调用共享一次执行和序列化结果
+  bool idempotent = false;
+  // stop_token 在客户端通过 $/cancelRequest 取消该请求后进入 stop_requested 状态
+  std::move_only_function<RpcJsonAwaitable(rfl::Generic, rfl::Generic, std::stop_token) const>
+      handler;
+  // 仅注册了列式编码器的方法提供，HTTP 层按 Accept 协商后调用
+  std::move_only_function<RpcBodyAwaitable(rfl::Generic, rfl::Generic, std::stop_token) const>
+      columnar_handler;
+  // 仅幂等方法提供；共享执行只写出 result 成员，信封由每个参与者按自己的 id 写出
+  std::move_only_function<RpcOutcomeAwaitable(rfl::Generic, std::stop_token) const>
+      result_handler;
+  // JSON 与列式入口共用；包装层和 process_request 都会写入
+  std::shared_ptr<metrics::MethodMetrics> metrics;
 };
 
 // 空参数结构，用于不需要参数的RPC方法
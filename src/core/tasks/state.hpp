@@ -24,12 +24,26 @@ struct TaskSnapshot {
   std::optional<std::string> context;
 };
 
+// 单个任务的通知节流状态
+struct TaskEmitState {
+  std::chrono::steady_clock::time_point last_emitted{};
+  bool flush_scheduled = false;
+};
+
 struct TaskState {
   std::unordered_map<std::string, TaskSnapshot> tasks;
   std::deque<std::string> order;  // 旧 -> 新
   std::mutex mutex;
   std::uint64_t next_task_id = 1;
   size_t history_limit = 30;
+
+  // 以下两项由 mutex 保护：等待发出的最新快照（同一任务只保留一份）和节流状态
+  std::unordered_map<std::string, TaskSnapshot> pending_updates;
+  std::unordered_map<std::string, TaskEmitState> emit_states;
+  // 同一任务的中间进度通知最小间隔；状态变化和终态不受限制
+  std::chrono::milliseconds progress_emit_interval{100};
+  // 串行化序列化与分发，保证同一任务的通知按状态顺序到达；加锁顺序 emit_mutex -> mutex
+  std::mutex emit_mutex;
 };
 
 }  // namespace core::tasks
@@ -2,11 +2,14 @@
 
 #include "vendor/std.hpp"
 
+#include "vendor/asio.hpp"
 #include "vendor/rfl.hpp"
 
+#include "core/async/async.hpp"
 #include "core/rpc/notification_hub.hpp"
 #include "core/state/app_state.hpp"
 #include "core/tasks/state.hpp"
+#include "core/tasks/throttle.hpp"
 #include "utils/logger/logger.hpp"
 
 namespace core::tasks {
@@ -23,7 +26,64 @@ auto is_task_active(std::string_view status) -> bool {
 
 auto emit_task_updated(core::AppState& state, const TaskSnapshot& snapshot) -> void {
   auto params_json = rfl::json::write<rfl::SnakeCaseToCamelCase>(snapshot);
-  core::rpc::notification_hub::send_notification(state, "task.updated", params_json);
+  // 同一任务只需要最新状态，慢客户端队列里按任务 id 合并
+  core::rpc::notification_hub::send_notification(state, "task.updated", params_json,
+                                                 "task.updated:" + snapshot.task_id);
+}
+
+// 在异步运行时上取出该任务最新的待发快照并发出；已被更早的刷新取走时什么也不做
+auto flush_task_update(core::AppState& state, const std::string& task_id, bool from_timer)
+    -> void {
+  if (!state.tasks) {
+    return;
+  }
+
+  auto& task_state = *state.tasks;
+  std::lock_guard<std::mutex> emit_lock(task_state.emit_mutex);
+
+  std::optional<TaskSnapshot> snapshot;
+  {
+    std::lock_guard<std::mutex> lock(task_state.mutex);
+    snapshot = throttle::take_pending_update(task_state, task_id, from_timer,
+                                             std::chrono::steady_clock::now());
+  }
+
+  if (snapshot) {
+    emit_task_updated(state, *snapshot);
+  }
+}
+
+// 持有 TaskState 锁时调用，只记录最新快照并投递刷新，序列化和通知分发都不在调用线程上执行。
+// 节流规则见 throttle::plan_update。返回 true 表示异步运行时不可用，调用方需在解锁后同步发出。
+auto queue_task_update_unlocked(core::AppState& state, const TaskSnapshot& snapshot,
+                                bool throttled) -> bool {
+  auto* io_context = core::async::get_io_context(state);
+  const auto plan = throttle::plan_update(*state.tasks, snapshot, throttled, io_context != nullptr,
+                                          std::chrono::steady_clock::now());
+
+  switch (plan.action) {
+    case throttle::UpdateAction::Coalesced:
+    case throttle::UpdateAction::Dropped:
+      return false;
+    case throttle::UpdateAction::EmitNow:
+      return true;
+    case throttle::UpdateAction::ScheduleFlush: {
+      auto timer = std::make_shared<asio::steady_timer>(*io_context, plan.delay);
+      timer->async_wait(
+          [&state, task_id = snapshot.task_id, timer](const asio::error_code& error) {
+            if (!error) {
+              flush_task_update(state, task_id, true);
+            }
+          });
+      return false;
+    }
+    case throttle::UpdateAction::PostFlush:
+      asio::post(*io_context, [&state, task_id = snapshot.task_id]() {
+        flush_task_update(state, task_id, false);
+      });
+      return false;
+  }
+  return false;
 }
 
 auto prune_history_unlocked(TaskState& task_state) -> void {
@@ -53,6 +113,7 @@ auto create_task(core::AppState& state, const std::string& type,
   }
 
   TaskSnapshot snapshot;
+  bool emit_now = false;
   {
     std::lock_guard<std::mutex> lock(state.tasks->mutex);
 
@@ -66,9 +127,12 @@ auto create_task(core::AppState& state, const std::string& type,
     state.tasks->tasks[task_id] = snapshot;
     state.tasks->order.push_back(task_id);
     prune_history_unlocked(*state.tasks);
+    emit_now = queue_task_update_unlocked(state, snapshot, false);
   }
 
-  emit_task_updated(state, snapshot);
+  if (emit_now) {
+    emit_task_updated(state, snapshot);
+  }
   return snapshot.task_id;
 }
 
@@ -124,10 +188,14 @@ auto mark_task_running(core::AppState& state, const std::string& task_id) -> boo
     task.started_at = now_millis();
     task.finished_at.reset();
     task.error_message.reset();
-    snapshot = task;
+    if (queue_task_update_unlocked(state, task, false)) {
+      snapshot = task;
+    }
   }
 
-  emit_task_updated(state, snapshot.value());
+  if (snapshot) {
+    emit_task_updated(state, *snapshot);
+  }
   return true;
 }
 
@@ -155,11 +223,16 @@ auto update_task_progress(core::AppState& state, const std::string& task_id,
       task.started_at = now_millis();
     }
 
+    // 扫描类任务每秒可能上报上千次进度，这里只记录最新值，按间隔合并发出
     task.progress = progress;
-    snapshot = task;
+    if (queue_task_update_unlocked(state, task, true)) {
+      snapshot = task;
+    }
   }
 
-  emit_task_updated(state, snapshot.value());
+  if (snapshot) {
+    emit_task_updated(state, *snapshot);
+  }
   return true;
 }
 
@@ -190,11 +263,17 @@ auto complete_task_success(core::AppState& state, const std::string& task_id) ->
     if (task.progress.has_value() && !task.progress->percent.has_value()) {
       task.progress->percent = 100.0;
     }
-    snapshot = task;
+    // 终态立即发出，并覆盖尚未发出的中间进度
+    if (queue_task_update_unlocked(state, task, false)) {
+      snapshot = task;
+    }
+    state.tasks->emit_states.erase(task_id);
     prune_history_unlocked(*state.tasks);
   }
 
-  emit_task_updated(state, snapshot.value());
+  if (snapshot) {
+    emit_task_updated(state, *snapshot);
+  }
   return true;
 }
 
@@ -223,11 +302,17 @@ auto complete_task_failed(core::AppState& state, const std::string& task_id,
     }
     task.finished_at = now_millis();
     task.error_message = error_message;
-    snapshot = task;
+    // 终态立即发出，并覆盖尚未发出的中间进度
+    if (queue_task_update_unlocked(state, task, false)) {
+      snapshot = task;
+    }
+    state.tasks->emit_states.erase(task_id);
     prune_history_unlocked(*state.tasks);
   }
 
-  emit_task_updated(state, snapshot.value());
+  if (snapshot) {
+    emit_task_updated(state, *snapshot);
+  }
   return true;
 }
 
@@ -0,0 +1,53 @@
+#include "core/tasks/throttle.hpp"
+
+#include "vendor/std.hpp"
+
+#include "core/tasks/state.hpp"
+
+namespace core::tasks::throttle {
+
+auto plan_update(TaskState& task_state, const TaskSnapshot& snapshot, bool throttled,
+                 bool can_defer, std::chrono::steady_clock::time_point now) -> UpdatePlan {
+  auto& emit_state = task_state.emit_states[snapshot.task_id];
+  const auto next_emit = emit_state.last_emitted + task_state.progress_emit_interval;
+
+  if (throttled && (emit_state.flush_scheduled || now < next_emit)) {
+    if (!can_defer) {
+      return {.action = UpdateAction::Dropped};
+    }
+
+    task_state.pending_updates[snapshot.task_id] = snapshot;
+    if (emit_state.flush_scheduled) {
+      return {.action = UpdateAction::Coalesced};
+    }
+
+    emit_state.flush_scheduled = true;
+    return {.action = UpdateAction::ScheduleFlush, .delay = next_emit - now};
+  }
+
+  emit_state.last_emitted = now;
+  if (!can_defer) {
+    return {.action = UpdateAction::EmitNow};
+  }
+
+  task_state.pending_updates[snapshot.task_id] = snapshot;
+  return {.action = UpdateAction::PostFlush};
+}
+
+auto take_pending_update(TaskState& task_state, const std::string& task_id, bool from_timer,
+                         std::chrono::steady_clock::time_point now)
+    -> std::optional<TaskSnapshot> {
+  if (from_timer) {
+    if (auto it = task_state.emit_states.find(task_id); it != task_state.emit_states.end()) {
+      it->second.flush_scheduled = false;
+      it->second.last_emitted = now;
+    }
+  }
+
+  if (auto node = task_state.pending_updates.extract(task_id)) {
+    return std::move(node.mapped());
+  }
+  return std::nullopt;
+}
+
+}  // namespace core::tasks::throttle
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "vendor/std.hpp"
+
+#include "core/tasks/state.hpp"
+
+namespace core::tasks::throttle {
+
+enum class UpdateAction {
+  // 已记为待发快照，会由已投递的定时刷新一起发出
+  Coalesced,
+  // 节流间隔未到，调用方需在 delay 后按定时器刷新
+  ScheduleFlush,
+  // 立即可发，调用方投递一次刷新
+  PostFlush,
+  // 无法延迟刷新，调用方在解锁后同步发出
+  EmitNow,
+  // 无法延迟刷新的中间进度，直接丢弃
+  Dropped,
+};
+
+struct UpdatePlan {
+  UpdateAction action = UpdateAction::Dropped;
+  std::chrono::steady_clock::duration delay{};
+};
+
+// 持有 TaskState 锁时调用：记录最新快照并决定何时发出。
+// throttled 为 true 的进度更新在间隔内合并；状态变化和终态立即发出并覆盖未发出的进度。
+// can_defer 为 false 表示没有异步运行时，无法投递刷新。
+auto plan_update(TaskState& task_state, const TaskSnapshot& snapshot, bool throttled,
+                 bool can_defer, std::chrono::steady_clock::time_point now) -> UpdatePlan;
+
+// 持有 TaskState 锁时调用：取出该任务待发的最新快照；已被更早的刷新取走时返回空。
+// from_timer 为 true 时同时结束本轮节流。
+auto take_pending_update(TaskState& task_state, const std::string& task_id, bool from_timer,
+                         std::chrono::steady_clock::time_point now) -> std::optional<TaskSnapshot>;
+
+}  // namespace core::tasks::throttle
@@ -0,0 +1,198 @@
+#include "core/tracing/tracing.hpp"
+
+#include "vendor/std.hpp"
+
+namespace core::tracing {
+
+struct SpanEvent {
+  const char* name = nullptr;
+  const char* category = nullptr;
+  std::int64_t start_us = 0;
+  std::int64_t duration_us = 0;
+  std::uint64_t async_id = 0;
+};
+
+// 锁只在导出和清空时与写入线程争用，平时总是无竞争地获取
+struct ThreadBuffer {
+  std::uint32_t thread_id = 0;
+  std::mutex mutex;
+  std::string thread_name;
+  std::vector<SpanEvent> events;
+  // 累计写入数，超过容量后按取模覆盖
+  std::size_t written = 0;
+};
+
+// 缓冲区随线程首次记录时登记，线程退出后仍保留，导出时能看到已结束的线程
+std::mutex g_buffers_mutex;
+std::vector<std::shared_ptr<ThreadBuffer>> g_buffers;
+std::atomic<std::uint32_t> g_next_thread_id{1};
+std::atomic<std::uint64_t> g_next_async_id{1};
+const auto g_epoch = std::chrono::steady_clock::now();
+
+std::mutex g_names_mutex;
+std::unordered_set<std::string> g_names;
+
+thread_local std::shared_ptr<ThreadBuffer> current_buffer;
+// 缓冲区在首次记录时才分配，线程名先暂存
+thread_local std::string current_thread_name;
+
+auto get_thread_buffer() -> ThreadBuffer& {
+  if (!current_buffer) {
+    current_buffer = std::make_shared<ThreadBuffer>();
+    current_buffer->thread_id = g_next_thread_id.fetch_add(1, std::memory_order_relaxed);
+    current_buffer->thread_name = current_thread_name;
+    current_buffer->events.resize(kThreadBufferCapacity);
+    std::lock_guard lock(g_buffers_mutex);
+    g_buffers.push_back(current_buffer);
+  }
+  return *current_buffer;
+}
+
+auto to_trace_us(std::chrono::steady_clock::time_point time) -> std::int64_t {
+  return std::chrono::duration_cast<std::chrono::microseconds>(time - g_epoch).count();
+}
+
+auto append_json_string(std::string& out, std::string_view value) -> void {
+  out.push_back('"');
+  for (const auto ch : value) {
+    switch (ch) {
+      case '"':
+        out += "\\\"";
+        break;
+      case '\\':
+        out += "\\\\";
+        break;
+      case '\n':
+        out += "\\n";
+        break;
+      default:
+        if (static_cast<unsigned char>(ch) < 0x20) {
+          out += std::format("\\u{:04x}", static_cast<unsigned char>(ch));
+        } else {
+          out.push_back(ch);
+        }
+    }
+  }
+  out.push_back('"');
+}
+
+auto append_event(std::string& out, std::uint32_t thread_id, const SpanEvent& event) -> void {
+  auto append_header = [&](std::string_view phase) {
+    out += "{\"name\":";
+    append_json_string(out, event.name);
+    out += ",\"cat\":";
+    append_json_string(out, event.category);
+    out += std::format(",\"ph\":\"{}\",\"pid\":1,\"tid\":{}", phase, thread_id);
+  };
+
+  if (event.async_id == 0) {
+    append_header("X");
+    out += std::format(",\"ts\":{},\"dur\":{}}},\n", event.start_us, event.duration_us);
+    return;
+  }
+
+  // 异步区间拆成开始与结束两条，按 id 配对显示在独立的轨道上
+  append_header("b");
+  out += std::format(",\"ts\":{},\"id\":{}}},\n", event.start_us, event.async_id);
+  append_header("e");
+  out += std::format(",\"ts\":{},\"id\":{}}},\n", event.start_us + event.duration_us,
+                     event.async_id);
+}
+
+auto set_recording(bool enabled) -> void {
+  if (enabled && !recording.load()) {
+    std::lock_guard lock(g_buffers_mutex);
+    for (const auto& buffer : g_buffers) {
+      std::lock_guard buffer_lock(buffer->mutex);
+      buffer->written = 0;
+    }
+  }
+  recording.store(enabled);
+}
+
+auto record_span(const char* name, const char* category,
+                 std::chrono::steady_clock::time_point start,
+                 std::chrono::steady_clock::time_point end, std::uint64_t async_id) -> void {
+  auto& buffer = get_thread_buffer();
+  std::lock_guard lock(buffer.mutex);
+  buffer.events[buffer.written % kThreadBufferCapacity] =
+      SpanEvent{.name = name,
+                .category = category,
+                .start_us = to_trace_us(start),
+                .duration_us = std::chrono::duration_cast<std::chrono::microseconds>(end - start)
+                                   .count(),
+                .async_id = async_id};
+  ++buffer.written;
+}
+
+auto intern_name(std::string_view name) -> const char* {
+  std::lock_guard lock(g_names_mutex);
+  // unordered_set 的元素地址在重哈希后保持不变
+  return g_names.emplace(name).first->c_str();
+}
+
+auto next_async_id() -> std::uint64_t {
+  return g_next_async_id.fetch_add(1, std::memory_order_relaxed);
+}
+
+auto set_thread_name(std::string name) -> void {
+  current_thread_name = std::move(name);
+  if (current_buffer) {
+    std::lock_guard lock(current_buffer->mutex);
+    current_buffer->thread_name = current_thread_name;
+  }
+}
+
+auto write_chrome_trace() -> std::string {
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+  {
+    std::lock_guard lock(g_buffers_mutex);
+    buffers = g_buffers;
+  }
+
+  std::string out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+  for (const auto& buffer : buffers) {
+    std::lock_guard lock(buffer->mutex);
+    if (!buffer->thread_name.empty()) {
+      out += std::format(
+          "{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},\"args\":{{\"name\":",
+          buffer->thread_id);
+      append_json_string(out, buffer->thread_name);
+      out += "}},\n";
+    }
+
+    const auto count = std::min(buffer->written, kThreadBufferCapacity);
+    for (std::size_t i = buffer->written - count; i < buffer->written; ++i) {
+      append_event(out, buffer->thread_id, buffer->events[i % kThreadBufferCapacity]);
+    }
+  }
+
+  // 去掉最后一个事件后的逗号
+  if (out.ends_with(",\n")) {
+    out.erase(out.size() - 2);
+  }
+  out += "\n]}\n";
+  return out;
+}
+
+auto dump_chrome_trace(const std::filesystem::path& path) -> std::expected<void, std::string> {
+  try {
+    if (path.has_parent_path()) {
+      std::filesystem::create_directories(path.parent_path());
+    }
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+      return std::unexpected("Failed to open trace file: " + path.string());
+    }
+    const auto json = write_chrome_trace();
+    file.write(json.data(), static_cast<std::streamsize>(json.size()));
+    if (!file) {
+      return std::unexpected("Failed to write trace file: " + path.string());
+    }
+    return {};
+  } catch (const std::exception& e) {
+    return std::unexpected(std::string("Failed to dump trace: ") + e.what());
+  }
+}
+
+}  // namespace core::tracing
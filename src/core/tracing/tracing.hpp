@@ -0,0 +1,71 @@
+#pragma once
+
+#include "vendor/std.hpp"
+
+#include "core/build_config.hpp"
+
+namespace core::tracing {
+
+// 每个线程保留最近的事件数，写满后覆盖最旧的
+constexpr std::size_t kThreadBufferCapacity = 8192;
+
+// 运行时开关；关闭时 Span 只多一次 relaxed 读取
+inline std::atomic<bool> recording{false};
+
+inline auto is_recording() -> bool { return recording.load(std::memory_order_relaxed); }
+
+// 开启时清空上一轮的全部事件，从空时间线开始
+auto set_recording(bool enabled) -> void;
+
+// 缓冲区只保存指针，name 与 category 必须是静态字符串或 intern_name 的返回值。
+// async_id 非 0 时按异步事件导出
+auto record_span(const char* name, const char* category,
+                 std::chrono::steady_clock::time_point start,
+                 std::chrono::steady_clock::time_point end, std::uint64_t async_id = 0) -> void;
+
+// 把运行期字符串（如 RPC 方法名）换成进程内永久有效的指针，同名只保存一份
+auto intern_name(std::string_view name) -> const char*;
+
+auto next_async_id() -> std::uint64_t;
+
+// 导出时显示的线程名，在线程入口调用一次
+auto set_thread_name(std::string name) -> void;
+
+// 汇总所有线程（包括已退出线程）的缓冲区，生成 Chrome trace JSON，可直接拖入 Perfetto
+auto write_chrome_trace() -> std::string;
+
+auto dump_chrome_trace(const std::filesystem::path& path) -> std::expected<void, std::string>;
+
+// RAII 区间：构造时取开始时间，析构时写入当前线程缓冲区。
+// 构造时未在记录则整个区间忽略，中途开启不会产生只有结尾的事件。
+// 跨越 co_await、可能在其他线程结束的区间传 async = true，导出为独立轨道上的异步事件
+struct Span {
+  const char* name = nullptr;
+  const char* category = nullptr;
+  std::uint64_t async_id = 0;
+  std::chrono::steady_clock::time_point start;
+
+  Span(const char* span_name, const char* span_category, bool async = false) {
+    if constexpr (core::build_config::tracing_enabled()) {
+      if (is_recording()) {
+        name = span_name;
+        category = span_category;
+        async_id = async ? next_async_id() : 0;
+        start = std::chrono::steady_clock::now();
+      }
+    }
+  }
+
+  ~Span() {
+    if constexpr (core::build_config::tracing_enabled()) {
+      if (name != nullptr) {
+        record_span(name, category, start, std::chrono::steady_clock::now(), async_id);
+      }
+    }
+  }
+
+  Span(const Span&) = delete;
+  auto operator=(const Span&) -> Span& = delete;
+};
+
+}  // namespace core::tracing
@@ -48,9 +48,14 @@ auto handle_webview_message(core::AppState& state, const std::string& message)
                  message.substr(0, 100) + (message.size() > 100 ? "..." : ""));
 
   try {
-    // WebView2 始终代表本机调用者，直接授予 local 访问等级。
-    auto response =
-        co_await core::rpc::process_request(state, message, core::rpc::AccessLevel::local);
+    // WebView2 始终代表本机调用者，直接授予 local 访问等级；进程内只有一个 WebView 会话。
+    auto response = co_await core::rpc::process_request(
+        state, message, {.access = core::rpc::AccessLevel::local, .session = "webview"});
+
+    // 通知不回复
+    if (response.empty()) {
+      co_return;
+    }
 
     // 直接投递响应字符串到UI线程处理
     core::events::post(state, core::webview::events::WebViewResponseEvent{response});
@@ -0,0 +1,115 @@
+#include "core/worker_pool/parallel.hpp"
+
+#include "vendor/std.hpp"
+
+#include "core/worker_pool/state.hpp"
+#include "core/worker_pool/worker_pool.hpp"
+
+namespace core::worker_pool {
+
+auto enter_run(ParallelRun& run) -> void { run.active.fetch_add(1); }
+
+auto leave_run(ParallelRun& run) -> void {
+  if (run.active.fetch_sub(1) == 1) {
+    std::lock_guard<std::mutex> lock(run.mutex);
+    run.idle.notify_all();
+  }
+}
+
+auto fail_run(ParallelRun& run, std::exception_ptr error) -> void {
+  std::lock_guard<std::mutex> lock(run.mutex);
+  if (!run.error) {
+    run.error = std::move(error);
+  }
+  run.failed.store(true, std::memory_order_relaxed);
+}
+
+auto finish_run(ParallelRun& run) -> void {
+  // 之后的认领一律越界；在此之前认领成功的协助者都已登记为活跃
+  run.next.exchange(run.total);
+
+  std::unique_lock<std::mutex> lock(run.mutex);
+  run.idle.wait(lock, [&run] { return run.active.load() == 0; });
+  if (run.error) {
+    std::rethrow_exception(run.error);
+  }
+}
+
+auto helper_capacity(const WorkerPoolState* pool) -> std::size_t {
+  if (!pool || !pool->is_running.load()) {
+    return 0;
+  }
+  return pool->worker_threads.size();
+}
+
+// 领取一个组内任务；已失败或已取消时直接丢弃剩余任务
+auto take_group_task(TaskGroup& group) -> std::optional<std::move_only_function<void()>> {
+  std::lock_guard<std::mutex> lock(group.state->tasks_mutex);
+  if (group.state->tasks.empty()) {
+    return std::nullopt;
+  }
+  auto task = std::move(group.state->tasks.front());
+  group.state->tasks.pop_front();
+  return task;
+}
+
+auto run_group_task(TaskGroupState& state, const std::stop_token& stop_token,
+                    std::move_only_function<void()>& task) -> void {
+  if (state.run.failed.load(std::memory_order_relaxed) || stop_token.stop_requested()) {
+    return;
+  }
+  try {
+    task();
+  } catch (...) {
+    fail_run(state.run, std::current_exception());
+  }
+}
+
+TaskGroup::~TaskGroup() {
+  if (!waited) {
+    try {
+      wait(*this);
+    } catch (...) {
+    }
+  }
+}
+
+auto run(TaskGroup& group, std::move_only_function<void()> task) -> void {
+  {
+    std::lock_guard<std::mutex> lock(group.state->tasks_mutex);
+    group.state->tasks.push_back(std::move(task));
+  }
+
+  if (helper_capacity(group.pool) == 0) {
+    return;
+  }
+  // 协助任务不绑定具体任务，只负责从组内队列领取一个；领不到说明已被调用线程执行
+  submit_to_pool(
+      *group.pool,
+      [state = group.state, stop_token = group.options.stop_token] {
+        enter_run(state->run);
+        std::optional<std::move_only_function<void()>> task;
+        {
+          std::lock_guard<std::mutex> lock(state->tasks_mutex);
+          if (!state->tasks.empty()) {
+            task = std::move(state->tasks.front());
+            state->tasks.pop_front();
+          }
+        }
+        if (task) {
+          run_group_task(*state, stop_token, *task);
+        }
+        leave_run(state->run);
+      },
+      group.options.task);
+}
+
+auto wait(TaskGroup& group) -> void {
+  group.waited = true;
+  while (auto task = take_group_task(group)) {
+    run_group_task(*group.state, group.options.stop_token, *task);
+  }
+  finish_run(group.state->run);
+}
+
+}  // namespace core::worker_pool
@@ -0,0 +1,170 @@
+#pragma once
+
+#include "vendor/std.hpp"
+
+#include "core/state/app_state.hpp"
+#include "core/worker_pool/state.hpp"
+#include "core/worker_pool/worker_pool.hpp"
+
+namespace core::worker_pool {
+
+// 结构化并行：调用线程与协助任务从同一处认领工作，调用线程自己也干活而不是阻塞等待。
+// 线程池繁忙、未运行或在工作线程内嵌套调用时都能退化为串行完成，不会死锁。
+// 任务抛出的第一个异常在全部收尾后于调用线程重新抛出；stop_token 触发后不再认领新工作。
+
+struct ParallelOptions {
+  // 每次认领的元素数
+  std::size_t grain = 1;
+  TaskOptions task;
+  std::stop_token stop_token;
+};
+
+// 一次并行调用的共享状态。协助任务可能在调用返回后才出队，因此由 shared_ptr 持有；
+// 协助者先登记为活跃再认领工作，调用方关闭认领后只需等活跃者归零，迟到的协助任务不会触碰调用方的栈
+struct ParallelRun {
+  std::atomic<std::size_t> next{0};
+  std::size_t total = 0;
+  std::atomic<std::size_t> active{0};
+  std::atomic<bool> failed{false};
+  std::exception_ptr error;
+  std::mutex mutex;
+  std::condition_variable idle;
+};
+
+auto enter_run(ParallelRun& run) -> void;
+
+auto leave_run(ParallelRun& run) -> void;
+
+// 只保留第一个异常，并让其他参与者停止认领
+auto fail_run(ParallelRun& run, std::exception_ptr error) -> void;
+
+// 关闭认领并等待所有已登记的协助者退出，有异常时重新抛出
+auto finish_run(ParallelRun& run) -> void;
+
+// 除调用线程外最多还能有几个线程同时参与
+auto helper_capacity(const WorkerPoolState* pool) -> std::size_t;
+
+// 把 [0, count) 按 grain 分块并行执行 body(begin, end, local)。
+// 每个参与者独占一个 Local，不需要锁；返回全部 Local 由调用方合并，未参与者保持默认值。
+template <typename Local, typename Body>
+auto parallel_collect(WorkerPoolState* pool, std::size_t count, const ParallelOptions& options,
+                      Body&& body) -> std::vector<Local> {
+  const auto grain = std::max<std::size_t>(1, options.grain);
+  const auto chunk_count = (count + grain - 1) / grain;
+  const auto helper_count =
+      chunk_count > 1 ? std::min(helper_capacity(pool), chunk_count - 1) : std::size_t{0};
+  std::vector<Local> locals(helper_count + 1);
+
+  auto run = std::make_shared<ParallelRun>();
+  run->total = chunk_count;
+
+  // 认领循环从 first_chunk 开始；body 与 locals 都在调用方栈上，只在认领成功后访问
+  auto drain = [&](std::size_t first_chunk, Local& local) {
+    for (auto chunk = first_chunk; chunk < chunk_count; chunk = run->next.fetch_add(1)) {
+      if (run->failed.load(std::memory_order_relaxed) || options.stop_token.stop_requested()) {
+        return;
+      }
+      try {
+        const auto begin = chunk * grain;
+        body(begin, std::min(count, begin + grain), local);
+      } catch (...) {
+        fail_run(*run, std::current_exception());
+        return;
+      }
+    }
+  };
+
+  for (std::size_t slot = 0; slot < helper_count; ++slot) {
+    const auto submitted = submit_to_pool(
+        *pool,
+        [run, drain_ptr = &drain, local_ptr = &locals[slot]] {
+          enter_run(*run);
+          if (const auto chunk = run->next.fetch_add(1); chunk < run->total) {
+            (*drain_ptr)(chunk, *local_ptr);
+          }
+          leave_run(*run);
+        },
+        options.task);
+    // 提交失败时剩余工作由调用线程完成
+    if (!submitted) {
+      break;
+    }
+  }
+
+  drain(run->next.fetch_add(1), locals.back());
+  finish_run(*run);
+  return locals;
+}
+
+// 不需要收集结果的 parallel_collect
+template <typename Body>
+auto parallel_for(WorkerPoolState* pool, std::size_t count, const ParallelOptions& options,
+                  Body&& body) -> void {
+  struct NoLocal {};
+  parallel_collect<NoLocal>(pool, count, options,
+                            [&body](std::size_t begin, std::size_t end, NoLocal&) {
+                              body(begin, end);
+                            });
+}
+
+template <typename Local, typename Body>
+auto parallel_collect(core::AppState& state, std::size_t count, const ParallelOptions& options,
+                      Body&& body) -> std::vector<Local> {
+  return parallel_collect<Local>(state.worker_pool.get(), count, options,
+                                 std::forward<Body>(body));
+}
+
+template <typename Body>
+auto parallel_for(core::AppState& state, std::size_t count, const ParallelOptions& options,
+                  Body&& body) -> void {
+  parallel_for(state.worker_pool.get(), count, options, std::forward<Body>(body));
+}
+
+struct TaskGroupState {
+  ParallelRun run;
+  std::mutex tasks_mutex;
+  std::deque<std::move_only_function<void()>> tasks;
+};
+
+// 一组异构任务；析构前必须 wait，析构函数兜底等待并丢弃异常
+struct TaskGroup {
+  WorkerPoolState* pool = nullptr;
+  ParallelOptions options;
+  std::shared_ptr<TaskGroupState> state = std::make_shared<TaskGroupState>();
+  bool waited = false;
+
+  explicit TaskGroup(WorkerPoolState* target_pool, ParallelOptions group_options = {})
+      : pool(target_pool), options(std::move(group_options)) {}
+  ~TaskGroup();
+
+  TaskGroup(const TaskGroup&) = delete;
+  auto operator=(const TaskGroup&) -> TaskGroup& = delete;
+};
+
+// 任务先进入组内队列，再提交一个协助任务去领取；wait 时调用线程会领取剩余任务自己执行
+auto run(TaskGroup& group, std::move_only_function<void()> task) -> void;
+
+// 执行或等待组内全部任务，有异常时重新抛出第一个
+auto wait(TaskGroup& group) -> void;
+
+// 并发执行多个返回值非 void 的可调用对象，按参数顺序返回结果
+template <typename... Fns>
+auto when_all(WorkerPoolState* pool, TaskOptions options, Fns&&... fns)
+    -> std::tuple<std::invoke_result_t<Fns&>...> {
+  static_assert((!std::is_void_v<std::invoke_result_t<Fns&>> && ...),
+                "when_all requires non-void results");
+  std::tuple<std::optional<std::invoke_result_t<Fns&>>...> results;
+  TaskGroup group(pool, {.task = options});
+  [&]<std::size_t... I>(std::index_sequence<I...>) {
+    (run(group, [&fn = fns, &result = std::get<I>(results)] { result.emplace(fn()); }), ...);
+  }(std::index_sequence_for<Fns...>{});
+  wait(group);
+
+  return std::apply(
+      [](auto&... result) {
+        return std::tuple<std::invoke_result_t<Fns&>...>{std::move(*result)...};
+      },
+      results);
+}
+
+}  // namespace core::worker_pool
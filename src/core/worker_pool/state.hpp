@@ -2,17 +2,82 @@
 
 #include "vendor/std.hpp"
 
+#include "core/executor_metrics/executor_metrics.hpp"
+
 namespace core::worker_pool {
 
+// 数值越小越先执行；同一优先级内外部提交按 FIFO，线程内提交按 LIFO
+enum class TaskPriority : std::uint8_t {
+  Interactive,  // 用户正在等待结果，如下载打包
+  Normal,       // 默认
+  Background,   // 扫描、回填等可被让路的批量工作
+};
+
+constexpr std::size_t kTaskPriorityCount = 3;
+
+// 任务来源，只用于按来源统计
+enum class TaskTag : std::uint8_t {
+  General,
+  GalleryScan,
+  GalleryHash,
+  GalleryThumbnail,
+  GallerySimilarity,
+  GalleryDownload,
+  PhotoExtract,
+  MediaHardlinks,
+};
+
+constexpr std::size_t kTaskTagCount = 8;
+
+struct TaskOptions {
+  TaskPriority priority = TaskPriority::Normal;
+  TaskTag tag = TaskTag::General;
+};
+
+struct PoolTask {
+  std::move_only_function<void()> run;
+  TaskTag tag = TaskTag::General;
+  // 执行器指标关闭时为空
+  std::chrono::steady_clock::time_point enqueued_at;
+};
+
+// 每个工作线程一份；所有者从尾部取，其他线程从头部窃取，锁几乎不发生争用
+struct WorkerQueue {
+  std::mutex mutex;
+  std::array<std::deque<PoolTask>, kTaskPriorityCount> tasks;
+  // 各优先级的任务数，在锁内更新；取任务前先无锁读取以跳过空队列
+  std::array<std::atomic<std::size_t>, kTaskPriorityCount> sizes{};
+};
+
+struct TagCounters {
+  std::atomic<std::uint64_t> submitted{0};
+  std::atomic<std::uint64_t> completed{0};
+};
+
 struct WorkerPoolState {
   // 工作线程池
   std::vector<std::jthread> worker_threads;
+  // 与 worker_threads 一一对应，启动后大小不变
+  std::vector<std::unique_ptr<WorkerQueue>> worker_queues;
 
-  // 任务队列和同步原语
-  std::queue<std::move_only_function<void()>> task_queue;
-  std::mutex queue_mutex;
+  // 池外线程提交的任务先进入全局注入队列，由空闲线程领取
+  std::array<std::deque<PoolTask>, kTaskPriorityCount> injection_queues;
+  std::array<std::atomic<std::size_t>, kTaskPriorityCount> injected_sizes{};
+  std::mutex injection_mutex;
+
+  // 所有队列中尚未被取走的任务数，决定工作线程是否休眠
+  std::atomic<std::size_t> queued_tasks{0};
+  std::atomic<std::size_t> sleeping_workers{0};
+  // 被唤醒后尚未取到任务的线程数
+  std::atomic<std::size_t> searching_workers{0};
+  std::mutex sleep_mutex;
   std::condition_variable condition;
 
+  std::array<TagCounters, kTaskTagCount> tag_counters;
+  std::atomic<std::uint64_t> steals{0};
+  // 按 TaskTag 统计排队等待与执行耗时
+  executor_metrics::ExecutorMetrics metrics{kTaskTagCount};
+
   // 运行状态
   std::atomic<bool> is_running{false};
   std::atomic<bool> shutdown_requested{false};
@@ -3,17 +3,157 @@
 #include "vendor/std.hpp"
 
 #include "core/state/app_state.hpp"
+#include "core/tracing/tracing.hpp"
 #include "core/worker_pool/state.hpp"
 #include "utils/logger/logger.hpp"
 
 namespace core::worker_pool {
 
-auto start(core::AppState& state, size_t thread_count) -> std::expected<void, std::string> {
-  if (!state.worker_pool) {
-    return std::unexpected("WorkerPoolState is not initialized");
+// 当前线程所属的线程池与队列下标；池外线程为 nullptr
+thread_local WorkerPoolState* current_pool = nullptr;
+thread_local std::size_t current_worker_index = 0;
+// 当前线程正在执行的任务来源，供数据库执行器按来源统计
+thread_local TaskTag current_tag = TaskTag::General;
+
+auto priority_index(TaskPriority priority) -> std::size_t {
+  return static_cast<std::size_t>(priority);
+}
+
+auto tag_index(TaskTag tag) -> std::size_t { return static_cast<std::size_t>(tag); }
+
+// 计数与出队在同一把锁内完成，queued_tasks 不会短暂多于实际可取的任务，空闲线程不会空转
+auto take_locked(WorkerPoolState& pool, std::deque<PoolTask>& tasks,
+                 std::atomic<std::size_t>& size, bool from_back) -> PoolTask {
+  auto task = std::move(from_back ? tasks.back() : tasks.front());
+  if (from_back) {
+    tasks.pop_back();
+  } else {
+    tasks.pop_front();
+  }
+  size.fetch_sub(1, std::memory_order_relaxed);
+  pool.queued_tasks.fetch_sub(1);
+  return task;
+}
+
+// 优先级从高到低依次查看：本线程队列尾部、全局注入队列、其他线程队列头部
+auto try_take_task(WorkerPoolState& pool, std::size_t self) -> std::optional<PoolTask> {
+  auto& own = *pool.worker_queues[self];
+  const auto worker_count = pool.worker_queues.size();
+
+  for (std::size_t priority = 0; priority < kTaskPriorityCount; ++priority) {
+    if (own.sizes[priority].load(std::memory_order_relaxed) > 0) {
+      std::lock_guard<std::mutex> lock(own.mutex);
+      if (!own.tasks[priority].empty()) {
+        return take_locked(pool, own.tasks[priority], own.sizes[priority], true);
+      }
+    }
+
+    if (pool.injected_sizes[priority].load(std::memory_order_relaxed) > 0) {
+      std::lock_guard<std::mutex> lock(pool.injection_mutex);
+      if (!pool.injection_queues[priority].empty()) {
+        return take_locked(pool, pool.injection_queues[priority], pool.injected_sizes[priority],
+                           false);
+      }
+    }
+
+    for (std::size_t offset = 1; offset < worker_count; ++offset) {
+      auto& victim = *pool.worker_queues[(self + offset) % worker_count];
+      if (victim.sizes[priority].load(std::memory_order_relaxed) == 0) {
+        continue;
+      }
+      std::lock_guard<std::mutex> lock(victim.mutex);
+      if (!victim.tasks[priority].empty()) {
+        pool.steals.fetch_add(1, std::memory_order_relaxed);
+        return take_locked(pool, victim.tasks[priority], victim.sizes[priority], false);
+      }
+    }
+  }
+  return std::nullopt;
+}
+
+auto run_task(WorkerPoolState& pool, PoolTask& task) -> void {
+  const auto tag = tag_index(task.tag);
+  const auto started_at = executor_metrics::begin_task(pool.metrics, tag, task.enqueued_at);
+  current_tag = task.tag;
+  try {
+    core::tracing::Span span(task_tag_name(task.tag).data(), "worker_pool");
+    task.run();
+  } catch (const std::exception& e) {
+    Logger().error("WorkerPool task execution error: {}", e.what());
+  } catch (...) {
+    Logger().error("WorkerPool task execution unknown error");
+  }
+  current_tag = TaskTag::General;
+  executor_metrics::end_task(pool.metrics, tag, task.enqueued_at, started_at);
+  pool.tag_counters[tag].completed.fetch_add(1, std::memory_order_relaxed);
+}
+
+// 已有线程醒着找活时不再唤醒新的，找到任务的线程负责接力唤醒下一个，避免一次提交惊醒一片
+auto wake_one_worker(WorkerPoolState& pool) -> void {
+  if (pool.searching_workers.load() == 0 && pool.sleeping_workers.load() > 0) {
+    std::lock_guard<std::mutex> lock(pool.sleep_mutex);
+    pool.condition.notify_one();
+  }
+}
+
+// 工作线程主循环：关闭后继续排空已接收任务，避免遗弃任务持有的同步计数。
+auto run_worker(WorkerPoolState& pool, std::size_t index) -> void {
+  current_pool = &pool;
+  current_worker_index = index;
+  core::tracing::set_thread_name(std::format("worker_pool/{}", index));
+  bool searching = false;
+
+  while (true) {
+    if (auto task = try_take_task(pool, index)) {
+      if (searching) {
+        searching = false;
+        if (pool.searching_workers.fetch_sub(1) == 1) {
+          wake_one_worker(pool);
+        }
+      }
+      run_task(pool, *task);
+      continue;
+    }
+
+    if (searching) {
+      searching = false;
+      pool.searching_workers.fetch_sub(1);
+    }
+
+    std::unique_lock<std::mutex> lock(pool.sleep_mutex);
+    // 提交方先递增 queued_tasks 再读取 searching/sleeping，与这里相反的顺序保证至少一方看到对方
+    pool.sleeping_workers.fetch_add(1);
+    pool.condition.wait(lock, [&pool] {
+      return pool.shutdown_requested.load() || pool.queued_tasks.load() > 0;
+    });
+    pool.sleeping_workers.fetch_sub(1);
+
+    // 关闭且所有队列已经排空后再退出，保证每个已接收任务都有机会完成收尾。
+    if (pool.shutdown_requested.load() && pool.queued_tasks.load() == 0) {
+      break;
+    }
+    searching = true;
+    pool.searching_workers.fetch_add(1);
   }
-  auto& pool = *state.worker_pool;
 
+  current_pool = nullptr;
+}
+
+auto clear_queues(WorkerPoolState& pool) -> void {
+  pool.worker_queues.clear();
+  {
+    std::lock_guard<std::mutex> lock(pool.injection_mutex);
+    for (auto& tasks : pool.injection_queues) {
+      tasks.clear();
+    }
+    for (auto& size : pool.injected_sizes) {
+      size = 0;
+    }
+  }
+  pool.queued_tasks = 0;
+}
+
+auto start_pool(WorkerPoolState& pool, size_t thread_count) -> std::expected<void, std::string> {
   // 检查是否已经运行
   if (pool.is_running.exchange(true)) {
     Logger().warn("WorkerPool already started");
@@ -29,45 +169,18 @@ auto start(core::AppState& state, size_t thread_count) -> std::expected<void, st
 
     Logger().info("Starting WorkerPool with {} threads", thread_count);
 
+    // 队列必须先于线程就绪，工作线程会立即互相窃取
+    pool.worker_queues.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; ++i) {
+      pool.worker_queues.push_back(std::make_unique<WorkerQueue>());
+    }
+
     // 创建工作线程池
     pool.worker_threads.reserve(thread_count);
     for (size_t i = 0; i < thread_count; ++i) {
       pool.worker_threads.emplace_back([&pool, i]() {
         try {
-          // 工作线程主循环：关闭后继续排空已接收任务，避免遗弃任务持有的同步计数。
-          while (true) {
-            std::move_only_function<void()> task;
-
-            // 从任务队列获取任务
-            {
-              std::unique_lock<std::mutex> lock(pool.queue_mutex);
-              pool.condition.wait(lock, [&pool] {
-                return pool.shutdown_requested.load() || !pool.task_queue.empty();
-              });
-
-              // 关闭且队列已经排空后再退出，保证每个已接收任务都有机会完成收尾。
-              if (pool.shutdown_requested.load() && pool.task_queue.empty()) {
-                break;
-              }
-
-              // 获取任务
-              if (!pool.task_queue.empty()) {
-                task = std::move(pool.task_queue.front());
-                pool.task_queue.pop();
-              }
-            }
-
-            // 执行任务
-            if (task) {
-              try {
-                task();
-              } catch (const std::exception& e) {
-                Logger().error("WorkerPool task execution error: {}", e.what());
-              } catch (...) {
-                Logger().error("WorkerPool task execution unknown error");
-              }
-            }
-          }
+          run_worker(pool, i);
         } catch (const std::exception& e) {
           Logger().error("WorkerPool worker thread {} error: {}", i, e.what());
         }
@@ -79,14 +192,13 @@ auto start(core::AppState& state, size_t thread_count) -> std::expected<void, st
 
   } catch (const std::exception& e) {
     // 部分线程可能已经启动；唤醒并等待它们退出后再恢复为空闲状态。
-    pool.shutdown_requested = true;
-    pool.condition.notify_all();
-    pool.worker_threads.clear();
     {
-      std::lock_guard<std::mutex> lock(pool.queue_mutex);
-      std::queue<std::move_only_function<void()>> empty;
-      pool.task_queue.swap(empty);
+      std::lock_guard<std::mutex> lock(pool.sleep_mutex);
+      pool.shutdown_requested = true;
     }
+    pool.condition.notify_all();
+    pool.worker_threads.clear();
+    clear_queues(pool);
     pool.shutdown_requested = false;
     pool.is_running = false;
 
@@ -96,11 +208,7 @@ auto start(core::AppState& state, size_t thread_count) -> std::expected<void, st
   }
 }
 
-auto stop(core::AppState& state) -> void {
-  if (!state.worker_pool) {
-    return;
-  }
-  auto& pool = *state.worker_pool;
+auto stop_pool(WorkerPoolState& pool) -> void {
   if (!pool.is_running.exchange(false)) {
     return;  // 已经停止
   }
@@ -108,14 +216,17 @@ auto stop(core::AppState& state) -> void {
   Logger().info("Stopping WorkerPool");
 
   try {
-    // 与任务提交使用同一把锁，确保关闭开始后不会再有任务成功入队。
+    // 与外部提交使用同一把锁，确保关闭开始后不会再有任务进入注入队列。
     {
-      std::lock_guard<std::mutex> lock(pool.queue_mutex);
+      std::lock_guard<std::mutex> lock(pool.injection_mutex);
       pool.shutdown_requested = true;
     }
 
-    // 唤醒所有工作线程
-    pool.condition.notify_all();
+    // 持有休眠锁再通知，避免线程检查完条件、尚未进入等待时错过唤醒
+    {
+      std::lock_guard<std::mutex> lock(pool.sleep_mutex);
+      pool.condition.notify_all();
+    }
 
     // 等待所有工作线程结束
     for (auto& worker : pool.worker_threads) {
@@ -126,12 +237,7 @@ auto stop(core::AppState& state) -> void {
 
     // 清理资源
     pool.worker_threads.clear();
-    {
-      std::lock_guard<std::mutex> lock(pool.queue_mutex);
-      // 清空任务队列
-      std::queue<std::move_only_function<void()>> empty;
-      pool.task_queue.swap(empty);
-    }
+    clear_queues(pool);
     pool.shutdown_requested = false;
 
     Logger().info("WorkerPool stopped");
@@ -141,6 +247,81 @@ auto stop(core::AppState& state) -> void {
   }
 }
 
+auto submit_to_pool(WorkerPoolState& pool, std::move_only_function<void()> task,
+                    TaskOptions options) -> bool {
+  const auto priority = priority_index(options.priority);
+  PoolTask pool_task{.run = std::move(task),
+                     .tag = options.tag,
+                     .enqueued_at = executor_metrics::enqueue_time(pool.metrics)};
+
+  try {
+    if (current_pool == &pool) {
+      // 本线程正在运行，关闭时也会先排空自己的队列，无需经过注入锁
+      if (pool.shutdown_requested.load()) {
+        return false;
+      }
+      auto& own = *pool.worker_queues[current_worker_index];
+      std::lock_guard<std::mutex> lock(own.mutex);
+      own.tasks[priority].push_back(std::move(pool_task));
+      own.sizes[priority].fetch_add(1, std::memory_order_relaxed);
+      pool.queued_tasks.fetch_add(1);
+    } else {
+      std::lock_guard<std::mutex> lock(pool.injection_mutex);
+      if (!pool.is_running.load() || pool.shutdown_requested.load()) {
+        return false;
+      }
+      pool.injection_queues[priority].push_back(std::move(pool_task));
+      pool.injected_sizes[priority].fetch_add(1, std::memory_order_relaxed);
+      pool.queued_tasks.fetch_add(1);
+    }
+  } catch (const std::exception& e) {
+    Logger().error("Failed to submit task to WorkerPool: {}", e.what());
+    return false;
+  }
+
+  pool.tag_counters[tag_index(options.tag)].submitted.fetch_add(1, std::memory_order_relaxed);
+  wake_one_worker(pool);
+  return true;
+}
+
+auto task_tag_name(TaskTag tag) -> std::string_view {
+  switch (tag) {
+    case TaskTag::General:
+      return "general";
+    case TaskTag::GalleryScan:
+      return "gallery_scan";
+    case TaskTag::GalleryHash:
+      return "gallery_hash";
+    case TaskTag::GalleryThumbnail:
+      return "gallery_thumbnail";
+    case TaskTag::GallerySimilarity:
+      return "gallery_similarity";
+    case TaskTag::GalleryDownload:
+      return "gallery_download";
+    case TaskTag::PhotoExtract:
+      return "photo_extract";
+    case TaskTag::MediaHardlinks:
+      return "media_hardlinks";
+  }
+  return "unknown";
+}
+
+auto current_task_tag() -> TaskTag { return current_tag; }
+
+auto start(core::AppState& state, size_t thread_count) -> std::expected<void, std::string> {
+  if (!state.worker_pool) {
+    return std::unexpected("WorkerPoolState is not initialized");
+  }
+  return start_pool(*state.worker_pool, thread_count);
+}
+
+auto stop(core::AppState& state) -> void {
+  if (!state.worker_pool) {
+    return;
+  }
+  stop_pool(*state.worker_pool);
+}
+
 auto is_running(const core::AppState& state) -> bool {
   if (!state.worker_pool) {
     return false;
@@ -149,25 +330,12 @@ auto is_running(const core::AppState& state) -> bool {
   return pool.is_running.load();
 }
 
-auto submit_task(core::AppState& state, std::move_only_function<void()> task) -> bool {
+auto submit_task(core::AppState& state, std::move_only_function<void()> task,
+                 TaskOptions options) -> bool {
   if (!state.worker_pool) {
     return false;
   }
-  auto& pool = *state.worker_pool;
-  try {
-    {
-      std::lock_guard<std::mutex> lock(pool.queue_mutex);
-      if (!pool.is_running.load() || pool.shutdown_requested.load()) {
-        return false;
-      }
-      pool.task_queue.push(std::move(task));
-    }
-    pool.condition.notify_one();
-    return true;
-  } catch (const std::exception& e) {
-    Logger().error("Failed to submit task to WorkerPool: {}", e.what());
-    return false;
-  }
+  return submit_to_pool(*state.worker_pool, std::move(task), options);
 }
 
 auto get_thread_count(const core::AppState& state) -> size_t {
@@ -182,10 +350,7 @@ auto get_pending_tasks(core::AppState& state) -> size_t {
   if (!state.worker_pool) {
     return 0;
   }
-  auto& pool = *state.worker_pool;
-
-  std::lock_guard<std::mutex> lock(pool.queue_mutex);
-  return pool.task_queue.size();
+  return state.worker_pool->queued_tasks.load();
 }
 
 }  // namespace core::worker_pool
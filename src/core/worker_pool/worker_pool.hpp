@@ -3,6 +3,7 @@
 #include "vendor/std.hpp"
 
 #include "core/state/app_state.hpp"
+#include "core/worker_pool/state.hpp"
 
 namespace core::worker_pool {
 
@@ -15,8 +16,9 @@ auto stop(core::AppState& state) -> void;
 // 检查线程池是否正在运行
 auto is_running(const core::AppState& state) -> bool;
 
-// 提交任务到线程池
-auto submit_task(core::AppState& state, std::move_only_function<void()> task) -> bool;
+// 提交任务到线程池；工作线程内提交的子任务进入本线程队列，不经过全局锁
+auto submit_task(core::AppState& state, std::move_only_function<void()> task,
+                 TaskOptions options = {}) -> bool;
 
 // 获取工作线程数量
 auto get_thread_count(const core::AppState& state) -> size_t;
@@ -24,4 +26,18 @@ auto get_thread_count(const core::AppState& state) -> size_t;
 // 获取待处理任务数量
 auto get_pending_tasks(core::AppState& state) -> size_t;
 
+// 指标与日志中使用的来源名
+auto task_tag_name(TaskTag tag) -> std::string_view;
+
+// 当前线程正在执行的线程池任务来源；池外线程为 General
+auto current_task_tag() -> TaskTag;
+
+// 直接操作线程池状态，供不构造 AppState 的测试和基准使用
+auto start_pool(WorkerPoolState& pool, size_t thread_count) -> std::expected<void, std::string>;
+
+auto stop_pool(WorkerPoolState& pool) -> void;
+
+auto submit_to_pool(WorkerPoolState& pool, std::move_only_function<void()> task,
+                    TaskOptions options = {}) -> bool;
+
 }  // namespace core::worker_pool
@@ -306,7 +306,8 @@ auto query_same_outfit_dye_code_target_asset_ids(
 // 查询指定世界下的照片地图点位。
 // 加载远端地图配置后，对每个点位进行世界归属判定和坐标变换，
 // 只返回属于请求 world_id 的点位，且每个点位已包含 lat/lng。
-auto query_photo_map_points(core::AppState& app_state, const QueryPhotoMapPointsParams& params)
+auto query_photo_map_points(core::AppState& app_state, const QueryPhotoMapPointsParams& params,
+                            std::stop_token stop_token)
     -> asio::awaitable<std::expected<std::vector<PhotoMapPoint>, std::string>> {
   auto where_result =
       features::gallery::asset::query_support::build_unified_where_clause(params.filters, "a");
@@ -363,10 +364,17 @@ auto query_photo_map_points(core::AppState& app_state, const QueryPhotoMapPoints
   )",
                                 where_clause, order_config.indexed_order_clause);
 
-  auto result = core::database::query<PhotoMapPointWithWorldRecord>(app_state, sql, query_params);
+  // 取消作用域不能跨越下面加载地图配置的 co_await
+  auto result = [&] {
+    core::database::CancellationScope cancellation_scope(stop_token);
+    return core::database::query<PhotoMapPointWithWorldRecord>(app_state, sql, query_params);
+  }();
   if (!result) {
     co_return std::unexpected("Failed to query photo map points: " + result.error());
   }
+  if (stop_token.stop_requested()) {
+    co_return std::unexpected("Photo map point query cancelled");
+  }
 
   const auto world_id = world_area::normalize_world_id(params.world_id);
   if (world_id.empty()) {
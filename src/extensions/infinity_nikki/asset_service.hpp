@@ -10,7 +10,9 @@
 
 namespace extensions::infinity_nikki::asset_service {
 
-auto query_photo_map_points(core::AppState& app_state, const QueryPhotoMapPointsParams& params)
+// stop_token 只作用于点位查询本身，地图配置加载不可取消
+auto query_photo_map_points(core::AppState& app_state, const QueryPhotoMapPointsParams& params,
+                            std::stop_token stop_token = {})
     -> asio::awaitable<std::expected<std::vector<PhotoMapPoint>, std::string>>;
 
 auto get_details(core::AppState& app_state, const GetInfinityNikkiDetailsParams& params)
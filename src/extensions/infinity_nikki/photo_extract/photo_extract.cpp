@@ -332,7 +332,8 @@ auto extract_photo_params_from_candidates(
 
           slot_ready_ptr[index].store(true, std::memory_order_release);
           completed_prepare->fetch_add(1, std::memory_order_relaxed);
-        });
+        },
+        {.tag = core::worker_pool::TaskTag::PhotoExtract});
 
     if (!submitted) {
       (*outcomes)[index].error = "Failed to submit prepare task to worker pool";
@@ -167,25 +167,29 @@ auto on_gallery_scan_complete(core::AppState& app_state,
     } else {
       // 扫描结果如何驱动硬链接同步，由 media_hardlinks 自己解释；
       // PhotoService 只负责把 Gallery 的事实转发过去。
-      bool submitted = core::worker_pool::submit_task(app_state, [&app_state,
-                                                                  scan_result = result]() {
-        Logger().info(
-            "InfinityNikki managed hardlink worker start: total={}, new={}, updated={}, "
-            "missing={}, changes={}",
-            scan_result.total_files, scan_result.new_items, scan_result.updated_items,
-            scan_result.missing_items, scan_result.changes.size());
-        auto sync_result =
-            extensions::infinity_nikki::media_hardlinks::apply_scan_result(app_state, scan_result);
-        if (!sync_result) {
-          Logger().warn("InfinityNikki managed hardlinks sync failed: {}", sync_result.error());
-        } else {
-          const auto& r = sync_result.value();
-          Logger().info(
-              "InfinityNikki managed hardlinks synced: source={}, created={}, updated={}, "
-              "removed={}, ignored={}",
-              r.source_count, r.created_count, r.updated_count, r.removed_count, r.ignored_count);
-        }
-      });
+      bool submitted = core::worker_pool::submit_task(
+          app_state,
+          [&app_state, scan_result = result]() {
+            Logger().info(
+                "InfinityNikki managed hardlink worker start: total={}, new={}, updated={}, "
+                "missing={}, changes={}",
+                scan_result.total_files, scan_result.new_items, scan_result.updated_items,
+                scan_result.missing_items, scan_result.changes.size());
+            auto sync_result = extensions::infinity_nikki::media_hardlinks::apply_scan_result(
+                app_state, scan_result);
+            if (!sync_result) {
+              Logger().warn("InfinityNikki managed hardlinks sync failed: {}", sync_result.error());
+            } else {
+              const auto& r = sync_result.value();
+              Logger().info(
+                  "InfinityNikki managed hardlinks synced: source={}, created={}, updated={}, "
+                  "removed={}, ignored={}",
+                  r.source_count, r.created_count, r.updated_count, r.removed_count,
+                  r.ignored_count);
+            }
+          },
+          {.priority = core::worker_pool::TaskPriority::Background,
+           .tag = core::worker_pool::TaskTag::MediaHardlinks});
       if (!submitted) {
         Logger().warn("InfinityNikki hardlinks sync: failed to submit worker task");
       }
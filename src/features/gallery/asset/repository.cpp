@@ -63,6 +63,21 @@ auto make_scanner_update_params(const Asset& item) -> std::vector<core::database
   return params;
 }
 
+// 单条 IN 查询的参数上限，远低于 SQLite 默认变量数限制
+constexpr std::size_t kAssetLookupChunkSize = 500;
+
+auto build_in_clause_placeholders(std::size_t count) -> std::string {
+  std::string placeholders;
+  placeholders.reserve(count * 2);
+  for (std::size_t i = 0; i < count; ++i) {
+    if (i > 0) {
+      placeholders += ",";
+    }
+    placeholders += "?";
+  }
+  return placeholders;
+}
+
 }  // namespace features::gallery::asset::repository::detail
 
 namespace features::gallery::asset::repository {
@@ -229,6 +244,42 @@ auto get_asset_by_path(core::AppState& app_state, const std::string& path)
   return result.value();
 }
 
+auto get_present_assets_by_ids(core::AppState& app_state, const std::vector<std::int64_t>& ids)
+    -> std::expected<std::vector<Asset>, std::string> {
+  std::vector<Asset> assets;
+  assets.reserve(ids.size());
+
+  for (std::size_t offset = 0; offset < ids.size(); offset += detail::kAssetLookupChunkSize) {
+    const auto count = std::min(detail::kAssetLookupChunkSize, ids.size() - offset);
+    auto sql = std::format(R"(
+      SELECT id, name, path, type,
+             NULL AS dominant_color_hex,
+             rating, review_flag,
+             description, width, height, size, extension, mime_type, hash,
+             NULL AS root_id, NULL AS relative_path, folder_id,
+             file_created_at, file_modified_at,
+             created_at, updated_at
+      FROM assets
+      WHERE id IN ({}) AND missing_at IS NULL
+    )",
+                           detail::build_in_clause_placeholders(count));
+
+    std::vector<core::database::DbParam> params;
+    params.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+      params.push_back(ids[offset + i]);
+    }
+
+    auto result = core::database::query<Asset>(app_state, sql, params);
+    if (!result) {
+      return std::unexpected("Failed to query assets by ids: " + result.error());
+    }
+    std::ranges::move(result.value(), std::back_inserter(assets));
+  }
+
+  return assets;
+}
+
 auto has_assets_under_path_prefix(core::AppState& app_state, const std::string& path_prefix)
     -> std::expected<bool, std::string> {
   // 这里不是查“这个目录本身是否有一条 folder 记录”，
@@ -22,6 +22,10 @@ auto get_asset_by_id(core::AppState& app_state, std::int64_t id)
 auto get_asset_by_path(core::AppState& app_state, const std::string& path)
     -> std::expected<std::optional<Asset>, std::string>;
 
+// 按 ID 取回未 missing 的资产，返回顺序不保证与输入一致
+auto get_present_assets_by_ids(core::AppState& app_state, const std::vector<std::int64_t>& ids)
+    -> std::expected<std::vector<Asset>, std::string>;
+
 auto has_assets_under_path_prefix(core::AppState& app_state, const std::string& path_prefix)
     -> std::expected<bool, std::string>;
 
@@ -2,15 +2,21 @@
 
 #include "vendor/std.hpp"
 
+#include "vendor/rfl.hpp"
+
 #include "core/database/database.hpp"
 #include "core/database/types.hpp"
 #include "core/state/app_state.hpp"
 #include "features/gallery/asset/query_support.hpp"
 #include "features/gallery/asset/repository.hpp"
 #include "features/gallery/asset/thumbnail.hpp"
+#include "features/gallery/change_log/repository.hpp"
 #include "features/gallery/color/repository.hpp"
+#include "features/gallery/layout/justified.hpp"
 #include "features/gallery/original_locator.hpp"
+#include "features/gallery/state.hpp"
 #include "features/gallery/types.hpp"
+#include "utils/hash/xxhash.hpp"
 #include "utils/logger/logger.hpp"
 
 namespace features::gallery::asset::service {
@@ -211,6 +217,169 @@ auto query_asset_layout_meta(core::AppState& app_state, const QueryAssetLayoutMe
   return response;
 }
 
+// 按资产顺序与宽高计算布局输入指纹；筛选结果有任何变化都会得到新的指纹
+auto make_layout_input_id(std::span<const AssetLayoutMetaItem> items)
+    -> std::expected<std::string, std::string> {
+  auto state_result = utils::hash::create_state();
+  if (!state_result) {
+    return std::unexpected(state_result.error());
+  }
+  auto& state = state_result.value();
+
+  for (const auto& item : items) {
+    const std::array<std::int64_t, 3> fields{item.id, item.width.value_or(0),
+                                             item.height.value_or(0)};
+    if (auto result = utils::hash::update_state(state.get(), fields.data(), sizeof(fields));
+        !result) {
+      return std::unexpected(result.error());
+    }
+  }
+  return utils::hash::digest_state(state.get());
+}
+
+// 筛选与排序参数的指纹；JSON 字段顺序固定，同一组参数总得到同一指纹
+auto make_layout_query_id(const QueryAssetLayoutMetaParams& params)
+    -> std::expected<std::string, std::string> {
+  auto state_result = utils::hash::create_state();
+  if (!state_result) {
+    return std::unexpected(state_result.error());
+  }
+  auto& state = state_result.value();
+
+  const auto json = rfl::json::write(params);
+  if (auto result = utils::hash::update_state(state.get(), json.data(), json.size()); !result) {
+    return std::unexpected(result.error());
+  }
+  return utils::hash::digest_state(state.get());
+}
+
+// 先取变更游标再查库：期间的新写入只会让缓存项游标偏旧而在下次重查，不会把新数据记成旧版本
+auto make_layout_query_key(core::AppState& app_state, const QueryAssetLayoutMetaParams& params)
+    -> std::expected<layout::LayoutQueryKey, std::string> {
+  auto query_id = make_layout_query_id(params);
+  if (!query_id) {
+    return std::unexpected("Failed to fingerprint asset layout query: " + query_id.error());
+  }
+
+  auto bounds_result = change_log::repository::get_change_log_bounds(app_state);
+  if (!bounds_result) {
+    return std::unexpected(bounds_result.error());
+  }
+  return layout::LayoutQueryKey{.query_id = std::move(query_id.value()),
+                                .generation = bounds_result->last_seq.value_or(0)};
+}
+
+auto make_layout_id(std::string_view input_id, const layout::LayoutOptions& options)
+    -> std::string {
+  return std::format("{}-{}-{}-{}", input_id, options.container_width, options.target_row_height,
+                     options.gap);
+}
+
+// 把布局中与窗口相交的行展开成响应；x 由行内宽度累加得到
+auto slice_layout_rows(const layout::CachedLayout& cached, std::int64_t offset,
+                       std::int64_t height) -> std::vector<AssetLayoutRow> {
+  const auto& items = *cached.items;
+  const auto& computed = *cached.layout;
+  const auto [first, last] = layout::find_rows_in_range(computed, offset, height);
+
+  std::vector<AssetLayoutRow> rows;
+  rows.reserve(last - first);
+  for (auto row_index = first; row_index < last; ++row_index) {
+    const auto& row = computed.rows[row_index];
+    AssetLayoutRow response_row{.index = static_cast<std::int32_t>(row_index),
+                                .top = row.top,
+                                .height = row.height,
+                                .items = {}};
+    response_row.items.reserve(row.item_count);
+
+    std::int32_t x = 0;
+    for (auto item_index = row.first_item; item_index < row.first_item + row.item_count;
+         ++item_index) {
+      const auto width = computed.item_widths[item_index];
+      response_row.items.push_back(
+          AssetLayoutRowItem{.id = items[item_index].id,
+                             .index = static_cast<std::int32_t>(item_index),
+                             .x = x,
+                             .width = width});
+      x += width + computed.options.gap;
+    }
+    rows.push_back(std::move(response_row));
+  }
+  return rows;
+}
+
+auto query_asset_layout(core::AppState& app_state, const QueryAssetLayoutParams& params)
+    -> std::expected<QueryAssetLayoutResponse, std::string> {
+  const layout::LayoutOptions options{.container_width = params.container_width,
+                                      .target_row_height = params.target_row_height,
+                                      .gap = std::max(0, params.gap.value_or(0))};
+  if (options.container_width <= 0 || options.target_row_height <= 0) {
+    return std::unexpected("Container width and target row height must be positive");
+  }
+
+  QueryAssetLayoutMetaParams meta_params{
+      .filters = params.filters, .sort_by = params.sort_by, .sort_order = params.sort_order};
+  auto query_key = make_layout_query_key(app_state, meta_params);
+  if (!query_key) {
+    return std::unexpected(query_key.error());
+  }
+
+  auto& cache = app_state.gallery->layout_cache;
+  std::optional<layout::CachedLayout> cached;
+  if (params.layout_id) {
+    cached = layout::find_cached_layout(cache, *params.layout_id, *query_key);
+  }
+
+  // 旧布局仍有效但宽度或行高变了：沿用其输入重新排版，不必重新查库
+  if (cached && cached->layout->options != options) {
+    auto layout_id = make_layout_id(cached->input_id, options);
+    if (auto resized = layout::find_cached_layout(cache, layout_id, *query_key)) {
+      cached = std::move(resized);
+    } else {
+      cached->layout = std::make_shared<const layout::JustifiedLayout>(
+          layout::compute_justified_layout(*cached->items, options));
+      cached->layout_id = std::move(layout_id);
+      layout::store_cached_layout(cache, *cached);
+    }
+  }
+
+  if (!cached) {
+    auto meta_result = query_asset_layout_meta(app_state, meta_params);
+    if (!meta_result) {
+      return std::unexpected(meta_result.error());
+    }
+
+    auto input_id = make_layout_input_id(meta_result->items);
+    if (!input_id) {
+      return std::unexpected("Failed to fingerprint asset layout input: " + input_id.error());
+    }
+
+    auto layout_id = make_layout_id(*input_id, options);
+    cached = layout::find_cached_layout(cache, layout_id, *query_key);
+    if (!cached) {
+      auto items = std::make_shared<const std::vector<AssetLayoutMetaItem>>(
+          std::move(meta_result->items));
+      auto computed = std::make_shared<const layout::JustifiedLayout>(
+          layout::compute_justified_layout(*items, options));
+      cached = layout::CachedLayout{.layout_id = std::move(layout_id),
+                                    .query_key = std::move(query_key.value()),
+                                    .input_id = std::move(input_id.value()),
+                                    .items = std::move(items),
+                                    .layout = std::move(computed)};
+      layout::store_cached_layout(cache, *cached);
+    }
+  }
+
+  QueryAssetLayoutResponse response;
+  response.layout_id = cached->layout_id;
+  response.total_count = static_cast<std::int32_t>(cached->items->size());
+  response.row_count = static_cast<std::int32_t>(cached->layout->rows.size());
+  response.total_height = cached->layout->total_height;
+  response.rows = slice_layout_rows(*cached, params.scroll_offset.value_or(0),
+                                    params.viewport_height.value_or(0));
+  return response;
+}
+
 auto get_timeline_buckets(core::AppState& app_state, const TimelineBucketsParams& params)
     -> std::expected<TimelineBucketsResponse, std::string> {
   // 将 TimelineBucketsParams 转换为 QueryAssetsFilters，复用统一的过滤逻辑
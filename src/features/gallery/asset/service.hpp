@@ -14,6 +14,10 @@ auto query_assets(core::AppState& app_state, const QueryAssetsParams& params)
 auto query_asset_layout_meta(core::AppState& app_state, const QueryAssetLayoutMetaParams& params)
     -> std::expected<QueryAssetLayoutMetaResponse, std::string>;
 
+// 服务端 justified 排版，只返回与滚动窗口相交的行
+auto query_asset_layout(core::AppState& app_state, const QueryAssetLayoutParams& params)
+    -> std::expected<QueryAssetLayoutResponse, std::string>;
+
 auto get_timeline_buckets(core::AppState& app_state, const TimelineBucketsParams& params)
     -> std::expected<TimelineBucketsResponse, std::string>;
 
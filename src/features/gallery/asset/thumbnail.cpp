@@ -4,6 +4,7 @@
 
 #include "core/database/database.hpp"
 #include "core/state/app_state.hpp"
+#include "core/worker_pool/parallel.hpp"
 #include "features/gallery/asset/service.hpp"
 #include "features/gallery/state.hpp"
 #include "features/gallery/types.hpp"
@@ -168,125 +169,161 @@ auto scan_existing_thumbnail_files(core::AppState& app_state)
   return entries;
 }
 
-// 只负责补“缺失缩略图”；孤儿删除由上层全局对账处理。
-// 如果调用方已经事先拿到了 existing_hashes，就不必再逐个 hash 查磁盘了。
-auto repair_expected_thumbnail_entries(
-    core::AppState& app_state,
-    const std::unordered_map<std::string, ExpectedThumbnailEntry>& expected_entries,
-    const std::unordered_set<std::string>* existing_hashes, std::uint32_t short_edge_size,
-    std::stop_token stop_token) -> MissingThumbnailRepairSummary {
+// 每个并行参与者一份；参与者始终在同一线程上运行，线程绑定的 WIC 工厂可以随之缓存
+struct ThumbnailRepairWorker {
   MissingThumbnailRepairSummary stats;
-  stats.candidate_hashes = static_cast<int>(expected_entries.size());
-
   std::optional<utils::image::WICFactory> wic_factory;
+};
 
-  for (const auto& [hash, entry] : expected_entries) {
-    // 当前文件自然完成，停止后不再开始修复下一个缩略图。
-    if (stop_token.stop_requested()) {
-      break;
+auto repair_expected_thumbnail_entry(core::AppState& app_state, const std::string& hash,
+                                     const ExpectedThumbnailEntry& entry,
+                                     const std::unordered_set<std::string>* existing_hashes,
+                                     std::uint32_t short_edge_size, ThumbnailRepairWorker& worker)
+    -> void {
+  bool thumbnail_exists = false;
+
+  if (existing_hashes != nullptr) {
+    thumbnail_exists = existing_hashes->contains(hash);
+  } else {
+    auto thumbnail_path_result = ensure_thumbnail_path(app_state, hash);
+    if (!thumbnail_path_result) {
+      worker.stats.failed_repairs++;
+      Logger().warn("Failed to resolve thumbnail path for hash {}: {}", hash,
+                    thumbnail_path_result.error());
+      return;
     }
 
-    bool thumbnail_exists = false;
+    std::error_code exists_ec;
+    thumbnail_exists = std::filesystem::exists(thumbnail_path_result.value(), exists_ec);
+    if (exists_ec) {
+      worker.stats.failed_repairs++;
+      Logger().warn("Failed to check thumbnail existence for hash {}: {}", hash,
+                    exists_ec.message());
+      return;
+    }
+  }
 
-    if (existing_hashes != nullptr) {
-      thumbnail_exists = existing_hashes->contains(hash);
-    } else {
-      auto thumbnail_path_result = ensure_thumbnail_path(app_state, hash);
-      if (!thumbnail_path_result) {
-        stats.failed_repairs++;
-        Logger().warn("Failed to resolve thumbnail path for hash {}: {}", hash,
-                      thumbnail_path_result.error());
-        continue;
-      }
+  if (thumbnail_exists) {
+    return;
+  }
 
-      std::error_code exists_ec;
-      thumbnail_exists = std::filesystem::exists(thumbnail_path_result.value(), exists_ec);
-      if (exists_ec) {
-        stats.failed_repairs++;
-        Logger().warn("Failed to check thumbnail existence for hash {}: {}", hash,
-                      exists_ec.message());
-        continue;
-      }
-    }
+  worker.stats.missing_thumbnails++;
 
-    if (thumbnail_exists) {
-      continue;
+  std::optional<std::filesystem::path> source_path;
+  // 同一个 hash 可能来自多份重复内容；这里选任意一份还存在的源文件即可重建缩略图。
+  for (const auto& candidate_path : entry.source_paths) {
+    std::error_code source_ec;
+    bool exists = std::filesystem::exists(candidate_path, source_ec);
+    bool is_regular = exists && std::filesystem::is_regular_file(candidate_path, source_ec);
+    if (!source_ec && exists && is_regular) {
+      source_path = candidate_path;
+      break;
     }
+  }
 
-    stats.missing_thumbnails++;
+  if (!source_path.has_value()) {
+    worker.stats.skipped_missing_sources++;
+    Logger().debug("Skip thumbnail repair for hash {}: no source file is available", hash);
+    return;
+  }
 
-    std::optional<std::filesystem::path> source_path;
-    // 同一个 hash 可能来自多份重复内容；这里选任意一份还存在的源文件即可重建缩略图。
-    for (const auto& candidate_path : entry.source_paths) {
-      std::error_code source_ec;
-      bool exists = std::filesystem::exists(candidate_path, source_ec);
-      bool is_regular = exists && std::filesystem::is_regular_file(candidate_path, source_ec);
-      if (!source_ec && exists && is_regular) {
-        source_path = candidate_path;
-        break;
+  if (entry.type == "photo") {
+    if (!worker.wic_factory.has_value()) {
+      auto wic_result = utils::image::get_thread_wic_factory();
+      if (!wic_result) {
+        worker.stats.failed_repairs++;
+        Logger().warn("Failed to initialize WIC factory for thumbnail repair: {}",
+                      wic_result.error());
+        return;
       }
+      worker.wic_factory = std::move(wic_result.value());
     }
 
-    if (!source_path.has_value()) {
-      stats.skipped_missing_sources++;
-      Logger().debug("Skip thumbnail repair for hash {}: no source file is available", hash);
-      continue;
+    auto repair_result = generate_thumbnail(app_state, *worker.wic_factory, *source_path, hash,
+                                            short_edge_size, false);
+    if (!repair_result) {
+      worker.stats.failed_repairs++;
+      Logger().warn("Failed to repair thumbnail for '{}': {}", source_path->string(),
+                    repair_result.error());
+      return;
     }
 
-    if (entry.type == "photo") {
-      if (!wic_factory.has_value()) {
-        auto wic_result = utils::image::get_thread_wic_factory();
-        if (!wic_result) {
-          stats.failed_repairs++;
-          Logger().warn("Failed to initialize WIC factory for thumbnail repair: {}",
-                        wic_result.error());
-          continue;
-        }
-        wic_factory = std::move(wic_result.value());
-      }
+    worker.stats.repaired_thumbnails++;
+    return;
+  }
 
-      auto repair_result =
-          generate_thumbnail(app_state, *wic_factory, *source_path, hash, short_edge_size, false);
-      if (!repair_result) {
-        stats.failed_repairs++;
-        Logger().warn("Failed to repair thumbnail for '{}': {}", source_path->string(),
-                      repair_result.error());
-        continue;
-      }
+  if (entry.type == "video") {
+    auto video_result =
+        utils::media::video_asset::analyze_video_file(*source_path, short_edge_size);
+    if (!video_result) {
+      worker.stats.failed_repairs++;
+      Logger().warn("Failed to analyze video during thumbnail repair '{}': {}",
+                    source_path->string(), video_result.error());
+      return;
+    }
 
-      stats.repaired_thumbnails++;
-      continue;
+    if (!video_result->thumbnail.has_value()) {
+      worker.stats.failed_repairs++;
+      Logger().warn("Video thumbnail repair yielded no thumbnail data: {}",
+                    source_path->string());
+      return;
     }
 
-    if (entry.type == "video") {
-      auto video_result =
-          utils::media::video_asset::analyze_video_file(*source_path, short_edge_size);
-      if (!video_result) {
-        stats.failed_repairs++;
-        Logger().warn("Failed to analyze video during thumbnail repair '{}': {}",
-                      source_path->string(), video_result.error());
-        continue;
-      }
+    auto repair_result = save_thumbnail_data(app_state, hash, *video_result->thumbnail, false);
+    if (!repair_result) {
+      worker.stats.failed_repairs++;
+      Logger().warn("Failed to save repaired video thumbnail for '{}': {}", source_path->string(),
+                    repair_result.error());
+      return;
+    }
 
-      if (!video_result->thumbnail.has_value()) {
-        stats.failed_repairs++;
-        Logger().warn("Video thumbnail repair yielded no thumbnail data: {}",
-                      source_path->string());
-        continue;
-      }
+    worker.stats.repaired_thumbnails++;
+  }
+}
 
-      auto repair_result = save_thumbnail_data(app_state, hash, *video_result->thumbnail, false);
-      if (!repair_result) {
-        stats.failed_repairs++;
-        Logger().warn("Failed to save repaired video thumbnail for '{}': {}", source_path->string(),
-                      repair_result.error());
-        continue;
-      }
+// 只负责补“缺失缩略图”；孤儿删除由上层全局对账处理。
+// 如果调用方已经事先拿到了 existing_hashes，就不必再逐个 hash 查磁盘了。
+auto repair_expected_thumbnail_entries(
+    core::AppState& app_state,
+    const std::unordered_map<std::string, ExpectedThumbnailEntry>& expected_entries,
+    const std::unordered_set<std::string>* existing_hashes, std::uint32_t short_edge_size,
+    std::stop_token stop_token) -> MissingThumbnailRepairSummary {
+  MissingThumbnailRepairSummary stats;
+  stats.candidate_hashes = static_cast<int>(expected_entries.size());
 
-      stats.repaired_thumbnails++;
-    }
+  const auto entries = expected_entries |
+                       std::views::transform([](const auto& pair) { return &pair; }) |
+                       std::ranges::to<std::vector>();
+
+  std::vector<ThumbnailRepairWorker> workers;
+  try {
+    workers = core::worker_pool::parallel_collect<ThumbnailRepairWorker>(
+        app_state, entries.size(),
+        {.grain = 4,
+         .task = {.priority = core::worker_pool::TaskPriority::Background,
+                  .tag = core::worker_pool::TaskTag::GalleryThumbnail},
+         .stop_token = stop_token},
+        [&](std::size_t begin, std::size_t end, ThumbnailRepairWorker& worker) {
+          for (auto i = begin; i < end; ++i) {
+            // 当前文件自然完成，停止后不再开始修复下一个缩略图。
+            if (stop_token.stop_requested()) {
+              return;
+            }
+            const auto& [hash, entry] = *entries[i];
+            repair_expected_thumbnail_entry(app_state, hash, entry, existing_hashes,
+                                            short_edge_size, worker);
+          }
+        });
+  } catch (const std::exception& e) {
+    Logger().error("Thumbnail repair failed: {}", e.what());
   }
 
+  for (const auto& worker : workers) {
+    stats.missing_thumbnails += worker.stats.missing_thumbnails;
+    stats.repaired_thumbnails += worker.stats.repaired_thumbnails;
+    stats.failed_repairs += worker.stats.failed_repairs;
+    stats.skipped_missing_sources += worker.stats.skipped_missing_sources;
+  }
   return stats;
 }
 
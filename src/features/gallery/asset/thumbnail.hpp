@@ -64,6 +64,10 @@ auto save_thumbnail_data(core::AppState& app_state, const std::string& file_hash
     -> std::expected<std::filesystem::path, std::string>;
 
 // 路径管理
+// 按 hash 前两级目录拼出缩略图路径，不检查文件是否存在。
+auto build_thumbnail_path(const std::filesystem::path& thumbnails_dir, const std::string& file_hash)
+    -> std::filesystem::path;
+
 auto ensure_thumbnails_directory_exists(core::AppState& app_state)
     -> std::expected<void, std::string>;
 
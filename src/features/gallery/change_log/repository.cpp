@@ -0,0 +1,53 @@
+#include "features/gallery/change_log/repository.hpp"
+
+#include "vendor/std.hpp"
+
+#include "core/database/database.hpp"
+#include "core/state/app_state.hpp"
+#include "features/gallery/change_log/types.hpp"
+
+namespace features::gallery::change_log::repository {
+
+auto get_change_log_bounds(core::AppState& app_state)
+    -> std::expected<ChangeLogBounds, std::string> {
+  static const std::string kQuerySql = R"(
+    SELECT
+      (SELECT MIN(seq) FROM gallery_change_log) AS first_seq,
+      (SELECT seq FROM sqlite_sequence WHERE name = 'gallery_change_log') AS last_seq
+  )";
+
+  auto result = core::database::query_single<ChangeLogBounds>(app_state, kQuerySql);
+  if (!result) {
+    return std::unexpected("Failed to query gallery change log bounds: " + result.error());
+  }
+  return result->value_or(ChangeLogBounds{});
+}
+
+auto list_changes_after(core::AppState& app_state, std::int64_t after_seq, std::int64_t limit)
+    -> std::expected<std::vector<ChangeLogRow>, std::string> {
+  static const std::string kQuerySql = R"(
+    SELECT seq, entity, entity_id, op
+    FROM gallery_change_log
+    WHERE seq > ?
+    ORDER BY seq
+    LIMIT ?
+  )";
+
+  auto result = core::database::query<ChangeLogRow>(app_state, kQuerySql, {after_seq, limit});
+  if (!result) {
+    return std::unexpected("Failed to list gallery changes: " + result.error());
+  }
+  return result.value();
+}
+
+auto delete_changes_up_to(core::AppState& app_state, std::int64_t seq)
+    -> std::expected<void, std::string> {
+  auto result =
+      core::database::execute(app_state, "DELETE FROM gallery_change_log WHERE seq <= ?", {seq});
+  if (!result) {
+    return std::unexpected("Failed to trim gallery change log: " + result.error());
+  }
+  return {};
+}
+
+}  // namespace features::gallery::change_log::repository
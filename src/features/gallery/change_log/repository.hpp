@@ -0,0 +1,21 @@
+#pragma once
+
+#include "vendor/std.hpp"
+
+#include "core/state/app_state.hpp"
+#include "features/gallery/change_log/types.hpp"
+
+namespace features::gallery::change_log::repository {
+
+auto get_change_log_bounds(core::AppState& app_state)
+    -> std::expected<ChangeLogBounds, std::string>;
+
+// 按 seq 升序列出游标之后的变更
+auto list_changes_after(core::AppState& app_state, std::int64_t after_seq, std::int64_t limit)
+    -> std::expected<std::vector<ChangeLogRow>, std::string>;
+
+// 删除 seq 不大于给定值的变更
+auto delete_changes_up_to(core::AppState& app_state, std::int64_t seq)
+    -> std::expected<void, std::string>;
+
+}  // namespace features::gallery::change_log::repository
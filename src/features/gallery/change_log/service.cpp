@@ -0,0 +1,164 @@
+#include "features/gallery/change_log/service.hpp"
+
+#include "vendor/std.hpp"
+
+#include "vendor/asio.hpp"
+
+#include "core/async/async.hpp"
+#include "core/state/app_state.hpp"
+#include "features/gallery/asset/repository.hpp"
+#include "features/gallery/change_log/repository.hpp"
+#include "features/gallery/change_log/types.hpp"
+#include "features/gallery/types.hpp"
+#include "utils/logger/logger.hpp"
+
+namespace features::gallery::change_log::service {
+
+constexpr std::int32_t kDefaultChangeLimit = 1000;
+constexpr std::int32_t kMaxChangeLimit = 5000;
+// 全量扫描一次新增上万资产也能覆盖，日志体积仍在几 MB 以内
+constexpr std::int64_t kRetainedChangeCount = 100000;
+// 一次全量扫描写入的条数也远小于保留条数，每小时裁剪足以控制体积
+constexpr auto kTrimInterval = std::chrono::hours(1);
+
+// 实体 ID -> 区间内最后一次操作是否为 upsert，std::map 让输出按 ID 有序
+using LatestOps = std::map<std::int64_t, bool>;
+
+auto split_latest_ops(const LatestOps& ops, std::vector<std::int64_t>& upserted,
+                      std::vector<std::int64_t>& removed) -> void {
+  for (const auto& [entity_id, is_upsert] : ops) {
+    (is_upsert ? upserted : removed).push_back(entity_id);
+  }
+}
+
+auto get_changes_since(core::AppState& app_state, const GalleryChangesSinceParams& params)
+    -> std::expected<GalleryChangesSinceResponse, std::string> {
+  GalleryChangesSinceResponse response;
+
+  if (!params.cursor.has_value()) {
+    auto bounds_result = repository::get_change_log_bounds(app_state);
+    if (!bounds_result) {
+      return std::unexpected(bounds_result.error());
+    }
+    response.cursor = bounds_result->last_seq.value_or(0);
+    return response;
+  }
+
+  const auto cursor = params.cursor.value();
+  if (cursor < 0) {
+    return std::unexpected("Invalid change cursor: " + std::to_string(cursor));
+  }
+  const auto limit = std::clamp(params.limit.value_or(kDefaultChangeLimit), 1, kMaxChangeLimit);
+
+  auto rows_result = repository::list_changes_after(app_state, cursor, limit);
+  if (!rows_result) {
+    return std::unexpected(rows_result.error());
+  }
+  const auto& rows = rows_result.value();
+
+  // 先读变更再读边界：两次查询之间发生裁剪时宁可多一次重载，也不漏掉变更
+  auto bounds_result = repository::get_change_log_bounds(app_state);
+  if (!bounds_result) {
+    return std::unexpected(bounds_result.error());
+  }
+  const auto& bounds = bounds_result.value();
+  const auto last_seq = bounds.last_seq.value_or(0);
+  const bool trimmed =
+      bounds.first_seq.has_value() ? cursor < bounds.first_seq.value() - 1 : cursor < last_seq;
+  // 游标超过最新值说明数据库被重建或从备份恢复
+  if (trimmed || cursor > last_seq) {
+    response.cursor = last_seq;
+    response.resync_required = true;
+    return response;
+  }
+
+  LatestOps asset_ops;
+  LatestOps folder_ops;
+  LatestOps tag_ops;
+  for (const auto& row : rows) {
+    auto& ops = row.entity == "asset" ? asset_ops : row.entity == "folder" ? folder_ops : tag_ops;
+    ops[row.entity_id] = row.op == "upsert";
+  }
+
+  std::vector<std::int64_t> upserted_asset_ids;
+  split_latest_ops(asset_ops, upserted_asset_ids, response.removed_asset_ids);
+  split_latest_ops(folder_ops, response.upserted_folder_ids, response.removed_folder_ids);
+  split_latest_ops(tag_ops, response.upserted_tag_ids, response.removed_tag_ids);
+
+  if (!upserted_asset_ids.empty()) {
+    auto assets_result =
+        asset::repository::get_present_assets_by_ids(app_state, upserted_asset_ids);
+    if (!assets_result) {
+      return std::unexpected(assets_result.error());
+    }
+    response.upserted_assets = std::move(assets_result.value());
+    std::ranges::sort(response.upserted_assets, {}, &Asset::id);
+
+    // 变更后不再可见（missing 或已删除）的资产对前端而言等同于移除
+    for (const auto asset_id : upserted_asset_ids) {
+      if (!std::ranges::binary_search(response.upserted_assets, asset_id, {}, &Asset::id)) {
+        response.removed_asset_ids.push_back(asset_id);
+      }
+    }
+    std::ranges::sort(response.removed_asset_ids);
+  }
+
+  response.cursor = rows.empty() ? cursor : rows.back().seq;
+  response.has_more = rows.size() == static_cast<std::size_t>(limit);
+  return response;
+}
+
+auto trim_change_log(core::AppState& app_state) -> std::expected<void, std::string> {
+  auto bounds_result = repository::get_change_log_bounds(app_state);
+  if (!bounds_result) {
+    return std::unexpected(bounds_result.error());
+  }
+  const auto& bounds = bounds_result.value();
+  if (!bounds.first_seq.has_value() || !bounds.last_seq.has_value()) {
+    return {};
+  }
+
+  const auto trim_up_to = bounds.last_seq.value() - kRetainedChangeCount;
+  if (bounds.first_seq.value() > trim_up_to) {
+    return {};
+  }
+
+  if (auto delete_result = repository::delete_changes_up_to(app_state, trim_up_to);
+      !delete_result) {
+    return std::unexpected(delete_result.error());
+  }
+  Logger().info("Trimmed gallery change log up to seq {}", trim_up_to);
+  return {};
+}
+
+// 变更日志只服务增量同步，裁剪失败只记日志，下一轮再试
+auto trim_change_log_loop(core::AppState& app_state) -> asio::awaitable<void> {
+  asio::steady_timer timer(co_await asio::this_coro::executor);
+  while (true) {
+    if (auto trim_result = trim_change_log(app_state); !trim_result) {
+      Logger().warn("Failed to trim gallery change log: {}", trim_result.error());
+    }
+
+    timer.expires_after(kTrimInterval);
+    std::error_code wait_error;
+    co_await timer.async_wait(asio::redirect_error(asio::use_awaitable, wait_error));
+    if (wait_error) {
+      co_return;
+    }
+  }
+}
+
+auto start_trim_loop(core::AppState& app_state) -> void {
+  auto* io_context = core::async::get_io_context(app_state);
+  if (!io_context) {
+    Logger().warn("IO context unavailable, gallery change log trimmed only once");
+    if (auto trim_result = trim_change_log(app_state); !trim_result) {
+      Logger().warn("Failed to trim gallery change log: {}", trim_result.error());
+    }
+    return;
+  }
+  asio::co_spawn(*io_context, trim_change_log_loop(app_state),
+                 core::async::log_completion("Gallery change log trim"));
+}
+
+}  // namespace features::gallery::change_log::service
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "vendor/std.hpp"
+
+#include "core/state/app_state.hpp"
+#include "features/gallery/types.hpp"
+
+namespace features::gallery::change_log::service {
+
+// 游标已被裁剪或不属于当前数据库时返回 resync_required
+auto get_changes_since(core::AppState& app_state, const GalleryChangesSinceParams& params)
+    -> std::expected<GalleryChangesSinceResponse, std::string>;
+
+// 只保留最近的固定条数，更早的游标需要前端整页重载
+auto trim_change_log(core::AppState& app_state) -> std::expected<void, std::string>;
+
+// 在异步运行时上立即裁剪一次，之后按固定间隔重复，长时间运行也不会无限增长
+auto start_trim_loop(core::AppState& app_state) -> void;
+
+}  // namespace features::gallery::change_log::service
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "vendor/std.hpp"
+
+namespace features::gallery::change_log {
+
+// entity 为 "asset" | "folder" | "tag"，op 为 "upsert" | "remove"
+struct ChangeLogRow {
+  std::int64_t seq = 0;
+  std::string entity;
+  std::int64_t entity_id = 0;
+  std::string op;
+};
+
+// last_seq 取自 sqlite_sequence，日志被裁空后仍是最新游标
+struct ChangeLogBounds {
+  std::optional<std::int64_t> first_seq;
+  std::optional<std::int64_t> last_seq;
+};
+
+}  // namespace features::gallery::change_log
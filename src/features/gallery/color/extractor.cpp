@@ -85,6 +85,7 @@ auto extract_main_colors_from_bgra(const utils::image::BGRABitmapData& bitmap_da
       utils::image::PaletteExtractOptions{
           .max_samples = options.max_samples,
           .cluster_count = options.cluster_count,
+          .engine = options.engine,
       });
   if (!palette_result) {
     return std::unexpected("Color clustering failed: " + palette_result.error());
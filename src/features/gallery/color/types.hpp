@@ -2,6 +2,8 @@
 
 #include "vendor/std.hpp"
 
+#include "utils/image/palette.hpp"
+
 namespace features::gallery::color {
 
 struct LabColor {
@@ -37,6 +39,8 @@ struct MainColorExtractOptions {
   float merge_delta_e = 8.0f;
   float l_bin_size = 5.0f;
   float ab_bin_size = 8.0f;
+  // 入库主色默认仍走 K-Means；直方图聚类的 bin 与已入库数据不同，只供显式选择
+  utils::image::PaletteEngine engine = utils::image::PaletteEngine::KMeans;
 };
 
 }  // namespace features::gallery::color
@@ -9,6 +9,7 @@
 #include "core/rpc/notification_hub.hpp"
 #include "core/state/app_state.hpp"
 #include "features/gallery/asset/thumbnail.hpp"
+#include "features/gallery/change_log/service.hpp"
 #include "features/gallery/download/download.hpp"
 #include "features/gallery/folder/service.hpp"
 #include "features/gallery/root_availability.hpp"
@@ -97,6 +98,9 @@ auto prepare_runtime_resources(core::AppState& app_state) -> std::expected<void,
                              availability_result.error());
     }
 
+    // 变更日志只服务增量同步，裁剪失败不影响图库启动
+    change_log::service::start_trim_loop(app_state);
+
     // 注册静态服务解析器
     static_resolver::register_http_resolvers(app_state);
     static_resolver::register_webview_resolvers(app_state);
@@ -0,0 +1,132 @@
+#include "features/gallery/layout/justified.hpp"
+
+#include "vendor/std.hpp"
+
+namespace features::gallery::layout {
+
+// 宽高缺失或异常时回退到安全比例，避免单张错误数据把整行布局拉坏
+auto normalize_aspect_ratio(const AssetLayoutMetaItem& item) -> double {
+  if (!item.width || !item.height || *item.width <= 0 || *item.height <= 0) {
+    return 1.0;
+  }
+  return std::clamp(static_cast<double>(*item.width) / *item.height, 0.25, 4.0);
+}
+
+auto compute_justified_layout(std::span<const AssetLayoutMetaItem> items,
+                              const LayoutOptions& options) -> JustifiedLayout {
+  JustifiedLayout layout;
+  layout.options = options;
+  if (items.empty() || options.container_width <= 0 || options.target_row_height <= 0) {
+    return layout;
+  }
+
+  const double gap = std::max(0, options.gap);
+  const double content_width = options.container_width;
+  const double target_row_height = options.target_row_height;
+
+  layout.item_widths.reserve(items.size());
+
+  std::vector<double> aspect_ratios;
+  std::size_t row_begin = 0;
+  double aspect_sum = 0.0;
+  std::int64_t current_top = 0;
+
+  // justify 为 true 时铺满容器宽度；最后一行保持目标高度，不强行拉伸
+  auto finalize_row = [&](bool justify) {
+    const auto count = aspect_ratios.size();
+    if (count == 0) {
+      return;
+    }
+
+    const double available_width =
+        std::max(1.0, content_width - static_cast<double>(count - 1) * gap);
+    const double fitted_height = std::max(1.0, available_width / aspect_sum);
+    const auto row_height = static_cast<std::int32_t>(std::max(
+        1.0, std::round(justify ? fitted_height : std::min(target_row_height, fitted_height))));
+
+    // 普通行用最后一张吸收取整误差，保证整行宽度与容器逐像素一致
+    auto remaining_width = static_cast<std::int64_t>(available_width);
+    for (std::size_t index = 0; index < count; ++index) {
+      auto width = std::max<std::int64_t>(
+          1, static_cast<std::int64_t>(std::round(aspect_ratios[index] * row_height)));
+      if (justify && index == count - 1) {
+        width = std::max<std::int64_t>(1, remaining_width);
+      } else if (justify) {
+        const auto items_after = static_cast<std::int64_t>(count - index - 1);
+        width = std::min(std::max<std::int64_t>(1, remaining_width - items_after), width);
+      }
+      remaining_width -= width;
+      layout.item_widths.push_back(static_cast<std::int32_t>(width));
+    }
+
+    layout.rows.push_back(LayoutRow{.first_item = static_cast<std::uint32_t>(row_begin),
+                                    .item_count = static_cast<std::uint32_t>(count),
+                                    .top = current_top,
+                                    .height = row_height});
+    current_top += row_height + static_cast<std::int64_t>(gap);
+    row_begin += count;
+    aspect_ratios.clear();
+    aspect_sum = 0.0;
+  };
+
+  for (const auto& item : items) {
+    const auto aspect_ratio = normalize_aspect_ratio(item);
+    aspect_ratios.push_back(aspect_ratio);
+    aspect_sum += aspect_ratio;
+
+    // 按目标高度排下当前行后已触达容器宽度，就立即收束成一行
+    const double projected_width =
+        aspect_sum * target_row_height + static_cast<double>(aspect_ratios.size() - 1) * gap;
+    if (projected_width >= content_width) {
+      finalize_row(true);
+    }
+  }
+  finalize_row(false);
+
+  const auto& last_row = layout.rows.back();
+  layout.total_height = last_row.top + last_row.height;
+  return layout;
+}
+
+auto find_rows_in_range(const JustifiedLayout& layout, std::int64_t offset, std::int64_t height)
+    -> std::pair<std::size_t, std::size_t> {
+  const auto& rows = layout.rows;
+  const auto range_end = offset + std::max<std::int64_t>(0, height);
+
+  // 行按 top 单调递增，首个底边越过 offset 的行即窗口起点
+  auto first = std::ranges::partition_point(
+      rows, [offset](const LayoutRow& row) { return row.top + row.height <= offset; });
+  auto last = std::ranges::partition_point(
+      first, rows.end(), [range_end](const LayoutRow& row) { return row.top < range_end; });
+  return {static_cast<std::size_t>(first - rows.begin()),
+          static_cast<std::size_t>(last - rows.begin())};
+}
+
+auto find_cached_layout(LayoutCache& cache, std::string_view layout_id,
+                        const LayoutQueryKey& query_key) -> std::optional<CachedLayout> {
+  std::lock_guard lock(cache.mutex);
+  auto it = std::ranges::find(cache.entries, layout_id, &CachedLayout::layout_id);
+  if (it == cache.entries.end()) {
+    return std::nullopt;
+  }
+  if (it->query_key != query_key) {
+    cache.entries.erase(it);
+    return std::nullopt;
+  }
+  // 命中后移到表头，淘汰时从表尾开始
+  cache.entries.splice(cache.entries.begin(), cache.entries, it);
+  return *it;
+}
+
+auto store_cached_layout(LayoutCache& cache, CachedLayout entry) -> void {
+  std::lock_guard lock(cache.mutex);
+  std::erase_if(cache.entries, [&entry](const CachedLayout& cached) {
+    return cached.layout_id == entry.layout_id;
+  });
+  cache.entries.push_front(std::move(entry));
+  while (cache.entries.size() > kMaxCachedLayouts) {
+    cache.entries.pop_back();
+  }
+}
+
+}  // namespace features::gallery::layout
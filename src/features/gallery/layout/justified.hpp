@@ -0,0 +1,78 @@
+#pragma once
+
+#include "vendor/std.hpp"
+
+#include "features/gallery/types.hpp"
+
+namespace features::gallery::layout {
+
+// 同时保留的布局份数：几种常用宽度 × 少量筛选条件足够覆盖来回调整窗口的场景
+constexpr std::size_t kMaxCachedLayouts = 8;
+
+struct LayoutOptions {
+  // 容器宽度按整像素参与排版，同一像素宽度的结果完全一致，也就是缓存的宽度分桶
+  std::int32_t container_width = 0;
+  std::int32_t target_row_height = 0;
+  std::int32_t gap = 0;
+
+  auto operator==(const LayoutOptions&) const -> bool = default;
+};
+
+struct LayoutRow {
+  std::uint32_t first_item = 0;
+  std::uint32_t item_count = 0;
+  std::int64_t top = 0;
+  std::int32_t height = 0;
+};
+
+// 按资产顺序保存的排版结果；只存每项宽度与行边界，10 万资产也不足 1 MB
+struct JustifiedLayout {
+  LayoutOptions options;
+  std::vector<std::int32_t> item_widths;
+  std::vector<LayoutRow> rows;
+  std::int64_t total_height = 0;
+};
+
+// 布局所依据的查询与数据版本；筛选、排序或图库内容变化后，旧 layout_id 不能再命中
+struct LayoutQueryKey {
+  // 筛选条件与排序参数的指纹
+  std::string query_id;
+  // 查询前图库变更日志的最新游标
+  std::int64_t generation = 0;
+
+  auto operator==(const LayoutQueryKey&) const -> bool = default;
+};
+
+// 同一份输入可被不同宽度复用，调整窗口大小时无需重新查库
+struct CachedLayout {
+  std::string layout_id;
+  LayoutQueryKey query_key;
+  // 只由资产顺序与宽高决定，换宽度时沿用
+  std::string input_id;
+  std::shared_ptr<const std::vector<AssetLayoutMetaItem>> items;
+  std::shared_ptr<const JustifiedLayout> layout;
+};
+
+// 最近使用的布局，按 layout_id 查找；窗口查询拿到 shared_ptr 后在锁外切片
+struct LayoutCache {
+  std::mutex mutex;
+  std::list<CachedLayout> entries;
+};
+
+// 与前端 adaptive 视图相同的 justified 排版：行按目标高度填满后拉伸到容器宽度，
+// 最后一行保持不超过目标高度；宽高缺失的资产按 1:1 处理，极端比例截断到 [0.25, 4]。
+auto compute_justified_layout(std::span<const AssetLayoutMetaItem> items,
+                              const LayoutOptions& options) -> JustifiedLayout;
+
+// 返回与 [offset, offset + height) 相交的行区间 [first, last)，二分查找行边界
+auto find_rows_in_range(const JustifiedLayout& layout, std::int64_t offset, std::int64_t height)
+    -> std::pair<std::size_t, std::size_t>;
+
+// 只有 query_key 也一致时才算命中；不一致说明条件或数据已变，顺带移除该项
+auto find_cached_layout(LayoutCache& cache, std::string_view layout_id,
+                        const LayoutQueryKey& query_key) -> std::optional<CachedLayout>;
+
+// 写入表头；同 ID 旧项被替换，超出 kMaxCachedLayouts 时淘汰最久未用的一项
+auto store_cached_layout(LayoutCache& cache, CachedLayout entry) -> void;
+
+}  // namespace features::gallery::layout
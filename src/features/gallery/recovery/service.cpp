@@ -267,6 +267,12 @@ auto make_rule_fingerprint(core::AppState& app_state, const std::filesystem::pat
                                 rule.rule_pattern));
   }
 
+  // 只有非默认指纹模式写入规则，升级后默认配置的既有基线不会因此失效
+  if (features::gallery::scanner::common::resolve_fingerprint_mode(scan_options.fingerprint_mode) ==
+      features::gallery::scanner::common::FingerprintMode::Full) {
+    lines.push_back("fingerprint:full");
+  }
+
   lines.push_back("scan_semantics:v1");
   std::ranges::sort(lines);
 
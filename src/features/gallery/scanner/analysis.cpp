@@ -2,11 +2,9 @@
 
 #include "vendor/std.hpp"
 
-#include "vendor/wil.hpp"
-#include "vendor/windows.hpp"
-
 #include "core/state/app_state.hpp"
-#include "core/worker_pool/worker_pool.hpp"
+#include "core/tracing/tracing.hpp"
+#include "core/worker_pool/parallel.hpp"
 #include "features/gallery/asset/repository.hpp"
 #include "features/gallery/scanner/common.hpp"
 #include "features/gallery/scanner/progress.hpp"
@@ -59,6 +57,7 @@ auto analyze_file_changes(const std::vector<FileSystemInfo>& file_infos,
 // 并行计算 NEW / NEEDS_HASH_CHECK 的内容指纹，并写回 analysis 状态
 auto calculate_hash_for_targets(core::AppState& app_state,
                                 std::vector<FileAnalysisResult>& analysis_results,
+                                common::FingerprintMode fingerprint_mode,
                                 progress::HashProgressTracker* progress_tracker,
                                 std::stop_token stop_token)
     -> std::expected<std::size_t, std::string> {
@@ -76,63 +75,45 @@ auto calculate_hash_for_targets(core::AppState& app_state,
   }
 
   constexpr size_t HASH_BATCH_SIZE = 32;
-  auto batches =
-      targets_with_index | std::views::chunk(HASH_BATCH_SIZE) | std::ranges::to<std::vector>();
 
-  std::latch completion_latch(batches.size());
-  std::vector<std::pair<size_t, std::string>> all_hashes;
-  std::mutex results_mutex;
-  std::size_t submitted_batches = 0;
-
-  for (const auto& batch : batches) {
-    bool submitted = core::worker_pool::submit_task(
-        app_state, [&all_hashes, &results_mutex, &completion_latch, batch, &analysis_results,
-                    progress_tracker, stop_token]() {
-          auto finish_batch =
-              wil::scope_exit([&completion_latch] { completion_latch.count_down(); });
-
-          auto batch_hashes =
-              batch | std::views::take_while([stop_token](const auto&) {
-                return !stop_token.stop_requested();
-              }) |
-              std::views::transform([progress_tracker, stop_token](const auto& pair)
-                                        -> std::optional<std::pair<size_t, std::string>> {
-                const auto& [idx, analysis] = pair;
-                auto hash_result = common::calculate_content_fingerprint(
-                    analysis.file_info.path, analysis.file_info.size, stop_token);
-                if (progress_tracker) {
-                  progress_tracker->mark_item_hashed();
-                }
-                if (hash_result) {
-                  return std::make_pair(static_cast<size_t>(idx), std::move(hash_result.value()));
-                }
-                if (!stop_token.stop_requested()) {
-                  Logger().warn("Failed to calculate hash for {}: {}",
-                                analysis.file_info.path.string(), hash_result.error());
-                }
-                return std::nullopt;
-              }) |
-              std::views::filter([](const auto& result) { return result.has_value(); }) |
-              std::views::transform([](auto&& result) { return std::move(result.value()); }) |
-              std::ranges::to<std::vector>();
-
-          if (!batch_hashes.empty()) {
-            std::lock_guard<std::mutex> lock(results_mutex);
-            all_hashes.insert(all_hashes.end(), std::make_move_iterator(batch_hashes.begin()),
-                              std::make_move_iterator(batch_hashes.end()));
+  // 每个参与线程写自己的缓冲区，结束后再合并，不需要结果锁
+  using HashBuffer = std::vector<std::pair<size_t, std::string>>;
+  std::vector<HashBuffer> hash_buffers;
+  try {
+    hash_buffers = core::worker_pool::parallel_collect<HashBuffer>(
+        app_state, targets_with_index.size(),
+        {.grain = HASH_BATCH_SIZE,
+         .task = {.priority = core::worker_pool::TaskPriority::Background,
+                  .tag = core::worker_pool::TaskTag::GalleryHash},
+         .stop_token = stop_token},
+        [&app_state, &targets_with_index, fingerprint_mode, progress_tracker, &stop_token](
+            std::size_t begin, std::size_t end, HashBuffer& hashes) {
+          core::tracing::Span span("hash_batch", "scanner");
+          for (auto i = begin; i < end && !stop_token.stop_requested(); ++i) {
+            const auto& [idx, analysis] = targets_with_index[i];
+            auto hash_result = common::calculate_content_fingerprint(
+                app_state, analysis.file_info.path, analysis.file_info.size, stop_token,
+                fingerprint_mode);
+            if (progress_tracker) {
+              progress_tracker->mark_item_hashed();
+            }
+            if (hash_result) {
+              hashes.emplace_back(static_cast<size_t>(idx), std::move(hash_result.value()));
+            } else if (!stop_token.stop_requested()) {
+              Logger().warn("Failed to calculate hash for {}: {}",
+                            analysis.file_info.path.string(), hash_result.error());
+            }
           }
         });
-
-    if (!submitted) {
-      // 已提交批次仍持有局部引用，必须等它们收尾
-      completion_latch.count_down(static_cast<std::ptrdiff_t>(batches.size() - submitted_batches));
-      completion_latch.wait();
-      return std::unexpected("Failed to submit hash calculation task to worker pool");
-    }
-    submitted_batches++;
+  } catch (const std::exception& e) {
+    return std::unexpected(std::string("Hash calculation failed: ") + e.what());
   }
 
-  completion_latch.wait();
+  std::vector<std::pair<size_t, std::string>> all_hashes;
+  for (auto& hashes : hash_buffers) {
+    all_hashes.insert(all_hashes.end(), std::make_move_iterator(hashes.begin()),
+                      std::make_move_iterator(hashes.end()));
+  }
 
   if (stop_token.stop_requested()) {
     return std::unexpected("Gallery scan cancelled");
@@ -174,6 +155,7 @@ auto run_hash_analysis_phase(core::AppState& app_state,
                              const std::function<void(const ScanProgress&)>& progress_callback,
                              std::stop_token stop_token)
     -> std::expected<std::vector<FileAnalysisResult>, std::string> {
+  core::tracing::Span span("hash_analysis_phase", "scanner");
   auto analysis_results =
       analyze_file_changes(file_infos, asset_cache, options.force_reanalyze.value_or(false));
 
@@ -196,7 +178,8 @@ auto run_hash_analysis_phase(core::AppState& app_state,
   }
 
   auto hash_phase = calculate_hash_for_targets(
-      app_state, analysis_results, hash_tracker ? &(*hash_tracker) : nullptr, stop_token);
+      app_state, analysis_results, common::resolve_fingerprint_mode(options.fingerprint_mode),
+      hash_tracker ? &(*hash_tracker) : nullptr, stop_token);
   if (!hash_phase) {
     return std::unexpected("Fingerprint calculation failed: " + hash_phase.error());
   }
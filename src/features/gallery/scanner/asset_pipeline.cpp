@@ -4,6 +4,7 @@
 
 #include "core/database/database.hpp"
 #include "core/state/app_state.hpp"
+#include "core/tracing/tracing.hpp"
 #include "features/gallery/asset/repository.hpp"
 #include "features/gallery/asset/thumbnail.hpp"
 #include "features/gallery/color/extractor.hpp"
@@ -11,6 +12,8 @@
 #include "features/gallery/color/types.hpp"
 #include "features/gallery/ignore/service.hpp"
 #include "features/gallery/scanner/common.hpp"
+#include "features/gallery/similarity/repository.hpp"
+#include "features/gallery/similarity/service.hpp"
 #include "features/gallery/types.hpp"
 #include "utils/image/image.hpp"
 #include "utils/logger/logger.hpp"
@@ -75,9 +78,12 @@ auto prepare_media_asset(core::AppState& app_state, const std::filesystem::path&
 
     std::optional<utils::image::BGRABitmapData> thumbnail_bitmap_data;
 
-    // 缩略图像素同时供主色复用，避免同一照片重复解码缩放
-    auto bitmap_data_result = utils::image::load_scaled_bgra_bitmap_data(
-        photo_wic_factory.get(), normalized_path, kDefaultThumbnailShortEdge);
+    // 缩略图像素同时供主色与 dHash 复用，避免同一照片重复解码缩放
+    auto bitmap_data_result = [&] {
+      core::tracing::Span span("decode_image", "scanner");
+      return utils::image::load_scaled_bgra_bitmap_data(photo_wic_factory.get(), normalized_path,
+                                                        kDefaultThumbnailShortEdge);
+    }();
     if (!bitmap_data_result) {
       Logger().warn("Failed to load thumbnail bitmap data for {}: {}", normalized_path.string(),
                     bitmap_data_result.error());
@@ -87,6 +93,7 @@ auto prepare_media_asset(core::AppState& app_state, const std::filesystem::path&
       if (input.hash.empty()) {
         Logger().warn("Skip thumbnail generation for {}: empty hash", normalized_path.string());
       } else {
+        core::tracing::Span span("save_thumbnail", "scanner");
         auto thumbnail_result = asset::thumbnail::save_thumbnail_from_bgra(
             app_state, input.hash, thumbnail_bitmap_data.value(),
             options.rebuild_thumbnails.value_or(false));
@@ -95,16 +102,28 @@ auto prepare_media_asset(core::AppState& app_state, const std::filesystem::path&
                         thumbnail_result.error());
         }
       }
+
+      auto perceptual_hash_result = features::gallery::similarity::service::
+          compute_bitmap_perceptual_hash(thumbnail_bitmap_data.value());
+      if (perceptual_hash_result) {
+        prepared.perceptual_hash = perceptual_hash_result.value();
+      } else {
+        Logger().warn("Failed to compute perceptual hash for {}: {}", normalized_path.string(),
+                      perceptual_hash_result.error());
+      }
     }
 
     const features::gallery::color::MainColorExtractOptions color_extract_options{
         .sample_short_edge = kDefaultThumbnailShortEdge,
     };
-    auto color_result = thumbnail_bitmap_data.has_value()
-                            ? features::gallery::color::extractor::extract_main_colors_from_bgra(
-                                  thumbnail_bitmap_data.value(), color_extract_options)
-                            : features::gallery::color::extractor::extract_main_colors(
-                                  photo_wic_factory, normalized_path, color_extract_options);
+    auto color_result = [&] {
+      core::tracing::Span span("extract_main_colors", "scanner");
+      return thumbnail_bitmap_data.has_value()
+                 ? features::gallery::color::extractor::extract_main_colors_from_bgra(
+                       thumbnail_bitmap_data.value(), color_extract_options)
+                 : features::gallery::color::extractor::extract_main_colors(
+                       photo_wic_factory, normalized_path, color_extract_options);
+    }();
     if (color_result) {
       prepared.colors = std::move(color_result.value());
     } else {
@@ -114,8 +133,11 @@ auto prepare_media_asset(core::AppState& app_state, const std::filesystem::path&
     }
   } else if (asset_type == "video") {
     // MF：分辨率/时长 + 封面；失败时兜底写入，避免单文件拖垮整批
-    auto video_result =
-        utils::media::video_asset::analyze_video_file(normalized_path, kDefaultThumbnailShortEdge);
+    auto video_result = [&] {
+      core::tracing::Span span("analyze_video", "scanner");
+      return utils::media::video_asset::analyze_video_file(normalized_path,
+                                                           kDefaultThumbnailShortEdge);
+    }();
     if (video_result) {
       asset.width = static_cast<std::int32_t>(video_result->width);
       asset.height = static_cast<std::int32_t>(video_result->height);
@@ -170,12 +192,13 @@ auto mark_assets_missing_at_paths(core::AppState& app_state,
   return asset::repository::mark_assets_missing_by_paths(app_state, normalized_paths);
 }
 
-// 在一个事务中写入单个资产及颜色，避免指纹已提交但颜色仍停留在旧状态。
+// 在一个事务中写入单个资产、颜色与 dHash，避免指纹已提交但派生数据仍停留在旧状态。
 auto persist_prepared_asset(core::AppState& app_state, PreparedAsset& prepared)
     -> std::expected<PathSyncOutcome, std::string> {
-  return core::database::execute_transaction(
+  auto persist_result = core::database::execute_transaction(
       app_state,
       [&prepared](core::AppState& txn_app_state) -> std::expected<PathSyncOutcome, std::string> {
+        core::tracing::Span span("persist_asset", "scanner");
         if (prepared.is_update) {
           auto update_result =
               asset::repository::update_asset_scanner_fields(txn_app_state, prepared.asset);
@@ -189,6 +212,13 @@ auto persist_prepared_asset(core::AppState& app_state, PreparedAsset& prepared)
           if (!color_result) {
             return std::unexpected("Failed to update asset colors: " + color_result.error());
           }
+
+          auto hash_result = features::gallery::similarity::repository::
+              replace_asset_perceptual_hash_in_transaction(txn_app_state, prepared.asset.id,
+                                                           prepared.perceptual_hash);
+          if (!hash_result) {
+            return std::unexpected("Failed to update perceptual hash: " + hash_result.error());
+          }
           return PathSyncOutcome::Updated;
         }
 
@@ -205,8 +235,20 @@ auto persist_prepared_asset(core::AppState& app_state, PreparedAsset& prepared)
         if (!color_result) {
           return std::unexpected("Failed to create asset colors: " + color_result.error());
         }
+
+        auto hash_result = features::gallery::similarity::repository::
+            replace_asset_perceptual_hash_in_transaction(txn_app_state, prepared.asset.id,
+                                                         prepared.perceptual_hash);
+        if (!hash_result) {
+          return std::unexpected("Failed to create perceptual hash: " + hash_result.error());
+        }
         return PathSyncOutcome::Created;
       });
+
+  if (persist_result) {
+    features::gallery::similarity::service::mark_index_stale(app_state);
+  }
+  return persist_result;
 }
 
 // 增量路径：过滤 → 粗判 → 指纹 → 媒体 → 单条写库
@@ -286,7 +328,9 @@ auto upsert_asset_at_path(core::AppState& app_state, const std::filesystem::path
     return std::unexpected("Gallery scan cancelled");
   }
 
-  auto hash_result = common::calculate_content_fingerprint(normalized, size_i64, stop_token);
+  auto hash_result = common::calculate_content_fingerprint(
+      app_state, normalized, size_i64, stop_token,
+      common::resolve_fingerprint_mode(options.fingerprint_mode));
   if (!hash_result) {
     return std::unexpected(hash_result.error());
   }
@@ -21,6 +21,8 @@ enum class PathSyncOutcome {
 struct PreparedAsset {
   Asset asset;
   std::vector<features::gallery::color::ExtractedColor> colors;
+  // 仅照片且缩略图解码成功时有值；更新时 nullopt 会清掉旧 dHash
+  std::optional<std::uint64_t> perceptual_hash;
   // true = 库中已有记录（更新），false = 新建
   bool is_update = false;
 };
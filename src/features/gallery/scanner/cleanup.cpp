@@ -3,6 +3,7 @@
 #include "vendor/std.hpp"
 
 #include "core/state/app_state.hpp"
+#include "core/tracing/tracing.hpp"
 #include "features/gallery/folder/repository.hpp"
 #include "features/gallery/scanner/asset_pipeline.hpp"
 #include "features/gallery/scanner/progress.hpp"
@@ -159,6 +160,7 @@ auto run_cleanup_phase(core::AppState& app_state, const std::filesystem::path& n
                        const std::vector<Folder>& folder_inventory,
                        const std::function<void(const ScanProgress&)>& progress_callback)
     -> CleanupPhaseResult {
+  core::tracing::Span span("cleanup_phase", "scanner");
   progress::report_scan_progress(progress_callback, "cleanup", 0, 1, progress::kCleanupPercent,
                                  "Reconciling deleted files");
 
@@ -3,6 +3,8 @@
 #include "vendor/std.hpp"
 
 #include "core/build_config.hpp"
+#include "features/gallery/scanner/tree_hash.hpp"
+#include "utils/hash/file_hash.hpp"
 #include "utils/hash/xxhash.hpp"
 #include "utils/media/video_asset.hpp"
 #include "utils/string/string.hpp"
@@ -70,7 +72,8 @@ constexpr std::size_t kMediaSampleCount = 5;
 constexpr std::uint64_t kMediaFullHashThreshold = kMediaSampleSize * kMediaSampleCount;
 
 // 使用固定元数据和五个均匀内容切片计算大媒体文件的内容指纹
-auto calculate_sampled_media_fingerprint(std::uint64_t file_size, std::ifstream& file,
+auto calculate_sampled_media_fingerprint(const std::filesystem::path& file_path,
+                                         std::uint64_t file_size,
                                          std::span<const std::byte> metadata,
                                          std::stop_token stop_token)
     -> std::expected<std::string, std::string> {
@@ -84,13 +87,12 @@ auto calculate_sampled_media_fingerprint(std::uint64_t file_size, std::ifstream&
       utils::hash::StreamRange{.offset = last_offset, .size = kMediaSampleSize},
   };
 
-  return utils::hash::hash_stream_ranges_to_hex(file, metadata, ranges, stop_token);
+  return utils::hash::hash_file_ranges_to_hex(file_path, metadata, ranges, stop_token);
 }
 
 // 为大视频计算“稳定媒体元数据 + 五个均匀采样块”的内容指纹
 auto calculate_sampled_video_fingerprint(const std::filesystem::path& file_path,
-                                         std::uint64_t file_size, std::ifstream& file,
-                                         std::stop_token stop_token)
+                                         std::uint64_t file_size, std::stop_token stop_token)
     -> std::expected<std::string, std::string> {
   // 元数据解析失败时保留零值，采样内容仍可为该文件提供稳定指纹。
   std::uint64_t width = 0;
@@ -104,13 +106,21 @@ auto calculate_sampled_video_fingerprint(const std::filesystem::path& file_path,
   }
 
   const std::array<std::uint64_t, 4> metadata{file_size, width, height, duration_millis};
-  return calculate_sampled_media_fingerprint(file_size, file, std::as_bytes(std::span{metadata}),
-                                             stop_token);
+  return calculate_sampled_media_fingerprint(file_path, file_size,
+                                             std::as_bytes(std::span{metadata}), stop_token);
+}
+
+auto resolve_fingerprint_mode(const std::optional<std::string>& mode) -> FingerprintMode {
+  if (mode.has_value() && utils::string::ToLowerAscii(*mode) == "full") {
+    return FingerprintMode::Full;
+  }
+  return FingerprintMode::Sampled;
 }
 
-// 计算素材内容指纹：Debug 使用路径哈希，Release 对小媒体完整哈希、对大媒体五点采样
-auto calculate_content_fingerprint(const std::filesystem::path& file_path, std::int64_t file_size,
-                                   std::stop_token stop_token)
+// 计算素材内容指纹：Debug 使用路径哈希，Release 对小媒体完整哈希、对大媒体按模式采样或树哈希
+auto calculate_content_fingerprint(core::AppState& app_state,
+                                   const std::filesystem::path& file_path, std::int64_t file_size,
+                                   std::stop_token stop_token, FingerprintMode mode)
     -> std::expected<std::string, std::string> {
   // 停止后不再打开文件，避免退出阶段继续产生磁盘访问
   if (stop_token.stop_requested()) {
@@ -128,26 +138,33 @@ auto calculate_content_fingerprint(const std::filesystem::path& file_path, std::
     return std::unexpected("Cannot fingerprint a file with negative size: " + file_path.string());
   }
 
-  // Release 以二进制流打开文件，小媒体完整读取，大媒体只读取固定采样区间
-  std::ifstream file(file_path, std::ios::binary);
-  if (!file) {
-    return std::unexpected("Cannot open file for fingerprinting: " + file_path.string());
+  auto unsigned_size = static_cast<std::uint64_t>(file_size);
+
+  // 完整模式下的大媒体按块分给共享线程池，各参与者自行打开文件，不共用单个流
+  if (mode == FingerprintMode::Full && unsigned_size > kMediaFullHashThreshold) {
+    auto tree_result = tree_hash::hash_file_tree_to_hex(app_state.worker_pool.get(), file_path,
+                                                        unsigned_size, stop_token);
+    if (!tree_result) {
+      return std::unexpected(std::format("Failed to fingerprint file '{}': {}", file_path.string(),
+                                         tree_result.error()));
+    }
+    return tree_result;
   }
 
+  // Release 按路径哈希：本地文件走内存映射，小媒体完整读取，大媒体只读取固定采样区间
   std::expected<std::string, std::string> hash_result;
-  auto unsigned_size = static_cast<std::uint64_t>(file_size);
   auto asset_type = detect_asset_type(file_path);
   if (unsigned_size > kMediaFullHashThreshold && asset_type == "photo") {
     // 大图片使用文件大小和固定采样，避免完整指纹读取量随文件大小线性增长
     const std::array<std::uint64_t, 1> metadata{unsigned_size};
     hash_result = calculate_sampled_media_fingerprint(
-        unsigned_size, file, std::as_bytes(std::span{metadata}), stop_token);
+        file_path, unsigned_size, std::as_bytes(std::span{metadata}), stop_token);
   } else if (unsigned_size > kMediaFullHashThreshold && asset_type == "video") {
     // 大视频保留媒体元数据参与指纹，降低不同视频命中相同采样内容的概率
-    hash_result = calculate_sampled_video_fingerprint(file_path, unsigned_size, file, stop_token);
+    hash_result = calculate_sampled_video_fingerprint(file_path, unsigned_size, stop_token);
   } else {
     // 小媒体直接完整哈希，避免五个采样区间互相重叠
-    hash_result = utils::hash::hash_stream_to_hex(file, stop_token);
+    hash_result = utils::hash::hash_file_to_hex(file_path, stop_token);
   }
 
   if (!hash_result) {
@@ -2,6 +2,8 @@
 
 #include "vendor/std.hpp"
 
+#include "core/state/app_state.hpp"
+
 namespace features::gallery::scanner::common {
 
 auto default_supported_extensions() -> const std::vector<std::string>&;
@@ -13,9 +15,19 @@ auto is_photo_file(const std::filesystem::path& file_path) -> bool;
 
 auto detect_asset_type(const std::filesystem::path& file_path) -> std::string;
 
-// 计算素材内容指纹：Debug 使用路径哈希，Release 对小媒体完整哈希、对大媒体五点采样
-auto calculate_content_fingerprint(const std::filesystem::path& file_path, std::int64_t file_size,
-                                   std::stop_token stop_token)
+enum class FingerprintMode {
+  Sampled,  // 大媒体五点采样，16 位十六进制
+  Full,     // 大媒体分块树哈希，32 位十六进制，带格式版本
+};
+
+// 未知取值回落到 Sampled，保证旧设置与前端不传时行为不变
+auto resolve_fingerprint_mode(const std::optional<std::string>& mode) -> FingerprintMode;
+
+// 计算素材内容指纹：Debug 使用路径哈希，Release 对小媒体完整哈希、对大媒体按模式采样或树哈希
+auto calculate_content_fingerprint(core::AppState& app_state,
+                                   const std::filesystem::path& file_path, std::int64_t file_size,
+                                   std::stop_token stop_token,
+                                   FingerprintMode mode = FingerprintMode::Sampled)
     -> std::expected<std::string, std::string>;
 
 }  // namespace features::gallery::scanner::common
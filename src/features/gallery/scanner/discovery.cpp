@@ -3,6 +3,7 @@
 #include "vendor/std.hpp"
 
 #include "core/state/app_state.hpp"
+#include "core/tracing/tracing.hpp"
 #include "features/gallery/folder/repository.hpp"
 #include "features/gallery/ignore/service.hpp"
 #include "features/gallery/scanner/common.hpp"
@@ -179,6 +180,7 @@ auto run_discovery_phase(core::AppState& app_state, const std::filesystem::path&
                          std::int64_t folder_id, const ScanOptions& options,
                          const std::function<void(const ScanProgress&)>& progress_callback)
     -> std::expected<DiscoveryResult, std::string> {
+  core::tracing::Span span("discovery_phase", "scanner");
   progress::report_scan_progress(progress_callback, "discovering", 0, 1,
                                  progress::kDiscoveringStartPercent,
                                  "Scanning files and folders from disk");
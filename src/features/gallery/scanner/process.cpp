@@ -2,17 +2,17 @@
 
 #include "vendor/std.hpp"
 
-#include "vendor/wil.hpp"
-#include "vendor/windows.hpp"
-
 #include "core/database/database.hpp"
 #include "core/state/app_state.hpp"
-#include "core/worker_pool/worker_pool.hpp"
+#include "core/tracing/tracing.hpp"
+#include "core/worker_pool/parallel.hpp"
 #include "features/gallery/asset/repository.hpp"
 #include "features/gallery/color/repository.hpp"
 #include "features/gallery/scanner/asset_pipeline.hpp"
 #include "features/gallery/scanner/common.hpp"
 #include "features/gallery/scanner/progress.hpp"
+#include "features/gallery/similarity/repository.hpp"
+#include "features/gallery/similarity/service.hpp"
 #include "features/gallery/types.hpp"
 #include "utils/logger/logger.hpp"
 
@@ -24,6 +24,7 @@ auto process_single_file(core::AppState& app_state, const FileAnalysisResult& an
                          const std::unordered_map<std::string, std::int64_t>& folder_mapping,
                          progress::ProcessingProgressTracker* progress_tracker)
     -> std::expected<ProcessedAssetEntry, std::string> {
+  core::tracing::Span span("process_file", "scanner");
   const auto& file_info = analysis.file_info;
   const auto& file_path = file_info.path;
 
@@ -60,10 +61,11 @@ auto process_single_file(core::AppState& app_state, const FileAnalysisResult& an
   return ProcessedAssetEntry{
       .asset = std::move(prepared_result->asset),
       .colors = std::move(prepared_result->colors),
+      .perceptual_hash = prepared_result->perceptual_hash,
   };
 }
 
-// 线程池分批并行处理文件，合并 NEW/MODIFIED 结果
+// 分块并行处理文件，合并 NEW/MODIFIED 结果
 auto process_files_in_parallel(core::AppState& app_state,
                                const std::vector<FileAnalysisResult>& files_to_process,
                                const ScanOptions& options,
@@ -76,26 +78,19 @@ auto process_files_in_parallel(core::AppState& app_state,
   }
 
   constexpr size_t PROCESS_BATCH_SIZE = 16;
-  size_t total_batches = (files_to_process.size() + PROCESS_BATCH_SIZE - 1) / PROCESS_BATCH_SIZE;
-
-  std::latch completion_latch(total_batches);
-  FileProcessingBatchResult final_result;
-  std::mutex results_mutex;
-  std::size_t submitted_batches = 0;
-
-  for (size_t batch_idx = 0; batch_idx < total_batches; ++batch_idx) {
-    size_t start = batch_idx * PROCESS_BATCH_SIZE;
-    size_t end = std::min(start + PROCESS_BATCH_SIZE, files_to_process.size());
 
-    bool submitted = core::worker_pool::submit_task(
-        app_state, [&final_result, &results_mutex, &completion_latch, &app_state, &files_to_process,
-                    start, end, &options, &folder_mapping, progress_tracker, stop_token]() {
-          auto finish_batch =
-              wil::scope_exit([&completion_latch] { completion_latch.count_down(); });
-
-          FileProcessingBatchResult batch_result;
-
-          for (size_t idx = start; idx < end; ++idx) {
+  // 每个参与线程写自己的批次结果，结束后再合并，不需要结果锁
+  std::vector<FileProcessingBatchResult> batch_results;
+  try {
+    batch_results = core::worker_pool::parallel_collect<FileProcessingBatchResult>(
+        app_state, files_to_process.size(),
+        {.grain = PROCESS_BATCH_SIZE,
+         .task = {.priority = core::worker_pool::TaskPriority::Background,
+                  .tag = core::worker_pool::TaskTag::GalleryScan},
+         .stop_token = stop_token},
+        [&app_state, &files_to_process, &options, &folder_mapping, progress_tracker,
+         &stop_token](std::size_t begin, std::size_t end, FileProcessingBatchResult& batch_result) {
+          for (size_t idx = begin; idx < end; ++idx) {
             // 已开始的单文件媒体调用自然收尾，下一文件开始前响应停止
             if (stop_token.stop_requested()) {
               return;
@@ -119,29 +114,23 @@ auto process_files_in_parallel(core::AppState& app_state,
               progress_tracker->mark_file_processed();
             }
           }
-
-          std::lock_guard<std::mutex> lock(results_mutex);
-          final_result.new_assets.insert(final_result.new_assets.end(),
-                                         std::make_move_iterator(batch_result.new_assets.begin()),
-                                         std::make_move_iterator(batch_result.new_assets.end()));
-          final_result.updated_assets.insert(
-              final_result.updated_assets.end(),
-              std::make_move_iterator(batch_result.updated_assets.begin()),
-              std::make_move_iterator(batch_result.updated_assets.end()));
-          final_result.errors.insert(final_result.errors.end(),
-                                     std::make_move_iterator(batch_result.errors.begin()),
-                                     std::make_move_iterator(batch_result.errors.end()));
         });
-
-    if (!submitted) {
-      completion_latch.count_down(static_cast<std::ptrdiff_t>(total_batches - submitted_batches));
-      completion_latch.wait();
-      return std::unexpected("Failed to submit file processing task to worker pool");
-    }
-    submitted_batches++;
+  } catch (const std::exception& e) {
+    return std::unexpected(std::string("File processing failed: ") + e.what());
   }
 
-  completion_latch.wait();
+  FileProcessingBatchResult final_result;
+  for (auto& batch_result : batch_results) {
+    final_result.new_assets.insert(final_result.new_assets.end(),
+                                   std::make_move_iterator(batch_result.new_assets.begin()),
+                                   std::make_move_iterator(batch_result.new_assets.end()));
+    final_result.updated_assets.insert(final_result.updated_assets.end(),
+                                       std::make_move_iterator(batch_result.updated_assets.begin()),
+                                       std::make_move_iterator(batch_result.updated_assets.end()));
+    final_result.errors.insert(final_result.errors.end(),
+                               std::make_move_iterator(batch_result.errors.begin()),
+                               std::make_move_iterator(batch_result.errors.end()));
+  }
 
   if (stop_token.stop_requested()) {
     return std::unexpected("Gallery scan cancelled");
@@ -158,6 +147,7 @@ auto run_processing_phase(core::AppState& app_state,
                           const std::function<void(const ScanProgress&)>& progress_callback,
                           std::stop_token stop_token)
     -> std::expected<ProcessingPhaseResult, std::string> {
+  core::tracing::Span span("processing_phase", "scanner");
   if (stop_token.stop_requested()) {
     return std::unexpected("Gallery scan cancelled");
   }
@@ -206,10 +196,11 @@ auto run_processing_phase(core::AppState& app_state,
 
   result.batch_result = std::move(processing_result.value());
 
-  // 新建、更新与颜色替换共用一个事务，任一颜色写入失败都会回滚对应资产指纹。
+  // 新建、更新与颜色、dHash 替换共用一个事务，任一派生数据写入失败都会回滚对应资产指纹。
   if (!result.batch_result.new_assets.empty() || !result.batch_result.updated_assets.empty()) {
     auto persist_result = core::database::execute_transaction(
         app_state, [&result](core::AppState& txn_app_state) -> std::expected<void, std::string> {
+          core::tracing::Span span("persist_scan_batch", "scanner");
           for (auto& entry : result.batch_result.new_assets) {
             auto create_result = asset::repository::create_asset_with_inherited_data_in_transaction(
                 txn_app_state, entry.asset);
@@ -224,6 +215,13 @@ auto run_processing_phase(core::AppState& app_state,
             if (!color_result) {
               return std::unexpected("Failed to create asset colors: " + color_result.error());
             }
+
+            auto hash_result = features::gallery::similarity::repository::
+                replace_asset_perceptual_hash_in_transaction(txn_app_state, entry.asset.id,
+                                                             entry.perceptual_hash);
+            if (!hash_result) {
+              return std::unexpected("Failed to create perceptual hash: " + hash_result.error());
+            }
           }
 
           for (const auto& entry : result.batch_result.updated_assets) {
@@ -243,6 +241,13 @@ auto run_processing_phase(core::AppState& app_state,
             if (!color_result) {
               return std::unexpected("Failed to update asset colors: " + color_result.error());
             }
+
+            auto hash_result = features::gallery::similarity::repository::
+                replace_asset_perceptual_hash_in_transaction(txn_app_state, entry.asset.id,
+                                                             entry.perceptual_hash);
+            if (!hash_result) {
+              return std::unexpected("Failed to update perceptual hash: " + hash_result.error());
+            }
           }
           return {};
         });
@@ -253,6 +258,7 @@ auto run_processing_phase(core::AppState& app_state,
                              persist_result.error());
     }
 
+    features::gallery::similarity::service::mark_index_stale(app_state);
     Logger().info("Successfully created {} and updated {} asset items with colors",
                   result.batch_result.new_assets.size(), result.batch_result.updated_assets.size());
   }
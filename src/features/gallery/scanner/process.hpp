@@ -11,6 +11,7 @@ namespace features::gallery::scanner::process {
 struct ProcessedAssetEntry {
   Asset asset;
   std::vector<features::gallery::color::ExtractedColor> colors;
+  std::optional<std::uint64_t> perceptual_hash;
 };
 
 struct FileProcessingBatchResult {
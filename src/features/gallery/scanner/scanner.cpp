@@ -3,6 +3,7 @@
 #include "vendor/std.hpp"
 
 #include "core/state/app_state.hpp"
+#include "core/tracing/tracing.hpp"
 #include "features/gallery/asset/repository.hpp"
 #include "features/gallery/asset/service.hpp"
 #include "features/gallery/folder/repository.hpp"
@@ -35,6 +36,7 @@ struct ScanPreparationContext {
 // 准备扫描上下文：规范化根路径 → 建 root folder → 写 ignore → 加载当前根的目录与资产库存。
 auto prepare_scan_context(core::AppState& app_state, const ScanOptions& options)
     -> std::expected<ScanPreparationContext, std::string> {
+  core::tracing::Span span("prepare_scan_context", "scanner");
   auto normalized_scan_root_result = utils::path::ResolvePath(options.directory);
   if (!normalized_scan_root_result) {
     return std::unexpected("Failed to normalize scan root path: " +
@@ -100,6 +102,7 @@ auto prepare_scan_context(core::AppState& app_state, const ScanOptions& options)
 auto scan_asset_directory(core::AppState& app_state, const ScanOptions& options,
                           std::function<void(const ScanProgress&)> progress_callback)
     -> std::expected<ScanResult, std::string> {
+  core::tracing::Span span("scan_asset_directory", "scanner");
   auto stop_token = app_state.gallery->scan_stop_source.get_token();
   // 已取消则直接退出
   if (stop_token.stop_requested()) {
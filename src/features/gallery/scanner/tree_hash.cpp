@@ -0,0 +1,45 @@
+#include "features/gallery/scanner/tree_hash.hpp"
+
+#include "vendor/std.hpp"
+
+#include "core/worker_pool/parallel.hpp"
+#include "utils/hash/file_hash.hpp"
+#include "utils/hash/xxhash.hpp"
+
+namespace features::gallery::scanner::tree_hash {
+
+auto hash_file_tree_to_hex(core::worker_pool::WorkerPoolState* pool,
+                           const std::filesystem::path& path, std::uint64_t file_size,
+                           std::stop_token stop_token) -> std::expected<std::string, std::string> {
+  if (file_size == 0) {
+    return std::unexpected("Input stream is empty");
+  }
+
+  std::vector<XXH128_hash_t> leaves(utils::hash::tree_chunk_count(file_size));
+  try {
+    // 扫描本身已按文件并行，协助任务与其他文件排在同一队列，空闲线程才会来分担叶子块
+    core::worker_pool::parallel_for(
+        pool, leaves.size(),
+        {.task = {.priority = core::worker_pool::TaskPriority::Background,
+                  .tag = core::worker_pool::TaskTag::GalleryHash},
+         .stop_token = stop_token},
+        [&path, file_size, &leaves, &stop_token](std::size_t begin, std::size_t end) {
+          auto leaves_result = utils::hash::hash_file_tree_leaves(
+              path, file_size, begin, std::span(leaves).subspan(begin, end - begin), stop_token);
+          if (!leaves_result) {
+            throw std::runtime_error(leaves_result.error());
+          }
+        });
+  } catch (const std::exception& e) {
+    return std::unexpected(e.what());
+  }
+
+  // 停止后未认领的叶子保持空值，不能合并成根摘要
+  if (stop_token.stop_requested()) {
+    return std::unexpected("Hash calculation cancelled");
+  }
+
+  return utils::hash::digest_tree_leaves(file_size, leaves);
+}
+
+}  // namespace features::gallery::scanner::tree_hash
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "vendor/std.hpp"
+
+#include "core/worker_pool/state.hpp"
+
+namespace features::gallery::scanner::tree_hash {
+
+// 固定大小分块在共享线程池上并行计算叶子摘要，再按块序合并为 32 位十六进制根摘要。
+// 调用线程始终参与认领；线程池繁忙或未运行时由调用线程串行完成，不另开线程。
+auto hash_file_tree_to_hex(core::worker_pool::WorkerPoolState* pool,
+                           const std::filesystem::path& path, std::uint64_t file_size,
+                           std::stop_token stop_token) -> std::expected<std::string, std::string>;
+
+}  // namespace features::gallery::scanner::tree_hash
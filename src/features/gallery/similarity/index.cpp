@@ -0,0 +1,160 @@
+#include "features/gallery/similarity/index.hpp"
+
+#include "vendor/std.hpp"
+
+#include "utils/image/perceptual_hash.hpp"
+
+namespace features::gallery::similarity::index {
+
+// 在已有树上挂入一个新的不同 hash 节点
+auto insert_node(HammingIndex& index, std::int32_t node_index) -> void {
+  std::int32_t current = 0;
+  const auto hash = index.nodes[node_index].hash;
+  for (;;) {
+    auto distance =
+        static_cast<std::uint8_t>(utils::image::hamming_distance(index.nodes[current].hash, hash));
+    std::int32_t child = index.nodes[current].first_child;
+    while (child >= 0 && index.nodes[child].parent_distance != distance) {
+      child = index.nodes[child].next_sibling;
+    }
+
+    if (child < 0) {
+      auto& node = index.nodes[node_index];
+      node.parent_distance = distance;
+      node.next_sibling = index.nodes[current].first_child;
+      index.nodes[current].first_child = node_index;
+      return;
+    }
+    current = child;
+  }
+}
+
+auto build_index(std::vector<HashEntry> entries) -> HammingIndex {
+  std::ranges::sort(entries, [](const HashEntry& lhs, const HashEntry& rhs) {
+    if (lhs.hash != rhs.hash) return lhs.hash < rhs.hash;
+    return lhs.asset_id < rhs.asset_id;
+  });
+
+  HammingIndex index;
+  index.entries = std::move(entries);
+
+  for (std::size_t begin = 0; begin < index.entries.size();) {
+    auto end = begin + 1;
+    while (end < index.entries.size() && index.entries[end].hash == index.entries[begin].hash) {
+      ++end;
+    }
+
+    index.nodes.push_back(HammingIndexNode{
+        .hash = index.entries[begin].hash,
+        .entries_begin = static_cast<std::uint32_t>(begin),
+        .entries_end = static_cast<std::uint32_t>(end),
+    });
+    auto node_index = static_cast<std::int32_t>(index.nodes.size() - 1);
+    if (node_index > 0) {
+      insert_node(index, node_index);
+    }
+    begin = end;
+  }
+
+  return index;
+}
+
+// 遍历满足三角不等式剪枝条件的节点，回调收到节点下标与距离
+template <typename Visitor>
+auto visit_within_distance(const HammingIndex& index, std::uint64_t hash, int max_distance,
+                           Visitor&& visitor) -> void {
+  if (index.nodes.empty() || max_distance < 0) {
+    return;
+  }
+
+  std::vector<std::int32_t> pending{0};
+  while (!pending.empty()) {
+    auto node_index = pending.back();
+    pending.pop_back();
+
+    const auto& node = index.nodes[node_index];
+    auto distance = utils::image::hamming_distance(node.hash, hash);
+    if (distance <= max_distance) {
+      visitor(node_index, distance);
+    }
+
+    // 只有与当前节点距离落在 [d-k, d+k] 的子树里才可能存在命中
+    for (auto child = node.first_child; child >= 0; child = index.nodes[child].next_sibling) {
+      int child_distance = index.nodes[child].parent_distance;
+      if (child_distance >= distance - max_distance && child_distance <= distance + max_distance) {
+        pending.push_back(child);
+      }
+    }
+  }
+}
+
+auto find_within_distance(const HammingIndex& index, std::uint64_t hash, int max_distance)
+    -> std::vector<HashMatch> {
+  std::vector<HashMatch> matches;
+  visit_within_distance(index, hash, max_distance, [&](std::int32_t node_index, int distance) {
+    const auto& node = index.nodes[node_index];
+    for (auto i = node.entries_begin; i < node.entries_end; ++i) {
+      matches.push_back(HashMatch{.asset_id = index.entries[i].asset_id, .distance = distance});
+    }
+  });
+
+  std::ranges::sort(matches, [](const HashMatch& lhs, const HashMatch& rhs) {
+    if (lhs.distance != rhs.distance) return lhs.distance < rhs.distance;
+    return lhs.asset_id < rhs.asset_id;
+  });
+  return matches;
+}
+
+auto find_root(std::vector<std::int32_t>& parents, std::int32_t node) -> std::int32_t {
+  while (parents[node] != node) {
+    parents[node] = parents[parents[node]];
+    node = parents[node];
+  }
+  return node;
+}
+
+auto group_near_duplicates(std::vector<HashEntry> entries, int max_distance,
+                           std::size_t min_group_size) -> std::vector<std::vector<std::int64_t>> {
+  auto index = build_index(std::move(entries));
+
+  // 并查集按节点合并；同一节点内的资产 hash 完全相同，天然属于同一组
+  std::vector<std::int32_t> parents(index.nodes.size());
+  std::iota(parents.begin(), parents.end(), 0);
+  for (std::size_t i = 0; i < index.nodes.size(); ++i) {
+    auto node_index = static_cast<std::int32_t>(i);
+    visit_within_distance(index, index.nodes[i].hash, max_distance,
+                          [&](std::int32_t neighbor, int) {
+                            auto lhs = find_root(parents, node_index);
+                            auto rhs = find_root(parents, neighbor);
+                            if (lhs != rhs) {
+                              parents[std::max(lhs, rhs)] = std::min(lhs, rhs);
+                            }
+                          });
+  }
+
+  std::unordered_map<std::int32_t, std::vector<std::int64_t>> groups_by_root;
+  for (std::size_t i = 0; i < index.nodes.size(); ++i) {
+    auto& group = groups_by_root[find_root(parents, static_cast<std::int32_t>(i))];
+    const auto& node = index.nodes[i];
+    for (auto entry = node.entries_begin; entry < node.entries_end; ++entry) {
+      group.push_back(index.entries[entry].asset_id);
+    }
+  }
+
+  std::vector<std::vector<std::int64_t>> groups;
+  for (auto& [root, group] : groups_by_root) {
+    if (group.size() < std::max<std::size_t>(min_group_size, 1)) {
+      continue;
+    }
+    std::ranges::sort(group);
+    groups.push_back(std::move(group));
+  }
+
+  std::ranges::sort(groups, [](const auto& lhs, const auto& rhs) {
+    if (lhs.size() != rhs.size()) return lhs.size() > rhs.size();
+    return lhs.front() < rhs.front();
+  });
+  return groups;
+}
+
+}  // namespace features::gallery::similarity::index
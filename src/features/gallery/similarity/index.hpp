@@ -0,0 +1,46 @@
+#pragma once
+
+#include "vendor/std.hpp"
+
+namespace features::gallery::similarity::index {
+
+struct HashEntry {
+  std::int64_t asset_id = 0;
+  std::uint64_t hash = 0;
+};
+
+struct HashMatch {
+  std::int64_t asset_id = 0;
+  int distance = 0;
+};
+
+// BK-tree 节点按互不相同的 hash 建立，相同 hash 的资产共享节点并指向 entries 中的一段区间。
+// 子节点用兄弟链表保存，避免为每个节点预留 65 个距离槽位。
+struct HammingIndexNode {
+  std::uint64_t hash = 0;
+  std::uint32_t entries_begin = 0;
+  std::uint32_t entries_end = 0;
+  std::int32_t first_child = -1;
+  std::int32_t next_sibling = -1;
+  std::uint8_t parent_distance = 0;
+};
+
+struct HammingIndex {
+  // 按 (hash, asset_id) 排序，节点通过区间引用
+  std::vector<HashEntry> entries;
+  std::vector<HammingIndexNode> nodes;
+};
+
+auto build_index(std::vector<HashEntry> entries) -> HammingIndex;
+
+// 返回与 hash 的汉明距离不超过 max_distance 的全部资产，按 (distance, asset_id) 升序
+auto find_within_distance(const HammingIndex& index, std::uint64_t hash, int max_distance)
+    -> std::vector<HashMatch>;
+
+// 以"距离不超过 max_distance 即相连"做传递闭包分组，只返回不少于 min_group_size 的组。
+// 组内资产 ID 升序，组之间按大小降序、首个 ID 升序。
+auto group_near_duplicates(std::vector<HashEntry> entries, int max_distance,
+                           std::size_t min_group_size = 2)
+    -> std::vector<std::vector<std::int64_t>>;
+
+}  // namespace features::gallery::similarity::index
@@ -0,0 +1,151 @@
+#include "features/gallery/similarity/repository.hpp"
+
+#include "vendor/std.hpp"
+
+#include "core/database/database.hpp"
+#include "core/database/types.hpp"
+#include "core/state/app_state.hpp"
+#include "features/gallery/asset/query_support.hpp"
+#include "features/gallery/similarity/types.hpp"
+#include "features/gallery/types.hpp"
+#include "utils/image/perceptual_hash.hpp"
+
+namespace features::gallery::similarity::repository {
+
+// 在外层资产事务中替换 dHash，失败时由调用方回滚整个资产聚合。
+auto replace_asset_perceptual_hash_in_transaction(core::AppState& app_state, std::int64_t asset_id,
+                                                  std::optional<std::uint64_t> dhash)
+    -> std::expected<void, std::string> {
+  if (asset_id <= 0) {
+    return std::unexpected("Invalid asset_id in perceptual hash replacement");
+  }
+
+  if (!dhash.has_value()) {
+    auto delete_result = core::database::execute(
+        app_state, "DELETE FROM asset_perceptual_hashes WHERE asset_id = ?", {asset_id});
+    if (!delete_result) {
+      return std::unexpected("Failed to delete perceptual hash for asset_id " +
+                             std::to_string(asset_id) + ": " + delete_result.error());
+    }
+    return {};
+  }
+
+  static const std::string kUpsertSql = R"(
+    INSERT INTO asset_perceptual_hashes (asset_id, dhash, algorithm_version)
+    VALUES (?, ?, ?)
+    ON CONFLICT(asset_id) DO UPDATE SET
+      dhash = excluded.dhash,
+      algorithm_version = excluded.algorithm_version
+  )";
+
+  auto upsert_result = core::database::execute(
+      app_state, kUpsertSql,
+      {asset_id, std::bit_cast<std::int64_t>(dhash.value()), utils::image::kDifferenceHashVersion});
+  if (!upsert_result) {
+    return std::unexpected("Failed to write perceptual hash for asset_id " +
+                           std::to_string(asset_id) + ": " + upsert_result.error());
+  }
+  return {};
+}
+
+auto get_asset_perceptual_hash(core::AppState& app_state, std::int64_t asset_id)
+    -> std::expected<std::optional<std::uint64_t>, std::string> {
+  auto result = core::database::query_scalar<std::int64_t>(
+      app_state,
+      "SELECT dhash FROM asset_perceptual_hashes WHERE asset_id = ? AND algorithm_version = ?",
+      {asset_id, utils::image::kDifferenceHashVersion});
+  if (!result) {
+    return std::unexpected("Failed to query asset perceptual hash: " + result.error());
+  }
+  if (!result->has_value()) {
+    return std::optional<std::uint64_t>{};
+  }
+  return std::bit_cast<std::uint64_t>(result->value());
+}
+
+auto list_perceptual_hashes(core::AppState& app_state)
+    -> std::expected<std::vector<PerceptualHashRow>, std::string> {
+  static const std::string kQuerySql = R"(
+    SELECT p.asset_id, p.dhash
+    FROM asset_perceptual_hashes p
+    INNER JOIN assets a ON a.id = p.asset_id
+    WHERE p.algorithm_version = ? AND a.missing_at IS NULL
+  )";
+
+  auto result = core::database::query<PerceptualHashRow>(
+      app_state, kQuerySql, {utils::image::kDifferenceHashVersion});
+  if (!result) {
+    return std::unexpected("Failed to list perceptual hashes: " + result.error());
+  }
+  return result.value();
+}
+
+auto list_perceptual_hashes_matching(core::AppState& app_state, const QueryAssetsFilters& filters)
+    -> std::expected<std::vector<PerceptualHashRow>, std::string> {
+  auto where_result = asset::query_support::build_unified_where_clause(filters, "a");
+  if (!where_result) {
+    return std::unexpected("Failed to build where clause: " + where_result.error());
+  }
+  auto [where_clause, params] = std::move(where_result.value());
+
+  // 统一筛选已包含 missing_at IS NULL，这里只追加版本条件
+  auto sql = std::format(R"(
+    SELECT p.asset_id, p.dhash
+    FROM assets a
+    INNER JOIN asset_perceptual_hashes p ON p.asset_id = a.id AND p.algorithm_version = ?
+    {}
+  )",
+                         where_clause);
+  params.insert(params.begin(), utils::image::kDifferenceHashVersion);
+
+  auto result = core::database::query<PerceptualHashRow>(app_state, sql, params);
+  if (!result) {
+    return std::unexpected("Failed to list filtered perceptual hashes: " + result.error());
+  }
+  return result.value();
+}
+
+auto list_backfill_candidates(core::AppState& app_state, std::int64_t after_id, std::int64_t limit)
+    -> std::expected<std::vector<PerceptualHashBackfillCandidate>, std::string> {
+  static const std::string kQuerySql = R"(
+    SELECT a.id, a.path
+    FROM assets a
+    LEFT JOIN asset_perceptual_hashes p
+      ON p.asset_id = a.id AND p.algorithm_version = ?
+    WHERE a.id > ?
+      AND a.type = 'photo'
+      AND a.missing_at IS NULL
+      AND p.asset_id IS NULL
+    ORDER BY a.id
+    LIMIT ?
+  )";
+
+  auto result = core::database::query<PerceptualHashBackfillCandidate>(
+      app_state, kQuerySql, {utils::image::kDifferenceHashVersion, after_id, limit});
+  if (!result) {
+    return std::unexpected("Failed to list perceptual hash backfill candidates: " +
+                           result.error());
+  }
+  return result.value();
+}
+
+auto count_backfill_candidates(core::AppState& app_state)
+    -> std::expected<std::int64_t, std::string> {
+  static const std::string kCountSql = R"(
+    SELECT COUNT(*)
+    FROM assets a
+    LEFT JOIN asset_perceptual_hashes p
+      ON p.asset_id = a.id AND p.algorithm_version = ?
+    WHERE a.type = 'photo' AND a.missing_at IS NULL AND p.asset_id IS NULL
+  )";
+
+  auto result = core::database::query_scalar<std::int64_t>(
+      app_state, kCountSql, {utils::image::kDifferenceHashVersion});
+  if (!result) {
+    return std::unexpected("Failed to count perceptual hash backfill candidates: " +
+                           result.error());
+  }
+  return result->value_or(0);
+}
+
+}  // namespace features::gallery::similarity::repository
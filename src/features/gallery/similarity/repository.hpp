@@ -0,0 +1,34 @@
+#pragma once
+
+#include "vendor/std.hpp"
+
+#include "core/state/app_state.hpp"
+#include "features/gallery/similarity/types.hpp"
+#include "features/gallery/types.hpp"
+
+namespace features::gallery::similarity::repository {
+
+// 在调用方已经建立的事务中写入当前版本的 dHash；nullopt 表示删除旧值。
+auto replace_asset_perceptual_hash_in_transaction(core::AppState& app_state, std::int64_t asset_id,
+                                                  std::optional<std::uint64_t> dhash)
+    -> std::expected<void, std::string>;
+
+auto get_asset_perceptual_hash(core::AppState& app_state, std::int64_t asset_id)
+    -> std::expected<std::optional<std::uint64_t>, std::string>;
+
+// 全库未 missing 资产的当前版本 dHash，供内存索引重建
+auto list_perceptual_hashes(core::AppState& app_state)
+    -> std::expected<std::vector<PerceptualHashRow>, std::string>;
+
+// 复用图库统一筛选条件，只返回命中资产的当前版本 dHash
+auto list_perceptual_hashes_matching(core::AppState& app_state, const QueryAssetsFilters& filters)
+    -> std::expected<std::vector<PerceptualHashRow>, std::string>;
+
+// 按 ID 游标分页列出缺少当前版本 dHash 的照片
+auto list_backfill_candidates(core::AppState& app_state, std::int64_t after_id, std::int64_t limit)
+    -> std::expected<std::vector<PerceptualHashBackfillCandidate>, std::string>;
+
+auto count_backfill_candidates(core::AppState& app_state)
+    -> std::expected<std::int64_t, std::string>;
+
+}  // namespace features::gallery::similarity::repository
@@ -0,0 +1,323 @@
+#include "features/gallery/similarity/service.hpp"
+
+#include "vendor/std.hpp"
+
+#include "core/database/database.hpp"
+#include "core/state/app_state.hpp"
+#include "core/worker_pool/parallel.hpp"
+#include "features/gallery/asset/repository.hpp"
+#include "features/gallery/similarity/index.hpp"
+#include "features/gallery/similarity/repository.hpp"
+#include "features/gallery/similarity/types.hpp"
+#include "features/gallery/state.hpp"
+#include "features/gallery/types.hpp"
+#include "utils/image/image.hpp"
+#include "utils/image/perceptual_hash.hpp"
+#include "utils/logger/logger.hpp"
+
+namespace features::gallery::similarity::service {
+
+// 超过 16 位后 BK-tree 剪枝基本失效，结果也不再是"相似"
+constexpr std::int32_t kMaxHammingDistance = 16;
+constexpr std::int32_t kMaxSimilarLimit = 500;
+constexpr std::int32_t kMaxGroupLimit = 1000;
+// 每页解码完成后提交一次，回填中途关闭也只丢失当前页
+constexpr std::int64_t kBackfillPageSize = 64;
+
+auto compute_bitmap_perceptual_hash(const utils::image::BGRABitmapData& bitmap_data)
+    -> std::expected<std::uint64_t, std::string> {
+  return utils::image::compute_difference_hash(bitmap_data.pixels, bitmap_data.width,
+                                               bitmap_data.height, bitmap_data.stride);
+}
+
+auto mark_index_stale(core::AppState& app_state) -> void {
+  app_state.gallery->similarity_index_stale.store(true, std::memory_order_release);
+}
+
+auto to_hash_entries(const std::vector<PerceptualHashRow>& rows) -> std::vector<index::HashEntry> {
+  std::vector<index::HashEntry> entries;
+  entries.reserve(rows.size());
+  for (const auto& row : rows) {
+    entries.push_back(index::HashEntry{.asset_id = row.asset_id,
+                                       .hash = std::bit_cast<std::uint64_t>(row.dhash)});
+  }
+  return entries;
+}
+
+// 取当前索引；脏标记在读库前清除，重建期间的新写入会再次置脏
+auto acquire_index(core::AppState& app_state)
+    -> std::expected<std::shared_ptr<const index::HammingIndex>, std::string> {
+  auto& gallery = *app_state.gallery;
+  std::lock_guard<std::mutex> lock(gallery.similarity_index_mutex);
+  if (gallery.similarity_index &&
+      !gallery.similarity_index_stale.load(std::memory_order_acquire)) {
+    return gallery.similarity_index;
+  }
+
+  gallery.similarity_index_stale.store(false, std::memory_order_release);
+  auto rows_result = repository::list_perceptual_hashes(app_state);
+  if (!rows_result) {
+    gallery.similarity_index_stale.store(true, std::memory_order_release);
+    return std::unexpected(rows_result.error());
+  }
+
+  gallery.similarity_index = std::make_shared<const index::HammingIndex>(
+      index::build_index(to_hash_entries(rows_result.value())));
+  Logger().debug("Rebuilt perceptual hash index with {} assets", rows_result->size());
+  return gallery.similarity_index;
+}
+
+auto find_similar_assets(core::AppState& app_state, const FindSimilarAssetsParams& params)
+    -> std::expected<FindSimilarAssetsResponse, std::string> {
+  const auto max_distance = std::clamp(params.max_distance.value_or(6), 0, kMaxHammingDistance);
+  const auto limit =
+      static_cast<std::size_t>(std::clamp(params.limit.value_or(100), 1, kMaxSimilarLimit));
+
+  auto source_hash_result = repository::get_asset_perceptual_hash(app_state, params.asset_id);
+  if (!source_hash_result) {
+    return std::unexpected(source_hash_result.error());
+  }
+  if (!source_hash_result->has_value()) {
+    return FindSimilarAssetsResponse{};
+  }
+
+  auto index_result = acquire_index(app_state);
+  if (!index_result) {
+    return std::unexpected("Failed to load perceptual hash index: " + index_result.error());
+  }
+
+  auto matches =
+      index::find_within_distance(*index_result.value(), source_hash_result->value(), max_distance);
+  std::erase_if(matches, [&params](const index::HashMatch& match) {
+    return match.asset_id == params.asset_id;
+  });
+
+  FindSimilarAssetsResponse response{.source_hashed = true};
+  // 索引可能落后于 missing 状态，按 limit 分段回表过滤，直到填满
+  for (std::size_t offset = 0; offset < matches.size() && response.items.size() < limit;
+       offset += limit) {
+    const auto end = std::min(offset + limit, matches.size());
+    std::vector<std::int64_t> ids;
+    ids.reserve(end - offset);
+    for (auto i = offset; i < end; ++i) {
+      ids.push_back(matches[i].asset_id);
+    }
+
+    auto assets_result = asset::repository::get_present_assets_by_ids(app_state, ids);
+    if (!assets_result) {
+      return std::unexpected(assets_result.error());
+    }
+
+    std::unordered_map<std::int64_t, Asset> assets_by_id;
+    for (auto& asset : assets_result.value()) {
+      assets_by_id.emplace(asset.id, std::move(asset));
+    }
+
+    for (auto i = offset; i < end && response.items.size() < limit; ++i) {
+      auto it = assets_by_id.find(matches[i].asset_id);
+      if (it == assets_by_id.end()) {
+        continue;
+      }
+      response.items.push_back(
+          SimilarAssetItem{.asset = std::move(it->second), .distance = matches[i].distance});
+    }
+  }
+
+  return response;
+}
+
+auto group_near_duplicates(core::AppState& app_state, const GroupNearDuplicatesParams& params)
+    -> std::expected<GroupNearDuplicatesResponse, std::string> {
+  const auto max_distance = std::clamp(params.max_distance.value_or(4), 0, kMaxHammingDistance);
+  const auto min_group_size =
+      static_cast<std::size_t>(std::max(params.min_group_size.value_or(2), 2));
+  const auto limit =
+      static_cast<std::size_t>(std::clamp(params.limit.value_or(200), 1, kMaxGroupLimit));
+
+  // 分组只针对筛选后的子集，直接建局部索引，不触碰全库共享索引
+  auto rows_result = repository::list_perceptual_hashes_matching(app_state, params.filters);
+  if (!rows_result) {
+    return std::unexpected(rows_result.error());
+  }
+
+  auto groups = index::group_near_duplicates(to_hash_entries(rows_result.value()), max_distance,
+                                             min_group_size);
+
+  GroupNearDuplicatesResponse response{
+      .total_group_count = static_cast<std::int64_t>(groups.size()),
+      .hashed_asset_count = static_cast<std::int64_t>(rows_result->size()),
+  };
+  if (groups.size() > limit) {
+    groups.resize(limit);
+  }
+
+  std::vector<std::int64_t> ids;
+  for (const auto& group : groups) {
+    ids.insert(ids.end(), group.begin(), group.end());
+  }
+  auto assets_result = asset::repository::get_present_assets_by_ids(app_state, ids);
+  if (!assets_result) {
+    return std::unexpected(assets_result.error());
+  }
+
+  std::unordered_map<std::int64_t, Asset> assets_by_id;
+  for (auto& asset : assets_result.value()) {
+    assets_by_id.emplace(asset.id, std::move(asset));
+  }
+
+  response.groups.reserve(groups.size());
+  for (const auto& group : groups) {
+    NearDuplicateGroup item;
+    item.assets.reserve(group.size());
+    for (auto asset_id : group) {
+      if (auto it = assets_by_id.find(asset_id); it != assets_by_id.end()) {
+        item.assets.push_back(std::move(it->second));
+      }
+    }
+    response.groups.push_back(std::move(item));
+  }
+
+  return response;
+}
+
+// 与扫描相同：按缩略图短边解码原图，保证回填值与新扫描写入的一致
+auto decode_and_hash(const PerceptualHashBackfillCandidate& candidate)
+    -> std::expected<std::uint64_t, std::string> {
+  auto wic_factory_result = utils::image::get_thread_wic_factory();
+  if (!wic_factory_result) {
+    return std::unexpected("Failed to get thread WIC factory: " + wic_factory_result.error());
+  }
+
+  auto bitmap_result = utils::image::load_scaled_bgra_bitmap_data(
+      wic_factory_result->get(), std::filesystem::path(candidate.path),
+      kDefaultThumbnailShortEdge);
+  if (!bitmap_result) {
+    return std::unexpected(bitmap_result.error());
+  }
+  return compute_bitmap_perceptual_hash(bitmap_result.value());
+}
+
+// 单页并行解码；失败项保持 nullopt，由调用方计数
+auto hash_backfill_page(core::AppState& app_state,
+                        const std::vector<PerceptualHashBackfillCandidate>& page,
+                        std::stop_token stop_token)
+    -> std::expected<std::vector<std::optional<std::uint64_t>>, std::string> {
+  std::vector<std::optional<std::uint64_t>> hashes(page.size());
+
+  try {
+    // 每个元素只写自己的槽位，不需要额外同步
+    core::worker_pool::parallel_for(
+        app_state, page.size(),
+        {.task = {.priority = core::worker_pool::TaskPriority::Background,
+                  .tag = core::worker_pool::TaskTag::GallerySimilarity},
+         .stop_token = stop_token},
+        [&page, &hashes](std::size_t begin, std::size_t end) {
+          for (auto i = begin; i < end; ++i) {
+            auto hash_result = decode_and_hash(page[i]);
+            if (hash_result) {
+              hashes[i] = hash_result.value();
+            } else {
+              Logger().warn("Failed to compute perceptual hash for {}: {}", page[i].path,
+                            hash_result.error());
+            }
+          }
+        });
+  } catch (const std::exception& e) {
+    return std::unexpected(std::string("Perceptual hash page failed: ") + e.what());
+  }
+
+  return hashes;
+}
+
+auto backfill_perceptual_hashes(core::AppState& app_state,
+                                std::function<void(const ScanProgress&)> progress_callback)
+    -> std::expected<PerceptualHashBackfillResult, std::string> {
+  auto stop_token = app_state.gallery->scan_stop_source.get_token();
+  // 与扫描一样持有共享锁，Gallery cleanup 会等待当前页结束
+  std::shared_lock<std::shared_mutex> scan_lifetime_lock(app_state.gallery->scan_lifetime_mutex);
+
+  auto total_result = repository::count_backfill_candidates(app_state);
+  if (!total_result) {
+    return std::unexpected(total_result.error());
+  }
+
+  PerceptualHashBackfillResult result{.total_candidates = total_result.value()};
+  auto report = [&](std::string stage) {
+    if (!progress_callback) {
+      return;
+    }
+    const auto processed = result.hashed_count + result.failed_count;
+    // 回填期间新增的照片也会被游标扫到，进度封顶 100
+    const auto percent = result.total_candidates > 0
+                             ? std::min(100.0, 100.0 * static_cast<double>(processed) /
+                                                   static_cast<double>(result.total_candidates))
+                             : 100.0;
+    progress_callback(ScanProgress{
+        .stage = std::move(stage),
+        .current = processed,
+        .total = result.total_candidates,
+        .percent = percent,
+        .message = std::format("Hashed {}, failed {}", result.hashed_count, result.failed_count),
+    });
+  };
+  report("hashing");
+
+  // 失败项不会写入，游标越过它们，避免同一批坏文件反复重试
+  std::int64_t after_id = 0;
+  while (!stop_token.stop_requested()) {
+    auto page_result = repository::list_backfill_candidates(app_state, after_id, kBackfillPageSize);
+    if (!page_result) {
+      return std::unexpected(page_result.error());
+    }
+    const auto& page = page_result.value();
+    if (page.empty()) {
+      break;
+    }
+    after_id = page.back().id;
+
+    auto hashes_result = hash_backfill_page(app_state, page, stop_token);
+    if (!hashes_result) {
+      return std::unexpected(hashes_result.error());
+    }
+    if (stop_token.stop_requested()) {
+      break;
+    }
+    const auto& hashes = hashes_result.value();
+
+    auto persist_result = core::database::execute_transaction(
+        app_state,
+        [&page, &hashes](core::AppState& txn_app_state) -> std::expected<void, std::string> {
+          for (std::size_t i = 0; i < page.size(); ++i) {
+            if (!hashes[i].has_value()) {
+              continue;
+            }
+            auto write_result = repository::replace_asset_perceptual_hash_in_transaction(
+                txn_app_state, page[i].id, hashes[i]);
+            if (!write_result) {
+              return std::unexpected(write_result.error());
+            }
+          }
+          return {};
+        });
+    if (!persist_result) {
+      return std::unexpected("Failed to persist perceptual hashes: " + persist_result.error());
+    }
+
+    const auto hashed = std::ranges::count_if(
+        hashes, [](const std::optional<std::uint64_t>& hash) { return hash.has_value(); });
+    result.hashed_count += hashed;
+    result.failed_count += static_cast<std::int64_t>(page.size()) - hashed;
+    mark_index_stale(app_state);
+    report("hashing");
+  }
+
+  if (stop_token.stop_requested()) {
+    return std::unexpected("Perceptual hash backfill cancelled");
+  }
+
+  Logger().info("Perceptual hash backfill completed: hashed {}, failed {}", result.hashed_count,
+                result.failed_count);
+  return result;
+}
+
+}  // namespace features::gallery::similarity::service
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "vendor/std.hpp"
+
+#include "core/state/app_state.hpp"
+#include "features/gallery/types.hpp"
+#include "utils/image/image.hpp"
+
+namespace features::gallery::similarity::service {
+
+// 从扫描解码出的缩略图像素计算 dHash，扫描与回填共用
+auto compute_bitmap_perceptual_hash(const utils::image::BGRABitmapData& bitmap_data)
+    -> std::expected<std::uint64_t, std::string>;
+
+// dHash 写库提交后调用，下一次查询会重建内存索引
+auto mark_index_stale(core::AppState& app_state) -> void;
+
+auto find_similar_assets(core::AppState& app_state, const FindSimilarAssetsParams& params)
+    -> std::expected<FindSimilarAssetsResponse, std::string>;
+
+auto group_near_duplicates(core::AppState& app_state, const GroupNearDuplicatesParams& params)
+    -> std::expected<GroupNearDuplicatesResponse, std::string>;
+
+// 为缺少当前版本 dHash 的照片重新解码并补写，分页提交，可随 Gallery 关闭中止
+auto backfill_perceptual_hashes(
+    core::AppState& app_state, std::function<void(const ScanProgress&)> progress_callback = nullptr)
+    -> std::expected<PerceptualHashBackfillResult, std::string>;
+
+}  // namespace features::gallery::similarity::service
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "vendor/std.hpp"
+
+namespace features::gallery::similarity {
+
+// SQLite 只有有符号整数，dHash 以 bit_cast 后的 int64 落库
+struct PerceptualHashRow {
+  std::int64_t asset_id = 0;
+  std::int64_t dhash = 0;
+};
+
+// 回填候选只需要定位原图，按扫描时相同的短边重新解码
+struct PerceptualHashBackfillCandidate {
+  std::int64_t id = 0;
+  std::string path;
+};
+
+}  // namespace features::gallery::similarity
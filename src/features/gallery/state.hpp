@@ -2,6 +2,8 @@
 
 #include "vendor/std.hpp"
 
+#include "features/gallery/layout/justified.hpp"
+#include "features/gallery/similarity/index.hpp"
 #include "features/gallery/types.hpp"
 
 namespace features::gallery {
@@ -128,6 +130,16 @@ struct GalleryState {
   std::unordered_map<std::wstring, ManualFileSystemIgnoreEntry> manual_file_system_ignore_paths;
   std::mutex manual_file_system_ignore_mutex;
 
+  // dHash 内存索引按需重建：写入 dHash 后只置脏，下一次相似查询再整体重建。
+  // 查询方拿到 shared_ptr 后在锁外遍历，重建时直接替换指针。
+  std::shared_ptr<const similarity::index::HammingIndex> similarity_index;
+  std::mutex similarity_index_mutex;
+  std::atomic<bool> similarity_index_stale{true};
+
+  // 服务端 justified 布局的 LRU；布局 ID 由筛选结果指纹和排版参数组成，
+  // 命中时还要求筛选排序指纹与图库变更游标一致，条件或数据变化后旧 ID 不再命中。
+  layout::LayoutCache layout_cache;
+
   // 新路径继承同内容最早资产的 Gallery 用户数据后，扩展在同一事务内复制自己的资产数据。
   std::function<std::expected<void, std::string>(std::int64_t, std::int64_t)>
       inherit_asset_data_callback;
@@ -185,6 +185,9 @@ struct ScanOptions {
   // 留空时统一回落到 scanner::common::default_supported_extensions()，避免多处维护默认列表。
   std::optional<std::vector<std::string>> supported_extensions;
   std::optional<std::vector<ScanIgnoreRule>> ignore_rules;
+  // "sampled"（默认）：大媒体五点采样；"full"：大媒体分块并行树哈希，读取全部内容。
+  // 两种模式对小媒体结果相同；大媒体指纹长度不同，切换后变化文件会按内容变化重新入库。
+  std::optional<std::string> fingerprint_mode;
 };
 
 struct ScanProgress {
@@ -448,6 +451,42 @@ struct QueryAssetLayoutMetaResponse {
   std::int32_t total_count;
 };
 
+struct QueryAssetLayoutParams {
+  QueryAssetsFilters filters;
+  std::optional<std::string> sort_by = "created_at";
+  std::optional<std::string> sort_order = "desc";
+  std::int32_t container_width;
+  std::int32_t target_row_height;
+  std::optional<std::int32_t> gap = 12;
+  // 只返回与 [scroll_offset, scroll_offset + viewport_height) 相交的行
+  std::optional<std::int64_t> scroll_offset = 0;
+  std::optional<std::int64_t> viewport_height = 0;
+  // 上次响应返回的布局标识；仍在缓存中时跳过查询与排版，直接切片
+  std::optional<std::string> layout_id;
+};
+
+struct AssetLayoutRowItem {
+  std::int64_t id;
+  std::int32_t index;  // 在整个筛选结果中的位置，供按页加载 Asset
+  std::int32_t x;
+  std::int32_t width;
+};
+
+struct AssetLayoutRow {
+  std::int32_t index;
+  std::int64_t top;
+  std::int32_t height;
+  std::vector<AssetLayoutRowItem> items;
+};
+
+struct QueryAssetLayoutResponse {
+  std::string layout_id;
+  std::int32_t total_count;
+  std::int32_t row_count;
+  std::int64_t total_height;
+  std::vector<AssetLayoutRow> rows;
+};
+
 // ============= 标签相关参数 =============
 
 struct CreateTagParams {
@@ -509,6 +548,73 @@ struct UpdateAssetsDescriptionParams {
 
 struct GetTagStatsParams {};
 
+// ============= 相似图相关类型 =============
+
+struct FindSimilarAssetsParams {
+  std::int64_t asset_id;
+  // dHash 汉明距离阈值，0 为完全相同，6 以内通常是同一画面的轻微变化
+  std::optional<std::int32_t> max_distance = 6;
+  std::optional<std::int32_t> limit = 100;
+};
+
+struct SimilarAssetItem {
+  Asset asset;
+  std::int32_t distance = 0;
+};
+
+struct FindSimilarAssetsResponse {
+  std::vector<SimilarAssetItem> items;
+  // 源资产还没有 dHash（视频、回填前的旧照片）时为 false
+  bool source_hashed = false;
+};
+
+struct GroupNearDuplicatesParams {
+  QueryAssetsFilters filters;
+  // 连拍相邻帧之间的阈值，组内按传递关系相连
+  std::optional<std::int32_t> max_distance = 4;
+  std::optional<std::int32_t> min_group_size = 2;
+  std::optional<std::int32_t> limit = 200;
+};
+
+struct NearDuplicateGroup {
+  std::vector<Asset> assets;
+};
+
+struct GroupNearDuplicatesResponse {
+  std::vector<NearDuplicateGroup> groups;
+  std::int64_t total_group_count = 0;
+  // 参与分组的已有 dHash 资产数，供前端提示是否需要回填
+  std::int64_t hashed_asset_count = 0;
+};
+
+struct PerceptualHashBackfillResult {
+  std::int64_t total_candidates = 0;
+  std::int64_t hashed_count = 0;
+  std::int64_t failed_count = 0;
+};
+
+// ============= 增量变更相关类型 =============
+
+// 不带 cursor 时只返回当前游标，供前端在整页加载后开始跟随变更
+struct GalleryChangesSinceParams {
+  std::optional<std::int64_t> cursor;
+  std::optional<std::int32_t> limit = 1000;
+};
+
+// 同一实体在区间内多次变化只保留最终状态；resync_required 为 true 时其余字段为空
+struct GalleryChangesSinceResponse {
+  std::int64_t cursor = 0;
+  bool resync_required = false;
+  bool has_more = false;
+  // 新增或修改后仍可见的资产；删除或变为 missing 的资产归入 removed_asset_ids
+  std::vector<Asset> upserted_assets;
+  std::vector<std::int64_t> removed_asset_ids;
+  std::vector<std::int64_t> upserted_folder_ids;
+  std::vector<std::int64_t> removed_folder_ids;
+  std::vector<std::int64_t> upserted_tag_ids;
+  std::vector<std::int64_t> removed_tag_ids;
+};
+
 // ============= 下载相关类型 =============
 
 struct PrepareDownloadParams {
@@ -7,6 +7,7 @@
 #include "core/notifications/types.hpp"
 #include "core/rpc/notification_hub.hpp"
 #include "core/state/app_state.hpp"
+#include "core/tracing/tracing.hpp"
 #include "features/gallery/asset/thumbnail.hpp"
 #include "features/gallery/folder/repository.hpp"
 #include "features/gallery/folder/service.hpp"
@@ -413,6 +414,7 @@ auto promote_stable_file_changes(FolderWatcherState& watcher) -> void {
 auto apply_incremental_sync(core::AppState& app_state, FolderWatcherState& watcher,
                             const PendingSnapshot& snapshot)
     -> std::expected<ScanResult, std::string> {
+  core::tracing::Span span("incremental_sync", "watcher");
   ScanResult result{};
   auto options = get_watcher_scan_options(watcher);
   auto stop_token = app_state.gallery->scan_stop_source.get_token();
@@ -581,6 +583,7 @@ auto apply_incremental_sync(core::AppState& app_state, FolderWatcherState& watch
 // 执行全量重扫逻辑（直接代理到 scanner 模块）
 auto apply_full_rescan(core::AppState& app_state, FolderWatcherState& watcher)
     -> std::expected<ScanResult, std::string> {
+  core::tracing::Span span("full_rescan", "watcher");
   auto stop_token = app_state.gallery->scan_stop_source.get_token();
   // 一次全量同步全程持有共享锁，cleanup 会在释放媒体资源前等待它结束。
   std::shared_lock<std::shared_mutex> scan_lifetime_lock(app_state.gallery->scan_lifetime_mutex);
@@ -639,6 +642,7 @@ auto apply_offline_scan_changes(core::AppState& app_state, FolderWatcherState& w
 auto dispatch_scan_result(core::AppState& app_state, FolderWatcherState& watcher,
                           const ScanResult& result, std::string_view mode,
                           bool force_gallery_changed) -> void {
+  core::tracing::Span span("dispatch_scan_result", "watcher");
   // 统一收口：日志、gallery.changed 通知、post_scan_callback 都在这里发。
   // 这样启动恢复与运行时增量可以共用同一套“扫描完成后处理”。
   Logger().info(
@@ -811,6 +815,7 @@ auto process_scheduled_watcher(core::AppState& app_state, const std::string& wat
 
 // Gallery 全局同步编排循环：选择最早到期 root，无任务时事件驱动休眠。
 auto run_sync_coordinator(core::AppState& app_state, std::stop_token stop_token) -> void {
+  core::tracing::set_thread_name("gallery_sync");
   while (!stop_token.stop_requested()) {
     std::uint64_t observed_generation = 0;
     {
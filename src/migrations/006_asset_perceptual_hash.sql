@@ -0,0 +1,8 @@
+-- Perceptual difference hashes for near-duplicate and burst-shot detection.
+CREATE TABLE IF NOT EXISTS asset_perceptual_hashes (
+    asset_id INTEGER PRIMARY KEY REFERENCES assets(id) ON DELETE CASCADE,
+    dhash INTEGER NOT NULL,
+    algorithm_version INTEGER NOT NULL
+);
+
+CREATE INDEX IF NOT EXISTS idx_asset_perceptual_hashes_version ON asset_perceptual_hashes(algorithm_version);
@@ -0,0 +1,160 @@
+-- Append-only gallery change log for incremental client sync (gallery.changesSince).
+-- Triggers record asset, folder and tag upserts/removals; tag relation edits count as asset
+-- upserts. seq never goes backwards because AUTOINCREMENT does not reuse trimmed values.
+-- Updates are logged by the *_updated_at triggers themselves: their re-update of updated_at
+-- would fire a separate AFTER UPDATE trigger again, but a trigger never re-fires itself while
+-- recursive_triggers is off, so each update logs exactly once.
+-- Every statement is safe to re-run: 2.1.6.0 applies this together with 006 in one transaction,
+-- and a failed start retries both.
+CREATE TABLE IF NOT EXISTS gallery_change_log (
+    seq INTEGER PRIMARY KEY AUTOINCREMENT,
+    entity TEXT NOT NULL CHECK (entity IN ('asset', 'folder', 'tag')),
+    entity_id INTEGER NOT NULL,
+    op TEXT NOT NULL CHECK (op IN ('upsert', 'remove'))
+);
+
+CREATE TRIGGER IF NOT EXISTS gallery_change_log_assets_insert
+AFTER
+INSERT
+    ON assets FOR EACH ROW BEGIN
+INSERT INTO
+    gallery_change_log (entity, entity_id, op)
+VALUES
+    ('asset', NEW.id, 'upsert');
+END;
+
+DROP TRIGGER IF EXISTS update_assets_updated_at;
+
+CREATE TRIGGER update_assets_updated_at
+AFTER
+UPDATE
+    ON assets FOR EACH ROW BEGIN
+UPDATE
+    assets
+SET
+    updated_at = (unixepoch('subsec') * 1000)
+WHERE
+    id = NEW.id;
+
+INSERT INTO
+    gallery_change_log (entity, entity_id, op)
+VALUES
+    ('asset', NEW.id, 'upsert');
+END;
+
+CREATE TRIGGER IF NOT EXISTS gallery_change_log_assets_delete
+AFTER
+DELETE
+    ON assets FOR EACH ROW BEGIN
+INSERT INTO
+    gallery_change_log (entity, entity_id, op)
+VALUES
+    ('asset', OLD.id, 'remove');
+END;
+
+CREATE TRIGGER IF NOT EXISTS gallery_change_log_asset_tags_insert
+AFTER
+INSERT
+    ON asset_tags FOR EACH ROW BEGIN
+INSERT INTO
+    gallery_change_log (entity, entity_id, op)
+VALUES
+    ('asset', NEW.asset_id, 'upsert');
+END;
+
+-- Cascaded deletes from a removed asset must not log a trailing upsert after its removal.
+CREATE TRIGGER IF NOT EXISTS gallery_change_log_asset_tags_delete
+AFTER
+DELETE
+    ON asset_tags FOR EACH ROW
+    WHEN EXISTS (
+        SELECT
+            1
+        FROM
+            assets
+        WHERE
+            id = OLD.asset_id
+    ) BEGIN
+INSERT INTO
+    gallery_change_log (entity, entity_id, op)
+VALUES
+    ('asset', OLD.asset_id, 'upsert');
+END;
+
+CREATE TRIGGER IF NOT EXISTS gallery_change_log_folders_insert
+AFTER
+INSERT
+    ON folders FOR EACH ROW BEGIN
+INSERT INTO
+    gallery_change_log (entity, entity_id, op)
+VALUES
+    ('folder', NEW.id, 'upsert');
+END;
+
+DROP TRIGGER IF EXISTS update_folders_updated_at;
+
+CREATE TRIGGER update_folders_updated_at
+AFTER
+UPDATE
+    ON folders FOR EACH ROW BEGIN
+UPDATE
+    folders
+SET
+    updated_at = (unixepoch('subsec') * 1000)
+WHERE
+    id = NEW.id;
+
+INSERT INTO
+    gallery_change_log (entity, entity_id, op)
+VALUES
+    ('folder', NEW.id, 'upsert');
+END;
+
+CREATE TRIGGER IF NOT EXISTS gallery_change_log_folders_delete
+AFTER
+DELETE
+    ON folders FOR EACH ROW BEGIN
+INSERT INTO
+    gallery_change_log (entity, entity_id, op)
+VALUES
+    ('folder', OLD.id, 'remove');
+END;
+
+CREATE TRIGGER IF NOT EXISTS gallery_change_log_tags_insert
+AFTER
+INSERT
+    ON tags FOR EACH ROW BEGIN
+INSERT INTO
+    gallery_change_log (entity, entity_id, op)
+VALUES
+    ('tag', NEW.id, 'upsert');
+END;
+
+DROP TRIGGER IF EXISTS update_tags_updated_at;
+
+CREATE TRIGGER update_tags_updated_at
+AFTER
+UPDATE
+    ON tags FOR EACH ROW BEGIN
+UPDATE
+    tags
+SET
+    updated_at = (unixepoch('subsec') * 1000)
+WHERE
+    id = NEW.id;
+
+INSERT INTO
+    gallery_change_log (entity, entity_id, op)
+VALUES
+    ('tag', NEW.id, 'upsert');
+END;
+
+CREATE TRIGGER IF NOT EXISTS gallery_change_log_tags_delete
+AFTER
+DELETE
+    ON tags FOR EACH ROW BEGIN
+INSERT INTO
+    gallery_change_log (entity, entity_id, op)
+VALUES
+    ('tag', OLD.id, 'remove');
+END;
@@ -0,0 +1,41 @@
+#include "utils/compression/compression.hpp"
+
+#include "vendor/std.hpp"
+
+#include "vendor/zlib.hpp"
+
+namespace utils::compression {
+
+auto compress(std::string_view input, Encoding encoding, int level)
+    -> std::expected<std::string, std::string> {
+  if (input.size() > std::numeric_limits<uInt>::max()) {
+    return std::unexpected("Input is too large to compress in one pass");
+  }
+
+  z_stream stream{};
+  // windowBits 加 16 让 zlib 写出 gzip 头尾，否则为 zlib 包装
+  const int window_bits = encoding == Encoding::Gzip ? MAX_WBITS + 16 : MAX_WBITS;
+  if (deflateInit2(&stream, std::clamp(level, 1, 9), Z_DEFLATED, window_bits, 8,
+                   Z_DEFAULT_STRATEGY) != Z_OK) {
+    return std::unexpected("Failed to initialize deflate stream");
+  }
+
+  // deflateBound 已计入所选包装格式的头尾，单次 Z_FINISH 必然写完
+  std::string output(deflateBound(&stream, static_cast<uLong>(input.size())), '\0');
+  stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+  stream.avail_in = static_cast<uInt>(input.size());
+  stream.next_out = reinterpret_cast<Bytef*>(output.data());
+  stream.avail_out = static_cast<uInt>(output.size());
+
+  const int result = deflate(&stream, Z_FINISH);
+  const auto written = stream.total_out;
+  deflateEnd(&stream);
+  if (result != Z_STREAM_END) {
+    return std::unexpected(std::format("Deflate failed with zlib error {}", result));
+  }
+
+  output.resize(static_cast<size_t>(written));
+  return output;
+}
+
+}  // namespace utils::compression
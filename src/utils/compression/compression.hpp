@@ -0,0 +1,14 @@
+#pragma once
+
+#include "vendor/std.hpp"
+
+namespace utils::compression {
+
+// HTTP Content-Encoding 中的两种 zlib 格式：gzip 包装与 zlib 包装（HTTP 称 deflate）
+enum class Encoding { Gzip, Deflate };
+
+// 一次性压缩整段输入；level 取 1（最快）到 9（最小），超出范围时截断
+auto compress(std::string_view input, Encoding encoding, int level)
+    -> std::expected<std::string, std::string>;
+
+}  // namespace utils::compression
@@ -0,0 +1,259 @@
+#include "utils/hash/file_hash.hpp"
+
+#include "vendor/std.hpp"
+
+#include "vendor/wil.hpp"
+#include "vendor/windows.hpp"
+#include "vendor/xxhash.hpp"
+
+#include "utils/hash/xxhash.hpp"
+
+namespace utils::hash {
+
+// 单个映射视图的最大跨度；x64 地址空间充裕，更大的视图只会减少映射调用次数
+constexpr std::uint64_t kMappedViewSize = 64 * 1024 * 1024;
+// 视图内每喂入这么多字节检查一次停止请求，与缓冲读取的响应粒度同一量级
+constexpr std::size_t kMappedUpdateStep = 4 * 1024 * 1024;
+
+struct MappedFile {
+  wil::unique_hfile file;
+  wil::unique_handle mapping;
+  std::uint64_t size = 0;
+};
+
+auto allocation_granularity() -> std::uint64_t {
+  static const std::uint64_t granularity = [] {
+    SYSTEM_INFO info{};
+    GetSystemInfo(&info);
+    return static_cast<std::uint64_t>(info.dwAllocationGranularity);
+  }();
+  return granularity;
+}
+
+// 映射页读取失败（网络中断、文件被截断）以结构化异常抛出，只能在无析构对象的函数里用 SEH 捕获
+auto update_state_from_view(XXH3_state_t* state, const void* data, std::size_t size) -> bool {
+  __try {
+    return XXH3_64bits_update(state, data, size) == XXH_OK;
+  } __except (GetExceptionCode() == EXCEPTION_IN_PAGE_ERROR ? EXCEPTION_EXECUTE_HANDLER
+                                                             : EXCEPTION_CONTINUE_SEARCH) {
+    return false;
+  }
+}
+
+// 树哈希叶子用 128 位流式状态，必须走对应的 128 位更新函数
+auto update_state_128_from_view(XXH3_state_t* state, const void* data, std::size_t size) -> bool {
+  __try {
+    return XXH3_128bits_update(state, data, size) == XXH_OK;
+  } __except (GetExceptionCode() == EXCEPTION_IN_PAGE_ERROR ? EXCEPTION_EXECUTE_HANDLER
+                                                             : EXCEPTION_CONTINUE_SEARCH) {
+    return false;
+  }
+}
+
+using ViewUpdate = bool (*)(XXH3_state_t*, const void*, std::size_t);
+
+// 只对可安全映射的本地非空文件返回映射；其余情况交给缓冲读取给出原有的错误语义
+auto open_mapped_file(const std::filesystem::path& path) -> std::optional<MappedFile> {
+  MappedFile mapped;
+  mapped.file.reset(CreateFileW(path.c_str(), GENERIC_READ,
+                                FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+                                OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr));
+  if (!mapped.file) {
+    return std::nullopt;
+  }
+
+  // 远程文件的缺页要走网络往返，且断线会变成读页异常，直接使用顺序缓冲读取
+  FILE_REMOTE_PROTOCOL_INFO remote_info{};
+  if (GetFileInformationByHandleEx(mapped.file.get(), FileRemoteProtocolInfo, &remote_info,
+                                   sizeof(remote_info))) {
+    return std::nullopt;
+  }
+
+  LARGE_INTEGER file_size{};
+  if (!GetFileSizeEx(mapped.file.get(), &file_size) || file_size.QuadPart <= 0) {
+    return std::nullopt;
+  }
+  mapped.size = static_cast<std::uint64_t>(file_size.QuadPart);
+
+  mapped.mapping.reset(
+      CreateFileMappingW(mapped.file.get(), nullptr, PAGE_READONLY, 0, 0, nullptr));
+  if (!mapped.mapping) {
+    return std::nullopt;
+  }
+  return mapped;
+}
+
+// 将映射文件的一个区间直接喂给 XXH3。返回 false 表示映射读取失败，调用方应整体回落。
+// update_view 须与状态的 reset 宽度一致
+auto update_state_from_mapping(const MappedFile& mapped, XXH3_state_t* state,
+                               std::uint64_t offset, std::uint64_t size,
+                               std::stop_token stop_token,
+                               ViewUpdate update_view = update_state_from_view)
+    -> std::expected<bool, std::string> {
+  // 越界区间交给缓冲读取，保持与流式版本相同的错误信息
+  if (offset > mapped.size || size > mapped.size - offset) {
+    return false;
+  }
+
+  const auto end = offset + size;
+  auto position = offset;
+  while (position < end) {
+    if (stop_token.stop_requested()) {
+      return std::unexpected("Hash calculation cancelled");
+    }
+
+    // 视图起点必须按分配粒度对齐，区间起点落在视图内部
+    const auto view_offset = position - position % allocation_granularity();
+    const auto view_size = std::min(kMappedViewSize, end - view_offset);
+    wil::unique_mapview_ptr<std::byte> view(static_cast<std::byte*>(MapViewOfFile(
+        mapped.mapping.get(), FILE_MAP_READ, static_cast<DWORD>(view_offset >> 32),
+        static_cast<DWORD>(view_offset & 0xFFFFFFFF), static_cast<SIZE_T>(view_size))));
+    if (!view) {
+      return false;
+    }
+
+    const auto* data = view.get() + (position - view_offset);
+    const auto data_size = static_cast<std::size_t>(view_offset + view_size - position);
+
+    // 顺序访问提示：让内存管理器提前批量读入整个视图，而不是逐页缺页
+    WIN32_MEMORY_RANGE_ENTRY prefetch_range{const_cast<std::byte*>(data), data_size};
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &prefetch_range, 0);
+
+    for (std::size_t consumed = 0; consumed < data_size;) {
+      if (stop_token.stop_requested()) {
+        return std::unexpected("Hash calculation cancelled");
+      }
+
+      const auto step = std::min(kMappedUpdateStep, data_size - consumed);
+      if (!update_view(state, data + consumed, step)) {
+        return false;
+      }
+      consumed += step;
+    }
+
+    position += data_size;
+  }
+
+  return true;
+}
+
+// 映射路径：返回 nullopt 表示无法映射或映射读取失败，需要回落到缓冲读取
+auto hash_mapped_ranges(const std::filesystem::path& path, std::span<const std::byte> metadata,
+                        std::span<const StreamRange> ranges, bool whole_file,
+                        std::stop_token stop_token)
+    -> std::optional<std::expected<std::string, std::string>> {
+  auto mapped = open_mapped_file(path);
+  if (!mapped) {
+    return std::nullopt;
+  }
+
+  auto state_result = create_state();
+  if (!state_result) {
+    return std::unexpected(state_result.error());
+  }
+  auto state = std::move(state_result.value());
+
+  auto metadata_result = update_state(state.get(), metadata.data(), metadata.size_bytes());
+  if (!metadata_result) {
+    return std::unexpected(metadata_result.error());
+  }
+
+  const std::array<StreamRange, 1> whole_range{
+      StreamRange{.offset = 0, .size = static_cast<std::size_t>(mapped->size)}};
+  for (const auto& range : whole_file ? std::span<const StreamRange>{whole_range} : ranges) {
+    auto update_result =
+        update_state_from_mapping(*mapped, state.get(), range.offset, range.size, stop_token);
+    if (!update_result) {
+      return std::unexpected(update_result.error());
+    }
+    if (!update_result.value()) {
+      return std::nullopt;
+    }
+  }
+
+  return digest_state(state.get());
+}
+
+auto hash_file_to_hex(const std::filesystem::path& path, std::stop_token stop_token)
+    -> std::expected<std::string, std::string> {
+  if (auto mapped_result = hash_mapped_ranges(path, {}, {}, true, stop_token)) {
+    return std::move(mapped_result.value());
+  }
+
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    return std::unexpected("Cannot open file for hashing: " + path.string());
+  }
+  return hash_stream_to_hex(file, stop_token);
+}
+
+auto hash_file_ranges_to_hex(const std::filesystem::path& path,
+                             std::span<const std::byte> metadata,
+                             std::span<const StreamRange> ranges, std::stop_token stop_token)
+    -> std::expected<std::string, std::string> {
+  if (auto mapped_result = hash_mapped_ranges(path, metadata, ranges, false, stop_token)) {
+    return std::move(mapped_result.value());
+  }
+
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    return std::unexpected("Cannot open file for hashing: " + path.string());
+  }
+  return hash_stream_ranges_to_hex(file, metadata, ranges, stop_token);
+}
+
+auto hash_file_tree_leaves(const std::filesystem::path& path, std::uint64_t file_size,
+                           std::size_t first_leaf, std::span<XXH128_hash_t> leaves,
+                           std::stop_token stop_token) -> std::expected<void, std::string> {
+  // 文件大小与扫描时不一致时叶子区间会越界，映射路径返回 false，由缓冲读取报告截断
+  auto mapped = open_mapped_file(path);
+  std::ifstream stream;
+  std::vector<char> buffer;
+
+  for (std::size_t i = 0; i < leaves.size(); ++i) {
+    if (stop_token.stop_requested()) {
+      return std::unexpected("Hash calculation cancelled");
+    }
+
+    const auto range = tree_chunk_range(file_size, first_leaf + i);
+    if (mapped) {
+      auto state_result = create_state();
+      if (!state_result) {
+        return std::unexpected(state_result.error());
+      }
+      auto state = std::move(state_result.value());
+      if (XXH3_128bits_reset(state.get()) != XXH_OK) {
+        return std::unexpected("Failed to reset XXH3 state");
+      }
+
+      auto update_result = update_state_from_mapping(*mapped, state.get(), range.offset,
+                                                     range.size, stop_token,
+                                                     update_state_128_from_view);
+      if (!update_result) {
+        return std::unexpected(update_result.error());
+      }
+      if (update_result.value()) {
+        leaves[i] = XXH3_128bits_digest(state.get());
+        continue;
+      }
+      mapped.reset();
+    }
+
+    if (!stream.is_open()) {
+      stream.open(path, std::ios::binary);
+      if (!stream) {
+        return std::unexpected("Cannot open file for tree hashing");
+      }
+      buffer.resize(static_cast<std::size_t>(std::min(kTreeChunkSize, file_size)));
+    }
+    auto leaf_result = hash_file_chunk(stream, range.offset, range.size, buffer);
+    if (!leaf_result) {
+      return std::unexpected(leaf_result.error());
+    }
+    leaves[i] = leaf_result.value();
+  }
+
+  return {};
+}
+
+}  // namespace utils::hash
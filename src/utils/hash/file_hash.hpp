@@ -0,0 +1,27 @@
+#pragma once
+
+#include "vendor/std.hpp"
+
+#include "utils/hash/xxhash.hpp"
+
+namespace utils::hash {
+
+// 按路径计算完整文件的 XXH3 摘要，结果与 hash_stream_to_hex 逐字节一致。
+// 本地文件走内存映射直接喂给 XXH3；远程文件、映射失败或读页错误时回落到缓冲读取。
+auto hash_file_to_hex(const std::filesystem::path& path, std::stop_token stop_token)
+    -> std::expected<std::string, std::string>;
+
+// 按路径计算"元数据 + 指定区间"的 XXH3 摘要，结果与 hash_stream_ranges_to_hex 一致
+auto hash_file_ranges_to_hex(const std::filesystem::path& path,
+                             std::span<const std::byte> metadata,
+                             std::span<const StreamRange> ranges, std::stop_token stop_token)
+    -> std::expected<std::string, std::string>;
+
+// 计算从 first_leaf 起连续 leaves.size() 个树哈希叶子块的 XXH3-128，写入 leaves。
+// 本地文件走内存映射，映射不可用或读页失败时该段其余叶子回落到缓冲读取；
+// 每次调用独立打开文件，可由多个线程各自处理不相交的叶子段。
+auto hash_file_tree_leaves(const std::filesystem::path& path, std::uint64_t file_size,
+                           std::size_t first_leaf, std::span<XXH128_hash_t> leaves,
+                           std::stop_token stop_token) -> std::expected<void, std::string>;
+
+}  // namespace utils::hash
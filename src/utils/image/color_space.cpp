@@ -0,0 +1,159 @@
+#include "utils/image/color_space.hpp"
+
+#include "vendor/std.hpp"
+
+#include <emmintrin.h>
+
+namespace utils::image {
+
+constexpr float kLabEpsilon = 216.0f / 24389.0f;
+constexpr float kLabKappa = 24389.0f / 27.0f;
+
+// D65 参考白
+constexpr float kRefX = 0.95047f;
+constexpr float kRefY = 1.00000f;
+constexpr float kRefZ = 1.08883f;
+
+auto srgb_to_linear(float value) -> float {
+  float normalized = value / 255.0f;
+  if (normalized <= 0.04045f) {
+    return normalized / 12.92f;
+  }
+  return std::pow((normalized + 0.055f) / 1.055f, 2.4f);
+}
+
+auto lab_f(float value) -> float {
+  if (value > kLabEpsilon) {
+    return std::cbrt(value);
+  }
+  return (kLabKappa * value + 16.0f) / 116.0f;
+}
+
+// 将 sRGB 字节值转换到 CIE Lab，供感知距离计算与 Lab 空间聚类使用
+auto rgb_to_lab_color(std::uint8_t r, std::uint8_t g, std::uint8_t b) -> LabColor {
+  float lr = srgb_to_linear(static_cast<float>(r));
+  float lg = srgb_to_linear(static_cast<float>(g));
+  float lb = srgb_to_linear(static_cast<float>(b));
+
+  float x = lr * 0.4124564f + lg * 0.3575761f + lb * 0.1804375f;
+  float y = lr * 0.2126729f + lg * 0.7151522f + lb * 0.0721750f;
+  float z = lr * 0.0193339f + lg * 0.1191920f + lb * 0.9503041f;
+
+  float fx = lab_f(x / kRefX);
+  float fy = lab_f(y / kRefY);
+  float fz = lab_f(z / kRefZ);
+
+  return LabColor{
+      .l = 116.0f * fy - 16.0f,
+      .a = 500.0f * (fx - fy),
+      .b = 200.0f * (fy - fz),
+  };
+}
+
+// 与 srgb_to_linear 逐项相同的 256 项线性化表，只在首次使用时构建
+auto linearization_table() -> const std::array<float, 256>& {
+  static const auto table = [] {
+    std::array<float, 256> values{};
+    for (std::size_t i = 0; i < values.size(); ++i) {
+      values[i] = srgb_to_linear(static_cast<float>(i));
+    }
+    return values;
+  }();
+  return table;
+}
+
+// 位运算给出立方根初值，再做两轮牛顿迭代；在 Lab 使用的 (epsilon, ~1.1] 区间相对误差约 1e-6
+auto fast_cbrt_ps(__m128 value) -> __m128 {
+  const __m128 one_third = _mm_set1_ps(1.0f / 3.0f);
+  const __m128 two = _mm_set1_ps(2.0f);
+
+  // 对 IEEE754 位模式除以 3 近似指数除以 3；SSE2 无整数除法，借助浮点乘法完成
+  __m128i bits = _mm_castps_si128(value);
+  __m128i third_bits = _mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(bits), one_third));
+  __m128 guess = _mm_castsi128_ps(_mm_add_epi32(third_bits, _mm_set1_epi32(0x2a5137a0)));
+
+  for (int iteration = 0; iteration < 2; ++iteration) {
+    __m128 squared = _mm_mul_ps(guess, guess);
+    guess = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(guess, two), _mm_div_ps(value, squared)), one_third);
+  }
+  return guess;
+}
+
+auto lab_f_ps(__m128 value) -> __m128 {
+  __m128 linear = _mm_div_ps(
+      _mm_add_ps(_mm_mul_ps(value, _mm_set1_ps(kLabKappa)), _mm_set1_ps(16.0f)),
+      _mm_set1_ps(116.0f));
+  __m128 cube_root = fast_cbrt_ps(value);
+  // SSE2 没有 blendv，用掩码与/非组合选择两条分支
+  __m128 use_cube_root = _mm_cmpgt_ps(value, _mm_set1_ps(kLabEpsilon));
+  return _mm_or_ps(_mm_and_ps(use_cube_root, cube_root), _mm_andnot_ps(use_cube_root, linear));
+}
+
+// 一次转换 4 个像素，输入为已经查表得到的线性 RGB 通道
+auto linear_rgb_to_lab_ps(__m128 lr, __m128 lg, __m128 lb, float* l_out, float* a_out,
+                          float* b_out) -> void {
+  auto dot = [&](float cr, float cg, float cb) {
+    return _mm_add_ps(_mm_add_ps(_mm_mul_ps(lr, _mm_set1_ps(cr)), _mm_mul_ps(lg, _mm_set1_ps(cg))),
+                      _mm_mul_ps(lb, _mm_set1_ps(cb)));
+  };
+
+  // 参考白倒数直接并入矩阵系数，省掉逐像素除法
+  __m128 x = dot(0.4124564f / kRefX, 0.3575761f / kRefX, 0.1804375f / kRefX);
+  __m128 y = dot(0.2126729f / kRefY, 0.7151522f / kRefY, 0.0721750f / kRefY);
+  __m128 z = dot(0.0193339f / kRefZ, 0.1191920f / kRefZ, 0.9503041f / kRefZ);
+
+  __m128 fx = lab_f_ps(x);
+  __m128 fy = lab_f_ps(y);
+  __m128 fz = lab_f_ps(z);
+
+  _mm_storeu_ps(l_out, _mm_sub_ps(_mm_mul_ps(fy, _mm_set1_ps(116.0f)), _mm_set1_ps(16.0f)));
+  _mm_storeu_ps(a_out, _mm_mul_ps(_mm_sub_ps(fx, fy), _mm_set1_ps(500.0f)));
+  _mm_storeu_ps(b_out, _mm_mul_ps(_mm_sub_ps(fy, fz), _mm_set1_ps(200.0f)));
+}
+
+auto bgra_to_lab_planes(std::span<const std::uint8_t> bgra_pixels, std::span<float> l_plane,
+                        std::span<float> a_plane, std::span<float> b_plane) -> void {
+  const auto pixel_count =
+      std::min({bgra_pixels.size() / 4, l_plane.size(), a_plane.size(), b_plane.size()});
+  const auto& table = linearization_table();
+  const auto* pixels = bgra_pixels.data();
+
+  std::size_t index = 0;
+  for (; index + 4 <= pixel_count; index += 4) {
+    const auto* block = pixels + index * 4;
+    // 查表是标量 gather，矩阵乘与立方根走 4 通道
+    __m128 lr = _mm_setr_ps(table[block[2]], table[block[6]], table[block[10]], table[block[14]]);
+    __m128 lg = _mm_setr_ps(table[block[1]], table[block[5]], table[block[9]], table[block[13]]);
+    __m128 lb = _mm_setr_ps(table[block[0]], table[block[4]], table[block[8]], table[block[12]]);
+    linear_rgb_to_lab_ps(lr, lg, lb, l_plane.data() + index, a_plane.data() + index,
+                         b_plane.data() + index);
+  }
+
+  // 尾部不足 4 个像素时补零成整块，结果只写回有效通道
+  if (index < pixel_count) {
+    std::array<float, 4> channel_r{};
+    std::array<float, 4> channel_g{};
+    std::array<float, 4> channel_b{};
+    const auto remaining = pixel_count - index;
+    for (std::size_t lane = 0; lane < remaining; ++lane) {
+      const auto* pixel = pixels + (index + lane) * 4;
+      channel_r[lane] = table[pixel[2]];
+      channel_g[lane] = table[pixel[1]];
+      channel_b[lane] = table[pixel[0]];
+    }
+
+    std::array<float, 4> tail_l{};
+    std::array<float, 4> tail_a{};
+    std::array<float, 4> tail_b{};
+    linear_rgb_to_lab_ps(_mm_loadu_ps(channel_r.data()), _mm_loadu_ps(channel_g.data()),
+                         _mm_loadu_ps(channel_b.data()), tail_l.data(), tail_a.data(),
+                         tail_b.data());
+    for (std::size_t lane = 0; lane < remaining; ++lane) {
+      l_plane[index + lane] = tail_l[lane];
+      a_plane[index + lane] = tail_a[lane];
+      b_plane[index + lane] = tail_b[lane];
+    }
+  }
+}
+
+}  // namespace utils::image
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "vendor/std.hpp"
+
+namespace utils::image {
+
+struct RgbColor {
+  std::uint8_t r = 0;
+  std::uint8_t g = 0;
+  std::uint8_t b = 0;
+};
+
+struct LabColor {
+  float l = 0.0f;
+  float a = 0.0f;
+  float b = 0.0f;
+};
+
+// 批量转换与逐像素 rgb_to_lab_color 的最大绝对误差（L/a/b 各分量）。
+// 远小于入库 bin 宽度（L 5、ab 8），已存的 l_bin/a_bin/b_bin 仅在 bin 边界极窄处可能差一格。
+constexpr float kBatchLabMaxError = 1e-3f;
+
+// sRGB 转 CIE Lab，供按色筛选与 Lab 空间聚类共用
+auto rgb_to_lab_color(std::uint8_t r, std::uint8_t g, std::uint8_t b) -> LabColor;
+
+// 将紧排 BGRA 像素批量转换为 SoA 的 L/a/b 平面，输出长度须不小于像素数。
+// 使用 256 项线性化查表、快速立方根与 SIMD 通道，误差见 kBatchLabMaxError。
+auto bgra_to_lab_planes(std::span<const std::uint8_t> bgra_pixels, std::span<float> l_plane,
+                        std::span<float> a_plane, std::span<float> b_plane) -> void;
+
+}  // namespace utils::image
@@ -0,0 +1,325 @@
+#include "utils/image/palette.hpp"
+
+#include "vendor/std.hpp"
+
+#include "vendor/dkm.hpp"
+
+#include "utils/image/color_space.hpp"
+
+namespace utils::image {
+
+auto mix_kmeans_seed(std::uint64_t hash, std::uint64_t value) -> std::uint64_t {
+  hash ^= value + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2);
+  return hash;
+}
+
+auto build_kmeans_seed(const std::vector<std::array<float, 3>>& points, std::size_t cluster_count)
+    -> std::uint64_t {
+  std::uint64_t hash = 0xCBF29CE484222325ull;
+  hash = mix_kmeans_seed(hash, static_cast<std::uint64_t>(points.size()));
+  hash = mix_kmeans_seed(hash, static_cast<std::uint64_t>(cluster_count));
+
+  for (const auto& point : points) {
+    for (float component : point) {
+      hash = mix_kmeans_seed(hash,
+                             static_cast<std::uint64_t>(std::bit_cast<std::uint32_t>(component)));
+    }
+  }
+
+  return hash == 0 ? 1 : hash;
+}
+
+// 用输入点集派生固定随机种子跑 K-Means，避免 dkm 默认 random_device 导致同图多次取色结果漂移
+auto run_deterministic_kmeans(const std::vector<std::array<float, 3>>& points,
+                              std::size_t cluster_count)
+    -> std::expected<std::vector<std::size_t>, std::string> {
+  if (points.empty()) {
+    return std::unexpected("KMeans input has no points");
+  }
+
+  if (cluster_count == 0) {
+    return std::unexpected("KMeans cluster count must be greater than zero");
+  }
+
+  auto effective_cluster_count = std::min(cluster_count, points.size());
+  if (effective_cluster_count > std::numeric_limits<std::uint32_t>::max()) {
+    return std::unexpected("KMeans cluster count is too large");
+  }
+
+  try {
+    dkm::clustering_parameters<float> parameters(
+        static_cast<std::uint32_t>(effective_cluster_count));
+    parameters.set_random_seed(build_kmeans_seed(points, effective_cluster_count));
+
+    auto [means, raw_labels] = dkm::kmeans_lloyd(points, parameters);
+    // 最终颜色由簇内像素均值决定，簇心坐标仅用于分组
+    (void)means;
+
+    std::vector<std::size_t> labels;
+    labels.reserve(raw_labels.size());
+    for (const auto& label : raw_labels) {
+      labels.push_back(static_cast<std::size_t>(label));
+    }
+
+    return labels;
+  } catch (const std::exception& e) {
+    return std::unexpected("Deterministic KMeans failed: " + std::string(e.what()));
+  }
+}
+
+constexpr std::size_t kHistogramAxisBins = 32;
+constexpr std::size_t kHistogramBinCount =
+    kHistogramAxisBins * kHistogramAxisBins * kHistogramAxisBins;
+constexpr std::size_t kHistogramMaxIterations = 16;
+
+// Lab 分量映射到 32 级直方图坐标；L 取 [0, 100]，a/b 取 [-128, 128)
+auto histogram_axis_index(float value, float min_value, float max_value) -> std::size_t {
+  auto scaled =
+      (value - min_value) / (max_value - min_value) * static_cast<float>(kHistogramAxisBins);
+  return static_cast<std::size_t>(
+      std::clamp(static_cast<int>(scaled), 0, static_cast<int>(kHistogramAxisBins) - 1));
+}
+
+auto squared_lab_distance(const std::array<double, 3>& lhs, const std::array<double, 3>& rhs)
+    -> double {
+  double dl = lhs[0] - rhs[0];
+  double da = lhs[1] - rhs[1];
+  double db = lhs[2] - rhs[2];
+  return dl * dl + da * da + db * db;
+}
+
+// 先把采样点量化成 32x32x32 的 Lab 直方图，再对非空 bin 做加权 K-Means，
+// 迭代成本只随非空 bin 数增长。种子按 k-means++ 思路贪心选取（权重 × 最近簇心距离平方最大），
+// 不依赖随机数，同一输入结果固定。
+auto run_histogram_kmeans(const std::vector<std::array<float, 3>>& points,
+                          std::size_t cluster_count)
+    -> std::expected<std::vector<std::size_t>, std::string> {
+  if (points.empty()) {
+    return std::unexpected("Histogram clustering input has no points");
+  }
+
+  if (cluster_count == 0) {
+    return std::unexpected("Histogram clustering cluster count must be greater than zero");
+  }
+
+  struct HistogramBin {
+    double weight = 0.0;
+    std::array<double, 3> mean{};
+  };
+
+  constexpr auto kNoSlot = std::numeric_limits<std::uint32_t>::max();
+  std::vector<std::uint32_t> slot_by_key(kHistogramBinCount, kNoSlot);
+  std::vector<HistogramBin> bins;
+  std::vector<std::uint32_t> point_slots;
+  point_slots.reserve(points.size());
+
+  for (const auto& point : points) {
+    auto key = (histogram_axis_index(point[0], 0.0f, 100.0f) * kHistogramAxisBins +
+                histogram_axis_index(point[1], -128.0f, 128.0f)) *
+                   kHistogramAxisBins +
+               histogram_axis_index(point[2], -128.0f, 128.0f);
+    auto& slot = slot_by_key[key];
+    if (slot == kNoSlot) {
+      slot = static_cast<std::uint32_t>(bins.size());
+      bins.emplace_back();
+    }
+
+    // bin 内先累计坐标和，稍后除以权重得到 bin 质心
+    auto& bin = bins[slot];
+    bin.weight += 1.0;
+    bin.mean[0] += point[0];
+    bin.mean[1] += point[1];
+    bin.mean[2] += point[2];
+    point_slots.push_back(slot);
+  }
+
+  for (auto& bin : bins) {
+    for (auto& component : bin.mean) {
+      component /= bin.weight;
+    }
+  }
+
+  auto effective_cluster_count = std::min(cluster_count, bins.size());
+  std::vector<std::array<double, 3>> centers;
+  centers.reserve(effective_cluster_count);
+
+  // 首个簇心取权重最大的 bin；并列时取先出现的 bin，保证确定性
+  auto heaviest = std::ranges::max_element(bins, std::ranges::less{}, &HistogramBin::weight);
+  centers.push_back(heaviest->mean);
+
+  std::vector<double> nearest_distance(bins.size(), std::numeric_limits<double>::max());
+  while (centers.size() < effective_cluster_count) {
+    std::size_t best_index = 0;
+    double best_score = -1.0;
+    for (std::size_t i = 0; i < bins.size(); ++i) {
+      nearest_distance[i] =
+          std::min(nearest_distance[i], squared_lab_distance(bins[i].mean, centers.back()));
+      double score = bins[i].weight * nearest_distance[i];
+      if (score > best_score) {
+        best_score = score;
+        best_index = i;
+      }
+    }
+
+    // 剩余 bin 都与已有簇心重合，继续加簇心只会得到空簇
+    if (best_score <= 0.0) {
+      break;
+    }
+    centers.push_back(bins[best_index].mean);
+  }
+
+  std::vector<std::size_t> bin_labels(bins.size(), 0);
+  for (std::size_t iteration = 0; iteration < kHistogramMaxIterations; ++iteration) {
+    bool changed = iteration == 0;
+    for (std::size_t i = 0; i < bins.size(); ++i) {
+      std::size_t best_label = 0;
+      double best_distance = std::numeric_limits<double>::max();
+      for (std::size_t c = 0; c < centers.size(); ++c) {
+        double distance = squared_lab_distance(bins[i].mean, centers[c]);
+        if (distance < best_distance) {
+          best_distance = distance;
+          best_label = c;
+        }
+      }
+      if (bin_labels[i] != best_label) {
+        bin_labels[i] = best_label;
+        changed = true;
+      }
+    }
+
+    if (!changed) {
+      break;
+    }
+
+    // 按 bin 权重重新计算簇心；空簇保留原位置，避免簇数塌缩
+    std::vector<std::array<double, 3>> sums(centers.size(), std::array<double, 3>{});
+    std::vector<double> weights(centers.size(), 0.0);
+    for (std::size_t i = 0; i < bins.size(); ++i) {
+      auto label = bin_labels[i];
+      weights[label] += bins[i].weight;
+      for (std::size_t axis = 0; axis < 3; ++axis) {
+        sums[label][axis] += bins[i].mean[axis] * bins[i].weight;
+      }
+    }
+    for (std::size_t c = 0; c < centers.size(); ++c) {
+      if (weights[c] <= 0.0) continue;
+      for (std::size_t axis = 0; axis < 3; ++axis) {
+        centers[c][axis] = sums[c][axis] / weights[c];
+      }
+    }
+  }
+
+  // 采样点继承所在 bin 的簇标签，后续仍按像素累计最终颜色
+  std::vector<std::size_t> labels;
+  labels.reserve(points.size());
+  for (auto slot : point_slots) {
+    labels.push_back(bin_labels[slot]);
+  }
+
+  return labels;
+}
+
+auto cluster_lab_points(const std::vector<std::array<float, 3>>& points,
+                        std::size_t cluster_count, PaletteEngine engine)
+    -> std::expected<std::vector<std::size_t>, std::string> {
+  return engine == PaletteEngine::Histogram ? run_histogram_kmeans(points, cluster_count)
+                                            : run_deterministic_kmeans(points, cluster_count);
+}
+
+auto build_lab_palette(std::span<const std::uint8_t> sampled_bgra, std::size_t max_clusters,
+                       PaletteEngine engine)
+    -> std::expected<std::vector<PaletteColor>, std::string> {
+  const auto sample_count = sampled_bgra.size() / 4;
+  if (sample_count == 0) {
+    return std::unexpected("No valid pixels found for palette extraction");
+  }
+
+  std::vector<float> l_plane(sample_count);
+  std::vector<float> a_plane(sample_count);
+  std::vector<float> b_plane(sample_count);
+  bgra_to_lab_planes(sampled_bgra, l_plane, a_plane, b_plane);
+
+  std::vector<std::array<float, 3>> points;
+  points.reserve(sample_count);
+  for (std::size_t i = 0; i < sample_count; ++i) {
+    points.push_back({l_plane[i], a_plane[i], b_plane[i]});
+  }
+
+  auto cluster_count = std::clamp(max_clusters, std::size_t{1}, points.size());
+  // 在 Lab 空间聚类，比 RGB 更符合人眼对"相近色"的感知
+  auto labels_result = cluster_lab_points(points, cluster_count, engine);
+  if (!labels_result) {
+    return std::unexpected(labels_result.error());
+  }
+
+  struct ClusterAccumulator {
+    std::size_t count = 0;
+    double r = 0.0;
+    double g = 0.0;
+    double b = 0.0;
+    double lab_l = 0.0;
+    double lab_a = 0.0;
+    double lab_b = 0.0;
+  };
+
+  std::vector<ClusterAccumulator> clusters(cluster_count);
+  for (std::size_t i = 0; i < sample_count && i < labels_result->size(); ++i) {
+    auto label = (*labels_result)[i];
+    if (label >= clusters.size()) {
+      continue;
+    }
+
+    auto& cluster = clusters[label];
+    const auto* pixel = sampled_bgra.data() + i * 4;
+    cluster.count += 1;
+    cluster.r += pixel[2];
+    cluster.g += pixel[1];
+    cluster.b += pixel[0];
+    cluster.lab_l += l_plane[i];
+    cluster.lab_a += a_plane[i];
+    cluster.lab_b += b_plane[i];
+  }
+
+  auto to_channel = [](double value, std::size_t count) -> std::uint8_t {
+    long rounded = std::lround(value / static_cast<double>(count));
+    return static_cast<std::uint8_t>(std::clamp(rounded, 0l, 255l));
+  };
+
+  std::vector<PaletteColor> palette;
+  palette.reserve(clusters.size());
+  const auto total_weight = static_cast<float>(sample_count);
+  for (const auto& cluster : clusters) {
+    if (cluster.count == 0) {
+      continue;
+    }
+
+    auto count = static_cast<double>(cluster.count);
+    palette.push_back(PaletteColor{
+        .rgb =
+            RgbColor{
+                .r = to_channel(cluster.r, cluster.count),
+                .g = to_channel(cluster.g, cluster.count),
+                .b = to_channel(cluster.b, cluster.count),
+            },
+        .lab =
+            LabColor{
+                .l = static_cast<float>(cluster.lab_l / count),
+                .a = static_cast<float>(cluster.lab_a / count),
+                .b = static_cast<float>(cluster.lab_b / count),
+            },
+        .weight = static_cast<float>(cluster.count) / total_weight,
+    });
+  }
+
+  // 权重降序，调用方取 front() 即画面占比最大的主色
+  std::ranges::sort(palette, [](const PaletteColor& lhs, const PaletteColor& rhs) {
+    if (lhs.weight != rhs.weight) return lhs.weight > rhs.weight;
+    if (lhs.rgb.r != rhs.rgb.r) return lhs.rgb.r < rhs.rgb.r;
+    if (lhs.rgb.g != rhs.rgb.g) return lhs.rgb.g < rhs.rgb.g;
+    return lhs.rgb.b < rhs.rgb.b;
+  });
+
+  return palette;
+}
+
+}  // namespace utils::image
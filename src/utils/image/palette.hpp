@@ -0,0 +1,35 @@
+#pragma once
+
+#include "vendor/std.hpp"
+
+#include "utils/image/color_space.hpp"
+
+namespace utils::image {
+
+struct PaletteColor {
+  RgbColor rgb;
+  LabColor lab;
+  float weight = 0.0f;
+};
+
+// 调色板聚类引擎：KMeans 对全部采样点跑 Lloyd；Histogram 先量化成 Lab 直方图，只对非空 bin 聚类
+enum class PaletteEngine { KMeans, Histogram };
+
+struct PaletteExtractOptions {
+  std::uint32_t max_samples = 8000;
+  std::uint32_t cluster_count = 8;
+  std::uint8_t min_alpha = 16;
+  PaletteEngine engine = PaletteEngine::KMeans;
+};
+
+// 对 Lab 点集聚类，返回与输入一一对应的簇标签；两种引擎对同一输入的结果都固定
+auto cluster_lab_points(const std::vector<std::array<float, 3>>& points,
+                        std::size_t cluster_count, PaletteEngine engine)
+    -> std::expected<std::vector<std::size_t>, std::string>;
+
+// 紧排 BGRA 采样像素 → Lab 聚类 → 按簇内像素均值生成调色板，结果按权重降序
+auto build_lab_palette(std::span<const std::uint8_t> sampled_bgra, std::size_t max_clusters,
+                       PaletteEngine engine)
+    -> std::expected<std::vector<PaletteColor>, std::string>;
+
+}  // namespace utils::image
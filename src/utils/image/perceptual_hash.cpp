@@ -0,0 +1,63 @@
+#include "utils/image/perceptual_hash.hpp"
+
+#include "vendor/std.hpp"
+
+namespace utils::image {
+
+constexpr std::uint32_t kHashGridWidth = 9;
+constexpr std::uint32_t kHashGridHeight = 8;
+
+auto compute_difference_hash(std::span<const std::uint8_t> bgra_pixels, std::uint32_t width,
+                             std::uint32_t height, std::uint32_t stride)
+    -> std::expected<std::uint64_t, std::string> {
+  if (width < kHashGridWidth || height < kHashGridHeight) {
+    return std::unexpected("Bitmap is too small for difference hash");
+  }
+
+  if (static_cast<std::uint64_t>(stride) < static_cast<std::uint64_t>(width) * 4) {
+    return std::unexpected("Bitmap stride is smaller than width * 4");
+  }
+
+  if (static_cast<std::uint64_t>(stride) * height > bgra_pixels.size()) {
+    return std::unexpected("Bitmap pixel buffer is smaller than stride * height");
+  }
+
+  // 每个像素只落入一个网格单元，按单元累计亮度后求平均，相当于区域平均缩放
+  std::array<std::uint64_t, kHashGridWidth * kHashGridHeight> luminance_sums{};
+  std::array<std::uint32_t, kHashGridWidth * kHashGridHeight> pixel_counts{};
+  for (std::uint32_t y = 0; y < height; ++y) {
+    const auto cell_y = static_cast<std::uint64_t>(y) * kHashGridHeight / height;
+    const auto* row = bgra_pixels.data() + static_cast<std::size_t>(y) * stride;
+    for (std::uint32_t x = 0; x < width; ++x) {
+      const auto cell_x = static_cast<std::uint64_t>(x) * kHashGridWidth / width;
+      const auto* pixel = row + static_cast<std::size_t>(x) * 4;
+      // BT.601 整数亮度，避免浮点误差影响同图多次计算的稳定性
+      auto luminance = static_cast<std::uint64_t>(pixel[2]) * 299 +
+                       static_cast<std::uint64_t>(pixel[1]) * 587 +
+                       static_cast<std::uint64_t>(pixel[0]) * 114;
+      auto cell = cell_y * kHashGridWidth + cell_x;
+      luminance_sums[cell] += luminance;
+      pixel_counts[cell] += 1;
+    }
+  }
+
+  std::array<std::uint64_t, kHashGridWidth * kHashGridHeight> averages{};
+  for (std::size_t i = 0; i < averages.size(); ++i) {
+    averages[i] = luminance_sums[i] / pixel_counts[i];
+  }
+
+  // 行优先输出比特：第 y 行第 x 位表示左侧单元比右侧单元更亮
+  std::uint64_t hash = 0;
+  for (std::uint32_t y = 0; y < kHashGridHeight; ++y) {
+    for (std::uint32_t x = 0; x + 1 < kHashGridWidth; ++x) {
+      hash <<= 1;
+      if (averages[y * kHashGridWidth + x] > averages[y * kHashGridWidth + x + 1]) {
+        hash |= 1;
+      }
+    }
+  }
+
+  return hash;
+}
+
+}  // namespace utils::image
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "vendor/std.hpp"
+
+namespace utils::image {
+
+// dHash 版本；缩放方式或比特布局变化时递增，旧版本的持久化值需要重新回填
+constexpr std::int64_t kDifferenceHashVersion = 1;
+
+// 从紧排 BGRA 像素计算 64 位 dHash：区域平均缩到 9x8 灰度，再比较每行相邻像素
+auto compute_difference_hash(std::span<const std::uint8_t> bgra_pixels, std::uint32_t width,
+                             std::uint32_t height, std::uint32_t stride)
+    -> std::expected<std::uint64_t, std::string>;
+
+inline auto hamming_distance(std::uint64_t lhs, std::uint64_t rhs) -> int {
+  return std::popcount(lhs ^ rhs);
+}
+
+}  // namespace utils::image
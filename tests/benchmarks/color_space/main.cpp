@@ -0,0 +1,73 @@
+#include "vendor/std.hpp"
+
+#include "utils/image/color_space.hpp"
+
+namespace {
+
+// 完整 RGB 立方体，对应最坏情况下一张图的全部取样像素
+constexpr std::size_t kPixelCount = 256 * 256 * 256;
+constexpr int kIterations = 5;
+
+auto build_bgra_cube() -> std::vector<std::uint8_t> {
+  std::vector<std::uint8_t> pixels(kPixelCount * 4);
+  for (std::size_t i = 0; i < kPixelCount; ++i) {
+    pixels[i * 4] = static_cast<std::uint8_t>(i & 0xff);
+    pixels[i * 4 + 1] = static_cast<std::uint8_t>((i >> 8) & 0xff);
+    pixels[i * 4 + 2] = static_cast<std::uint8_t>((i >> 16) & 0xff);
+    pixels[i * 4 + 3] = 255;
+  }
+  return pixels;
+}
+
+template <typename Fn>
+auto measure(std::string_view label, Fn fn) -> double {
+  std::vector<double> samples;
+  for (int i = 0; i < kIterations; ++i) {
+    const auto start = std::chrono::steady_clock::now();
+    fn();
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    samples.push_back(std::chrono::duration<double, std::milli>(elapsed).count());
+  }
+  std::ranges::sort(samples);
+  const auto median = samples[samples.size() / 2];
+  std::println("{:<26} median {:8.2f} ms  min {:8.2f} ms  {:7.1f} M px/s", label, median,
+               samples.front(), static_cast<double>(kPixelCount) / median / 1000.0);
+  return median;
+}
+
+}  // namespace
+
+auto main() -> int {
+  const auto pixels = build_bgra_cube();
+  std::vector<float> l_plane(kPixelCount);
+  std::vector<float> a_plane(kPixelCount);
+  std::vector<float> b_plane(kPixelCount);
+  std::println("{} pixels per run, {} iterations", kPixelCount, kIterations);
+
+  // 旧路径：逐像素调用标量转换
+  const auto scalar_ms = measure("scalar rgb_to_lab_color", [&] {
+    for (std::size_t i = 0; i < kPixelCount; ++i) {
+      const auto lab =
+          utils::image::rgb_to_lab_color(pixels[i * 4 + 2], pixels[i * 4 + 1], pixels[i * 4]);
+      l_plane[i] = lab.l;
+      a_plane[i] = lab.a;
+      b_plane[i] = lab.b;
+    }
+  });
+
+  const auto batch_ms = measure("batch bgra_to_lab_planes", [&] {
+    utils::image::bgra_to_lab_planes(pixels, l_plane, a_plane, b_plane);
+  });
+
+  // 顺带核对误差，避免只测到一条错误但更快的路径
+  float max_error = 0.0f;
+  for (std::size_t i = 0; i < kPixelCount; ++i) {
+    const auto expected =
+        utils::image::rgb_to_lab_color(pixels[i * 4 + 2], pixels[i * 4 + 1], pixels[i * 4]);
+    max_error = std::max({max_error, std::abs(expected.l - l_plane[i]),
+                          std::abs(expected.a - a_plane[i]), std::abs(expected.b - b_plane[i])});
+  }
+  std::println("speedup {:.1f}x, max abs error {:.6f} (limit {:.6f})", scalar_ms / batch_ms,
+               max_error, utils::image::kBatchLabMaxError);
+  return max_error <= utils::image::kBatchLabMaxError ? 0 : 1;
+}
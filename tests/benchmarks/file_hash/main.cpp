@@ -0,0 +1,124 @@
+#include "vendor/std.hpp"
+
+#include "core/worker_pool/state.hpp"
+#include "core/worker_pool/worker_pool.hpp"
+#include "features/gallery/scanner/tree_hash.hpp"
+#include "utils/hash/file_hash.hpp"
+#include "utils/hash/xxhash.hpp"
+
+namespace {
+
+// 远大于单个 64 MiB 映射视图，覆盖跨视图续读
+constexpr std::uint64_t kFileSize = 1024ull * 1024 * 1024;
+constexpr std::uint64_t kSampleSize = 1024 * 1024;
+constexpr int kIterations = 5;
+
+// 与扫描器的五点采样区间相同
+auto build_sample_ranges() -> std::array<utils::hash::StreamRange, 5> {
+  const auto last_offset = kFileSize - kSampleSize;
+  return {{{.offset = 0, .size = kSampleSize},
+           {.offset = last_offset / 4, .size = kSampleSize},
+           {.offset = last_offset / 2, .size = kSampleSize},
+           {.offset = last_offset - last_offset / 4, .size = kSampleSize},
+           {.offset = last_offset, .size = kSampleSize}}};
+}
+
+auto write_test_file(const std::filesystem::path& path) -> bool {
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  std::vector<std::uint64_t> block(utils::hash::kReadBufferSize / sizeof(std::uint64_t));
+  std::uint64_t state = 0x9e3779b97f4a7c15ull;
+  for (std::uint64_t written = 0; written < kFileSize; written += utils::hash::kReadBufferSize) {
+    for (auto& word : block) {
+      state ^= state << 13;
+      state ^= state >> 7;
+      state ^= state << 17;
+      word = state;
+    }
+    file.write(reinterpret_cast<const char*>(block.data()),
+               static_cast<std::streamsize>(utils::hash::kReadBufferSize));
+  }
+  return static_cast<bool>(file);
+}
+
+template <typename Fn>
+auto measure(std::string_view label, std::uint64_t bytes, Fn fn) -> std::string {
+  std::vector<double> samples;
+  std::string digest;
+  for (int i = 0; i < kIterations; ++i) {
+    const auto start = std::chrono::steady_clock::now();
+    auto result = fn();
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    if (!result) {
+      std::println("{}: {}", label, result.error());
+      return {};
+    }
+    digest = std::move(result.value());
+    samples.push_back(std::chrono::duration<double, std::milli>(elapsed).count());
+  }
+  std::ranges::sort(samples);
+  const auto median = samples[samples.size() / 2];
+  std::println("{:<24} median {:9.2f} ms  min {:9.2f} ms  {:8.1f} MiB/s", label, median,
+               samples.front(), static_cast<double>(bytes) / (1024.0 * 1024.0) / median * 1000.0);
+  return digest;
+}
+
+}  // namespace
+
+auto main() -> int {
+  const auto path = std::filesystem::temp_directory_path() / "spinning_momo_bench_file_hash.bin";
+  if (!write_test_file(path)) {
+    std::println("Failed to write {}", path.string());
+    return 1;
+  }
+  // 先完整读一遍进页缓存，两条路径都从缓存读取，比较的是拷贝与系统调用开销；冷读取未覆盖
+  (void)utils::hash::hash_file_to_hex(path, {});
+  std::println("{} MiB local file, warm page cache, median of {} runs", kFileSize >> 20,
+               kIterations);
+
+  const auto stream_full = measure("full buffered stream", kFileSize, [&] {
+    std::ifstream file(path, std::ios::binary);
+    return utils::hash::hash_stream_to_hex(file, {});
+  });
+  const auto mapped_full = measure("full mapped", kFileSize, [&] {
+    return utils::hash::hash_file_to_hex(path, {});
+  });
+
+  const auto ranges = build_sample_ranges();
+  const std::array<std::uint64_t, 1> metadata{kFileSize};
+  const auto metadata_bytes = std::as_bytes(std::span{metadata});
+  const auto stream_sampled = measure("sampled buffered stream", kSampleSize * ranges.size(), [&] {
+    std::ifstream file(path, std::ios::binary);
+    return utils::hash::hash_stream_ranges_to_hex(file, metadata_bytes, ranges, {});
+  });
+  const auto mapped_sampled = measure("sampled mapped", kSampleSize * ranges.size(), [&] {
+    return utils::hash::hash_file_ranges_to_hex(path, metadata_bytes, ranges, {});
+  });
+
+  // 树哈希：空池只有调用线程认领叶子块，作为单线程基线
+  const auto serial_tree = measure("tree, caller only", kFileSize, [&] {
+    return features::gallery::scanner::tree_hash::hash_file_tree_to_hex(nullptr, path, kFileSize,
+                                                                        {});
+  });
+
+  const auto thread_count = std::max(1u, std::thread::hardware_concurrency());
+  core::worker_pool::WorkerPoolState pool;
+  if (auto result = core::worker_pool::start_pool(pool, thread_count); !result) {
+    std::println("Failed to start worker pool: {}", result.error());
+    return 1;
+  }
+  const auto pooled_tree = measure(std::format("tree, pool of {}", thread_count), kFileSize, [&] {
+    return features::gallery::scanner::tree_hash::hash_file_tree_to_hex(&pool, path, kFileSize,
+                                                                        {});
+  });
+  core::worker_pool::stop_pool(pool);
+
+  std::error_code error;
+  std::filesystem::remove(path, error);
+
+  // 同一种指纹的不同路径摘要必须逐字节一致，否则速度没有意义
+  const bool identical = !stream_full.empty() && stream_full == mapped_full &&
+                         !stream_sampled.empty() && stream_sampled == mapped_sampled &&
+                         !serial_tree.empty() && serial_tree == pooled_tree;
+  std::println("digests {}", identical ? "identical" : "DIFFER");
+  return identical ? 0 : 1;
+}
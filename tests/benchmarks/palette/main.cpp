@@ -0,0 +1,159 @@
+#include "vendor/std.hpp"
+
+#include "utils/image/palette.hpp"
+
+namespace {
+
+// 与图库主色提取的默认采样数、簇数一致
+constexpr std::size_t kSampleCount = 8000;
+constexpr std::size_t kClusterCount = 8;
+constexpr int kIterations = 50;
+
+using utils::image::PaletteColor;
+using utils::image::PaletteEngine;
+
+struct Scenario {
+  std::string_view name;
+  std::vector<std::uint8_t> pixels;
+};
+
+auto next_random(std::uint32_t& state) -> std::uint32_t {
+  state = state * 1664525u + 1013904223u;
+  return state >> 8;
+}
+
+// 几块带噪声的纯色，对应 UI 截图、纯色背景
+auto make_patches() -> std::vector<std::uint8_t> {
+  const std::array<std::array<int, 3>, 5> colors = {
+      {{90, 150, 220}, {60, 140, 60}, {230, 190, 160}, {30, 30, 40}, {250, 250, 245}}};
+  std::uint32_t state = 1;
+  std::vector<std::uint8_t> pixels;
+  for (std::size_t i = 0; i < kSampleCount; ++i) {
+    const auto& color = colors[(i * colors.size()) / kSampleCount];
+    for (int channel = 2; channel >= 0; --channel) {
+      auto noise = static_cast<int>(next_random(state) % 25) - 12;
+      pixels.push_back(static_cast<std::uint8_t>(std::clamp(color[channel] + noise, 0, 255)));
+    }
+    pixels.push_back(255);
+  }
+  return pixels;
+}
+
+// 平滑的色相渐变叠加明度变化，没有明显的自然簇
+auto make_gradient() -> std::vector<std::uint8_t> {
+  std::vector<std::uint8_t> pixels;
+  for (std::size_t i = 0; i < kSampleCount; ++i) {
+    const auto t = static_cast<double>(i) / static_cast<double>(kSampleCount);
+    const auto light = 0.35 + 0.6 * std::abs(std::sin(t * 17.0));
+    auto channel = [&](double phase) {
+      return static_cast<std::uint8_t>(
+          std::clamp(255.0 * light * (0.5 + 0.5 * std::sin(6.2831853 * (t + phase))), 0.0, 255.0));
+    };
+    pixels.insert(pixels.end(), {channel(0.66), channel(0.33), channel(0.0), 255});
+  }
+  return pixels;
+}
+
+// 少数主色加大量随机杂色，近似风景照里天空、植被与细碎高光的混合
+auto make_photo_like() -> std::vector<std::uint8_t> {
+  const std::array<std::array<int, 3>, 3> colors = {
+      {{120, 170, 230}, {70, 110, 50}, {180, 150, 110}}};
+  std::uint32_t state = 7;
+  std::vector<std::uint8_t> pixels;
+  for (std::size_t i = 0; i < kSampleCount; ++i) {
+    if (next_random(state) % 4 == 0) {
+      for (int channel = 0; channel < 3; ++channel) {
+        pixels.push_back(static_cast<std::uint8_t>(next_random(state) & 0xff));
+      }
+    } else {
+      const auto& color = colors[next_random(state) % colors.size()];
+      for (int channel = 2; channel >= 0; --channel) {
+        auto noise = static_cast<int>(next_random(state) % 41) - 20;
+        pixels.push_back(static_cast<std::uint8_t>(std::clamp(color[channel] + noise, 0, 255)));
+      }
+    }
+    pixels.push_back(255);
+  }
+  return pixels;
+}
+
+auto shuffle_pixels(const std::vector<std::uint8_t>& pixels) -> std::vector<std::uint8_t> {
+  std::vector<std::array<std::uint8_t, 4>> quads(pixels.size() / 4);
+  std::memcpy(quads.data(), pixels.data(), quads.size() * 4);
+  std::ranges::shuffle(quads, std::mt19937{42});
+  std::vector<std::uint8_t> shuffled(pixels.size());
+  std::memcpy(shuffled.data(), quads.data(), quads.size() * 4);
+  return shuffled;
+}
+
+auto delta_e_76(const PaletteColor& lhs, const PaletteColor& rhs) -> float {
+  float dl = lhs.lab.l - rhs.lab.l;
+  float da = lhs.lab.a - rhs.lab.a;
+  float db = lhs.lab.b - rhs.lab.b;
+  return std::sqrt(dl * dl + da * da + db * db);
+}
+
+// 双向按权重平均的最近色距离；簇的拆分方式不同但覆盖同样颜色时仍接近 0
+auto palette_distance(const std::vector<PaletteColor>& lhs, const std::vector<PaletteColor>& rhs)
+    -> float {
+  auto directed = [](const auto& from, const auto& to) {
+    float total = 0.0f;
+    for (const auto& color : from) {
+      float nearest = std::numeric_limits<float>::max();
+      for (const auto& candidate : to) {
+        nearest = std::min(nearest, delta_e_76(color, candidate));
+      }
+      total += nearest * color.weight;
+    }
+    return total;
+  };
+  return (directed(lhs, rhs) + directed(rhs, lhs)) / 2.0f;
+}
+
+auto measure(const Scenario& scenario, PaletteEngine engine) -> double {
+  std::vector<double> samples;
+  for (int i = 0; i < kIterations; ++i) {
+    const auto start = std::chrono::steady_clock::now();
+    auto result = utils::image::build_lab_palette(scenario.pixels, kClusterCount, engine);
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    if (!result) {
+      std::println("{}: {}", scenario.name, result.error());
+      return 0.0;
+    }
+    samples.push_back(std::chrono::duration<double, std::micro>(elapsed).count());
+  }
+  std::ranges::sort(samples);
+  return samples[samples.size() / 2];
+}
+
+}  // namespace
+
+auto main() -> int {
+  const std::array<Scenario, 3> scenarios = {{{"patches", make_patches()},
+                                              {"gradient", make_gradient()},
+                                              {"photo-like", make_photo_like()}}};
+  std::println("{} samples, {} clusters, median of {} runs", kSampleCount, kClusterCount,
+               kIterations);
+
+  for (const auto& scenario : scenarios) {
+    const auto kmeans_us = measure(scenario, PaletteEngine::KMeans);
+    const auto histogram_us = measure(scenario, PaletteEngine::Histogram);
+    auto kmeans = utils::image::build_lab_palette(scenario.pixels, kClusterCount,
+                                                  PaletteEngine::KMeans);
+    auto histogram = utils::image::build_lab_palette(scenario.pixels, kClusterCount,
+                                                     PaletteEngine::Histogram);
+    // 打乱采样顺序会换一个 K-Means 种子，作为 K-Means 自身波动的参照
+    auto shuffled_pixels = shuffle_pixels(scenario.pixels);
+    auto reseeded = utils::image::build_lab_palette(shuffled_pixels, kClusterCount,
+                                                    PaletteEngine::KMeans);
+    if (!kmeans || !histogram || !reseeded) {
+      return 1;
+    }
+    std::println("{:<12} kmeans {:8.1f} us  histogram {:8.1f} us  speedup {:5.1f}x  "
+                 "distance {:5.2f} dE (kmeans reseeded {:5.2f} dE)",
+                 scenario.name, kmeans_us, histogram_us, kmeans_us / histogram_us,
+                 palette_distance(kmeans.value(), histogram.value()),
+                 palette_distance(kmeans.value(), reseeded.value()));
+  }
+  return 0;
+}
@@ -0,0 +1,126 @@
+#include "vendor/std.hpp"
+
+#include "vendor/rfl.hpp"
+
+#include "core/rpc/types.hpp"
+#include "features/gallery/types.hpp"
+
+namespace {
+
+constexpr std::size_t kItemCount = 5000;
+constexpr int kIterations = 20;
+
+// 可选字段的三种形态轮换：全部有值、全部为空、部分为空
+enum class OptionalShape { AllSet, AllUnset, Mixed };
+
+auto make_asset(std::size_t i, OptionalShape shape) -> features::gallery::Asset {
+  const auto id = static_cast<std::int64_t>(i + 1);
+  const bool set_all = shape == OptionalShape::AllSet;
+  const bool set_some = shape != OptionalShape::AllUnset;
+  features::gallery::Asset asset;
+  asset.id = id;
+  asset.name = std::format("IMG_{:05}.png", i);
+  asset.path = std::format("D:/Pictures/SpinningMomo/2026/{:02}/{}", i % 12 + 1, asset.name);
+  asset.type = "photo";
+  asset.mime_type = "image/png";
+  asset.created_at = 1'760'000'000'000 + id;
+  asset.updated_at = 1'760'000'000'000 + id;
+  if (set_all) {
+    asset.dominant_color_hex = "#a0b1c2";
+    asset.description = "burst shot";
+    asset.extension = ".png";
+    asset.root_id = 1;
+    asset.relative_path = std::format("2026/{:02}/{}", i % 12 + 1, asset.name);
+    asset.folder_id = static_cast<std::int64_t>(i % 12 + 1);
+    asset.file_created_at = 1'760'000'000'000 + id;
+  }
+  if (set_some) {
+    asset.width = 3840;
+    asset.height = 2160;
+    asset.size = 8'000'000 + id;
+    asset.hash = std::format("{:032x}", i * 2654435761u);
+    asset.file_modified_at = 1'760'000'000'000 + id;
+  }
+  return asset;
+}
+
+auto make_list_response(std::size_t item_count) -> features::gallery::ListResponse {
+  constexpr std::array shapes = {OptionalShape::AllSet, OptionalShape::AllUnset,
+                                 OptionalShape::Mixed};
+  features::gallery::ListResponse response;
+  response.items.reserve(item_count);
+  for (std::size_t i = 0; i < item_count; ++i) {
+    response.items.push_back(make_asset(i, shapes[i % shapes.size()]));
+  }
+  response.total_count = static_cast<std::int32_t>(item_count);
+  response.current_page = 1;
+  response.per_page = static_cast<std::int32_t>(item_count);
+  response.total_pages = 1;
+  return response;
+}
+
+// 旧路径：先转换成 rfl::Generic 树，再序列化整个信封
+auto write_via_generic(const features::gallery::ListResponse& result) -> std::string {
+  core::rpc::JsonRpcSuccessResponse response;
+  response.id = rfl::Generic(std::int64_t{1});
+  response.result = rfl::to_generic<rfl::SnakeCaseToCamelCase>(result);
+  return rfl::json::write<rfl::SnakeCaseToCamelCase>(response);
+}
+
+// 新路径：与 register_method 相同，结果结构体随信封直接写出
+auto write_typed(features::gallery::ListResponse result) -> std::string {
+  core::rpc::JsonRpcTypedSuccessResponse<features::gallery::ListResponse> response;
+  response.result = std::move(result);
+  response.id = rfl::Generic(std::int64_t{1});
+  return rfl::json::write<rfl::SnakeCaseToCamelCase>(response);
+}
+
+template <typename Fn>
+auto measure(std::string_view label, Fn fn) -> std::string {
+  std::string output;
+  std::vector<double> samples;
+  for (int i = 0; i < kIterations; ++i) {
+    const auto start = std::chrono::steady_clock::now();
+    output = fn();
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    samples.push_back(std::chrono::duration<double, std::milli>(elapsed).count());
+  }
+  std::ranges::sort(samples);
+  std::println("{:<8} median {:8.2f} ms  min {:8.2f} ms  {} bytes", label,
+               samples[samples.size() / 2], samples.front(), output.size());
+  return output;
+}
+
+// 逐种形态比较两条路径的输出；可选字段为空时 null 与省略键的差异只会出现在这里
+auto check_shape(std::string_view label, const features::gallery::ListResponse& result)
+    -> bool {
+  const bool identical = write_via_generic(result) == write_typed(result);
+  std::println("{:<28} {}", label, identical ? "identical" : "DIFFER");
+  return identical;
+}
+
+}  // namespace
+
+auto main() -> int {
+  auto single = [](OptionalShape shape) {
+    auto response = make_list_response(0);
+    response.items.push_back(make_asset(0, shape));
+    return response;
+  };
+  bool identical = check_shape("optionals all set", single(OptionalShape::AllSet));
+  identical = check_shape("optionals all unset", single(OptionalShape::AllUnset)) && identical;
+  identical = check_shape("optionals mixed", single(OptionalShape::Mixed)) && identical;
+  identical = check_shape("empty item list", make_list_response(0)) && identical;
+
+  const auto response = make_list_response(kItemCount);
+  std::println("serializing gallery ListResponse with {} items, {} iterations", kItemCount,
+               kIterations);
+
+  const auto generic_output = measure("generic", [&] { return write_via_generic(response); });
+  // 拷贝计入计时：真实调用里结果同样按值移入信封，这里用拷贝模拟最坏情况
+  const auto typed_output = measure("typed", [&] { return write_typed(response); });
+
+  identical = generic_output == typed_output && identical;
+  std::println("outputs {}", identical ? "identical" : "DIFFER");
+  return identical ? 0 : 1;
+}
@@ -0,0 +1,246 @@
+#include "vendor/std.hpp"
+
+namespace {
+
+// 与 http_server/types.hpp 的基础块大小、预读槽位数一致
+constexpr std::size_t kChunkSize = 64 * 1024;
+constexpr std::size_t kReadAheadSlots = 2;
+constexpr std::size_t kStreamCount = 16;
+constexpr std::uint64_t kFileSize = 256ull * 1024 * 1024;
+constexpr std::size_t kIoThreadCount = 2;
+constexpr int kIterations = 3;
+
+// 单线程任务队列，分别模拟 uWS 事件循环与 asio IO 线程
+struct TaskQueue {
+  std::mutex mutex;
+  std::condition_variable ready;
+  std::deque<std::move_only_function<void()>> tasks;
+  std::vector<std::jthread> threads;
+  bool stopping = false;
+  // 循环线程执行任务的累计耗时，即其他连接被阻塞的时间
+  std::chrono::nanoseconds busy{0};
+
+  explicit TaskQueue(std::size_t thread_count) {
+    for (std::size_t i = 0; i < thread_count; ++i) {
+      threads.emplace_back([this] { run(); });
+    }
+  }
+
+  ~TaskQueue() {
+    {
+      std::lock_guard lock(mutex);
+      stopping = true;
+    }
+    ready.notify_all();
+  }
+
+  auto post(std::move_only_function<void()> task) -> void {
+    {
+      std::lock_guard lock(mutex);
+      tasks.push_back(std::move(task));
+    }
+    ready.notify_one();
+  }
+
+  auto run() -> void {
+    for (;;) {
+      std::move_only_function<void()> task;
+      {
+        std::unique_lock lock(mutex);
+        ready.wait(lock, [this] { return stopping || !tasks.empty(); });
+        if (tasks.empty()) {
+          return;
+        }
+        task = std::move(tasks.front());
+        tasks.pop_front();
+      }
+      const auto start = std::chrono::steady_clock::now();
+      task();
+      busy += std::chrono::steady_clock::now() - start;
+    }
+  }
+};
+
+// 模拟 tryEnd：把数据拷进固定大小的 socket 发送缓冲
+struct Socket {
+  std::vector<char> buffer = std::vector<char>(512 * 1024);
+  std::size_t position = 0;
+
+  auto send(std::string_view data) -> void {
+    while (!data.empty()) {
+      const auto size = std::min(data.size(), buffer.size() - position);
+      std::memcpy(buffer.data() + position, data.data(), size);
+      position = (position + size) % buffer.size();
+      data.remove_prefix(size);
+    }
+  }
+};
+
+struct Run {
+  TaskQueue* loop = nullptr;
+  TaskQueue* io = nullptr;
+  std::filesystem::path path;
+  std::latch* finished = nullptr;
+};
+
+// 旧实现：IO 线程读进流缓冲区后拷成 make_shared<std::string>，发完一块才发起下一次读取
+struct CopyStream : std::enable_shared_from_this<CopyStream> {
+  Run run;
+  std::ifstream file;
+  std::vector<char> buffer = std::vector<char>(kChunkSize);
+  Socket socket;
+  std::uint64_t offset = 0;
+
+  auto read_next() -> void {
+    run.io->post([self = shared_from_this()] {
+      const auto size = static_cast<std::size_t>(std::min<std::uint64_t>(
+          kChunkSize, kFileSize - self->offset));
+      self->file.read(self->buffer.data(), static_cast<std::streamsize>(size));
+      auto chunk = std::make_shared<std::string>(self->buffer.data(), size);
+      self->run.loop->post([self, chunk] {
+        self->socket.send(*chunk);
+        self->offset += chunk->size();
+        if (self->offset < kFileSize) {
+          self->read_next();
+        } else {
+          self->run.finished->count_down();
+        }
+      });
+    });
+  }
+};
+
+enum class SlotState { Free, Reading, Ready };
+
+struct Slot {
+  std::vector<char> buffer = std::vector<char>(kChunkSize);
+  std::size_t size = 0;
+  SlotState state = SlotState::Free;
+};
+
+// 新实现：两个复用槽位轮换，发送当前块时下一块已在 IO 线程读取，槽位状态只在循环线程修改
+struct SlotStream : std::enable_shared_from_this<SlotStream> {
+  Run run;
+  std::ifstream file;
+  std::array<Slot, kReadAheadSlots> slots;
+  Socket socket;
+  std::uint64_t read_offset = 0;
+  std::uint64_t send_offset = 0;
+  std::size_t read_slot = 0;
+  std::size_t send_slot = 0;
+  bool read_in_flight = false;
+
+  auto pump() -> void {
+    auto& sending = slots[send_slot];
+    if (sending.state == SlotState::Ready) {
+      socket.send({sending.buffer.data(), sending.size});
+      send_offset += sending.size;
+      sending.state = SlotState::Free;
+      send_slot = (send_slot + 1) % slots.size();
+      if (send_offset == kFileSize) {
+        run.finished->count_down();
+        return;
+      }
+    }
+
+    auto& reading = slots[read_slot];
+    if (!read_in_flight && reading.state == SlotState::Free && read_offset < kFileSize) {
+      reading.state = SlotState::Reading;
+      reading.size =
+          static_cast<std::size_t>(std::min<std::uint64_t>(kChunkSize, kFileSize - read_offset));
+      read_offset += reading.size;
+      read_in_flight = true;
+      run.io->post([self = shared_from_this(), slot = read_slot] {
+        auto& target = self->slots[slot];
+        self->file.read(target.buffer.data(), static_cast<std::streamsize>(target.size));
+        self->run.loop->post([self, slot] {
+          self->slots[slot].state = SlotState::Ready;
+          self->read_in_flight = false;
+          self->pump();
+        });
+      });
+      read_slot = (read_slot + 1) % slots.size();
+    }
+
+    // 刚发完一块且下一块已就绪时继续推进
+    if (slots[send_slot].state == SlotState::Ready) {
+      run.loop->post([self = shared_from_this()] { self->pump(); });
+    }
+  }
+};
+
+struct Result {
+  double wall_ms = 0.0;
+  double loop_busy_ms = 0.0;
+};
+
+template <typename Stream>
+auto run_streams(const std::filesystem::path& path) -> Result {
+  std::latch finished(kStreamCount);
+  Result result;
+  const auto start = std::chrono::steady_clock::now();
+  {
+    TaskQueue loop(1);
+    TaskQueue io(kIoThreadCount);
+    std::vector<std::shared_ptr<Stream>> streams;
+    for (std::size_t i = 0; i < kStreamCount; ++i) {
+      auto stream = std::make_shared<Stream>();
+      stream->run = {.loop = &loop, .io = &io, .path = path, .finished = &finished};
+      stream->file.open(path, std::ios::binary);
+      streams.push_back(stream);
+    }
+    for (auto& stream : streams) {
+      if constexpr (std::is_same_v<Stream, CopyStream>) {
+        stream->read_next();
+      } else {
+        loop.post([stream] { stream->pump(); });
+      }
+    }
+    finished.wait();
+    result.wall_ms =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+            .count();
+    loop.post([&loop, &result] {
+      result.loop_busy_ms = std::chrono::duration<double, std::milli>(loop.busy).count();
+    });
+  }
+  return result;
+}
+
+template <typename Stream>
+auto measure(std::string_view label, const std::filesystem::path& path) -> void {
+  std::vector<Result> samples;
+  for (int i = 0; i < kIterations; ++i) {
+    samples.push_back(run_streams<Stream>(path));
+  }
+  std::ranges::sort(samples, {}, &Result::wall_ms);
+  const auto& median = samples[samples.size() / 2];
+  const auto total_mib = static_cast<double>(kFileSize * kStreamCount) / (1024.0 * 1024.0);
+  std::println("{:<22} wall {:8.1f} ms  {:8.1f} MiB/s  loop busy {:7.1f} ms ({:5.2f} ms/GiB)",
+               label, median.wall_ms, total_mib / median.wall_ms * 1000.0, median.loop_busy_ms,
+               median.loop_busy_ms / (total_mib / 1024.0));
+}
+
+}  // namespace
+
+auto main() -> int {
+  const auto path = std::filesystem::temp_directory_path() / "spinning_momo_bench_stream.bin";
+  {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    std::vector<char> block(kChunkSize, 'x');
+    for (std::uint64_t written = 0; written < kFileSize; written += block.size()) {
+      file.write(block.data(), static_cast<std::streamsize>(block.size()));
+    }
+  }
+  std::println("{} streams x {} MiB, {} KiB chunks, {} IO threads, warm page cache, median of {}",
+               kStreamCount, kFileSize >> 20, kChunkSize >> 10, kIoThreadCount, kIterations);
+
+  // 预热页缓存，两种实现都从缓存读取
+  run_streams<SlotStream>(path);
+  measure<CopyStream>("make_shared copy", path);
+  measure<SlotStream>("reused slots", path);
+
+  std::error_code error;
+  std::filesystem::remove(path, error);
+  return 0;
+}
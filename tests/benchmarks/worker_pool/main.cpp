@@ -0,0 +1,133 @@
+#include "vendor/std.hpp"
+
+#include "core/worker_pool/state.hpp"
+#include "core/worker_pool/worker_pool.hpp"
+
+namespace {
+
+constexpr std::size_t kThreadCount = 8;
+constexpr std::size_t kSubmitterCount = 4;
+constexpr std::size_t kTasksPerSubmitter = 250'000;
+constexpr std::size_t kFanOut = 64;
+constexpr int kIterations = 5;
+
+// 旧实现：单个 std::queue、一把锁和一个条件变量
+struct SingleQueuePool {
+  std::vector<std::jthread> threads;
+  std::queue<std::move_only_function<void()>> tasks;
+  std::mutex mutex;
+  std::condition_variable condition;
+  bool stopping = false;
+
+  explicit SingleQueuePool(std::size_t thread_count) {
+    for (std::size_t i = 0; i < thread_count; ++i) {
+      threads.emplace_back([this] {
+        while (true) {
+          std::move_only_function<void()> task;
+          {
+            std::unique_lock lock(mutex);
+            condition.wait(lock, [this] { return stopping || !tasks.empty(); });
+            if (stopping && tasks.empty()) {
+              return;
+            }
+            task = std::move(tasks.front());
+            tasks.pop();
+          }
+          task();
+        }
+      });
+    }
+  }
+
+  ~SingleQueuePool() {
+    {
+      std::lock_guard lock(mutex);
+      stopping = true;
+    }
+    condition.notify_all();
+  }
+
+  auto submit(std::move_only_function<void()> task) -> void {
+    {
+      std::lock_guard lock(mutex);
+      tasks.push(std::move(task));
+    }
+    condition.notify_one();
+  }
+};
+
+// 外部线程并发提交大量空任务，测的是纯调度开销
+template <typename Submit>
+auto run_external(Submit submit) -> void {
+  std::latch done(static_cast<std::ptrdiff_t>(kSubmitterCount * kTasksPerSubmitter));
+  std::vector<std::jthread> submitters;
+  for (std::size_t s = 0; s < kSubmitterCount; ++s) {
+    submitters.emplace_back([&submit, &done] {
+      for (std::size_t i = 0; i < kTasksPerSubmitter; ++i) {
+        submit([&done] { done.count_down(); });
+      }
+    });
+  }
+  done.wait();
+}
+
+// 每个父任务在工作线程内再拆出一批子任务，对应扫描批次拆细后的提交方式
+template <typename Submit>
+auto run_nested(Submit submit) -> void {
+  constexpr auto kParents = kSubmitterCount * kTasksPerSubmitter / kFanOut;
+  std::latch done(static_cast<std::ptrdiff_t>(kParents * kFanOut));
+  for (std::size_t parent = 0; parent < kParents; ++parent) {
+    submit([&submit, &done] {
+      for (std::size_t child = 0; child < kFanOut; ++child) {
+        submit([&done] { done.count_down(); });
+      }
+    });
+  }
+  done.wait();
+}
+
+template <typename Fn>
+auto measure(std::string_view label, Fn fn) -> void {
+  std::vector<double> samples;
+  for (int i = 0; i < kIterations; ++i) {
+    const auto start = std::chrono::steady_clock::now();
+    fn();
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    samples.push_back(std::chrono::duration<double, std::milli>(elapsed).count());
+  }
+  std::ranges::sort(samples);
+  const auto median = samples[samples.size() / 2];
+  const auto tasks = static_cast<double>(kSubmitterCount * kTasksPerSubmitter);
+  std::println("{:<24} median {:8.2f} ms  min {:8.2f} ms  {:6.2f} M tasks/s", label, median,
+               samples.front(), tasks / median / 1000.0);
+}
+
+}  // namespace
+
+auto main() -> int {
+  std::println("{} workers, {} tiny tasks per run, {} iterations", kThreadCount,
+               kSubmitterCount * kTasksPerSubmitter, kIterations);
+
+  {
+    SingleQueuePool pool(kThreadCount);
+    auto submit = [&pool](std::move_only_function<void()> task) { pool.submit(std::move(task)); };
+    measure("single queue / external", [&] { run_external(submit); });
+    measure("single queue / nested", [&] { run_nested(submit); });
+  }
+
+  {
+    core::worker_pool::WorkerPoolState pool;
+    if (auto result = core::worker_pool::start_pool(pool, kThreadCount); !result) {
+      std::println("failed to start worker pool: {}", result.error());
+      return 1;
+    }
+    auto submit = [&pool](std::move_only_function<void()> task) {
+      core::worker_pool::submit_to_pool(pool, std::move(task));
+    };
+    measure("work stealing / external", [&] { run_external(submit); });
+    measure("work stealing / nested", [&] { run_nested(submit); });
+    std::println("steals: {}", pool.steals.load());
+    core::worker_pool::stop_pool(pool);
+  }
+  return 0;
+}
@@ -0,0 +1,110 @@
+#include "vendor/std.hpp"
+
+#include "vendor/doctest.hpp"
+
+#include "core/executor_metrics/executor_metrics.hpp"
+#include "core/worker_pool/state.hpp"
+#include "core/worker_pool/worker_pool.hpp"
+
+namespace executor_metrics = core::executor_metrics;
+namespace worker_pool = core::worker_pool;
+
+namespace {
+
+auto source_name(std::size_t index) -> std::string { return std::format("source{}", index); }
+
+}  // namespace
+
+TEST_CASE("disabled executor metrics record nothing") {
+  executor_metrics::ExecutorMetrics metrics(2);
+  const auto enqueued_at = executor_metrics::enqueue_time(metrics);
+  CHECK(enqueued_at == std::chrono::steady_clock::time_point{});
+
+  const auto started_at = executor_metrics::begin_task(metrics, 1, enqueued_at);
+  executor_metrics::end_task(metrics, 1, enqueued_at, started_at);
+  CHECK(metrics.sources[1].tasks.load() == 0);
+  CHECK(metrics.running.load() == 0);
+  CHECK(metrics.busy_us.load() == 0);
+}
+
+TEST_CASE("enabled executor metrics record queue wait and run time per source") {
+  executor_metrics::ExecutorMetrics metrics(2);
+  executor_metrics::set_enabled(metrics, true);
+
+  const auto enqueued_at = std::chrono::steady_clock::now() - std::chrono::milliseconds(5);
+  const auto started_at = executor_metrics::begin_task(metrics, 1, enqueued_at);
+  CHECK(metrics.running.load() == 1);
+  executor_metrics::end_task(metrics, 1, enqueued_at, started_at - std::chrono::milliseconds(2));
+  CHECK(metrics.running.load() == 0);
+
+  const auto snapshot = executor_metrics::snapshot("test", metrics, 4, source_name);
+  CHECK(snapshot.enabled);
+  CHECK(snapshot.workers == 4);
+  REQUIRE(snapshot.sources.size() == 1);
+  CHECK(snapshot.sources[0].source == "source1");
+  CHECK(snapshot.sources[0].tasks == 1);
+  CHECK(snapshot.sources[0].queue_wait.max_us >= 5000);
+  CHECK(snapshot.sources[0].run.max_us >= 2000);
+  CHECK(metrics.busy_us.load() >= 2000);
+}
+
+TEST_CASE("utilization samples are relative to worker time and capped") {
+  executor_metrics::ExecutorMetrics metrics(1);
+  executor_metrics::set_enabled(metrics, true);
+  const auto start = std::chrono::steady_clock::time_point{} + std::chrono::hours(1);
+
+  // 第一次只建立基准
+  executor_metrics::record_sample(metrics, 3, 2, start, 1000);
+  CHECK(metrics.samples.empty());
+
+  metrics.busy_us = 1'000'000;
+  executor_metrics::record_sample(metrics, 5, 2, start + std::chrono::seconds(1), 2000);
+  REQUIRE(metrics.samples.size() == 1);
+  CHECK(metrics.samples.back().utilization == doctest::Approx(0.5));
+  CHECK(metrics.samples.back().queue_depth == 5);
+  CHECK(metrics.samples.back().timestamp_ms == 2000);
+
+  // 长任务在完成的周期一次性计入，超出部分截断为满载
+  metrics.busy_us = 10'000'000;
+  executor_metrics::record_sample(metrics, 0, 2, start + std::chrono::seconds(2), 3000);
+  CHECK(metrics.samples.back().utilization == doctest::Approx(1.0));
+
+  for (std::size_t i = 0; i < executor_metrics::kSampleCapacity; ++i) {
+    executor_metrics::record_sample(metrics, 0, 2, start + std::chrono::seconds(3 + i), 0);
+  }
+  CHECK(metrics.samples.size() == executor_metrics::kSampleCapacity);
+
+  // 重新开启时丢弃关闭前的样本
+  executor_metrics::set_enabled(metrics, false);
+  executor_metrics::set_enabled(metrics, true);
+  CHECK(metrics.samples.empty());
+}
+
+TEST_CASE("worker pool records per-tag timings only while enabled") {
+  worker_pool::WorkerPoolState pool;
+  REQUIRE(worker_pool::start_pool(pool, 2));
+  const auto tag = static_cast<std::size_t>(worker_pool::TaskTag::GalleryHash);
+
+  std::latch first(1);
+  worker_pool::submit_to_pool(pool, [&first] { first.count_down(); },
+                              {.tag = worker_pool::TaskTag::GalleryHash});
+  first.wait();
+
+  executor_metrics::set_enabled(pool.metrics, true);
+  std::latch second(1);
+  std::atomic<bool> tag_seen{false};
+  worker_pool::submit_to_pool(
+      pool,
+      [&second, &tag_seen] {
+        tag_seen = worker_pool::current_task_tag() == worker_pool::TaskTag::GalleryHash;
+        second.count_down();
+      },
+      {.tag = worker_pool::TaskTag::GalleryHash});
+  second.wait();
+  worker_pool::stop_pool(pool);
+
+  CHECK(tag_seen.load());
+  CHECK(pool.metrics.sources[tag].tasks.load() == 1);
+  CHECK(pool.metrics.running.load() == 0);
+  CHECK(worker_pool::current_task_tag() == worker_pool::TaskTag::General);
+}
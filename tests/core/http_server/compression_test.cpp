@@ -0,0 +1,34 @@
+#include "vendor/std.hpp"
+
+#include "vendor/doctest.hpp"
+
+#include "core/http_server/compression.hpp"
+
+using core::http_server::compression::accepts_encoding;
+using core::http_server::compression::is_compressible_mime;
+using core::http_server::compression::negotiate_encoding;
+using utils::compression::Encoding;
+
+TEST_CASE("accept-encoding negotiation follows q values") {
+  CHECK(negotiate_encoding("gzip, deflate, br") == Encoding::Gzip);
+  CHECK(negotiate_encoding("deflate") == Encoding::Deflate);
+  CHECK(negotiate_encoding("gzip;q=0.5, deflate;q=0.8") == Encoding::Deflate);
+  CHECK(negotiate_encoding("GZIP ; Q=1") == Encoding::Gzip);
+  CHECK_FALSE(negotiate_encoding("").has_value());
+  CHECK_FALSE(negotiate_encoding("br, identity").has_value());
+  // 显式 q=0 表示拒绝，即使通配符允许也不能使用
+  CHECK(negotiate_encoding("gzip;q=0, *") == Encoding::Deflate);
+  CHECK_FALSE(accepts_encoding("*;q=0", Encoding::Gzip));
+  CHECK(accepts_encoding("br, *;q=0.1", Encoding::Gzip));
+}
+
+TEST_CASE("only text-like mime types are compressible") {
+  CHECK(is_compressible_mime("text/html; charset=utf-8"));
+  CHECK(is_compressible_mime("application/javascript; charset=utf-8"));
+  CHECK(is_compressible_mime("application/json"));
+  CHECK(is_compressible_mime("image/svg+xml"));
+  CHECK_FALSE(is_compressible_mime("image/jpeg"));
+  CHECK_FALSE(is_compressible_mime("image/webp"));
+  CHECK_FALSE(is_compressible_mime("video/mp4"));
+  CHECK_FALSE(is_compressible_mime("font/woff2"));
+}
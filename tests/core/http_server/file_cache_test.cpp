@@ -0,0 +1,84 @@
+#include "vendor/std.hpp"
+
+#include "vendor/doctest.hpp"
+
+#include "core/http_server/file_cache.hpp"
+
+namespace file_cache = core::http_server::file_cache;
+
+namespace {
+
+auto make_file(size_t size, std::int64_t modified_seconds, bool immutable = false)
+    -> file_cache::CachedFile {
+  return file_cache::CachedFile{
+      .data = std::make_shared<const std::string>(size, 'x'),
+      .gzip_data = nullptr,
+      .modified_seconds = modified_seconds,
+      .immutable = immutable,
+  };
+}
+
+}  // namespace
+
+// 大小或修改时间变化都视为文件已被替换，旧内容不能再命中
+TEST_CASE("static file cache validates entries by size and mtime") {
+  file_cache::StaticFileCache cache;
+  const std::filesystem::path path = L"C:/web/index.html";
+  file_cache::store(cache, path, make_file(100, 10));
+
+  CHECK(file_cache::find_valid(cache, path, 100, 10) != nullptr);
+  CHECK(file_cache::find_valid(cache, path, 100, 11) == nullptr);
+  // 校验失败的条目已被移除，恢复原属性也不会再命中
+  CHECK(file_cache::find_valid(cache, path, 100, 10) == nullptr);
+
+  file_cache::store(cache, path, make_file(100, 10));
+  CHECK(file_cache::find_valid(cache, path, 101, 10) == nullptr);
+
+  const auto stats = file_cache::get_stats(cache);
+  CHECK(stats.hit_count == 1);
+  CHECK(stats.miss_count == 3);
+  CHECK(stats.entry_count == 0);
+  CHECK(stats.cached_bytes == 0);
+}
+
+TEST_CASE("static file cache evicts least recently used entries within budget") {
+  file_cache::StaticFileCache cache;
+  cache.budget_bytes = 300;
+  const std::filesystem::path first = L"C:/web/a.js";
+  const std::filesystem::path second = L"C:/web/b.js";
+  const std::filesystem::path third = L"C:/web/c.js";
+
+  file_cache::store(cache, first, make_file(100, 1));
+  file_cache::store(cache, second, make_file(100, 1));
+  // 访问 first 后，最久未使用的是 second
+  CHECK(file_cache::find_valid(cache, first, 100, 1) != nullptr);
+  file_cache::store(cache, third, make_file(150, 1));
+
+  CHECK(file_cache::find_valid(cache, first, 100, 1) != nullptr);
+  CHECK(file_cache::find_valid(cache, second, 100, 1) == nullptr);
+  CHECK(file_cache::find_valid(cache, third, 150, 1) != nullptr);
+  CHECK(file_cache::get_stats(cache).cached_bytes == 250);
+
+  // 超过整个预算的文件直接跳过，不清空已有条目
+  file_cache::store(cache, second, make_file(400, 1));
+  CHECK(file_cache::get_stats(cache).entry_count == 2);
+}
+
+TEST_CASE("static file cache serves immutable assets without validation") {
+  file_cache::StaticFileCache cache;
+  const std::filesystem::path asset = L"C:/web/assets/app-1a2b.js";
+  const std::filesystem::path page = L"C:/web/index.html";
+  file_cache::store(cache, asset, make_file(10, 5, true));
+  file_cache::store(cache, page, make_file(10, 5));
+
+  auto cached = file_cache::find_immutable(cache, asset);
+  REQUIRE(cached != nullptr);
+  CHECK(cached->modified_seconds == 5);
+  CHECK(file_cache::find_immutable(cache, page) == nullptr);
+
+  file_cache::record_bytes_saved(cache, cached->data->size());
+  const auto stats = file_cache::get_stats(cache);
+  CHECK(stats.hit_count == 1);
+  CHECK(stats.bytes_saved == 10);
+  CHECK(stats.hit_ratio == doctest::Approx(1.0));
+}
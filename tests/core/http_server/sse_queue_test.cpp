@@ -0,0 +1,119 @@
+#include "vendor/std.hpp"
+
+#include "vendor/doctest.hpp"
+
+#include "core/http_server/sse_queue.hpp"
+
+namespace sse_queue = core::http_server::sse_queue;
+
+using sse_queue::EnqueueResult;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr sse_queue::EventQueueLimits kLimits{.max_pending_events = 3,
+                                              .lag_budget = std::chrono::seconds(30)};
+
+// 先写出一条并遇到背压，之后的事件都留在队列里
+auto make_blocked_queue(Clock::time_point now) -> sse_queue::EventQueue {
+  sse_queue::EventQueue queue;
+  CHECK(sse_queue::enqueue(queue, kLimits, "", "first", now) == EnqueueResult::Queued);
+  CHECK(sse_queue::pop_writable(queue) == "first");
+  sse_queue::record_write(queue, false, now);
+  return queue;
+}
+
+auto pending_messages(const sse_queue::EventQueue& queue) -> std::vector<std::string> {
+  std::vector<std::string> messages;
+  for (const auto& event : queue.events) {
+    messages.push_back(event.message);
+  }
+  return messages;
+}
+
+}  // namespace
+
+// 背压期间同 key 事件原位替换为最新一条，顺序不变
+TEST_CASE("sse queue coalesces keyed events in place") {
+  const auto now = Clock::now();
+  auto queue = make_blocked_queue(now);
+
+  CHECK(sse_queue::enqueue(queue, kLimits, "task.updated:1", "t1 10%", now) ==
+        EnqueueResult::Queued);
+  CHECK(sse_queue::enqueue(queue, kLimits, "", "log", now) == EnqueueResult::Queued);
+  CHECK(sse_queue::enqueue(queue, kLimits, "task.updated:1", "t1 done", now) ==
+        EnqueueResult::Coalesced);
+
+  const std::vector<std::string> expected = {"t1 done", "log"};
+  CHECK(pending_messages(queue) == expected);
+}
+
+// 超出上限时淘汰最旧的无 key 事件，任务的终态 task.updated 保留
+TEST_CASE("sse queue evicts unkeyed events before keyed ones") {
+  const auto now = Clock::now();
+  auto queue = make_blocked_queue(now);
+
+  CHECK(sse_queue::enqueue(queue, kLimits, "task.updated:1", "t1 done", now) ==
+        EnqueueResult::Queued);
+  CHECK(sse_queue::enqueue(queue, kLimits, "", "log 1", now) == EnqueueResult::Queued);
+  CHECK(sse_queue::enqueue(queue, kLimits, "gallery.changed", "changed", now) ==
+        EnqueueResult::Queued);
+  CHECK(sse_queue::enqueue(queue, kLimits, "", "log 2", now) == EnqueueResult::Dropped);
+
+  const std::vector<std::string> expected = {"t1 done", "changed", "log 2"};
+  CHECK(pending_messages(queue) == expected);
+}
+
+// 全部积压都带 key 时不淘汰任何事件，暂时超出上限
+TEST_CASE("sse queue never evicts keyed events") {
+  const auto now = Clock::now();
+  auto queue = make_blocked_queue(now);
+
+  for (int task = 0; task < 5; ++task) {
+    CHECK(sse_queue::enqueue(queue, kLimits, std::format("task.updated:{}", task), "done", now) ==
+          EnqueueResult::Queued);
+  }
+  CHECK(queue.events.size() == 5);
+}
+
+// 未背压时按入队顺序写出；写出返回背压后停止，resume 后继续
+TEST_CASE("sse queue writes in order and stops on backpressure") {
+  const auto now = Clock::now();
+  sse_queue::EventQueue queue;
+
+  CHECK(sse_queue::enqueue(queue, kLimits, "", "a", now) == EnqueueResult::Queued);
+  CHECK(sse_queue::enqueue(queue, kLimits, "", "b", now) == EnqueueResult::Queued);
+
+  auto first = sse_queue::pop_writable(queue);
+  REQUIRE(first.has_value());
+  CHECK(*first == "a");
+  sse_queue::record_write(queue, false, now);
+  CHECK_FALSE(sse_queue::pop_writable(queue).has_value());
+
+  sse_queue::resume(queue);
+  auto second = sse_queue::pop_writable(queue);
+  REQUIRE(second.has_value());
+  CHECK(*second == "b");
+  sse_queue::record_write(queue, true, now);
+  CHECK_FALSE(queue.write_blocked);
+}
+
+// 延迟预算从最近一次写出进展算起，持续有进展的慢连接不会被误判
+TEST_CASE("sse queue measures lag from the last write progress") {
+  const auto start = Clock::now();
+  auto queue = make_blocked_queue(start);
+
+  // 25 秒时 socket 排空了一部分，又写出一条后再次背压
+  const auto progress = start + std::chrono::seconds(25);
+  CHECK(sse_queue::enqueue(queue, kLimits, "", "second", progress) == EnqueueResult::Queued);
+  sse_queue::resume(queue);
+  REQUIRE(sse_queue::pop_writable(queue).has_value());
+  sse_queue::record_write(queue, false, progress);
+
+  CHECK(sse_queue::enqueue(queue, kLimits, "", "third", start + std::chrono::seconds(50)) ==
+        EnqueueResult::Queued);
+  CHECK(sse_queue::enqueue(queue, kLimits, "", "fourth", start + std::chrono::seconds(56)) ==
+        EnqueueResult::Lagging);
+  CHECK(queue.events.size() == 1);
+}
@@ -0,0 +1,101 @@
+#include "vendor/std.hpp"
+
+#include "vendor/doctest.hpp"
+
+#include "core/http_server/thumbnail_batch_format.hpp"
+
+namespace thumbnail_batch = core::http_server::thumbnail_batch;
+
+using thumbnail_batch::EntryStatus;
+
+namespace {
+
+auto read_u32_le(std::string_view bytes, std::size_t offset) -> std::uint32_t {
+  std::uint32_t value = 0;
+  for (int index = 0; index < 4; ++index) {
+    value |= static_cast<std::uint32_t>(static_cast<std::uint8_t>(bytes[offset + index]))
+             << (index * 8);
+  }
+  return value;
+}
+
+auto to_payload(std::string_view text) -> std::vector<char> {
+  return {text.begin(), text.end()};
+}
+
+}  // namespace
+
+// 长度越界、大写、非十六进制和路径字符都拒绝，合法 hash 不可能拼出目录穿越
+TEST_CASE("thumbnail batch rejects malformed hashes") {
+  CHECK(thumbnail_batch::is_valid_thumbnail_hash(std::string(16, 'a')));
+  CHECK(thumbnail_batch::is_valid_thumbnail_hash(std::string(64, '0')));
+  CHECK(thumbnail_batch::is_valid_thumbnail_hash("0123456789abcdef"));
+
+  CHECK_FALSE(thumbnail_batch::is_valid_thumbnail_hash(""));
+  CHECK_FALSE(thumbnail_batch::is_valid_thumbnail_hash(std::string(15, 'a')));
+  CHECK_FALSE(thumbnail_batch::is_valid_thumbnail_hash(std::string(65, 'a')));
+  CHECK_FALSE(thumbnail_batch::is_valid_thumbnail_hash("0123456789ABCDEF"));
+  CHECK_FALSE(thumbnail_batch::is_valid_thumbnail_hash("0123456789abcdeg"));
+  CHECK_FALSE(thumbnail_batch::is_valid_thumbnail_hash("../../0123456789abcdef"));
+  CHECK_FALSE(thumbnail_batch::is_valid_thumbnail_hash("0123456789abcdef.webp"));
+}
+
+// 空批次只有魔数、版本和为 0 的条目数
+TEST_CASE("thumbnail batch encodes an empty batch as a bare header") {
+  const auto body = thumbnail_batch::encode_batch_response({}, {});
+
+  REQUIRE(body.size() == 12);
+  CHECK(body.substr(0, 4) == thumbnail_batch::kResponseMagic);
+  CHECK(read_u32_le(body, 4) == thumbnail_batch::kResponseVersion);
+  CHECK(read_u32_le(body, 8) == 0);
+}
+
+// 条目按请求顺序编码；非 Ok 条目长度为 0，即使调用方留了数据也不写出
+TEST_CASE("thumbnail batch frames entries in request order") {
+  const std::vector<EntryStatus> statuses = {EntryStatus::Ok, EntryStatus::Missing,
+                                             EntryStatus::Invalid, EntryStatus::Ok};
+  const std::vector<std::vector<char>> payloads = {to_payload("webp"), to_payload("stale"), {},
+                                                   {}};
+
+  const auto body = thumbnail_batch::encode_batch_response(statuses, payloads);
+  REQUIRE(body.size() == 12 + 4 * 5 + 4);
+  CHECK(read_u32_le(body, 8) == statuses.size());
+
+  struct Entry {
+    EntryStatus status;
+    std::string payload;
+  };
+  std::vector<Entry> entries;
+  std::size_t offset = 12;
+  while (offset < body.size()) {
+    const auto status = static_cast<EntryStatus>(static_cast<std::uint8_t>(body[offset]));
+    const auto length = read_u32_le(body, offset + 1);
+    entries.push_back({status, body.substr(offset + 5, length)});
+    offset += 5 + length;
+  }
+
+  REQUIRE(offset == body.size());
+  REQUIRE(entries.size() == statuses.size());
+  for (std::size_t index = 0; index < statuses.size(); ++index) {
+    CHECK(entries[index].status == statuses[index]);
+  }
+  CHECK(entries[0].payload == "webp");
+  CHECK(entries[1].payload.empty());
+  CHECK(entries[2].payload.empty());
+  CHECK(entries[3].payload.empty());
+}
+
+// 长度字段是小端 u32，超过一个字节的载荷也能正确分帧
+TEST_CASE("thumbnail batch writes payload lengths little-endian") {
+  const std::vector<EntryStatus> statuses = {EntryStatus::Ok};
+  const std::vector<std::vector<char>> payloads = {std::vector<char>(0x0102, 'x')};
+
+  const auto body = thumbnail_batch::encode_batch_response(statuses, payloads);
+  REQUIRE(body.size() == 12 + 5 + 0x0102);
+  CHECK(static_cast<std::uint8_t>(body[12]) == 0);
+  CHECK(static_cast<std::uint8_t>(body[13]) == 0x02);
+  CHECK(static_cast<std::uint8_t>(body[14]) == 0x01);
+  CHECK(static_cast<std::uint8_t>(body[15]) == 0x00);
+  CHECK(static_cast<std::uint8_t>(body[16]) == 0x00);
+  CHECK(body.back() == 'x');
+}
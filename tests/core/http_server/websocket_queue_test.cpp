@@ -0,0 +1,94 @@
+#include "vendor/std.hpp"
+
+#include "vendor/doctest.hpp"
+
+#include "core/http_server/websocket_queue.hpp"
+
+namespace websocket_queue = core::http_server::websocket_queue;
+
+using websocket_queue::MessageKind;
+using websocket_queue::PushResult;
+
+namespace {
+
+// 用小阈值代替线上的 MB 级配置，便于构造背压场景
+constexpr websocket_queue::SendQueueLimits kLimits{
+    .high_watermark = 10, .notification_drop_threshold = 20, .max_queued_bytes = 30};
+
+auto drain(websocket_queue::SendQueue& queue, std::size_t buffered_amount)
+    -> std::vector<std::string> {
+  std::vector<std::string> written;
+  while (auto message = websocket_queue::pop_writable(queue, kLimits, buffered_amount)) {
+    written.push_back(std::move(*message));
+  }
+  return written;
+}
+
+}  // namespace
+
+// 缓冲未满时消息立即可写；缓冲越过高水位后积压，drain 时按入队顺序写出
+TEST_CASE("websocket send queue preserves enqueue order across backpressure") {
+  websocket_queue::SendQueue queue;
+
+  CHECK(websocket_queue::push(queue, kLimits, "r1", MessageKind::Response, 0) ==
+        PushResult::Accepted);
+  CHECK(drain(queue, 0) == std::vector<std::string>{"r1"});
+
+  CHECK(websocket_queue::push(queue, kLimits, "r2", MessageKind::Response, 10) ==
+        PushResult::Accepted);
+  CHECK(websocket_queue::push(queue, kLimits, "n3", MessageKind::Notification, 10) ==
+        PushResult::Accepted);
+  CHECK(websocket_queue::push(queue, kLimits, "r4", MessageKind::Response, 10) ==
+        PushResult::Accepted);
+  CHECK(drain(queue, 10).empty());
+  CHECK(queue.bytes == 6);
+
+  const std::vector<std::string> expected = {"r2", "n3", "r4"};
+  CHECK(drain(queue, 0) == expected);
+  CHECK(queue.bytes == 0);
+}
+
+// 积压越过通知阈值后只丢弃通知，响应仍然入队
+TEST_CASE("websocket send queue drops notifications before responses") {
+  websocket_queue::SendQueue queue;
+
+  CHECK(websocket_queue::push(queue, kLimits, std::string(8, 'r'), MessageKind::Response, 15) ==
+        PushResult::Accepted);
+  CHECK(websocket_queue::push(queue, kLimits, "note", MessageKind::Notification, 15) ==
+        PushResult::DroppedNotification);
+  CHECK(websocket_queue::push(queue, kLimits, "resp", MessageKind::Response, 15) ==
+        PushResult::Accepted);
+  CHECK(queue.dropped_notifications == 1);
+  CHECK(queue.messages.size() == 2);
+}
+
+// 队列总量越过上限时清空并关闭，之后的消息一律忽略
+TEST_CASE("websocket send queue closes on overflow") {
+  websocket_queue::SendQueue queue;
+
+  CHECK(websocket_queue::push(queue, kLimits, std::string(20, 'a'), MessageKind::Response, 10) ==
+        PushResult::Accepted);
+  CHECK(websocket_queue::push(queue, kLimits, std::string(11, 'b'), MessageKind::Response, 10) ==
+        PushResult::Overflow);
+  CHECK(queue.closed);
+  CHECK(queue.messages.empty());
+  CHECK(queue.bytes == 0);
+  CHECK(websocket_queue::push(queue, kLimits, "late", MessageKind::Response, 0) ==
+        PushResult::Closed);
+}
+
+// 连接关闭后积压被丢弃，仍在途的响应不会再写出
+TEST_CASE("websocket send queue discards backlog on close") {
+  websocket_queue::SendQueue queue;
+
+  CHECK(websocket_queue::push(queue, kLimits, "r1", MessageKind::Response, 10) ==
+        PushResult::Accepted);
+  websocket_queue::close(queue);
+
+  CHECK(drain(queue, 0).empty());
+  CHECK(queue.bytes == 0);
+  CHECK(websocket_queue::push(queue, kLimits, "r2", MessageKind::Response, 0) ==
+        PushResult::Closed);
+  CHECK(websocket_queue::push(queue, kLimits, "n3", MessageKind::Notification, 0) ==
+        PushResult::Closed);
+}
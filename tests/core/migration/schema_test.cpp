@@ -0,0 +1,147 @@
+#include "vendor/std.hpp"
+
+#include "vendor/doctest.hpp"
+#include "vendor/sqlite.hpp"
+
+#include "core/migration/generated/schema.hpp"
+#include "core/version.hpp"
+
+namespace schema = core::migration::schema;
+
+template <typename SchemaModule>
+auto apply_schema(SQLite::Database& connection) -> void {
+  for (const auto& sql : SchemaModule::statements) {
+    connection.exec(std::string(sql));
+  }
+}
+
+// 与首次安装一致：按顺序执行全部 schema，连接参数与 DB worker 相同
+auto open_fresh_database() -> std::unique_ptr<SQLite::Database> {
+  auto connection = std::make_unique<SQLite::Database>(
+      ":memory:", SQLite::OPEN_READWRITE | SQLite::OPEN_CREATE);
+  connection->exec("PRAGMA foreign_keys=ON;");
+  apply_schema<schema::V001>(*connection);
+  apply_schema<schema::V002>(*connection);
+  apply_schema<schema::V003>(*connection);
+  apply_schema<schema::V004>(*connection);
+  apply_schema<schema::V005>(*connection);
+  apply_schema<schema::V006>(*connection);
+  apply_schema<schema::V007>(*connection);
+  return connection;
+}
+
+auto count_rows(SQLite::Database& connection, const std::string& sql) -> std::int64_t {
+  SQLite::Statement query(connection, sql);
+  return query.executeStep() ? query.getColumn(0).getInt64() : -1;
+}
+
+auto parse_version(std::string_view version) -> std::array<int, 4> {
+  std::array<int, 4> parts{};
+  std::size_t index = 0;
+  for (auto part : std::views::split(version, '.')) {
+    if (index == parts.size()) break;
+    std::from_chars(part.data(), part.data() + part.size(), parts[index++]);
+  }
+  return parts;
+}
+
+// 与 persist_prepared_asset 新建分支相同的写入序列：资产、主色、dHash 同一事务提交
+auto persist_asset(SQLite::Database& connection, const std::string& path, std::int64_t dhash)
+    -> std::int64_t {
+  SQLite::Transaction transaction(connection);
+
+  std::int64_t asset_id = 0;
+  {
+    SQLite::Statement insert_asset(connection, R"(
+      INSERT INTO assets (name, path, type, width, height, size, extension, mime_type, hash)
+      VALUES (?, ?, 'photo', 1920, 1080, 1024, '.png', 'image/png', ?)
+      RETURNING id
+    )");
+    insert_asset.bind(1, std::filesystem::path(path).filename().string());
+    insert_asset.bind(2, path);
+    insert_asset.bind(3, std::to_string(dhash));
+    CHECK(insert_asset.executeStep());
+    asset_id = insert_asset.getColumn(0).getInt64();
+  }
+
+  SQLite::Statement insert_color(connection, R"(
+    INSERT INTO asset_colors (asset_id, r, g, b, lab_l, lab_a, lab_b, weight, l_bin, a_bin, b_bin)
+    VALUES (?, 90, 150, 220, 60.9, 1.4, -41.4, 1.0, 12, 0, -5)
+  )");
+  insert_color.bind(1, asset_id);
+  insert_color.exec();
+
+  SQLite::Statement upsert_hash(connection, R"(
+    INSERT INTO asset_perceptual_hashes (asset_id, dhash, algorithm_version)
+    VALUES (?, ?, 1)
+    ON CONFLICT(asset_id) DO UPDATE SET
+      dhash = excluded.dhash,
+      algorithm_version = excluded.algorithm_version
+  )");
+  upsert_hash.bind(1, asset_id);
+  upsert_hash.bind(2, dhash);
+  upsert_hash.exec();
+
+  transaction.commit();
+  return asset_id;
+}
+
+// 扫描写库依赖的表必须落在当前版本可达的迁移里，否则真实安装上每次写入都会回滚
+TEST_CASE("app version reaches the perceptual hash and change log migration") {
+  CHECK(parse_version(core::version::get_app_version()) >= parse_version("2.1.6.0"));
+}
+
+// 全新数据库执行一次扫描写入，资产聚合完整提交
+TEST_CASE("fresh database accepts a scanner asset persist") {
+  auto connection = open_fresh_database();
+
+  const auto asset_id = persist_asset(*connection, "D:/Pictures/IMG_0001.png", 0x0123456789abcdef);
+  CHECK(asset_id > 0);
+  CHECK(count_rows(*connection, "SELECT COUNT(*) FROM assets") == 1);
+  CHECK(count_rows(*connection, "SELECT COUNT(*) FROM asset_colors") == 1);
+  CHECK(count_rows(*connection, "SELECT dhash FROM asset_perceptual_hashes") ==
+        0x0123456789abcdef);
+
+  // 删除资产时 dHash 随外键级联清理
+  connection->exec("DELETE FROM assets");
+  CHECK(count_rows(*connection, "SELECT COUNT(*) FROM asset_perceptual_hashes") == 0);
+}
+
+// 迁移中途失败后下次启动会重放 V006，已建好的表和索引不能让重放失败
+TEST_CASE("perceptual hash schema can be reapplied") {
+  auto connection = open_fresh_database();
+
+  CHECK_NOTHROW(apply_schema<schema::V006>(*connection));
+  CHECK(persist_asset(*connection, "D:/Pictures/IMG_0003.png", 2) > 0);
+}
+
+// 更新时间戳触发器的回写不能再记一条变更：每次插入、更新各一行
+TEST_CASE("change log records one row per insert and update") {
+  auto connection = open_fresh_database();
+
+  const auto asset_id = persist_asset(*connection, "D:/Pictures/IMG_0002.png", 1);
+  CHECK(count_rows(*connection, "SELECT COUNT(*) FROM gallery_change_log "
+                                "WHERE entity = 'asset' AND op = 'upsert'") == 1);
+
+  connection->exec("UPDATE assets SET rating = 5 WHERE id = " + std::to_string(asset_id));
+  CHECK(count_rows(*connection, "SELECT COUNT(*) FROM gallery_change_log "
+                                "WHERE entity = 'asset' AND op = 'upsert'") == 2);
+
+  connection->exec("INSERT INTO tags (name) VALUES ('sky')");
+  connection->exec("UPDATE tags SET name = 'clouds'");
+  CHECK(count_rows(*connection, "SELECT COUNT(*) FROM gallery_change_log WHERE entity = 'tag'") ==
+        2);
+
+  connection->exec("DELETE FROM assets");
+  CHECK(count_rows(*connection, "SELECT op = 'remove' FROM gallery_change_log "
+                                "WHERE entity = 'asset' ORDER BY seq DESC LIMIT 1") == 1);
+}
+
+// 2.1.6.0 的两个 schema 在同一事务中执行，重放时同样不能因已有对象失败，也不能重复记录变更
+TEST_CASE("change log schema can be reapplied") {
+  auto connection = open_fresh_database();
+
+  CHECK_NOTHROW(apply_schema<schema::V007>(*connection));
+  persist_asset(*connection, "D:/Pictures/IMG_0004.png", 3);
+  CHECK(count_rows(*connection, "SELECT COUNT(*) FROM gallery_change_log") == 1);
+}
@@ -0,0 +1,66 @@
+#include "vendor/std.hpp"
+
+#include "vendor/doctest.hpp"
+
+#include "core/rpc/cancellation.hpp"
+
+namespace cancellation = core::rpc::cancellation;
+
+namespace {
+
+struct Registered {
+  std::stop_token token;
+  std::uint64_t serial = 0;
+};
+
+auto register_request(cancellation::InFlightTable& table, bool local_caller,
+                      std::string_view session, std::string_view id_json) -> Registered {
+  auto key = cancellation::make_key(local_caller, session, id_json).value();
+  std::stop_source stop_source;
+  auto token = stop_source.get_token();
+  return {.token = token,
+          .serial = cancellation::add(table, std::move(key), std::move(stop_source))};
+}
+
+}  // namespace
+
+// 两个客户端用同一个 id 发起请求，取消只命中发起取消的那一方
+TEST_CASE("cancellation only reaches the caller's own request") {
+  cancellation::InFlightTable table;
+  const auto first = register_request(table, false, "ws:1", "7");
+  const auto second = register_request(table, false, "ws:2", "7");
+
+  const auto key = cancellation::make_key(false, "ws:1", "7");
+  REQUIRE(key.has_value());
+  CHECK(cancellation::request_stop(table, key.value()) == 1);
+  CHECK(first.token.stop_requested());
+  CHECK_FALSE(second.token.stop_requested());
+}
+
+// 同一会话内复用 id 的请求一并取消；已注销的请求不再命中
+TEST_CASE("cancellation stops every live request with the same key") {
+  cancellation::InFlightTable table;
+  const auto first = register_request(table, true, "webview", "\"query\"");
+  const auto second = register_request(table, true, "webview", "\"query\"");
+  cancellation::remove(table, second.serial);
+
+  const auto key = cancellation::make_key(true, "webview", "\"query\"");
+  REQUIRE(key.has_value());
+  CHECK(cancellation::request_stop(table, key.value()) == 1);
+  CHECK(first.token.stop_requested());
+  CHECK_FALSE(second.token.stop_requested());
+}
+
+// 访问等级、会话与 id 任一不同都得到不同的 key，且拼接处不会产生歧义
+TEST_CASE("cancellation keys separate access levels and sessions") {
+  CHECK(cancellation::make_key(false, "s", "1") != cancellation::make_key(true, "s", "1"));
+  CHECK(cancellation::make_key(false, "a", "1") != cancellation::make_key(false, "b", "1"));
+  CHECK(cancellation::make_key(false, "a1", "1") != cancellation::make_key(false, "a", "11"));
+  CHECK(cancellation::make_key(false, "a", "1") == cancellation::make_key(false, "a", "1"));
+}
+
+// 没有会话或 id 为 null 的请求不登记，也就无法被取消
+TEST_CASE("cancellation keys require a session and a non-null id") {
+  CHECK_FALSE(cancellation::make_key(false, "", "1").has_value());
+  CHECK_FALSE(cancellation::make_key(true, "webview", "null").has_value());
+}
@@ -0,0 +1,125 @@
+#include "vendor/std.hpp"
+
+#include "vendor/doctest.hpp"
+
+#include "core/rpc/columnar.hpp"
+
+namespace columnar = core::rpc::columnar;
+
+namespace {
+
+struct Row {
+  std::int64_t id = 0;
+  std::optional<std::int32_t> width;
+  std::string name;
+  double score = 0.0;
+};
+
+template <typename T>
+auto read_at(const std::string& buffer, std::size_t offset) -> T {
+  T value{};
+  std::memcpy(&value, buffer.data() + offset, sizeof(T));
+  return value;
+}
+
+auto align(std::size_t offset) -> std::size_t {
+  return (offset + columnar::kAlignment - 1) / columnar::kAlignment * columnar::kAlignment;
+}
+
+struct ParsedColumn {
+  std::string name;
+  columnar::ColumnType type;
+  bool nullable = false;
+  std::size_t body_offset = 0;
+  std::size_t body_length = 0;
+};
+
+// 按格式说明逐段解析，验证前端可以只靠偏移量定位每一列
+auto parse_columns(const std::string& buffer, std::string& meta_json) -> std::vector<ParsedColumn> {
+  CHECK(buffer.substr(0, 4) == columnar::kMagic);
+  CHECK(read_at<std::uint32_t>(buffer, 4) == columnar::kVersion);
+  const auto column_count = read_at<std::uint32_t>(buffer, 12);
+  const auto meta_length = read_at<std::uint32_t>(buffer, 16);
+  meta_json = buffer.substr(20, meta_length);
+
+  std::vector<ParsedColumn> columns;
+  std::size_t offset = align(20 + meta_length);
+  for (std::uint32_t i = 0; i < column_count; ++i) {
+    ParsedColumn column;
+    const auto name_length = read_at<std::uint16_t>(buffer, offset);
+    column.name = buffer.substr(offset + 2, name_length);
+    column.type = static_cast<columnar::ColumnType>(buffer[offset + 2 + name_length]);
+    column.nullable = buffer[offset + 3 + name_length] == columnar::kNullableFlag;
+    offset = align(offset + 4 + name_length);
+    column.body_length = read_at<std::uint64_t>(buffer, offset);
+    column.body_offset = offset + 8;
+    CHECK(column.body_offset % columnar::kAlignment == 0);
+    offset = column.body_offset + column.body_length;
+    columns.push_back(std::move(column));
+  }
+  CHECK(offset == buffer.size());
+  return columns;
+}
+
+}  // namespace
+
+TEST_CASE("columnar encoding round-trips numeric, nullable and string columns") {
+  const std::vector<Row> rows{
+      {.id = 7, .width = 1920, .name = "a", .score = 0.5},
+      {.id = 1LL << 40, .width = std::nullopt, .name = "", .score = -1.0},
+      {.id = 3, .width = 640, .name = "照片", .score = 2.25},
+  };
+  const std::span<const Row> view = rows;
+
+  auto builder = columnar::begin_columnar(3, R"({"totalCount":3})");
+  columnar::append_column(builder, "id", view, &Row::id);
+  columnar::append_column(builder, "width", view, &Row::width);
+  columnar::append_column(builder, "name", view, &Row::name);
+  columnar::append_column(builder, "score", view, &Row::score);
+  const auto buffer = columnar::finish_columnar(std::move(builder));
+
+  std::string meta_json;
+  const auto columns = parse_columns(buffer, meta_json);
+  CHECK(meta_json == R"({"totalCount":3})");
+  REQUIRE(columns.size() == 4);
+
+  CHECK(columns[0].name == "id");
+  CHECK(columns[0].type == columnar::ColumnType::Int64);
+  CHECK_FALSE(columns[0].nullable);
+  CHECK(read_at<std::int64_t>(buffer, columns[0].body_offset + 8) == (1LL << 40));
+
+  CHECK(columns[1].type == columnar::ColumnType::Int32);
+  REQUIRE(columns[1].nullable);
+  const auto validity = columns[1].body_offset;
+  CHECK(buffer[validity] == 1);
+  CHECK(buffer[validity + 1] == 0);
+  CHECK(buffer[validity + 2] == 1);
+  const auto width_values = align(validity + 3);
+  CHECK(read_at<std::int32_t>(buffer, width_values) == 1920);
+  CHECK(read_at<std::int32_t>(buffer, width_values + 4) == 0);
+  CHECK(read_at<std::int32_t>(buffer, width_values + 8) == 640);
+
+  CHECK(columns[2].type == columnar::ColumnType::String);
+  const auto offsets = columns[2].body_offset;
+  const auto string_bytes = align(offsets + 4 * 4);
+  CHECK(read_at<std::uint32_t>(buffer, offsets) == 0);
+  CHECK(read_at<std::uint32_t>(buffer, offsets + 4) == 1);
+  CHECK(read_at<std::uint32_t>(buffer, offsets + 8) == 1);
+  const auto end = read_at<std::uint32_t>(buffer, offsets + 12);
+  CHECK(buffer.substr(string_bytes, end) == "a照片");
+
+  CHECK(columns[3].type == columnar::ColumnType::Float64);
+  CHECK(read_at<double>(buffer, columns[3].body_offset + 16) == 2.25);
+}
+
+TEST_CASE("columnar encoding of an empty result still carries headers") {
+  const std::vector<Row> rows;
+  auto builder = columnar::begin_columnar(0, "{}");
+  columnar::append_column(builder, "id", std::span<const Row>{rows}, &Row::id);
+  const auto buffer = columnar::finish_columnar(std::move(builder));
+
+  std::string meta_json;
+  const auto columns = parse_columns(buffer, meta_json);
+  REQUIRE(columns.size() == 1);
+  CHECK(columns[0].body_length == 0);
+}
@@ -0,0 +1,45 @@
+#include "vendor/std.hpp"
+
+#include "vendor/doctest.hpp"
+
+#include "core/rpc/metrics.hpp"
+
+namespace metrics = core::rpc::metrics;
+
+TEST_CASE("latency buckets are contiguous and bound their values") {
+  std::uint64_t expected_lower = 0;
+  for (std::size_t index = 0; index < metrics::kLatencyBucketCount; ++index) {
+    const auto upper = metrics::latency_bucket_upper_bound(index);
+    CHECK(metrics::latency_bucket_index(expected_lower) == index);
+    CHECK(metrics::latency_bucket_index(upper) == index);
+    // 相对误差不超过 1/8
+    CHECK((upper - expected_lower) * metrics::kLatencySubBucketCount <= std::max<std::uint64_t>(
+                                                                            expected_lower, 1));
+    expected_lower = upper + 1;
+  }
+  CHECK(metrics::latency_bucket_index(std::uint64_t{1} << 40) ==
+        metrics::kLatencyBucketCount - 1);
+}
+
+TEST_CASE("latency snapshot reports percentiles within bucket precision") {
+  metrics::LatencyHistogram histogram;
+  for (int micros = 1; micros <= 1000; ++micros) {
+    metrics::record_latency(histogram, std::chrono::microseconds(micros));
+  }
+
+  const auto snapshot = metrics::snapshot_latency(histogram);
+  CHECK(snapshot.count == 1000);
+  CHECK(snapshot.total_us == 500500);
+  CHECK(snapshot.max_us == 1000);
+  CHECK(snapshot.p50_us >= 500);
+  CHECK(snapshot.p50_us <= 500 * 9 / 8);
+  CHECK(snapshot.p99_us >= 990);
+  CHECK(snapshot.p999_us == 1000);
+}
+
+TEST_CASE("empty latency snapshot is all zeros") {
+  const metrics::LatencyHistogram histogram;
+  const auto snapshot = metrics::snapshot_latency(histogram);
+  CHECK(snapshot.count == 0);
+  CHECK(snapshot.p99_us == 0);
+}
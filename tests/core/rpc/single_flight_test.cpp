@@ -0,0 +1,135 @@
+#include "vendor/std.hpp"
+
+#include "vendor/doctest.hpp"
+
+#include "core/rpc/single_flight.hpp"
+
+namespace single_flight = core::rpc::single_flight;
+
+namespace {
+
+constexpr std::string_view kKey = "gallery.getTagTree\n{}";
+
+auto make_result(std::string result_json) -> std::shared_ptr<const single_flight::Outcome> {
+  single_flight::Outcome outcome;
+  outcome.result_json = std::move(result_json);
+  return std::make_shared<const single_flight::Outcome>(std::move(outcome));
+}
+
+}  // namespace
+
+// 执行启动前已到达的相同调用加入同一次执行，结束后等待者拿到同一份结果，下一次调用重新执行
+TEST_CASE("single flight shares one run among calls that arrived before it started") {
+  single_flight::Table table;
+  const std::string key(kKey);
+  const auto first_arrival = single_flight::arrive(table);
+  const auto second_arrival = single_flight::arrive(table);
+
+  auto leader = single_flight::join(table, key, first_arrival);
+  auto joined = single_flight::join(table, key, second_arrival);
+  CHECK(leader.leader);
+  CHECK_FALSE(joined.leader);
+  CHECK(joined.run == leader.run);
+  CHECK(leader.run->participants == 2);
+
+  std::shared_ptr<const single_flight::Outcome> delivered;
+  single_flight::wait(table, *joined.run, [&delivered](auto outcome) { delivered = outcome; });
+  CHECK(delivered == nullptr);
+
+  auto outcome = make_result(R"({"tags":[]})");
+  auto waiters = single_flight::finish(table, key, leader.run, outcome);
+  REQUIRE(waiters.size() == 1);
+  waiters.front()(outcome);
+  CHECK(delivered == outcome);
+  CHECK(table.runs.empty());
+
+  // 结果就绪后等待直接交付，不再登记
+  std::shared_ptr<const single_flight::Outcome> late;
+  single_flight::wait(table, *joined.run, [&late](auto outcome) { late = outcome; });
+  CHECK(late == outcome);
+  CHECK(joined.run->waiters.empty());
+
+  auto next = single_flight::join(table, key, single_flight::arrive(table));
+  CHECK(next.leader);
+  CHECK(next.run != leader.run);
+}
+
+// 调用到达前已启动的执行可能读不到调用方刚完成的写入，改由该调用新开一次执行
+TEST_CASE("single flight does not join runs that started before the call arrived") {
+  single_flight::Table table;
+  const std::string key(kKey);
+
+  auto stale = single_flight::join(table, key, single_flight::arrive(table));
+  auto fresh = single_flight::join(table, key, single_flight::arrive(table));
+  CHECK(stale.leader);
+  CHECK(fresh.leader);
+  CHECK(fresh.run != stale.run);
+  CHECK(stale.run->participants == 1);
+
+  // 旧执行结束时只移除自己的条目，新执行仍可被加入
+  auto waiters = single_flight::finish(table, key, stale.run, make_result("1"));
+  CHECK(waiters.empty());
+  REQUIRE(table.runs.contains(key));
+  CHECK(table.runs.at(key) == fresh.run);
+}
+
+// 单个参与者取消不影响共享执行；全部取消后执行停止，且不再接纳新调用
+TEST_CASE("single flight stops a run only after every participant cancels") {
+  single_flight::Table table;
+  const std::string key(kKey);
+  const auto first_arrival = single_flight::arrive(table);
+  const auto second_arrival = single_flight::arrive(table);
+  const auto third_arrival = single_flight::arrive(table);
+
+  auto leader = single_flight::join(table, key, first_arrival);
+  auto joined = single_flight::join(table, key, second_arrival);
+  REQUIRE(!joined.leader);
+
+  single_flight::cancel(table, *joined.run);
+  CHECK_FALSE(leader.run->stop_source.stop_requested());
+  single_flight::cancel(table, *leader.run);
+  CHECK(leader.run->stop_source.stop_requested());
+
+  auto late = single_flight::join(table, key, third_arrival);
+  CHECK(late.leader);
+  CHECK(late.run != leader.run);
+}
+
+// 错误结果同样交给全部参与者，但不会留在表中被之后的调用复用
+TEST_CASE("single flight delivers errors to every participant without caching them") {
+  single_flight::Table table;
+  const std::string key(kKey);
+  const auto first_arrival = single_flight::arrive(table);
+  const auto second_arrival = single_flight::arrive(table);
+
+  auto leader = single_flight::join(table, key, first_arrival);
+  auto joined = single_flight::join(table, key, second_arrival);
+  std::shared_ptr<const single_flight::Outcome> delivered;
+  single_flight::wait(table, *joined.run, [&delivered](auto outcome) { delivered = outcome; });
+
+  single_flight::Outcome error;
+  error.error_code = -32000;
+  error.error_message = "Database is busy";
+  auto outcome = std::make_shared<const single_flight::Outcome>(std::move(error));
+  for (auto& waiter : single_flight::finish(table, key, leader.run, outcome)) {
+    waiter(outcome);
+  }
+  REQUIRE(delivered != nullptr);
+  CHECK_FALSE(delivered->result_json.has_value());
+  CHECK(delivered->error_code == -32000);
+  CHECK(delivered->error_message == "Database is busy");
+
+  CHECK(single_flight::join(table, key, single_flight::arrive(table)).leader);
+}
+
+// 同一份 result 按各调用方的 id 分别写出信封，id 类型原样保留
+TEST_CASE("single flight writes each participant's own id into the envelope") {
+  const std::string_view result = R"({"id":"$shared","count":3})";
+
+  CHECK(single_flight::write_success_envelope(result, "7") ==
+        R"({"jsonrpc":"2.0","result":{"id":"$shared","count":3},"id":7})");
+  CHECK(single_flight::write_success_envelope(result, R"("pane-2")") ==
+        R"({"jsonrpc":"2.0","result":{"id":"$shared","count":3},"id":"pane-2"})");
+  CHECK(single_flight::write_success_envelope("null", "null") ==
+        R"({"jsonrpc":"2.0","result":null,"id":null})");
+}
@@ -0,0 +1,106 @@
+#include "vendor/std.hpp"
+
+#include "vendor/doctest.hpp"
+
+#include "core/tasks/state.hpp"
+#include "core/tasks/throttle.hpp"
+
+namespace throttle = core::tasks::throttle;
+
+using core::tasks::TaskSnapshot;
+using throttle::UpdateAction;
+
+namespace {
+
+using namespace std::chrono_literals;
+
+auto make_snapshot(std::string status, std::int64_t current) -> TaskSnapshot {
+  TaskSnapshot snapshot;
+  snapshot.task_id = "task_1";
+  snapshot.type = "gallery.scan";
+  snapshot.status = std::move(status);
+  snapshot.progress = core::tasks::TaskProgress{};
+  snapshot.progress->stage = "scan";
+  snapshot.progress->current = current;
+  return snapshot;
+}
+
+}  // namespace
+
+// 间隔内的中间进度只挂一个定时刷新，到期时发出最新的一份
+TEST_CASE("task updates coalesce progress within the emit interval") {
+  core::tasks::TaskState task_state;
+  const auto start = std::chrono::steady_clock::now();
+
+  auto plan = throttle::plan_update(task_state, make_snapshot("running", 0), false, true, start);
+  CHECK(plan.action == UpdateAction::PostFlush);
+  CHECK(throttle::take_pending_update(task_state, "task_1", false, start)->progress->current == 0);
+
+  plan = throttle::plan_update(task_state, make_snapshot("running", 1), true, true, start + 10ms);
+  CHECK(plan.action == UpdateAction::ScheduleFlush);
+  CHECK(plan.delay == 90ms);
+  for (std::int64_t current = 2; current <= 9; ++current) {
+    plan = throttle::plan_update(task_state, make_snapshot("running", current), true, true,
+                                 start + current * 10ms);
+    CHECK(plan.action == UpdateAction::Coalesced);
+  }
+  CHECK(task_state.pending_updates.size() == 1);
+
+  auto flushed = throttle::take_pending_update(task_state, "task_1", true, start + 100ms);
+  REQUIRE(flushed.has_value());
+  CHECK(flushed->progress->current == 9);
+  CHECK_FALSE(task_state.emit_states["task_1"].flush_scheduled);
+  CHECK_FALSE(throttle::take_pending_update(task_state, "task_1", false, start + 100ms)
+                  .has_value());
+
+  // 上一轮在 100ms 发出，新一轮从这里重新计时
+  plan = throttle::plan_update(task_state, make_snapshot("running", 10), true, true, start + 150ms);
+  CHECK(plan.action == UpdateAction::ScheduleFlush);
+  CHECK(plan.delay == 50ms);
+}
+
+// 间隔已过的进度立即发出，不等定时器
+TEST_CASE("task updates emit progress immediately once the interval has passed") {
+  core::tasks::TaskState task_state;
+  const auto start = std::chrono::steady_clock::now();
+
+  CHECK(throttle::plan_update(task_state, make_snapshot("running", 0), false, true, start).action ==
+        UpdateAction::PostFlush);
+  CHECK(throttle::plan_update(task_state, make_snapshot("running", 1), true, true, start + 150ms)
+            .action == UpdateAction::PostFlush);
+}
+
+// 终态不受节流，立即投递并覆盖未发出的中间进度；之后到期的定时器没有可发内容
+TEST_CASE("task updates flush terminal status immediately") {
+  core::tasks::TaskState task_state;
+  const auto start = std::chrono::steady_clock::now();
+
+  (void)throttle::plan_update(task_state, make_snapshot("running", 0), false, true, start);
+  (void)throttle::take_pending_update(task_state, "task_1", false, start);
+  CHECK(throttle::plan_update(task_state, make_snapshot("running", 5), true, true, start + 10ms)
+            .action == UpdateAction::ScheduleFlush);
+
+  auto plan =
+      throttle::plan_update(task_state, make_snapshot("succeeded", 5), false, true, start + 20ms);
+  CHECK(plan.action == UpdateAction::PostFlush);
+
+  auto flushed = throttle::take_pending_update(task_state, "task_1", false, start + 20ms);
+  REQUIRE(flushed.has_value());
+  CHECK(flushed->status == "succeeded");
+  CHECK_FALSE(
+      throttle::take_pending_update(task_state, "task_1", true, start + 100ms).has_value());
+}
+
+// 没有异步运行时：中间进度丢弃，状态变化要求调用方同步发出
+TEST_CASE("task updates without an async runtime emit synchronously") {
+  core::tasks::TaskState task_state;
+  const auto start = std::chrono::steady_clock::now();
+
+  CHECK(throttle::plan_update(task_state, make_snapshot("running", 0), false, false, start)
+            .action == UpdateAction::EmitNow);
+  CHECK(throttle::plan_update(task_state, make_snapshot("running", 1), true, false, start + 10ms)
+            .action == UpdateAction::Dropped);
+  CHECK(throttle::plan_update(task_state, make_snapshot("failed", 1), false, false, start + 20ms)
+            .action == UpdateAction::EmitNow);
+  CHECK(task_state.pending_updates.empty());
+}
@@ -0,0 +1,72 @@
+#include "vendor/std.hpp"
+
+#include "vendor/doctest.hpp"
+
+#include "core/tracing/tracing.hpp"
+
+namespace tracing = core::tracing;
+
+namespace {
+
+auto count_occurrences(std::string_view text, std::string_view needle) -> std::size_t {
+  std::size_t count = 0;
+  for (auto pos = text.find(needle); pos != std::string_view::npos;
+       pos = text.find(needle, pos + needle.size())) {
+    ++count;
+  }
+  return count;
+}
+
+}  // namespace
+
+TEST_CASE("spans are only recorded while tracing is on") {
+  tracing::set_recording(false);
+  { tracing::Span span("ignored_span", "test"); }
+
+  tracing::set_recording(true);
+  tracing::set_thread_name("test \"main\"");
+  { tracing::Span span("recorded_span", "test"); }
+  tracing::set_recording(false);
+
+  const auto json = tracing::write_chrome_trace();
+  CHECK(json.find("ignored_span") == std::string::npos);
+  CHECK(count_occurrences(json, "\"name\":\"recorded_span\",\"cat\":\"test\",\"ph\":\"X\"") == 1);
+  CHECK(json.find(R"("args":{"name":"test \"main\""})") != std::string::npos);
+}
+
+TEST_CASE("async spans are exported as begin and end events on any thread") {
+  tracing::set_recording(true);
+  std::thread([] { tracing::Span span("async_span", "test", true); }).join();
+  tracing::set_recording(false);
+
+  const auto json = tracing::write_chrome_trace();
+  CHECK(count_occurrences(json, "\"name\":\"async_span\",\"cat\":\"test\",\"ph\":\"b\"") == 1);
+  CHECK(count_occurrences(json, "\"name\":\"async_span\",\"cat\":\"test\",\"ph\":\"e\"") == 1);
+}
+
+TEST_CASE("restarting tracing clears earlier events and the ring keeps the newest") {
+  tracing::set_recording(true);
+  { tracing::Span span("stale_span", "test"); }
+  tracing::set_recording(false);
+
+  tracing::set_recording(true);
+  const auto start = std::chrono::steady_clock::now();
+  tracing::record_span("old_span", "test", start, start);
+  for (std::size_t i = 0; i < tracing::kThreadBufferCapacity; ++i) {
+    tracing::record_span("new_span", "test", start, start);
+  }
+  tracing::set_recording(false);
+
+  const auto json = tracing::write_chrome_trace();
+  CHECK(json.find("stale_span") == std::string::npos);
+  CHECK(json.find("old_span") == std::string::npos);
+  CHECK(count_occurrences(json, "\"name\":\"new_span\"") == tracing::kThreadBufferCapacity);
+  CHECK(json.ends_with("\n]}\n"));
+}
+
+TEST_CASE("interned names are stable and shared") {
+  const auto* first = tracing::intern_name(std::string("gallery.scan"));
+  const auto* second = tracing::intern_name("gallery.scan");
+  CHECK(first == second);
+  CHECK(std::string_view(first) == "gallery.scan");
+}
@@ -0,0 +1,122 @@
+#include "vendor/std.hpp"
+
+#include "vendor/doctest.hpp"
+
+#include "core/worker_pool/parallel.hpp"
+#include "core/worker_pool/state.hpp"
+#include "core/worker_pool/worker_pool.hpp"
+
+namespace worker_pool = core::worker_pool;
+
+namespace {
+
+struct RunningPool {
+  worker_pool::WorkerPoolState state;
+
+  explicit RunningPool(std::size_t thread_count) {
+    REQUIRE(worker_pool::start_pool(state, thread_count).has_value());
+  }
+  ~RunningPool() { worker_pool::stop_pool(state); }
+};
+
+auto sum_locals(const std::vector<std::uint64_t>& locals) -> std::uint64_t {
+  return std::accumulate(locals.begin(), locals.end(), std::uint64_t{0});
+}
+
+}  // namespace
+
+TEST_CASE("parallel_collect visits every element once and merges per-participant results") {
+  RunningPool pool(4);
+  constexpr std::size_t kCount = 100'003;
+  std::vector<std::atomic<int>> visits(kCount);
+
+  const auto locals = worker_pool::parallel_collect<std::uint64_t>(
+      &pool.state, kCount, {.grain = 97},
+      [&visits](std::size_t begin, std::size_t end, std::uint64_t& local) {
+        for (auto i = begin; i < end; ++i) {
+          visits[i].fetch_add(1);
+          local += i;
+        }
+      });
+
+  CHECK(locals.size() <= 5);
+  CHECK(sum_locals(locals) == std::uint64_t{kCount} * (kCount - 1) / 2);
+  CHECK(std::ranges::all_of(visits, [](const auto& count) { return count.load() == 1; }));
+}
+
+// 没有线程池或线程池未运行时由调用线程串行完成
+TEST_CASE("parallel_collect runs serially without a running pool") {
+  worker_pool::WorkerPoolState stopped;
+  for (auto* pool : {static_cast<worker_pool::WorkerPoolState*>(nullptr), &stopped}) {
+    const auto locals = worker_pool::parallel_collect<std::uint64_t>(
+        pool, 10, {.grain = 3},
+        [](std::size_t begin, std::size_t end, std::uint64_t& local) { local += end - begin; });
+    REQUIRE(locals.size() == 1);
+    CHECK(locals[0] == 10);
+  }
+}
+
+TEST_CASE("parallel_for rethrows the first exception after all participants finish") {
+  RunningPool pool(3);
+  std::atomic<int> started{0};
+  CHECK_THROWS_AS(worker_pool::parallel_for(&pool.state, 1000, {.grain = 1},
+                                            [&started](std::size_t begin, std::size_t) {
+                                              started.fetch_add(1);
+                                              if (begin == 10) {
+                                                throw std::runtime_error("boom");
+                                              }
+                                            }),
+                  std::runtime_error);
+  // 失败后其余参与者不再认领新块
+  CHECK(started.load() < 1000);
+}
+
+TEST_CASE("parallel_for stops claiming work after cancellation") {
+  RunningPool pool(2);
+  std::stop_source stop_source;
+  std::atomic<int> processed{0};
+  worker_pool::parallel_for(&pool.state, 1000,
+                            {.grain = 1, .stop_token = stop_source.get_token()},
+                            [&](std::size_t begin, std::size_t) {
+                              processed.fetch_add(1);
+                              if (begin == 5) {
+                                stop_source.request_stop();
+                              }
+                            });
+  CHECK(processed.load() < 1000);
+}
+
+// 唯一的工作线程在任务内嵌套并行时由自己完成全部工作，不会等待自己
+TEST_CASE("nested parallel_for on a single worker does not deadlock") {
+  RunningPool pool(1);
+  std::atomic<int> inner_total{0};
+  worker_pool::parallel_for(&pool.state, 8, {}, [&](std::size_t, std::size_t) {
+    worker_pool::parallel_for(&pool.state, 16, {}, [&](std::size_t begin, std::size_t end) {
+      inner_total.fetch_add(static_cast<int>(end - begin));
+    });
+  });
+  CHECK(inner_total.load() == 8 * 16);
+}
+
+TEST_CASE("task group and when_all run heterogeneous tasks") {
+  RunningPool pool(2);
+
+  std::atomic<int> done{0};
+  {
+    worker_pool::TaskGroup group(&pool.state);
+    for (int i = 0; i < 50; ++i) {
+      worker_pool::run(group, [&done] { done.fetch_add(1); });
+    }
+    worker_pool::wait(group);
+  }
+  CHECK(done.load() == 50);
+
+  worker_pool::TaskGroup failing(&pool.state);
+  worker_pool::run(failing, [] { throw std::logic_error("bad"); });
+  CHECK_THROWS_AS(worker_pool::wait(failing), std::logic_error);
+
+  auto [number, text] = worker_pool::when_all(
+      &pool.state, {}, [] { return 42; }, [] { return std::string("ok"); });
+  CHECK(number == 42);
+  CHECK(text == "ok");
+}
@@ -0,0 +1,84 @@
+#include "vendor/std.hpp"
+
+#include "vendor/doctest.hpp"
+
+#include "core/worker_pool/state.hpp"
+#include "core/worker_pool/worker_pool.hpp"
+
+namespace worker_pool = core::worker_pool;
+
+// 工作线程内提交的子任务走本线程队列，空闲线程需要把它们窃取过去
+TEST_CASE("worker pool runs nested tasks across threads") {
+  worker_pool::WorkerPoolState pool;
+  REQUIRE(worker_pool::start_pool(pool, 4).has_value());
+
+  constexpr int kParents = 64;
+  constexpr int kChildren = 64;
+  std::latch done(kParents * kChildren);
+  std::atomic<int> executed{0};
+  for (int parent = 0; parent < kParents; ++parent) {
+    REQUIRE(worker_pool::submit_to_pool(pool, [&pool, &done, &executed] {
+      for (int child = 0; child < kChildren; ++child) {
+        const auto submitted = worker_pool::submit_to_pool(pool, [&done, &executed] {
+          executed.fetch_add(1);
+          done.count_down();
+        });
+        if (!submitted) {
+          done.count_down();
+        }
+      }
+    }));
+  }
+
+  done.wait();
+  CHECK(executed.load() == kParents * kChildren);
+  worker_pool::stop_pool(pool);
+  CHECK(pool.queued_tasks.load() == 0);
+  CHECK(pool.tag_counters[0].completed.load() == kParents + kParents * kChildren);
+}
+
+TEST_CASE("worker pool runs higher priority tasks first") {
+  worker_pool::WorkerPoolState pool;
+  REQUIRE(worker_pool::start_pool(pool, 1).has_value());
+
+  // 先占住唯一的工作线程，再按低到高的优先级入队
+  std::promise<void> release;
+  auto released = release.get_future().share();
+  std::latch blocked(1);
+  REQUIRE(worker_pool::submit_to_pool(pool, [released, &blocked] {
+    blocked.count_down();
+    released.wait();
+  }));
+  blocked.wait();
+
+  std::mutex order_mutex;
+  std::vector<worker_pool::TaskPriority> order;
+  for (auto priority : {worker_pool::TaskPriority::Background, worker_pool::TaskPriority::Normal,
+                        worker_pool::TaskPriority::Interactive}) {
+    REQUIRE(worker_pool::submit_to_pool(
+        pool,
+        [&order_mutex, &order, priority] {
+          std::lock_guard lock(order_mutex);
+          order.push_back(priority);
+        },
+        {.priority = priority, .tag = worker_pool::TaskTag::GalleryScan}));
+  }
+
+  release.set_value();
+  worker_pool::stop_pool(pool);
+
+  REQUIRE(order.size() == 3);
+  CHECK(order[0] == worker_pool::TaskPriority::Interactive);
+  CHECK(order[1] == worker_pool::TaskPriority::Normal);
+  CHECK(order[2] == worker_pool::TaskPriority::Background);
+  const auto scan_tag = static_cast<std::size_t>(worker_pool::TaskTag::GalleryScan);
+  CHECK(pool.tag_counters[scan_tag].submitted.load() == 3);
+  CHECK(pool.tag_counters[scan_tag].completed.load() == 3);
+}
+
+TEST_CASE("worker pool rejects tasks after stop") {
+  worker_pool::WorkerPoolState pool;
+  REQUIRE(worker_pool::start_pool(pool, 2).has_value());
+  worker_pool::stop_pool(pool);
+  CHECK_FALSE(worker_pool::submit_to_pool(pool, [] {}));
+}
@@ -0,0 +1,168 @@
+#include "vendor/std.hpp"
+
+#include "vendor/doctest.hpp"
+
+#include "features/gallery/layout/justified.hpp"
+
+using features::gallery::AssetLayoutMetaItem;
+using features::gallery::layout::CachedLayout;
+using features::gallery::layout::compute_justified_layout;
+using features::gallery::layout::find_cached_layout;
+using features::gallery::layout::find_rows_in_range;
+using features::gallery::layout::kMaxCachedLayouts;
+using features::gallery::layout::LayoutCache;
+using features::gallery::layout::LayoutOptions;
+using features::gallery::layout::LayoutQueryKey;
+using features::gallery::layout::store_cached_layout;
+
+namespace {
+
+const LayoutQueryKey kQueryKey{.query_id = "created_at-desc", .generation = 7};
+
+auto make_cached_layout(std::string layout_id, LayoutQueryKey query_key = kQueryKey)
+    -> CachedLayout {
+  CachedLayout entry;
+  entry.layout_id = std::move(layout_id);
+  entry.query_key = std::move(query_key);
+  return entry;
+}
+
+auto make_items(std::size_t count) -> std::vector<AssetLayoutMetaItem> {
+  std::vector<AssetLayoutMetaItem> items;
+  for (std::size_t i = 0; i < count; ++i) {
+    // 横图、竖图、方图和缺失尺寸交替出现
+    switch (i % 4) {
+      case 0:
+        items.push_back({.id = static_cast<std::int64_t>(i + 1), .width = 1920, .height = 1080});
+        break;
+      case 1:
+        items.push_back({.id = static_cast<std::int64_t>(i + 1), .width = 1080, .height = 1920});
+        break;
+      case 2:
+        items.push_back({.id = static_cast<std::int64_t>(i + 1), .width = 800, .height = 800});
+        break;
+      default:
+        items.push_back(
+            {.id = static_cast<std::int64_t>(i + 1), .width = std::nullopt, .height = 0});
+        break;
+    }
+  }
+  return items;
+}
+
+}  // namespace
+
+// 除最后一行外，每行宽度加间距必须逐像素等于容器宽度
+TEST_CASE("justified layout fills every row except the last") {
+  const auto items = make_items(1000);
+  const LayoutOptions options{.container_width = 1237, .target_row_height = 220, .gap = 12};
+  const auto layout = compute_justified_layout(items, options);
+
+  REQUIRE(layout.item_widths.size() == items.size());
+  REQUIRE(layout.rows.size() > 1);
+
+  std::size_t next_item = 0;
+  std::int64_t next_top = 0;
+  for (std::size_t row_index = 0; row_index < layout.rows.size(); ++row_index) {
+    const auto& row = layout.rows[row_index];
+    CHECK(row.first_item == next_item);
+    CHECK(row.top == next_top);
+
+    std::int64_t row_width = static_cast<std::int64_t>(row.item_count - 1) * options.gap;
+    for (auto i = row.first_item; i < row.first_item + row.item_count; ++i) {
+      row_width += layout.item_widths[i];
+    }
+
+    if (row_index + 1 < layout.rows.size()) {
+      CHECK(row_width == options.container_width);
+    } else {
+      CHECK(row.height <= options.target_row_height);
+      CHECK(row_width <= options.container_width);
+    }
+    next_item += row.item_count;
+    next_top += row.height + options.gap;
+  }
+
+  CHECK(next_item == items.size());
+  CHECK(layout.total_height == layout.rows.back().top + layout.rows.back().height);
+}
+
+// 二分得到的窗口与逐行判断相交的结果一致
+TEST_CASE("justified layout window query matches a linear scan") {
+  const auto items = make_items(500);
+  const auto layout = compute_justified_layout(
+      items, {.container_width = 900, .target_row_height = 180, .gap = 8});
+
+  const std::array<std::int64_t, 5> offsets{0, 1, 187, 5000, layout.total_height - 1};
+  for (const auto offset : offsets) {
+    for (std::int64_t height : {0, 1, 600, 100000}) {
+      std::size_t expected_first = layout.rows.size();
+      std::size_t expected_last = layout.rows.size();
+      for (std::size_t i = 0; i < layout.rows.size(); ++i) {
+        const auto& row = layout.rows[i];
+        const bool intersects = row.top < offset + height && row.top + row.height > offset;
+        if (intersects && expected_first == layout.rows.size()) {
+          expected_first = i;
+        }
+        if (intersects) {
+          expected_last = i + 1;
+        }
+      }
+
+      const auto [first, last] = find_rows_in_range(layout, offset, height);
+      if (expected_first == layout.rows.size()) {
+        CHECK(first == last);
+      } else {
+        CHECK(first == expected_first);
+        CHECK(last == expected_last);
+      }
+    }
+  }
+}
+
+TEST_CASE("justified layout handles empty input and invalid options") {
+  CHECK(compute_justified_layout({}, {.container_width = 800, .target_row_height = 200})
+            .rows.empty());
+
+  const auto items = make_items(3);
+  CHECK(compute_justified_layout(items, {.container_width = 0, .target_row_height = 200})
+            .rows.empty());
+}
+
+// 缓存按最近使用淘汰，命中会刷新位置
+TEST_CASE("layout cache evicts the least recently used entry") {
+  LayoutCache cache;
+  for (std::size_t i = 0; i < kMaxCachedLayouts; ++i) {
+    store_cached_layout(cache, make_cached_layout(std::to_string(i)));
+  }
+
+  REQUIRE(find_cached_layout(cache, "0", kQueryKey).has_value());
+  store_cached_layout(cache, make_cached_layout("new"));
+
+  CHECK(find_cached_layout(cache, "0", kQueryKey).has_value());
+  CHECK_FALSE(find_cached_layout(cache, "1", kQueryKey).has_value());
+  CHECK(find_cached_layout(cache, "new", kQueryKey).has_value());
+  CHECK(cache.entries.size() == kMaxCachedLayouts);
+}
+
+// 客户端带着旧 layout_id 换了筛选排序，或图库在两次请求之间有写入，都不能命中旧布局
+TEST_CASE("layout cache rejects stale hits after the query or gallery changes") {
+  LayoutCache cache;
+  store_cached_layout(cache, make_cached_layout("layout"));
+  REQUIRE(find_cached_layout(cache, "layout", kQueryKey).has_value());
+
+  const LayoutQueryKey other_sort{.query_id = "created_at-asc", .generation = 7};
+  CHECK_FALSE(find_cached_layout(cache, "layout", other_sort).has_value());
+  // 不一致的项已被移除，原条件也不会再拿到它
+  CHECK_FALSE(find_cached_layout(cache, "layout", kQueryKey).has_value());
+  CHECK(cache.entries.empty());
+
+  store_cached_layout(cache, make_cached_layout("layout"));
+  const LayoutQueryKey newer_gallery{.query_id = kQueryKey.query_id, .generation = 8};
+  CHECK_FALSE(find_cached_layout(cache, "layout", newer_gallery).has_value());
+
+  // 重新排版后以新游标写回，之后按新游标命中
+  store_cached_layout(cache, make_cached_layout("layout", newer_gallery));
+  CHECK(find_cached_layout(cache, "layout", newer_gallery).has_value());
+  CHECK_FALSE(find_cached_layout(cache, "layout", kQueryKey).has_value());
+}
@@ -0,0 +1,71 @@
+#include "vendor/std.hpp"
+
+#include "vendor/doctest.hpp"
+
+#include "features/gallery/similarity/index.hpp"
+
+using features::gallery::similarity::index::build_index;
+using features::gallery::similarity::index::find_within_distance;
+using features::gallery::similarity::index::group_near_duplicates;
+using features::gallery::similarity::index::HashEntry;
+
+// BK-tree 剪枝后的结果必须与线性扫描完全一致
+TEST_CASE("hamming index returns the same matches as a linear scan") {
+  std::vector<HashEntry> entries;
+  std::uint64_t state = 0x9E3779B97F4A7C15ull;
+  for (std::int64_t id = 1; id <= 2000; ++id) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    // 每 10 个资产共享一个基准 hash 并翻转少量比特，模拟连拍
+    auto base = id % 10 == 1 ? state : entries.back().hash;
+    entries.push_back(HashEntry{.asset_id = id, .hash = base ^ (1ull << (id % 64))});
+  }
+
+  const auto index = build_index(entries);
+  for (std::int64_t probe : {1, 17, 503, 1999}) {
+    const auto query_hash = entries[static_cast<std::size_t>(probe - 1)].hash;
+    for (int max_distance : {0, 3, 8}) {
+      std::vector<std::int64_t> expected;
+      for (const auto& entry : entries) {
+        if (std::popcount(entry.hash ^ query_hash) <= max_distance) {
+          expected.push_back(entry.asset_id);
+        }
+      }
+
+      std::vector<std::int64_t> actual;
+      for (const auto& match : find_within_distance(index, query_hash, max_distance)) {
+        actual.push_back(match.asset_id);
+      }
+      std::ranges::sort(actual);
+      CHECK(actual == expected);
+    }
+  }
+}
+
+// 相同 hash 的资产共享节点，距离为零时也要全部返回
+TEST_CASE("hamming index keeps every asset that shares a hash") {
+  const auto index = build_index({{.asset_id = 3, .hash = 42}, {.asset_id = 1, .hash = 42}});
+  const auto matches = find_within_distance(index, 42, 0);
+
+  REQUIRE(matches.size() == 2);
+  CHECK(matches[0].asset_id == 1);
+  CHECK(matches[1].asset_id == 3);
+  CHECK(matches[0].distance == 0);
+}
+
+// 分组按距离阈值传递相连，孤立资产不输出
+TEST_CASE("near duplicate groups are transitive and skip singletons") {
+  const auto groups = group_near_duplicates(
+      {
+          {.asset_id = 1, .hash = 0b0000},
+          {.asset_id = 2, .hash = 0b0001},
+          {.asset_id = 3, .hash = 0b0011},
+          {.asset_id = 4, .hash = ~0ull},
+      },
+      1);
+
+  const std::vector<std::int64_t> expected_group{1, 2, 3};
+  REQUIRE(groups.size() == 1);
+  CHECK(groups[0] == expected_group);
+}
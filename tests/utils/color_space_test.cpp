@@ -0,0 +1,72 @@
+#include "vendor/std.hpp"
+
+#include "vendor/doctest.hpp"
+
+#include "utils/image/color_space.hpp"
+
+using utils::image::bgra_to_lab_planes;
+using utils::image::kBatchLabMaxError;
+using utils::image::rgb_to_lab_color;
+
+// 按步长覆盖 RGB 立方体，末端补齐 255，保证边界值也参与比较
+auto build_strided_bgra_cube(int step) -> std::vector<std::uint8_t> {
+  std::vector<int> levels;
+  for (int value = 0; value < 256; value += step) {
+    levels.push_back(value);
+  }
+  if (levels.back() != 255) {
+    levels.push_back(255);
+  }
+
+  std::vector<std::uint8_t> pixels;
+  for (int r : levels) {
+    for (int g : levels) {
+      for (int b : levels) {
+        pixels.insert(pixels.end(), {static_cast<std::uint8_t>(b), static_cast<std::uint8_t>(g),
+                                     static_cast<std::uint8_t>(r), 255});
+      }
+    }
+  }
+  return pixels;
+}
+
+// 批量 SIMD 路径与逐像素标量路径的误差必须落在公开容差内
+TEST_CASE("batch Lab conversion matches scalar conversion within tolerance") {
+  const auto pixels = build_strided_bgra_cube(3);
+  const auto pixel_count = pixels.size() / 4;
+  std::vector<float> l_plane(pixel_count);
+  std::vector<float> a_plane(pixel_count);
+  std::vector<float> b_plane(pixel_count);
+
+  bgra_to_lab_planes(pixels, l_plane, a_plane, b_plane);
+
+  float max_error = 0.0f;
+  for (std::size_t i = 0; i < pixel_count; ++i) {
+    const auto expected = rgb_to_lab_color(pixels[i * 4 + 2], pixels[i * 4 + 1], pixels[i * 4]);
+    max_error = std::max({max_error, std::abs(expected.l - l_plane[i]),
+                          std::abs(expected.a - a_plane[i]), std::abs(expected.b - b_plane[i])});
+  }
+  CHECK(max_error <= kBatchLabMaxError);
+}
+
+// 不足一个 SIMD 块的尾部像素同样要转换，且不能越界写入输出
+TEST_CASE("batch Lab conversion handles tail pixels without overrunning outputs") {
+  const std::vector<std::uint8_t> pixels = {
+      0, 0, 0, 255, 255, 255, 255, 255, 0, 0, 255, 255, 0, 255, 0, 255, 255, 0, 0, 255,
+  };
+  std::vector<float> l_plane(6, -1.0f);
+  std::vector<float> a_plane(6, -1.0f);
+  std::vector<float> b_plane(6, -1.0f);
+
+  bgra_to_lab_planes(pixels, std::span(l_plane).first(5), std::span(a_plane).first(5),
+                     std::span(b_plane).first(5));
+
+  const auto red = rgb_to_lab_color(255, 0, 0);
+  CHECK(l_plane[2] == doctest::Approx(red.l).epsilon(0.0001));
+  CHECK(a_plane[2] == doctest::Approx(red.a).epsilon(0.0001));
+  CHECK(l_plane[1] == doctest::Approx(100.0f).epsilon(0.0001));
+  CHECK(std::abs(l_plane[0]) <= kBatchLabMaxError);
+  CHECK(l_plane[5] == -1.0f);
+  CHECK(a_plane[5] == -1.0f);
+  CHECK(b_plane[5] == -1.0f);
+}
@@ -0,0 +1,122 @@
+#include "vendor/std.hpp"
+
+#include "vendor/doctest.hpp"
+
+#include "utils/image/palette.hpp"
+
+using utils::image::build_lab_palette;
+using utils::image::cluster_lab_points;
+using utils::image::PaletteColor;
+using utils::image::PaletteEngine;
+
+struct Patch {
+  std::uint8_t r;
+  std::uint8_t g;
+  std::uint8_t b;
+  std::size_t pixel_count;
+};
+
+// 按色块生成紧排 BGRA 采样像素，每个通道叠加固定序列的 ±noise 扰动
+auto build_noisy_patches(const std::vector<Patch>& patches, int noise)
+    -> std::vector<std::uint8_t> {
+  std::uint32_t state = 0x12345678u;
+  auto jitter = [&](std::uint8_t value) {
+    state = state * 1664525u + 1013904223u;
+    auto offset = static_cast<int>(state >> 24) % (noise * 2 + 1) - noise;
+    return static_cast<std::uint8_t>(std::clamp(static_cast<int>(value) + offset, 0, 255));
+  };
+
+  std::vector<std::uint8_t> pixels;
+  for (const auto& patch : patches) {
+    for (std::size_t i = 0; i < patch.pixel_count; ++i) {
+      pixels.insert(pixels.end(), {jitter(patch.b), jitter(patch.g), jitter(patch.r), 255});
+    }
+  }
+  return pixels;
+}
+
+auto delta_e_76(const PaletteColor& lhs, const PaletteColor& rhs) -> float {
+  float dl = lhs.lab.l - rhs.lab.l;
+  float da = lhs.lab.a - rhs.lab.a;
+  float db = lhs.lab.b - rhs.lab.b;
+  return std::sqrt(dl * dl + da * da + db * db);
+}
+
+// 簇数与色块数相同时，直方图引擎与 dkm K-Means 应还原出同样的色块和占比
+TEST_CASE("histogram palette agrees with k-means palette on separated patches") {
+  const std::vector<Patch> patches = {
+      {90, 150, 220, 3200}, {60, 140, 60, 2400}, {230, 190, 160, 1600}, {30, 30, 40, 800}};
+  const auto pixels = build_noisy_patches(patches, 12);
+
+  auto kmeans = build_lab_palette(pixels, patches.size(), PaletteEngine::KMeans);
+  auto histogram = build_lab_palette(pixels, patches.size(), PaletteEngine::Histogram);
+  REQUIRE(kmeans.has_value());
+  REQUIRE(histogram.has_value());
+  REQUIRE(kmeans->size() == patches.size());
+  REQUIRE(histogram->size() == patches.size());
+
+  // 两边都按权重降序，色块占比互不相同，因此可以逐项比较
+  for (std::size_t i = 0; i < patches.size(); ++i) {
+    const auto& expected = kmeans.value()[i];
+    const auto& actual = histogram.value()[i];
+    CHECK(actual.weight == doctest::Approx(expected.weight).epsilon(0.01));
+    CHECK(delta_e_76(actual, expected) < 1.0f);
+    CHECK(std::abs(actual.rgb.r - patches[i].r) <= 2);
+    CHECK(std::abs(actual.rgb.g - patches[i].g) <= 2);
+    CHECK(std::abs(actual.rgb.b - patches[i].b) <= 2);
+  }
+}
+
+// 调色板按权重降序，权重合计为 1
+TEST_CASE("histogram palette weights are normalized and sorted") {
+  const auto pixels =
+      build_noisy_patches({{200, 40, 40, 500}, {40, 200, 40, 300}, {40, 40, 200, 200}}, 4);
+
+  auto palette = build_lab_palette(pixels, 3, PaletteEngine::Histogram);
+  REQUIRE(palette.has_value());
+  REQUIRE(palette->size() == 3);
+
+  float total = 0.0f;
+  for (const auto& color : palette.value()) {
+    total += color.weight;
+  }
+  CHECK(total == doctest::Approx(1.0f));
+  CHECK(std::ranges::is_sorted(palette.value(), std::ranges::greater{}, &PaletteColor::weight));
+  CHECK(palette->front().weight == doctest::Approx(0.5f));
+  CHECK(palette->back().weight == doctest::Approx(0.2f));
+}
+
+// 单色输入只产生一个簇，簇数超过非空 bin 时不会出现空簇
+TEST_CASE("histogram clustering collapses identical points") {
+  const std::vector<std::array<float, 3>> points(100, {50.0f, 10.0f, -20.0f});
+
+  auto labels = cluster_lab_points(points, 8, PaletteEngine::Histogram);
+  REQUIRE(labels.has_value());
+  CHECK(labels->size() == points.size());
+  CHECK(std::ranges::all_of(labels.value(), [](std::size_t label) { return label == 0; }));
+
+  auto palette = build_lab_palette(build_noisy_patches({{120, 80, 40, 64}}, 0), 8,
+                                   PaletteEngine::Histogram);
+  REQUIRE(palette.has_value());
+  REQUIRE(palette->size() == 1);
+  CHECK(palette->front().rgb.r == 120);
+  CHECK(palette->front().weight == doctest::Approx(1.0f));
+}
+
+// 相同输入多次运行结果一致，空输入返回错误
+TEST_CASE("histogram clustering is deterministic and rejects empty input") {
+  const auto pixels = build_noisy_patches({{10, 90, 160, 700}, {240, 220, 30, 300}}, 20);
+
+  auto first = build_lab_palette(pixels, 6, PaletteEngine::Histogram);
+  auto second = build_lab_palette(pixels, 6, PaletteEngine::Histogram);
+  REQUIRE(first.has_value());
+  REQUIRE(second.has_value());
+  REQUIRE(first->size() == second->size());
+  for (std::size_t i = 0; i < first->size(); ++i) {
+    CHECK(first.value()[i].weight == second.value()[i].weight);
+    CHECK(first.value()[i].lab.l == second.value()[i].lab.l);
+  }
+
+  CHECK_FALSE(build_lab_palette({}, 8, PaletteEngine::Histogram).has_value());
+  CHECK_FALSE(cluster_lab_points({}, 8, PaletteEngine::Histogram).has_value());
+}
@@ -0,0 +1,53 @@
+#include "vendor/std.hpp"
+
+#include "vendor/doctest.hpp"
+
+#include "utils/image/perceptual_hash.hpp"
+
+using utils::image::compute_difference_hash;
+using utils::image::hamming_distance;
+
+auto build_horizontal_gradient(std::uint32_t width, std::uint32_t height, bool ascending)
+    -> std::vector<std::uint8_t> {
+  std::vector<std::uint8_t> pixels(static_cast<std::size_t>(width) * height * 4);
+  for (std::uint32_t y = 0; y < height; ++y) {
+    for (std::uint32_t x = 0; x < width; ++x) {
+      auto value = static_cast<std::uint8_t>(x * 255 / (width - 1));
+      if (!ascending) value = static_cast<std::uint8_t>(255 - value);
+      auto* pixel = pixels.data() + (static_cast<std::size_t>(y) * width + x) * 4;
+      pixel[0] = value;
+      pixel[1] = value;
+      pixel[2] = value;
+      pixel[3] = 255;
+    }
+  }
+  return pixels;
+}
+
+// 持久化的 dHash 依赖固定比特布局：左亮于右记 1，行优先
+TEST_CASE("difference hash encodes left-brighter comparisons row by row") {
+  const auto descending = build_horizontal_gradient(90, 80, false);
+  const auto ascending = build_horizontal_gradient(90, 80, true);
+
+  CHECK(compute_difference_hash(descending, 90, 80, 90 * 4) == ~0ull);
+  CHECK(compute_difference_hash(ascending, 90, 80, 90 * 4) == 0ull);
+}
+
+// 同一画面的不同缩放尺寸应得到相同或极近的 hash
+TEST_CASE("difference hash is stable across thumbnail sizes") {
+  const auto small = build_horizontal_gradient(45, 40, false);
+  const auto large = build_horizontal_gradient(480, 427, false);
+
+  auto small_hash = compute_difference_hash(small, 45, 40, 45 * 4);
+  auto large_hash = compute_difference_hash(large, 480, 427, 480 * 4);
+  REQUIRE(small_hash.has_value());
+  REQUIRE(large_hash.has_value());
+  CHECK(hamming_distance(*small_hash, *large_hash) == 0);
+}
+
+// 尺寸不足 9x8 或缓冲区不完整时拒绝计算，避免写入无意义的 hash
+TEST_CASE("difference hash rejects undersized bitmaps") {
+  const auto pixels = build_horizontal_gradient(8, 8, true);
+  CHECK_FALSE(compute_difference_hash(pixels, 8, 8, 8 * 4).has_value());
+  CHECK_FALSE(compute_difference_hash(pixels, 9, 8, 9 * 4).has_value());
+}
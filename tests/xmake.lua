@@ -1,4 +1,5 @@
-add_requires("vcpkg::doctest", "vcpkg::spdlog")
+add_requires("vcpkg::doctest", "vcpkg::spdlog", "vcpkg::asio", "vcpkg::reflectcpp", "vcpkg::sqlitecpp",
+             "vcpkg::wil", "vcpkg::xxhash")
 
 target("SpinningMomoTests")
     set_kind("binary")
@@ -9,18 +10,58 @@ target("SpinningMomoTests")
     add_defines("NOMINMAX", "UNICODE", "_UNICODE", "WIN32_LEAN_AND_MEAN",
                 "_WIN32_WINNT=0x0A00", "SPDLOG_COMPILED_LIB")
     add_includedirs("../src")
+    add_includedirs("../third_party/dkm/include")
 
+    add_files("../src/core/executor_metrics/executor_metrics.cpp")
+    add_files("../src/core/http_server/compression.cpp")
+    add_files("../src/core/http_server/file_cache.cpp")
+    add_files("../src/core/http_server/sse_queue.cpp")
+    add_files("../src/core/http_server/thumbnail_batch_format.cpp")
+    add_files("../src/core/http_server/websocket_queue.cpp")
+    add_files("../src/core/rpc/cancellation.cpp")
+    add_files("../src/core/rpc/columnar.cpp")
+    add_files("../src/core/rpc/metrics.cpp")
+    add_files("../src/core/rpc/single_flight.cpp")
+    add_files("../src/core/tasks/throttle.cpp")
+    add_files("../src/core/tracing/tracing.cpp")
+    add_files("../src/core/worker_pool/parallel.cpp")
+    add_files("../src/core/worker_pool/worker_pool.cpp")
     add_files("../src/features/recording/time.cpp")
     add_files("../src/features/gallery/ignore/matcher.cpp")
+    add_files("../src/features/gallery/layout/justified.cpp")
+    add_files("../src/features/gallery/similarity/index.cpp")
     add_files("../src/utils/logger/logger.cpp")
+    add_files("../src/utils/image/color_space.cpp")
+    add_files("../src/utils/image/palette.cpp")
+    add_files("../src/utils/image/perceptual_hash.cpp")
     add_files("../src/utils/path/path.cpp")
     add_files("test_main.cpp")
+    add_files("core/executor_metrics/executor_metrics_test.cpp")
+    add_files("core/http_server/compression_test.cpp")
+    add_files("core/http_server/file_cache_test.cpp")
+    add_files("core/http_server/sse_queue_test.cpp")
+    add_files("core/http_server/thumbnail_batch_test.cpp")
+    add_files("core/http_server/websocket_queue_test.cpp")
+    add_files("core/migration/schema_test.cpp")
+    add_files("core/rpc/cancellation_test.cpp")
+    add_files("core/rpc/columnar_test.cpp")
+    add_files("core/rpc/metrics_test.cpp")
+    add_files("core/rpc/single_flight_test.cpp")
+    add_files("core/tasks/throttle_test.cpp")
+    add_files("core/tracing/tracing_test.cpp")
+    add_files("core/worker_pool/parallel_test.cpp")
+    add_files("core/worker_pool/worker_pool_test.cpp")
     add_files("features/gallery/ignore/matcher_test.cpp")
+    add_files("features/gallery/layout/justified_test.cpp")
+    add_files("features/gallery/similarity/index_test.cpp")
     add_files("features/recording/time_test.cpp")
+    add_files("utils/color_space_test.cpp")
+    add_files("utils/palette_test.cpp")
     add_files("utils/path_test.cpp")
+    add_files("utils/perceptual_hash_test.cpp")
 
-    add_packages("vcpkg::doctest", "vcpkg::spdlog")
-    add_links("shell32", "ole32")
+    add_packages("vcpkg::doctest", "vcpkg::spdlog", "vcpkg::sqlitecpp")
+    add_links("shell32", "ole32", "sqlite3")
     add_tests("default")
 
 target("SpinningMomoScenarioWindow")
@@ -34,3 +75,93 @@ target("SpinningMomoScenarioWindow")
     add_includedirs("../src")
     add_files("scenarios/window/main.cpp")
     add_links("gdi32", "shell32", "user32")
+
+target("SpinningMomoBenchRpcJson")
+    set_kind("binary")
+    set_default(false)
+    set_plat("windows")
+    set_arch("x64")
+
+    add_defines("NOMINMAX", "UNICODE", "_UNICODE", "WIN32_LEAN_AND_MEAN",
+                "_WIN32_WINNT=0x0A00")
+    add_includedirs("../src")
+    add_files("benchmarks/rpc_json/main.cpp")
+    add_packages("vcpkg::asio", "vcpkg::reflectcpp")
+
+target("SpinningMomoBenchWorkerPool")
+    set_kind("binary")
+    set_default(false)
+    set_plat("windows")
+    set_arch("x64")
+
+    add_defines("NOMINMAX", "UNICODE", "_UNICODE", "WIN32_LEAN_AND_MEAN",
+                "_WIN32_WINNT=0x0A00", "SPDLOG_COMPILED_LIB")
+    add_includedirs("../src")
+    add_files("../src/core/executor_metrics/executor_metrics.cpp")
+    add_files("../src/core/rpc/metrics.cpp")
+    add_files("../src/core/tracing/tracing.cpp")
+    add_files("../src/core/worker_pool/worker_pool.cpp")
+    add_files("../src/utils/logger/logger.cpp")
+    add_files("../src/utils/path/path.cpp")
+    add_files("benchmarks/worker_pool/main.cpp")
+    add_packages("vcpkg::spdlog")
+    add_links("shell32", "ole32")
+
+target("SpinningMomoBenchColorSpace")
+    set_kind("binary")
+    set_default(false)
+    set_plat("windows")
+    set_arch("x64")
+
+    add_defines("NOMINMAX", "UNICODE", "_UNICODE", "WIN32_LEAN_AND_MEAN",
+                "_WIN32_WINNT=0x0A00")
+    add_includedirs("../src")
+    add_files("../src/utils/image/color_space.cpp")
+    add_files("benchmarks/color_space/main.cpp")
+
+target("SpinningMomoBenchPalette")
+    set_kind("binary")
+    set_default(false)
+    set_plat("windows")
+    set_arch("x64")
+
+    add_defines("NOMINMAX", "UNICODE", "_UNICODE", "WIN32_LEAN_AND_MEAN",
+                "_WIN32_WINNT=0x0A00")
+    add_includedirs("../src")
+    add_includedirs("../third_party/dkm/include")
+    add_files("../src/utils/image/color_space.cpp")
+    add_files("../src/utils/image/palette.cpp")
+    add_files("benchmarks/palette/main.cpp")
+
+target("SpinningMomoBenchFileHash")
+    set_kind("binary")
+    set_default(false)
+    set_plat("windows")
+    set_arch("x64")
+
+    add_defines("NOMINMAX", "UNICODE", "_UNICODE", "WIN32_LEAN_AND_MEAN",
+                "_WIN32_WINNT=0x0A00", "SPDLOG_COMPILED_LIB")
+    add_includedirs("../src")
+    add_files("../src/core/executor_metrics/executor_metrics.cpp")
+    add_files("../src/core/rpc/metrics.cpp")
+    add_files("../src/core/tracing/tracing.cpp")
+    add_files("../src/core/worker_pool/parallel.cpp")
+    add_files("../src/core/worker_pool/worker_pool.cpp")
+    add_files("../src/features/gallery/scanner/tree_hash.cpp")
+    add_files("../src/utils/hash/file_hash.cpp")
+    add_files("../src/utils/logger/logger.cpp")
+    add_files("../src/utils/path/path.cpp")
+    add_files("benchmarks/file_hash/main.cpp")
+    add_packages("vcpkg::spdlog", "vcpkg::wil", "vcpkg::xxhash")
+    add_links("shell32", "ole32")
+
+target("SpinningMomoBenchStaticStream")
+    set_kind("binary")
+    set_default(false)
+    set_plat("windows")
+    set_arch("x64")
+
+    add_defines("NOMINMAX", "UNICODE", "_UNICODE", "WIN32_LEAN_AND_MEAN",
+                "_WIN32_WINNT=0x0A00")
+    add_includedirs("../src")
+    add_files("benchmarks/static_stream/main.cpp")
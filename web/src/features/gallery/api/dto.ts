@@ -214,6 +214,8 @@ export interface ScanAssetsParams {
   ignoreRules?: ScanIgnoreRule[]
   forceReanalyze?: boolean
   rebuildThumbnails?: boolean
+  // 'full' 对大媒体读取全部内容做分块树哈希；默认 'sampled'
+  fingerprintMode?: 'sampled' | 'full'
 }
 
 // 扫描结果